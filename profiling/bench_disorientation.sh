@@ -0,0 +1,3 @@
+#!/bin/sh
+
+../util/benchmarks/disorientation_bench 2000 1
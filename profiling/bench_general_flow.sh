@@ -0,0 +1,3 @@
+#!/bin/sh
+
+../util/benchmarks/general_flow_bench 100000
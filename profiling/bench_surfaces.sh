@@ -0,0 +1,3 @@
+#!/bin/sh
+
+../util/benchmarks/surfaces_bench 1000000
@@ -0,0 +1,3 @@
+#!/bin/sh
+
+../util/benchmarks/taylor_bench 16 64 4
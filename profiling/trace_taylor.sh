@@ -0,0 +1,3 @@
+#!/bin/sh
+
+NEML_TRACE=taylor_trace.json ../util/benchmarks/taylor_bench 16 64 4
@@ -425,7 +425,7 @@ PYBIND11_NOINLINE inline std::string error_string() {
         PyException_SetTraceback(scope.value, scope.trace);
 #endif
 
-#if !defined(PYPY_VERSION)
+#if !defined(PYPY_VERSION) && PY_VERSION_HEX < 0x030B0000
     if (scope.trace) {
         PyTracebackObject *trace = (PyTracebackObject *) scope.trace;
 
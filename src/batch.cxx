@@ -0,0 +1,103 @@
+#include "batch.h"
+
+#include "trace.h"
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+namespace neml {
+
+/// Return the first error, if any
+static int first_error(const std::vector<int> & ier)
+{
+  for (auto i : ier) {
+    if (i != SUCCESS) return i;
+  }
+  return SUCCESS;
+}
+
+int evaluate_sd_batch(NEMLModel & model, size_t n,
+                      const double * const e_np1, const double * const e_n,
+                      const double * const T_np1, const double * const T_n,
+                      double t_np1, double t_n,
+                      double * const s_np1, const double * const s_n,
+                      double * const h_np1, const double * const h_n,
+                      double * const A_np1,
+                      double * const u_np1, const double * const u_n,
+                      double * const p_np1, const double * const p_n,
+                      int nthreads)
+{
+  size_t nh = model.nstore();
+  std::vector<int> ier(n, SUCCESS);
+
+#ifdef USE_OMP
+  omp_set_num_threads(nthreads);
+#pragma omp parallel
+#endif
+  {
+    NEML_TRACE_SCOPE("evaluate_sd_batch thread");
+    // No barrier after the loop, so the scope times only this thread's work
+#ifdef USE_OMP
+#pragma omp for schedule(dynamic, 64) nowait
+#endif
+    for (size_t i = 0; i < n; i++) {
+      ier[i] = model.update_sd(&e_np1[i*6], &e_n[i*6], T_np1[i], T_n[i],
+                               t_np1, t_n, &s_np1[i*6], &s_n[i*6],
+                               &h_np1[i*nh], &h_n[i*nh], &A_np1[i*36],
+                               u_np1[i], u_n[i], p_np1[i], p_n[i]);
+    }
+  }
+
+  return first_error(ier);
+}
+
+int evaluate_ld_inc_batch(NEMLModel & model, size_t n,
+                      const double * const d_np1, const double * const d_n,
+                      const double * const w_np1, const double * const w_n,
+                      const double * const T_np1, const double * const T_n,
+                      double t_np1, double t_n,
+                      double * const s_np1, const double * const s_n,
+                      double * const h_np1, const double * const h_n,
+                      double * const A_np1, double * const B_np1,
+                      double * const u_np1, const double * const u_n,
+                      double * const p_np1, const double * const p_n,
+                      int nthreads)
+{
+  size_t nh = model.nstore();
+  std::vector<int> ier(n, SUCCESS);
+
+#ifdef USE_OMP
+  omp_set_num_threads(nthreads);
+#pragma omp parallel
+#endif
+  {
+    NEML_TRACE_SCOPE("evaluate_ld_inc_batch thread");
+    // No barrier after the loop, so the scope times only this thread's work
+#ifdef USE_OMP
+#pragma omp for schedule(dynamic, 64) nowait
+#endif
+    for (size_t i = 0; i < n; i++) {
+      ier[i] = model.update_ld_inc(&d_np1[i*6], &d_n[i*6], &w_np1[i*3],
+                                   &w_n[i*3], T_np1[i], T_n[i], t_np1, t_n,
+                                   &s_np1[i*6], &s_n[i*6], 
+                                   &h_np1[i*nh], &h_n[i*nh], 
+                                   &A_np1[i*36], &B_np1[i*18],
+                                   u_np1[i], u_n[i], p_np1[i], p_n[i]);
+    }
+  }
+
+  return first_error(ier);
+}
+
+int init_store_batch(NEMLModel & model, size_t n, double * const store)
+{
+  size_t nh = model.nstore();
+  for (size_t i = 0; i < n; i++) {
+    int ier = model.init_store(&store[i*nh]);
+    if (ier != SUCCESS) return ier;
+  }
+  return SUCCESS;
+}
+
+} // namespace neml
@@ -0,0 +1,46 @@
+#ifndef MODEL_BATCH_H
+#define MODEL_BATCH_H
+
+#include "models.h"
+
+#include "nemlerror.h"
+
+#include "windows.h"
+
+namespace neml {
+
+/// Small strain update for n independent points, optionally in parallel
+//  Arrays are row major with one row per point, i.e. (n,6), (n,nstore),
+//  (n,6,6), and (n) for the scalars.  Returns the first nonzero error code.
+NEML_EXPORT int evaluate_sd_batch(NEMLModel & model, size_t n,
+                      const double * const e_np1, const double * const e_n,
+                      const double * const T_np1, const double * const T_n,
+                      double t_np1, double t_n,
+                      double * const s_np1, const double * const s_n,
+                      double * const h_np1, const double * const h_n,
+                      double * const A_np1,
+                      double * const u_np1, const double * const u_n,
+                      double * const p_np1, const double * const p_n,
+                      int nthreads = 1);
+
+/// Large deformation incremental update for n independent points
+//  As above, with (n,3) spins and an additional (n,6,3) skew tangent
+NEML_EXPORT int evaluate_ld_inc_batch(NEMLModel & model, size_t n,
+                      const double * const d_np1, const double * const d_n,
+                      const double * const w_np1, const double * const w_n,
+                      const double * const T_np1, const double * const T_n,
+                      double t_np1, double t_n,
+                      double * const s_np1, const double * const s_n,
+                      double * const h_np1, const double * const h_n,
+                      double * const A_np1, double * const B_np1,
+                      double * const u_np1, const double * const u_n,
+                      double * const p_np1, const double * const p_n,
+                      int nthreads = 1);
+
+/// Initialize the stored variables for n points
+NEML_EXPORT int init_store_batch(NEMLModel & model, size_t n, 
+                                 double * const store);
+
+} // namespace neml
+
+#endif // MODEL_BATCH_H
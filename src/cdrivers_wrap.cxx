@@ -0,0 +1,608 @@
+#include "pyhelp.h" // include first to avoid annoying redef warning
+
+#include "drivers.h"
+#include "ensemble.h"
+#include "math/nemlmath.h"
+
+#include "nemlerror.h"
+
+namespace py = pybind11;
+
+PYBIND11_DECLARE_HOLDER_TYPE(T, std::shared_ptr<T>)
+
+namespace neml {
+
+/// Copy a vector into a new numpy array
+template<class T>
+static py::array_t<T> vec2arr(const std::vector<T> & v)
+{
+  auto arr = alloc_vec<T>(v.size());
+  std::copy(v.begin(), v.end(), arr2ptr<T>(arr));
+  return arr;
+}
+
+/// Copy flattened step data into a new (nsteps,n) numpy array
+static py::array_t<double> steps2arr(const std::vector<double> & v, size_t n)
+{
+  auto arr = alloc_mat<double>(v.size() / n, n);
+  std::copy(v.begin(), v.end(), arr2ptr<double>(arr));
+  return arr;
+}
+
+/// Convert a python hold time (None, scalar, or pair) to a vector
+static std::vector<double> hold_vector(py::object hold_time)
+{
+  if (hold_time.is_none()) return {};
+  if (py::isinstance<py::sequence>(hold_time)) {
+    return hold_time.cast<std::vector<double>>();
+  }
+  return {hold_time.cast<double>()};
+}
+
+/// Check a direction vector has six components
+static void check_dir(const std::vector<double> & v, std::string name)
+{
+  if (v.size() != 6) {
+    throw std::runtime_error(name + " must have 6 components");
+  }
+}
+
+/// Strain rate step with the optional python guesses
+static py::tuple erate_step(Driver_sd & d, std::vector<double> sdir,
+                            double erate, double t_np1, double T_np1,
+                            py::object einc_guess, py::object ainc_guess)
+{
+  check_dir(sdir, "sdir");
+  auto einc = alloc_vec<double>(6);
+  double ainc = 1.0;
+  bool guess = not (einc_guess.is_none() and ainc_guess.is_none());
+  double ns = norm2_vec(&sdir[0], 6);
+  for (int i = 0; i < 6; i++)
+    arr2ptr<double>(einc)[i] = sdir[i] / ns / 10000.0;
+  if (not einc_guess.is_none()) {
+    auto g = einc_guess.cast<std::vector<double>>();
+    check_dir(g, "einc_guess");
+    std::copy(g.begin(), g.end(), arr2ptr<double>(einc));
+  }
+  if (not ainc_guess.is_none()) ainc = ainc_guess.cast<double>();
+  py_error(d.erate_step(&sdir[0], erate, t_np1, T_np1,
+                        arr2ptr<double>(einc), ainc, guess));
+  return py::make_tuple(einc, ainc);
+}
+
+/// Check a results array for an ensemble run
+static void check_results(py::array_t<double, py::array::c_style> arr,
+                          size_t n, size_t nout)
+{
+  auto info = arr.request();
+  if ((info.ndim != 2) or ((size_t) info.shape[0] != n) or
+      ((size_t) info.shape[1] != nout)) {
+    throw std::runtime_error("out does not have the right shape");
+  }
+  if (not arr.writeable()) {
+    throw std::runtime_error("out is not writeable");
+  }
+}
+
+PYBIND11_MODULE(cdrivers, m) {
+  py::module::import("neml.objects");
+  py::module::import("neml.models");
+
+  m.doc() = "Native versions of the neml.drivers load path drivers.";
+
+  py::class_<Driver_sd, std::shared_ptr<Driver_sd>>(m, "Driver_sd")
+      .def(py::init<std::shared_ptr<NEMLModel>, double, bool, double, double,
+           int, bool>(),
+           py::arg("model"), py::arg("T_init") = 0.0,
+           py::arg("verbose") = false, py::arg("rtol") = 1.0e-6,
+           py::arg("atol") = 1.0e-10, py::arg("miter") = 25,
+           py::arg("no_thermal_strain") = false)
+      .def("strain_step",
+           [](Driver_sd & d, py::array_t<double, py::array::c_style> e_np1,
+              double t_np1, double T_np1)
+           {
+            if (e_np1.request().size != 6)
+              throw std::runtime_error("e_np1 must have 6 components");
+            py_error(d.strain_step(arr2ptr<double>(e_np1), t_np1, T_np1));
+           }, "Take a strain controlled step.")
+      .def("stress_step",
+           [](Driver_sd & d, py::array_t<double, py::array::c_style> s_np1,
+              double t_np1, double T_np1)
+           {
+            if (s_np1.request().size != 6)
+              throw std::runtime_error("s_np1 must have 6 components");
+            py_error(d.stress_step(arr2ptr<double>(s_np1), t_np1, T_np1));
+           }, "Take a stress controlled step.")
+      .def("erate_step",
+           [](Driver_sd & d, std::vector<double> sdir, double erate,
+              double t_np1, double T_np1, py::object einc_guess,
+              py::object ainc_guess) -> py::tuple
+           {
+            return erate_step(d, sdir, erate, t_np1, T_np1, einc_guess,
+                              ainc_guess);
+           }, "Drive in a stress direction at a given strain rate.",
+           py::arg("sdir"), py::arg("erate"), py::arg("t_np1"),
+           py::arg("T_np1"), py::arg("einc_guess") = py::none(),
+           py::arg("ainc_guess") = py::none())
+      .def("erate_einc_step",
+           [](Driver_sd & d, std::vector<double> sdir, double erate,
+              double einc, double T_np1, py::object einc_guess,
+              py::object ainc_guess) -> py::tuple
+           {
+            return erate_step(d, sdir, erate, d.t_n() + einc / erate, T_np1,
+                              einc_guess, ainc_guess);
+           }, "As erate_step, but given the strain increment.",
+           py::arg("sdir"), py::arg("erate"), py::arg("einc"),
+           py::arg("T_np1"), py::arg("einc_guess") = py::none(),
+           py::arg("ainc_guess") = py::none())
+      .def("srate_sinc_step",
+           [](Driver_sd & d, std::vector<double> sdir, double srate,
+              double sinc, double T_np1)
+           {
+            check_dir(sdir, "sdir");
+            py_error(d.srate_sinc_step(&sdir[0], srate, sinc, T_np1));
+           }, "Stress controlled step given the stress rate and increment.")
+      .def("strain_hold_step",
+           [](Driver_sd & d, int i, double t_np1, double T_np1, double q,
+              double E)
+           {
+            py_error(d.strain_hold_step(i, t_np1, T_np1, q, E));
+           }, "Hold one strain component, keeping the other stresses fixed.",
+           py::arg("i"), py::arg("t_np1"), py::arg("T_np1"),
+           py::arg("q") = 1.0, py::arg("E") = -1.0)
+      .def_property_readonly("strain",
+           [](Driver_sd & d) {return steps2arr(d.strain(), 6);})
+      .def_property_readonly("mechanical_strain",
+           [](Driver_sd & d) {return steps2arr(d.mechanical_strain(), 6);})
+      .def_property_readonly("thermal_strain",
+           [](Driver_sd & d) {return steps2arr(d.thermal_strain(), 6);})
+      .def_property_readonly("stress",
+           [](Driver_sd & d) {return steps2arr(d.stress(), 6);})
+      .def_property_readonly("stored",
+           [](Driver_sd & d) {return steps2arr(d.stored(), d.nstore());})
+      .def_property_readonly("T",
+           [](Driver_sd & d) {return vec2arr(d.T());})
+      .def_property_readonly("t",
+           [](Driver_sd & d) {return vec2arr(d.t());})
+      .def_property_readonly("u",
+           [](Driver_sd & d) {return vec2arr(d.u());})
+      .def_property_readonly("p",
+           [](Driver_sd & d) {return vec2arr(d.p());})
+      ;
+
+  m.def("uniaxial_test",
+        [](std::shared_ptr<NEMLModel> model, double erate, double T,
+           double emax, int nsteps, std::vector<double> sdir, double offset,
+           py::object history, std::vector<double> tdir) -> py::dict
+        {
+          check_dir(sdir, "sdir");
+          check_dir(tdir, "tdir");
+          std::vector<double> hist;
+          if (not history.is_none())
+            hist = history.cast<std::vector<double>>();
+          UniaxialTestResults res;
+          int ier;
+          {
+            py::gil_scoped_release release;
+            ier = uniaxial_test(model, erate, res, T, emax, nsteps, sdir,
+                                offset, hist, tdir);
+          }
+          py_error(ier);
+          py::dict d;
+          d["strain"] = vec2arr(res.strain);
+          d["stress"] = vec2arr(res.stress);
+          d["energy_density"] = vec2arr(res.energy_density);
+          d["plastic_work"] = vec2arr(res.plastic_work);
+          d["youngs"] = res.youngs;
+          d["yield"] = res.yield;
+          d["poissons"] = res.poissons;
+          return d;
+        }, "Uniaxial stress/strain curve.",
+        py::arg("model"), py::arg("erate"), py::arg("T") = 300.0,
+        py::arg("emax") = 0.05, py::arg("nsteps") = 250,
+        py::arg("sdir") = std::vector<double>({1,0,0,0,0,0}),
+        py::arg("offset") = 0.2/100.0, py::arg("history") = py::none(),
+        py::arg("tdir") = std::vector<double>({0,1,0,0,0,0}));
+
+  m.def("strain_cyclic",
+        [](std::shared_ptr<NEMLModel> model, double emax, double R,
+           double erate, int ncycles, double T, int nsteps,
+           std::vector<double> sdir, py::object hold_time, int n_hold,
+           bool check_dmg, double dtol) -> py::dict
+        {
+          check_dir(sdir, "sdir");
+          std::vector<double> holds = hold_vector(hold_time);
+          CyclicTestResults res;
+          int ier;
+          {
+            py::gil_scoped_release release;
+            ier = strain_cyclic(model, emax, R, erate, ncycles, res, T,
+                                nsteps, sdir, holds, n_hold, check_dmg, dtol);
+          }
+          py_error(ier);
+          py::dict d;
+          d["strain"] = vec2arr(res.strain);
+          d["stress"] = vec2arr(res.stress);
+          d["cycles"] = vec2arr(res.cycles);
+          d["max"] = vec2arr(res.max);
+          d["min"] = vec2arr(res.min);
+          d["mean"] = vec2arr(res.mean);
+          d["energy_density"] = vec2arr(res.energy_density);
+          d["plastic_work"] = vec2arr(res.plastic_work);
+          d["history"] = vec2arr(res.history);
+          d["time"] = vec2arr(res.time);
+          return d;
+        }, "Strain controlled cyclic test.",
+        py::arg("model"), py::arg("emax"), py::arg("R"), py::arg("erate"),
+        py::arg("ncycles"), py::arg("T") = 300.0, py::arg("nsteps") = 50,
+        py::arg("sdir") = std::vector<double>({1,0,0,0,0,0}),
+        py::arg("hold_time") = py::none(), py::arg("n_hold") = 25,
+        py::arg("check_dmg") = false, py::arg("dtol") = 0.75);
+
+  m.def("strain_cyclic_extrapolated",
+        [](std::shared_ptr<NEMLModel> model, double emax, double R,
+           double erate, int ncycles, double T, int nsteps,
+           std::vector<double> sdir, py::object hold_time, int n_hold,
+           bool check_dmg, double dtol, int min_cycle, int max_jump,
+           double jump_tol, double jump_stress) -> py::dict
+        {
+          check_dir(sdir, "sdir");
+          std::vector<double> holds = hold_vector(hold_time);
+          CyclicTestResults res;
+          int ier;
+          {
+            py::gil_scoped_release release;
+            ier = strain_cyclic_extrapolated(model, emax, R, erate, ncycles,
+                                             res, T, nsteps, sdir, holds,
+                                             n_hold, check_dmg, dtol,
+                                             min_cycle, max_jump, jump_tol,
+                                             jump_stress);
+          }
+          py_error(ier);
+          py::dict d;
+          d["strain"] = vec2arr(res.strain);
+          d["stress"] = vec2arr(res.stress);
+          d["cycles"] = vec2arr(res.cycles);
+          d["max"] = vec2arr(res.max);
+          d["min"] = vec2arr(res.min);
+          d["mean"] = vec2arr(res.mean);
+          d["energy_density"] = vec2arr(res.energy_density);
+          d["plastic_work"] = vec2arr(res.plastic_work);
+          d["history"] = vec2arr(res.history);
+          d["time"] = vec2arr(res.time);
+          d["extrapolated"] = vec2arr(res.extrapolated);
+          return d;
+        }, "Strain controlled cyclic test, extrapolating over stabilized cycles.",
+        py::arg("model"), py::arg("emax"), py::arg("R"), py::arg("erate"),
+        py::arg("ncycles"), py::arg("T") = 300.0, py::arg("nsteps") = 50,
+        py::arg("sdir") = std::vector<double>({1,0,0,0,0,0}),
+        py::arg("hold_time") = py::none(), py::arg("n_hold") = 25,
+        py::arg("check_dmg") = false, py::arg("dtol") = 0.75,
+        py::arg("min_cycle") = 3, py::arg("max_jump") = 100,
+        py::arg("jump_tol") = 1.0e-3, py::arg("jump_stress") = 5.0);
+
+  m.def("strain_cyclic_followup",
+        [](std::shared_ptr<NEMLModel> model, double emax, double R,
+           double erate, int ncycles, double q, double T, int nsteps,
+           int sind, py::object hold_time, int n_hold, bool check_dmg,
+           double dtol, bool logspace) -> py::dict
+        {
+          std::vector<double> holds = hold_vector(hold_time);
+          CyclicTestResults res;
+          int ier;
+          {
+            py::gil_scoped_release release;
+            ier = strain_cyclic_followup(model, emax, R, erate, ncycles, res,
+                                         q, T, nsteps, sind, holds, n_hold,
+                                         check_dmg, dtol, logspace);
+          }
+          py_error(ier);
+          py::dict d;
+          d["strain"] = vec2arr(res.strain);
+          d["stress"] = vec2arr(res.stress);
+          d["cycles"] = vec2arr(res.cycles);
+          d["max"] = vec2arr(res.max);
+          d["min"] = vec2arr(res.min);
+          d["mean"] = vec2arr(res.mean);
+          d["energy_density"] = vec2arr(res.energy_density);
+          d["plastic_work"] = vec2arr(res.plastic_work);
+          d["history"] = vec2arr(res.history);
+          d["time"] = vec2arr(res.time);
+          return d;
+        }, "Strain controlled cyclic test with follow up.",
+        py::arg("model"), py::arg("emax"), py::arg("R"), py::arg("erate"),
+        py::arg("ncycles"), py::arg("q") = 1.0, py::arg("T") = 300.0,
+        py::arg("nsteps") = 50, py::arg("sind") = 0,
+        py::arg("hold_time") = py::none(), py::arg("n_hold") = 25,
+        py::arg("check_dmg") = false, py::arg("dtol") = 0.75,
+        py::arg("logspace") = false);
+
+  m.def("stress_cyclic",
+        [](std::shared_ptr<NEMLModel> model, double smax, double R,
+           double srate, int ncycles, double T, int nsteps,
+           std::vector<double> sdir, py::object hold_time, int n_hold,
+           double etol) -> py::dict
+        {
+          check_dir(sdir, "sdir");
+          std::vector<double> holds = hold_vector(hold_time);
+          CyclicTestResults res;
+          int ier;
+          {
+            py::gil_scoped_release release;
+            ier = stress_cyclic(model, smax, R, srate, ncycles, res, T,
+                                nsteps, sdir, holds, n_hold, etol);
+          }
+          py_error(ier);
+          py::dict d;
+          d["strain"] = vec2arr(res.strain);
+          d["stress"] = vec2arr(res.stress);
+          d["cycles"] = vec2arr(res.cycles);
+          d["max"] = vec2arr(res.max);
+          d["min"] = vec2arr(res.min);
+          d["mean"] = vec2arr(res.mean);
+          d["energy_density"] = vec2arr(res.energy_density);
+          d["plastic_work"] = vec2arr(res.plastic_work);
+          d["time"] = vec2arr(res.time);
+          return d;
+        }, "Stress controlled cyclic test.",
+        py::arg("model"), py::arg("smax"), py::arg("R"), py::arg("srate"),
+        py::arg("ncycles"), py::arg("T") = 300.0, py::arg("nsteps") = 50,
+        py::arg("sdir") = std::vector<double>({1,0,0,0,0,0}),
+        py::arg("hold_time") = py::none(), py::arg("n_hold") = 10,
+        py::arg("etol") = 0.1);
+
+  m.def("stress_relaxation",
+        [](std::shared_ptr<NEMLModel> model, double emax, double erate,
+           double hold, double T, int nsteps, int nsteps_up, int index,
+           double tc, bool logspace, double q) -> py::dict
+        {
+          StressRelaxationResults res;
+          int ier;
+          {
+            py::gil_scoped_release release;
+            ier = stress_relaxation(model, emax, erate, hold, res, T, nsteps,
+                                    nsteps_up, index, tc, logspace, q);
+          }
+          py_error(ier);
+          py::dict d;
+          d["time"] = vec2arr(res.time);
+          d["strain"] = vec2arr(res.strain);
+          d["stress"] = vec2arr(res.stress);
+          d["rtime"] = vec2arr(res.rtime);
+          d["rrate"] = vec2arr(res.rrate);
+          d["rstress"] = vec2arr(res.rstress);
+          d["rstrain"] = vec2arr(res.rstrain);
+          return d;
+        }, "Stress relaxation test.",
+        py::arg("model"), py::arg("emax"), py::arg("erate"), py::arg("hold"),
+        py::arg("T") = 300.0, py::arg("nsteps") = 250,
+        py::arg("nsteps_up") = 50, py::arg("index") = 0, py::arg("tc") = 1.0,
+        py::arg("logspace") = false, py::arg("q") = 1.0);
+
+  m.def("creep",
+        [](std::shared_ptr<NEMLModel> model, double smax, double srate,
+           double hold, double T, int nsteps, int nsteps_up,
+           std::vector<double> sdir, bool logspace, py::object history,
+           double elimit, bool check_dmg, double dtol) -> py::dict
+        {
+          check_dir(sdir, "sdir");
+          std::vector<double> hist;
+          if (not history.is_none())
+            hist = history.cast<std::vector<double>>();
+          CreepResults res;
+          int ier;
+          {
+            py::gil_scoped_release release;
+            ier = creep(model, smax, srate, hold, res, T, nsteps, nsteps_up,
+                        sdir, logspace, hist, elimit, check_dmg, dtol);
+          }
+          py_error(ier);
+          py::dict d;
+          d["time"] = vec2arr(res.time);
+          d["strain"] = vec2arr(res.strain);
+          d["stress"] = vec2arr(res.stress);
+          d["rtime"] = vec2arr(res.rtime);
+          d["rrate"] = vec2arr(res.rrate);
+          d["rstrain"] = vec2arr(res.rstrain);
+          d["tstrain"] = vec2arr(res.tstrain);
+          d["failed"] = res.failed;
+          return d;
+        }, "Creep test.",
+        py::arg("model"), py::arg("smax"), py::arg("srate"), py::arg("hold"),
+        py::arg("T") = 300.0, py::arg("nsteps") = 250,
+        py::arg("nsteps_up") = 150,
+        py::arg("sdir") = std::vector<double>({1,0,0,0,0,0}),
+        py::arg("logspace") = false, py::arg("history") = py::none(),
+        py::arg("elimit") = 1.0, py::arg("check_dmg") = false,
+        py::arg("dtol") = 0.75);
+
+  m.def("rate_jump_test",
+        [](std::shared_ptr<NEMLModel> model, std::vector<double> erates,
+           double T, double e_per, int nsteps_per, std::vector<double> sdir,
+           py::object history, py::object strains) -> py::dict
+        {
+          check_dir(sdir, "sdir");
+          std::vector<double> hist, jumps;
+          if (not history.is_none())
+            hist = history.cast<std::vector<double>>();
+          if (not strains.is_none())
+            jumps = strains.cast<std::vector<double>>();
+          RateJumpResults res;
+          int ier;
+          {
+            py::gil_scoped_release release;
+            ier = rate_jump_test(model, erates, res, T, e_per, nsteps_per,
+                                 sdir, hist, jumps);
+          }
+          py_error(ier);
+          py::dict d;
+          d["strain"] = vec2arr(res.strain);
+          d["stress"] = vec2arr(res.stress);
+          d["energy_density"] = vec2arr(res.energy_density);
+          d["plastic_work"] = vec2arr(res.plastic_work);
+          return d;
+        }, "Uniaxial strain rate jump test.",
+        py::arg("model"), py::arg("erates"), py::arg("T") = 300.0,
+        py::arg("e_per") = 0.01, py::arg("nsteps_per") = 100,
+        py::arg("sdir") = std::vector<double>({1,0,0,0,0,0}),
+        py::arg("history") = py::none(), py::arg("strains") = py::none());
+
+  m.def("thermomechanical_strain_raw",
+        [](std::shared_ptr<NEMLModel> model, std::vector<double> time,
+           std::vector<double> temperature, std::vector<double> strain,
+           std::vector<double> sdir, int substep) -> py::dict
+        {
+          check_dir(sdir, "sdir");
+          ThermomechanicalResults res;
+          int ier;
+          {
+            py::gil_scoped_release release;
+            ier = thermomechanical_strain_raw(model, time, temperature,
+                                              strain, res, sdir, substep);
+          }
+          py_error(ier);
+          py::dict d;
+          d["time"] = vec2arr(res.time);
+          d["temperature"] = vec2arr(res.temperature);
+          d["strain"] = vec2arr(res.strain);
+          d["stress"] = vec2arr(res.stress);
+          d["mechanical strain"] = vec2arr(res.mechanical_strain);
+          return d;
+        }, "Follow a measured strain and temperature history.",
+        py::arg("model"), py::arg("time"), py::arg("temperature"),
+        py::arg("strain"),
+        py::arg("sdir") = std::vector<double>({1,0,0,0,0,0}),
+        py::arg("substep") = 1);
+
+  m.def("isochronous_curve",
+        [](std::shared_ptr<NEMLModel> model, double time, double T,
+           double emax, double srate, double ds, int max_cut, int nsteps,
+           py::object history, bool check_dmg, double dtol) -> py::dict
+        {
+          std::vector<double> hist;
+          if (not history.is_none())
+            hist = history.cast<std::vector<double>>();
+          IsochronousResults res;
+          int ier;
+          {
+            py::gil_scoped_release release;
+            ier = isochronous_curve(model, time, res, T, emax, srate, ds,
+                                    max_cut, nsteps, hist, check_dmg, dtol);
+          }
+          py_error(ier);
+          py::dict d;
+          d["strain"] = vec2arr(res.strain);
+          d["stress"] = vec2arr(res.stress);
+          return d;
+        }, "Isochronous stress-strain curve from a series of creep tests.",
+        py::arg("model"), py::arg("time"), py::arg("T") = 300.0,
+        py::arg("emax") = 0.05, py::arg("srate") = 1.0, py::arg("ds") = 10.0,
+        py::arg("max_cut") = 4, py::arg("nsteps") = 250,
+        py::arg("history") = py::none(), py::arg("check_dmg") = false,
+        py::arg("dtol") = 0.75);
+
+  py::class_<ModelEnsemble, std::shared_ptr<ModelEnsemble>>(m, "ModelEnsemble")
+      .def(py::init<std::string, std::string, std::vector<std::string>>(),
+           py::arg("fname"), py::arg("mname"), py::arg("names"))
+      .def_property_readonly("nparams", &ModelEnsemble::nparams)
+      .def_property_readonly("names", &ModelEnsemble::names)
+      .def_property_readonly("base_values",
+           [](ModelEnsemble & e) {return vec2arr(e.base_values());})
+      .def("make_model",
+           [](ModelEnsemble & e, std::vector<double> values)
+           {
+            if (values.size() != e.nparams())
+              throw std::runtime_error("Wrong number of parameter values");
+            return e.make_model(&values[0]);
+           }, "Make the model for a set of parameter values.")
+      ;
+
+  py::class_<EnsembleTest, std::shared_ptr<EnsembleTest>>(m, "EnsembleTest")
+      .def_property_readonly("outputs", &EnsembleTest::outputs)
+      .def_property_readonly("nout", &EnsembleTest::nout)
+      ;
+
+  py::class_<UniaxialEnsembleTest, EnsembleTest,
+      std::shared_ptr<UniaxialEnsembleTest>>(m, "UniaxialEnsembleTest")
+      .def(py::init<double, double, double, int>(),
+           py::arg("erate"), py::arg("T") = 300.0, py::arg("emax") = 0.05,
+           py::arg("nsteps") = 250)
+      ;
+
+  py::class_<CreepEnsembleTest, EnsembleTest,
+      std::shared_ptr<CreepEnsembleTest>>(m, "CreepEnsembleTest")
+      .def(py::init<double, double, double, double, int, int, bool, double>(),
+           py::arg("smax"), py::arg("srate"), py::arg("hold"),
+           py::arg("T") = 300.0, py::arg("nsteps") = 250,
+           py::arg("nsteps_up") = 150, py::arg("logspace") = false,
+           py::arg("elimit") = 1.0)
+      ;
+
+  py::class_<StrainCyclicEnsembleTest, EnsembleTest,
+      std::shared_ptr<StrainCyclicEnsembleTest>>(m, "StrainCyclicEnsembleTest")
+      .def(py::init(
+           [](double emax, double R, double erate, int ncycles, double T,
+              int nsteps, py::object hold_time, int n_hold)
+           {
+            return std::make_shared<StrainCyclicEnsembleTest>(emax, R, erate,
+                ncycles, T, nsteps, hold_vector(hold_time), n_hold);
+           }),
+           py::arg("emax"), py::arg("R"), py::arg("erate"),
+           py::arg("ncycles"), py::arg("T") = 300.0, py::arg("nsteps") = 50,
+           py::arg("hold_time") = py::none(), py::arg("n_hold") = 25)
+      ;
+
+  m.def("run_ensemble",
+        [](std::shared_ptr<ModelEnsemble> ensemble,
+           std::shared_ptr<EnsembleTest> test,
+           py::array_t<double, py::array::c_style> values, int nthreads,
+           py::object out) -> py::dict
+        {
+          auto info = values.request();
+          if ((info.ndim != 2) or
+              ((size_t) info.shape[1] != ensemble->nparams())) {
+            throw std::runtime_error("values must be (n,nparams)");
+          }
+          size_t n = info.shape[0];
+          size_t nout = test->nout();
+
+          py::array_t<double, py::array::c_style> results;
+          if (out.is_none()) results = alloc_mat<double>(n, nout);
+          else {
+            if (not py::isinstance<py::array_t<double,
+                py::array::c_style>>(out)) {
+              throw std::runtime_error(
+                  "out must be a C contiguous float64 array");
+            }
+            results = py::reinterpret_borrow<py::array_t<double,
+                    py::array::c_style>>(out);
+          }
+          check_results(results, n, nout);
+          auto errors = alloc_vec<int>(n);
+
+          {
+            py::gil_scoped_release release;
+            run_ensemble(*ensemble, *test, n, arr2ptr<double>(values),
+                         arr2ptr<double>(results), arr2ptr<int>(errors),
+                         nthreads);
+          }
+
+          // Split the results into views of each output block
+          py::dict d;
+          size_t start = 0;
+          for (auto & block : test->outputs()) {
+            py::object index;
+            if (block.second == 1) index = py::int_(start);
+            else index = py::slice(start, start + block.second, 1);
+            d[py::str(block.first)] = results.attr("__getitem__")(
+                py::make_tuple(py::slice(0, n, 1), index));
+            start += block.second;
+          }
+          d["errors"] = errors;
+          return d;
+        }, "Run a test on each variant of a model ensemble.",
+        py::arg("ensemble"), py::arg("test"), py::arg("values"),
+        py::arg("nthreads") = 1, py::arg("out") = py::none());
+}
+
+} // namespace neml
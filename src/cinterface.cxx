@@ -1,11 +1,14 @@
 #include "cinterface.h"
 #include "nemlerror.h"
+#include "replay.h"
 
 NEMLMODEL * create_nemlmodel(const char * fname, const char * mname, int * ier)
 {
   try {
     // Remember, releasing the unique_ptr means you have to reference count!
     std::unique_ptr<neml::NEMLModel> umodel = neml::parse_xml_unique(fname, mname);
+    // Lets a UMAT record slow points without recompiling, see replay.h
+    umodel->set_recorder(neml::UpdateRecorder::from_environment());
     *ier = 0;
 
     return umodel.release();
@@ -80,8 +83,91 @@ void update_sd_nemlmodel(NEMLMODEL * model, double * e_np1, double * e_n,
                          int * ier)
 {
   try {
-    *ier = model->update_sd(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1, s_n,
-                            h_np1, h_n, A_np1, *u_np1, u_n, *p_np1, p_n);
+    *ier = neml::recorded_update_sd(*model, e_np1, e_n, T_np1, T_n, t_np1,
+                                    t_n, s_np1, s_n, h_np1, h_n, A_np1,
+                                    *u_np1, u_n, *p_np1, p_n);
+  }
+  catch (...) {
+    *ier = neml::UNKNOWN_ERROR;
+  }
+}
+
+void collect_stats_nemlmodel(NEMLMODEL * model, int on, int * ier)
+{
+  try {
+    model->collect_solver_stats(on != 0);
+    *ier = 0;
+  }
+  catch (...) {
+    *ier = neml::UNKNOWN_ERROR;
+  }
+}
+
+void reset_stats_nemlmodel(NEMLMODEL * model, int * ier)
+{
+  try {
+    model->reset_solver_stats();
+    *ier = 0;
+  }
+  catch (...) {
+    *ier = neml::UNKNOWN_ERROR;
+  }
+}
+
+void stats_nemlmodel(NEMLMODEL * model, double * stats, int * ier)
+{
+  try {
+    neml::SolverStats merged = model->solver_stats();
+    stats[NEML_STAT_SOLVES] = merged.solves;
+    stats[NEML_STAT_ITERATIONS] = merged.iterations;
+    stats[NEML_STAT_RJ_CALLS] = merged.rj_calls;
+    stats[NEML_STAT_R_CALLS] = merged.r_calls;
+    stats[NEML_STAT_LINEAR_SOLVES] = merged.linear_solves;
+    stats[NEML_STAT_SUBSTEP_DIVISIONS] = merged.substep_divisions;
+    stats[NEML_STAT_FAILURES] = merged.total_failures();
+    stats[NEML_STAT_RJ_TIME] = merged.rj_time;
+    stats[NEML_STAT_LINEAR_TIME] = merged.linear_time;
+    *ier = 0;
+  }
+  catch (...) {
+    *ier = neml::UNKNOWN_ERROR;
+  }
+}
+
+double failures_nemlmodel(NEMLMODEL * model, int code, int * ier)
+{
+  try {
+    neml::SolverStats merged = model->solver_stats();
+    *ier = 0;
+    auto found = merged.failures.find(code);
+    if (found == merged.failures.end()) return 0;
+    return found->second;
+  }
+  catch (...) {
+    *ier = neml::UNKNOWN_ERROR;
+    return -1;
+  }
+}
+
+void record_nemlmodel(NEMLMODEL * model, const char * fname,
+                      int sample_every, double time_threshold,
+                      int iteration_threshold, int * ier)
+{
+  try {
+    model->set_recorder(std::make_shared<neml::UpdateRecorder>(
+            fname, sample_every, time_threshold, iteration_threshold));
+    *ier = 0;
+  }
+  catch (...) {
+    *ier = neml::UNKNOWN_ERROR;
+  }
+}
+
+void stop_recording_nemlmodel(NEMLMODEL * model, int * ier)
+{
+  try {
+    model->set_recorder(nullptr);
+    *ier = 0;
   }
   catch (...) {
     *ier = neml::UNKNOWN_ERROR;
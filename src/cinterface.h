@@ -35,6 +35,32 @@ void update_sd_nemlmodel(NEMLMODEL * model, double * e_np1, double * e_n,
                          double * p_np1, double p_n,
                          int * ier);
 
+// Solver statistics, see stats_nemlmodel for the layout
+#define NEML_STAT_SOLVES 0
+#define NEML_STAT_ITERATIONS 1
+#define NEML_STAT_RJ_CALLS 2
+#define NEML_STAT_R_CALLS 3
+#define NEML_STAT_LINEAR_SOLVES 4
+#define NEML_STAT_SUBSTEP_DIVISIONS 5
+#define NEML_STAT_FAILURES 6
+#define NEML_STAT_RJ_TIME 7
+#define NEML_STAT_LINEAR_TIME 8
+#define NEML_NSTATS 9
+
+void collect_stats_nemlmodel(NEMLMODEL * model, int on, int * ier);
+void reset_stats_nemlmodel(NEMLMODEL * model, int * ier);
+// Fill stats (NEML_NSTATS long) with the statistics merged over threads
+void stats_nemlmodel(NEMLMODEL * model, double * stats, int * ier);
+// Number of failed solves with the given error code
+double failures_nemlmodel(NEMLMODEL * model, int code, int * ier);
+
+// Capture update_sd calls to a log for replay, see replay.h.  Setting the
+// NEML_RECORD environment variable does the same for every created model.
+void record_nemlmodel(NEMLMODEL * model, const char * fname,
+                      int sample_every, double time_threshold,
+                      int iteration_threshold, int * ier);
+void stop_recording_nemlmodel(NEMLMODEL * model, int * ier);
+
 #ifdef __cplusplus
 }
 #endif
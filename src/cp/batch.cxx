@@ -1,11 +1,56 @@
 #include "batch.h"
 
+#include "../trace.h"
+
 #ifdef USE_OMP
 #include <omp.h>
 #endif
 
 namespace neml {
 
+OpenMPExecutor::OpenMPExecutor(int nthreads) :
+    nthreads_(nthreads < 1 ? 1 : nthreads)
+{
+
+}
+
+size_t OpenMPExecutor::nblocks() const
+{
+  return nthreads_;
+}
+
+void OpenMPExecutor::run(const std::function<void(size_t)> & fn) const
+{
+  size_t nb = nblocks();
+#ifdef USE_OMP
+  if (omp_in_parallel()) {
+    for (size_t i = 0; i < nb; i++) {
+#pragma omp task firstprivate(i) shared(fn)
+      fn(i);
+    }
+#pragma omp taskwait
+    return;
+  }
+  if (nb > 1) {
+#pragma omp parallel for schedule(static, 1) num_threads(nthreads_)
+    for (size_t i = 0; i < nb; i++) {
+      fn(i);
+    }
+    return;
+  }
+#endif
+  for (size_t i = 0; i < nb; i++) {
+    fn(i);
+  }
+}
+
+void block_range(size_t i, size_t nblocks, size_t n,
+                 size_t & begin, size_t & end)
+{
+  begin = (i * n) / nblocks;
+  end = ((i + 1) * n) / nblocks;
+}
+
 int evaluate_crystal_batch(SingleCrystalModel & model, size_t n, 
                            const double * const d_np1, const double * const d_n, 
                            const double * const w_np1, const double * const w_n, 
@@ -25,15 +70,23 @@ int evaluate_crystal_batch(SingleCrystalModel & model, size_t n,
   omp_set_num_threads(nthreads);
   #endif
 
+  // One chunk of crystals per thread, so the trace shows the imbalance
+  // (no barrier after the loop, so each scope ends with its own chunk)
 #ifdef USE_OMP
-#pragma omp parallel for
+#pragma omp parallel
 #endif
-  for (size_t i=0; i<n; i++) {
-    ier[i] = model.update_ld_inc(&d_np1[i*6], &d_n[i*6], &w_np1[i*3], &w_n[i*3],
-                                 T_np1[i], T_n[i], t_np1, t_n, &s_np1[i*6],
-                                 &s_n[i*6], &h_np1[i*nh], &h_n[i*nh],
-                                 &A_np1[i*36], &B_np1[i*18], 
-                                 u_np1[i], u_n[i], p_np1[i], p_n[i]);
+  {
+    NEML_TRACE_SCOPE("evaluate_crystal_batch chunk");
+#ifdef USE_OMP
+#pragma omp for nowait
+#endif
+    for (size_t i=0; i<n; i++) {
+      ier[i] = model.update_ld_inc(&d_np1[i*6], &d_n[i*6], &w_np1[i*3], &w_n[i*3],
+                                   T_np1[i], T_n[i], t_np1, t_n, &s_np1[i*6],
+                                   &s_n[i*6], &h_np1[i*nh], &h_n[i*nh],
+                                   &A_np1[i*36], &B_np1[i*18], 
+                                   u_np1[i], u_n[i], p_np1[i], p_n[i]);
+    }
   }
   
   int ret = 0;
@@ -59,6 +112,35 @@ int init_history_batch(SingleCrystalModel & model, size_t n, double * const hist
   return 0;
 }
 
+int init_history_batch(const SingleCrystalModel & model, size_t n,
+                       double * const hist, const OrientationArray & q0s,
+                       int nthreads)
+{
+  if (q0s.size() != n) return INCOMPATIBLE_VECTORS;
+
+  size_t nh = model.nstore();
+  int ret = 0;
+
+  // Each thread first touches the points it would later update
+  OpenMPExecutor executor(nthreads);
+  executor.run([&](size_t b)
+  {
+    size_t begin, end;
+    block_range(b, executor.nblocks(), n, begin, end);
+    for (size_t i = begin; i < end; i++) {
+      int ier = model.init_instance(&hist[i*nh], q0s.get(i));
+      if (ier != 0) {
+#ifdef USE_OMP
+#pragma omp critical
+#endif
+        ret = ier;
+      }
+    }
+  });
+
+  return ret;
+}
+
 int set_orientation_passive_batch(SingleCrystalModel & model, size_t n,
                                   double * const hist,
                                   std::vector<Orientation> orientations)
@@ -7,8 +7,48 @@
 
 #include "../windows.h"
 
+#include <functional>
+
 namespace neml {
 
+/// Runs independent blocks of work on a set of threads
+//  The polycrystal models hand their grains to an executor so that a
+//  caller that already threads over elements can supply its own pool.
+//  Block i should go to the same thread every time it runs, when the
+//  executor controls the threads, so memory first touched by block i
+//  stays local to that thread.
+class NEML_EXPORT BatchExecutor {
+ public:
+  virtual ~BatchExecutor() {};
+
+  /// Number of blocks to split the work into
+  virtual size_t nblocks() const = 0;
+  /// Call fn(i) for each block i, returning once all the calls finish
+  virtual void run(const std::function<void(size_t)> & fn) const = 0;
+};
+
+/// OpenMP executor that cooperates with an enclosing parallel region
+//  Outside a parallel region the blocks go to a new team of nthreads
+//  threads with a static schedule.  Inside one the blocks become tasks
+//  for the threads of the enclosing team instead of starting a nested
+//  team, which would either oversubscribe the cores or run serially.
+//  Tasks run on whichever thread of the team is free, so the block to
+//  thread placement only holds outside a parallel region.
+class NEML_EXPORT OpenMPExecutor: public BatchExecutor {
+ public:
+  OpenMPExecutor(int nthreads);
+
+  virtual size_t nblocks() const;
+  virtual void run(const std::function<void(size_t)> & fn) const;
+
+ private:
+  int nthreads_;
+};
+
+/// Contiguous range [begin, end) of n items in block i of nblocks
+NEML_EXPORT void block_range(size_t i, size_t nblocks, size_t n,
+                             size_t & begin, size_t & end);
+
 NEML_EXPORT int evaluate_crystal_batch(SingleCrystalModel & model, size_t n,
                            const double * const d_np1, const double * const d_n,
                            const double * const w_np1, const double * const w_n,
@@ -21,6 +61,14 @@ NEML_EXPORT int evaluate_crystal_batch(SingleCrystalModel & model, size_t n,
                            double * const p_np1, const double * const p_n,
                            int nthreads = 1);
 NEML_EXPORT int init_history_batch(SingleCrystalModel & model, size_t n, double * const hist);
+/// Initialize n points of one model, each with its own initial orientation
+//  The orientations are in the active convention, like the model's
+//  initial_angle.  The history then carries each point's orientation, so
+//  evaluate_crystal_batch runs all the points on the one shared model.
+NEML_EXPORT int init_history_batch(const SingleCrystalModel & model, size_t n,
+                                   double * const hist,
+                                   const OrientationArray & q0s,
+                                   int nthreads = 1);
 NEML_EXPORT int set_orientation_passive_batch(SingleCrystalModel & model, size_t n,
                                   double * const hist,
                                   std::vector<Orientation> orientations);
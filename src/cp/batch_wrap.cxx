@@ -157,6 +157,18 @@ PYBIND11_MODULE(batch, m) {
           py_error(ier);
           return h;
         }, "Batch initialize history");
+  m.def("init_history_batch",
+        [](const SingleCrystalModel & model, const OrientationArray & q0s,
+           int nthreads) -> py::array_t<double>
+        {
+          size_t n = q0s.size();
+          auto h = alloc_mat<double>(n, model.nstore());
+          int ier = init_history_batch(model, n, arr2ptr<double>(h), q0s,
+                                       nthreads);
+          py_error(ier);
+          return h;
+        }, "Batch initialize history, one point for each initial orientation",
+        py::arg("model"), py::arg("q0s"), py::arg("nthreads") = 1);
   m.def("set_orientation_passive_batch",
         [](SingleCrystalModel & model, py::array_t<double,
            py::array::c_style> h, std::vector<Orientation> qs)
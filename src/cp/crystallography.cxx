@@ -8,6 +8,10 @@
 #include <algorithm>
 #include <iostream>
 
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
 namespace neml {
 
 std::vector<Orientation> symmetry_rotations(std::string sclass)
@@ -134,11 +138,57 @@ std::vector<Orientation> symmetry_rotations(std::string sclass)
 SymmetryGroup::SymmetryGroup(std::string sclass) :
     ops_(symmetry_rotations(sclass))
 {
-  misops_.reserve(ops_.size() * ops_.size());
+  // The products of a group repeat each operator many times, keep one
   for (auto a : ops_) {
     for (auto b : ops_) {
-      misops_.push_back(a * b);
+      Orientation c = a * b;
+      bool found = false;
+      for (auto & other : misops_) {
+        double diff = 0.0;
+        for (int i = 0; i < 4; i++) {
+          diff = std::max(diff, fabs(c.quat()[i] - other.quat()[i]));
+        }
+        if (diff < 1.0e-12) {
+          found = true;
+          break;
+        }
+      }
+      if (not found) misops_.push_back(c);
+    }
+  }
+
+  // Operators distinct up to sign for the angle kernels
+  double min_angle = 2.0 * M_PI;
+  for (auto & op : misops_) {
+    const double * q = op.quat();
+    bool found = false;
+    for (size_t k = 0; k < sw_.size(); k++) {
+      if (fabs(q[0]*sw_[k] + q[1]*sx_[k] + q[2]*sy_[k] + q[3]*sz_[k])
+          > 1.0 - 1.0e-12) {
+        found = true;
+        break;
+      }
     }
+    if (found) continue;
+    sw_.push_back(q[0]);
+    sx_.push_back(q[1]);
+    sy_.push_back(q[2]);
+    sz_.push_back(q[3]);
+
+    double angle = 2.0 * acos(std::min(fabs(q[0]), 1.0));
+    if (angle > 1.0e-8) min_angle = std::min(min_angle, angle);
+  }
+
+  // An equivalent closer than half the smallest operator angle is the
+  // closest one
+  exit_cos_ = cos(min_angle / 4.0);
+
+  // Pad with the first operator, which does not change the maximum
+  while (sw_.size() % 4 != 0) {
+    sw_.push_back(sw_[0]);
+    sx_.push_back(sx_[0]);
+    sy_.push_back(sy_[0]);
+    sz_.push_back(sz_[0]);
   }
 }
 
@@ -188,6 +238,8 @@ Orientation SymmetryGroup::misorientation(const Orientation & a,
   for (auto misop : misops_) {
     Orientation trial = misop * ab;
     trial.to_axis_angle(cn, ca);
+    // q and -q are the same rotation
+    ca = std::min(ca, 2 * M_PI - ca);
     if (ca < angle_best) {
       angle_best = ca;
       best = trial;
@@ -230,7 +282,7 @@ std::vector<Orientation> SymmetryGroup::misorientation_block(
     double best_angle = 3 * M_PI;
     size_t bi = -1;
     for (size_t j = 0; j < S; j++) {
-      double f = std::max(-1.0,std::min(1.0,R[CINDEX((j*4),i,N)])); // need to check to prevent precision error and lie between [-1,1]
+      double f = std::min(1.0,fabs(R[CINDEX((j*4),i,N)])); // need to check to prevent precision error, and q and -q are the same rotation
       double ang = 2.0 * acos(f);
       if (ang < best_angle) {
         best_angle = ang;
@@ -245,11 +297,72 @@ std::vector<Orientation> SymmetryGroup::misorientation_block(
   return res;
 }
 
+void SymmetryGroup::disorientation_angles(const double * const A, size_t n,
+                                          const double * const B, size_t m,
+                                          double * const angles,
+                                          int nthreads) const
+{
+#ifdef USE_OMP
+  omp_set_num_threads(nthreads);
+#pragma omp parallel for
+#endif
+  for (size_t i = 0; i < n; i++) {
+    for (size_t j = 0; j < m; j++) {
+      angles[i*m+j] = disorientation_angle_(&A[4*i], &B[4*j]);
+    }
+  }
+}
+
+void SymmetryGroup::disorientation_angles_paired(const double * const A,
+                                                 const double * const B,
+                                                 size_t n,
+                                                 double * const angles,
+                                                 int nthreads) const
+{
+#ifdef USE_OMP
+  omp_set_num_threads(nthreads);
+#pragma omp parallel for
+#endif
+  for (size_t i = 0; i < n; i++) {
+    angles[i] = disorientation_angle_(&A[4*i], &B[4*i]);
+  }
+}
+
+double SymmetryGroup::disorientation_angle_(const double * const a,
+                                            const double * const b) const
+{
+  // x = a * b^-1
+  double x0 = a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3];
+  double x1 = -a[0]*b[1] + a[1]*b[0] - a[2]*b[3] + a[3]*b[2];
+  double x2 = -a[0]*b[2] + a[2]*b[0] - a[3]*b[1] + a[1]*b[3];
+  double x3 = -a[0]*b[3] + a[3]*b[0] - a[1]*b[2] + a[2]*b[1];
+
+  // Already inside the fundamental zone
+  double best = fabs(x0);
+  if (best < exit_cos_) {
+    // Scalar part of op * x for every operator
+    const double * const sw = &sw_[0];
+    const double * const sx = &sx_[0];
+    const double * const sy = &sy_[0];
+    const double * const sz = &sz_[0];
+    size_t nops = sw_.size();
+#ifdef USE_OMP
+#pragma omp simd reduction(max:best)
+#endif
+    for (size_t k = 0; k < nops; k++) {
+      double c = fabs(sw[k]*x0 - sx[k]*x1 - sy[k]*x2 - sz[k]*x3);
+      best = c > best ? c : best;
+    }
+  }
+
+  return 2.0 * acos(std::min(best, 1.0));
+}
+
 Lattice::Lattice(Vector a1, Vector a2, Vector a3,
                  std::shared_ptr<SymmetryGroup> symmetry,
                  list_systems isystems) :
     a1_(a1), a2_(a2), a3_(a3), symmetry_(symmetry), offsets_({0}),
-    setup_(false)
+    frozen_(false)
 {
   make_reciprocal_lattice_();
 
@@ -323,6 +436,11 @@ std::vector<Vector> Lattice::equivalent_vectors_bidirectional(Vector v)
 
 void Lattice::add_slip_system(std::vector<int> d, std::vector<int> p)
 {
+  if (frozen_) {
+    throw std::runtime_error("This lattice may be shared by other objects, "
+                             "give its slip systems in slip_systems instead");
+  }
+
   std::vector<Vector> burgers, directions, normals;
 
   std::vector<Vector> pbs = equivalent_vectors_bidirectional(
@@ -348,6 +466,13 @@ void Lattice::add_slip_system(std::vector<int> d, std::vector<int> p)
     slip_directions_.push_back(directions);
     slip_planes_.push_back(normals);
     offsets_.push_back(offsets_.back() + burgers.size());
+    for (size_t i = 0; i < burgers.size(); i++) {
+      Symmetric M(outer(directions[i], normals[i]));
+      Skew N(outer(directions[i], normals[i]));
+      schmid_.insert(schmid_.end(), M.data(), M.data() + 6);
+      skew_.insert(skew_.end(), N.data(), N.data() + 3);
+    }
+    cache_.reset();
   }
 }
 
@@ -366,30 +491,55 @@ size_t Lattice::flat(size_t g, size_t i) const
   return offsets_[g] + i;
 }
 
-const Symmetric & Lattice::M(size_t g, size_t i, const Orientation & Q)
+size_t Lattice::ntotal() const
 {
-  cache_rot_(Q);
-  return Ms_[g][i];
+  return offsets_.back();
 }
 
-const Skew & Lattice::N(size_t g, size_t i, const Orientation & Q)
+const Symmetric & Lattice::M(size_t g, size_t i, const Orientation & Q) const
 {
-  cache_rot_(Q);
-  return Ns_[g][i];
+  return cache_rot_(Q).Ms[g][i];
 }
 
-double Lattice::shear(size_t g, size_t i, const Orientation & Q,
-                      const Symmetric & stress)
+const Skew & Lattice::N(size_t g, size_t i, const Orientation & Q) const
 {
-  return M(g,i,Q).contract(stress);
+  return cache_rot_(Q).Ns[g][i];
+}
+
+double Lattice::shear(size_t g, size_t i, const Orientation & Q,
+                      const Symmetric & stress) const
+{
+  // The slip rules ask for one system at a time, but all the shears for
+  // a stress cost about as much as one once the stress is rotated
+  RotationCache & c = cache_rot_(Q);
+  if (!c.resolved || !std::equal(c.stress, c.stress + 6, stress.data())) {
+    std::copy(stress.data(), stress.data() + 6, c.stress);
+    c.tau.resize(ntotal());
+    resolve_(c, stress.data(), c.tau.data());
+    c.resolved = true;
+  }
+  return c.tau[flat(g,i)];
 }
 
 Symmetric Lattice::d_shear(size_t g, size_t i, const Orientation & Q,
-                           const Symmetric & stress)
+                           const Symmetric & stress) const
 {
   return M(g, i, Q);
 }
 
+void Lattice::shears(const Orientation & Q, const Symmetric & stress,
+                     double * const tau) const
+{
+  resolve_(cache_rot_(Q), stress.data(), tau);
+}
+
+void Lattice::d_shears(const Orientation & Q, const Symmetric & stress,
+                       double * const dtau) const
+{
+  // The rotated Schmid tensors, S R^T for the whole table
+  mat_mat_ABT(ntotal(), 6, 6, schmid_.data(), cache_rot_(Q).R, dtau);
+}
+
 const std::shared_ptr<SymmetryGroup> Lattice::symmetry()
 {
   return symmetry_;
@@ -409,25 +559,53 @@ void Lattice::assert_miller_(std::vector<int> m)
   }
 }
 
-void Lattice::cache_rot_(const Orientation & Q)
+Lattice::RotationCache & Lattice::cache_rot_(const Orientation & Q) const
 {
-  if (setup_ and (hash_ == Q.hash())) return;
+  RotationCache & c = cache_.local();
+  if (c.setup and (c.hash == Q.hash())) return c;
+
+  c.setup = true;
+  c.hash = Q.hash();
+  c.resolved = false;
 
-  setup_ = true;
-  hash_ = Q.hash();
+  // Rotate all the systems at once, as products with the 6x6 Mandel
+  // rotation and the 3x3 rotation of the skew components
+  Q.to_symmetric_rotation(c.R);
+  double W[9];
+  for (size_t j = 0; j < 3; j++) {
+    Skew e;
+    e.s()[j] = 1.0;
+    Skew r = Q.apply(e);
+    for (size_t k = 0; k < 3; k++) W[k*3+j] = r.data()[k];
+  }
 
-  Ms_.resize(ngroup());
-  Ns_.resize(ngroup());
+  size_t nt = ntotal();
+  std::vector<double> Ms(nt*6), Ns(nt*3);
+  mat_mat_ABT(nt, 6, 6, schmid_.data(), c.R, Ms.data());
+  mat_mat_ABT(nt, 3, 3, skew_.data(), W, Ns.data());
+
+  c.Ms.resize(ngroup());
+  c.Ns.resize(ngroup());
   for (size_t g = 0; g < ngroup(); g++) {
-    Ms_[g].resize(nslip(g));
-    Ns_[g].resize(nslip(g));
+    c.Ms[g].resize(nslip(g));
+    c.Ns[g].resize(nslip(g));
     for (size_t i = 0; i < nslip(g); i++) {
-      Ms_[g][i] = Q.apply(Symmetric(outer(slip_directions_[g][i],
-                                          slip_planes_[g][i])));
-      Ns_[g][i] = Q.apply(Skew(outer(slip_directions_[g][i],
-                                     slip_planes_[g][i])));
+      size_t k = flat(g, i);
+      std::copy(&Ms[k*6], &Ms[k*6] + 6, c.Ms[g][i].s());
+      std::copy(&Ns[k*3], &Ns[k*3] + 3, c.Ns[g][i].s());
     }
   }
+
+  return c;
+}
+
+void Lattice::resolve_(const RotationCache & c, const double * const stress,
+                       double * const tau) const
+{
+  // Stress in the crystal frame, R^T s, then all the shears S s_c
+  double sc[6];
+  mat_vec_trans(c.R, 6, stress, 6, sc);
+  mat_vec(schmid_.data(), ntotal(), sc, 6, tau);
 }
 
 CubicLattice::CubicLattice(double a,
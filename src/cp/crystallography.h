@@ -2,6 +2,7 @@
 #define CRYSTALLOGRAPHY_H
 
 #include "../objects.h"
+#include "../perthread.h"
 
 #include "../math/rotations.h"
 #include "../math/tensors.h"
@@ -33,6 +34,9 @@ class NEML_EXPORT SymmetryGroup: public NEMLObject {
   /// Quaternion symmetry operators
   const std::vector<Orientation> & ops() const;
 
+  /// Identical symmetry groups from the Factory are shared
+  static bool interned() {return true;};
+
   /// Number of symmetry operators
   size_t nops() const;
 
@@ -42,9 +46,32 @@ class NEML_EXPORT SymmetryGroup: public NEMLObject {
   /// Find the disorientation in a blocked way that trades memory for cpu
   std::vector<Orientation> misorientation_block(const std::vector<Orientation> & A, const std::vector<Orientation> & B);
 
+  /// Disorientation angles between every row of A (n) and of B (m)
+  //  A and B are packed [w,x,y,z] quaternions and angles is n x m.
+  //  The angle is that of misorientation(a,b), found without forming
+  //  any Orientation objects.
+  void disorientation_angles(const double * const A, size_t n,
+                             const double * const B, size_t m,
+                             double * const angles, int nthreads = 1) const;
+
+  /// Disorientation angles between the pairs A[i], B[i]
+  void disorientation_angles_paired(const double * const A,
+                                    const double * const B, size_t n,
+                                    double * const angles,
+                                    int nthreads = 1) const;
+
+ private:
+  double disorientation_angle_(const double * const a,
+                               const double * const b) const;
+
  private:
   const std::vector<Orientation> ops_;
   std::vector<Orientation> misops_;
+
+  // Distinct misops, split into components and padded for vectorization
+  std::vector<double> sw_, sx_, sy_, sz_;
+  // Half angle cosine past which no other operator can be closer
+  double exit_cos_;
 };
 
 static Register<SymmetryGroup> regSymmetryGroup;
@@ -97,29 +124,65 @@ class NEML_EXPORT Lattice: public NEMLObject {
   size_t nslip(size_t g) const;
   /// Flat index of slip group g, system i
   size_t flat(size_t g, size_t i) const;
+  /// Total number of slip systems
+  size_t ntotal() const;
 
   /// Return the sym(d x n) tensor for group g, system i, rotated with Q
-  const Symmetric & M(size_t g, size_t i, const Orientation & Q);
+  const Symmetric & M(size_t g, size_t i, const Orientation & Q) const;
   /// Return the skew(d x n) tensor for group g, system i, rotated with Q
-  const Skew & N(size_t g, size_t i, const Orientation & Q);
+  const Skew & N(size_t g, size_t i, const Orientation & Q) const;
 
   /// Calculate the resolved shear stress on group g, system i, rotated with Q
   /// given the stress
   double shear(size_t g, size_t i, const Orientation & Q, const Symmetric &
-               stress);
+               stress) const;
   /// Calculate the derivative of the resolved shear stress on group g,
   /// system i, rotated with Q, given the stress
   Symmetric d_shear(size_t g, size_t i, const Orientation & Q, const Symmetric &
-                    stress);
+                    stress) const;
+
+  /// Resolved shear stresses on all the systems, in flat order
+  //  The stress is rotated once into the crystal frame and multiplied by
+  //  the fixed (ntotal,6) table of crystal frame Schmid tensors.  shear
+  //  uses the same product, cached for the last stress a thread asked for.
+  void shears(const Orientation & Q, const Symmetric & stress,
+              double * const tau) const;
+  /// Derivatives of all the resolved shears with respect to the stress,
+  /// as a flat (ntotal,6) array
+  void d_shears(const Orientation & Q, const Symmetric & stress,
+                double * const dtau) const;
 
   /// Access the symmetry operations
   const std::shared_ptr<SymmetryGroup> symmetry();
 
+  /// Identical lattices from the Factory are shared
+  static bool interned() {return true;};
+  /// Lattices from the Factory take all their systems in the constructor,
+  /// add_slip_system throws afterwards
+  virtual void freeze() {frozen_ = true;};
+  /// Whether add_slip_system is closed
+  bool frozen() const {return frozen_;};
+
  private:
   void make_reciprocal_lattice_();
   static void assert_miller_(std::vector<int> m);
 
-  void cache_rot_(const Orientation & Q);
+  /// Slip system tensors rotated with the last orientation a thread used
+  struct RotationCache {
+    bool setup = false;
+    size_t hash = 0;
+    double R[36];
+    std::vector<std::vector<Symmetric>> Ms;
+    std::vector<std::vector<Skew>> Ns;
+    // Resolved shears for the last stress
+    bool resolved = false;
+    double stress[6];
+    std::vector<double> tau;
+  };
+
+  RotationCache & cache_rot_(const Orientation & Q) const;
+  void resolve_(const RotationCache & c, const double * const stress,
+                double * const tau) const;
 
  private:
   Vector a1_, a2_, a3_, b1_, b2_, b3_;
@@ -131,11 +194,15 @@ class NEML_EXPORT Lattice: public NEMLObject {
 
   std::vector<size_t> offsets_;
 
-  // Used for caching common asks
-  bool setup_;
-  size_t hash_;
-  std::vector<std::vector<Symmetric>> Ms_;
-  std::vector<std::vector<Skew>> Ns_;
+  // Crystal frame sym(d x n) as (ntotal,6) and skew(d x n) as (ntotal,3)
+  std::vector<double> schmid_;
+  std::vector<double> skew_;
+
+  // Used for caching common asks, kept per thread so that one lattice can
+  // be shared by updates running in parallel
+  mutable PerThread<RotationCache> cache_;
+
+  bool frozen_;
 };
 
 class NEML_EXPORT CubicLattice: public Lattice {
@@ -24,6 +24,43 @@ PYBIND11_MODULE(crystallography, m) {
       .def_property_readonly("ops", &SymmetryGroup::ops)
       .def("misorientation", &SymmetryGroup::misorientation)
       .def("misorientation_block", &SymmetryGroup::misorientation_block)
+      .def("disorientation_angles",
+           [](SymmetryGroup & m, py::array_t<double, py::array::c_style> A,
+              py::array_t<double, py::array::c_style> B,
+              int nthreads) -> py::array_t<double>
+           {
+            if ((A.request().ndim != 2) || (A.request().shape[1] != 4) ||
+                (B.request().ndim != 2) || (B.request().shape[1] != 4)) {
+              throw std::runtime_error("Quaternion arrays must have shape (n,4)");
+            }
+            size_t n = A.request().shape[0];
+            size_t k = B.request().shape[0];
+            auto angles = alloc_mat<double>(n, k);
+            m.disorientation_angles(arr2ptr<double>(A), n, arr2ptr<double>(B),
+                                    k, arr2ptr<double>(angles), nthreads);
+            return angles;
+           }, "Disorientation angles between all pairs of quaternions",
+           py::arg("A"), py::arg("B"), py::arg("nthreads") = 1)
+      .def("disorientation_angles_paired",
+           [](SymmetryGroup & m, py::array_t<double, py::array::c_style> A,
+              py::array_t<double, py::array::c_style> B,
+              int nthreads) -> py::array_t<double>
+           {
+            if ((A.request().ndim != 2) || (A.request().shape[1] != 4) ||
+                (B.request().ndim != 2) || (B.request().shape[1] != 4)) {
+              throw std::runtime_error("Quaternion arrays must have shape (n,4)");
+            }
+            size_t n = A.request().shape[0];
+            if (B.request().shape[0] != (py::ssize_t) n) {
+              throw std::runtime_error("Quaternion arrays must have the same length");
+            }
+            auto angles = alloc_vec<double>(n);
+            m.disorientation_angles_paired(arr2ptr<double>(A),
+                                           arr2ptr<double>(B), n,
+                                           arr2ptr<double>(angles), nthreads);
+            return angles;
+           }, "Disorientation angles between pairs of quaternions",
+           py::arg("A"), py::arg("B"), py::arg("nthreads") = 1)
       ;
 
   py::class_<Lattice, NEMLObject, std::shared_ptr<Lattice>>(m, "Lattice")
@@ -48,12 +85,31 @@ PYBIND11_MODULE(crystallography, m) {
       .def("equivalent_vectors_bidirectional", &Lattice::equivalent_vectors_bidirectional)
 
       .def("add_slip_system", &Lattice::add_slip_system)
+      .def_property_readonly("frozen", &Lattice::frozen)
       .def_property_readonly("ngroup", &Lattice::ngroup)
       .def("nslip", &Lattice::nslip)
       .def("M", &Lattice::M)
       .def("N", &Lattice::N)
       .def("shear", &Lattice::shear)
       .def("d_shear", &Lattice::d_shear)
+      .def_property_readonly("ntotal", &Lattice::ntotal)
+      .def("flat", &Lattice::flat)
+      .def("shears",
+           [](const Lattice & me, const Orientation & Q,
+              const Symmetric & stress) -> py::array_t<double>
+           {
+            auto tau = alloc_vec<double>(me.ntotal());
+            me.shears(Q, stress, arr2ptr<double>(tau));
+            return tau;
+           }, "Resolved shears on all the systems, in flat order")
+      .def("d_shears",
+           [](const Lattice & me, const Orientation & Q,
+              const Symmetric & stress) -> py::array_t<double>
+           {
+            auto dtau = alloc_mat<double>(me.ntotal(), 6);
+            me.d_shears(Q, stress, arr2ptr<double>(dtau));
+            return dtau;
+           }, "Derivatives of all the resolved shears, as Mandel vectors")
       ;
 
   py::class_<CubicLattice, Lattice, std::shared_ptr<CubicLattice>>(m, "CubicLattice")
@@ -7,6 +7,11 @@ bool InelasticModel::use_nye() const
   return false;
 }
 
+bool InelasticModel::diagonal_history_jacobian() const
+{
+  return false;
+}
+
 NoInelasticity::NoInelasticity()
 {
 
@@ -129,6 +134,11 @@ History NoInelasticity::d_w_p_d_history(const Symmetric & stress,
   return History();
 }
 
+bool NoInelasticity::diagonal_history_jacobian() const
+{
+  return true;
+}
+
 AsaroInelasticity::AsaroInelasticity(std::shared_ptr<SlipRule> rule) :
     rule_(rule)
 {
@@ -319,6 +329,11 @@ bool AsaroInelasticity::use_nye() const
   return rule_->use_nye();
 }
 
+bool AsaroInelasticity::diagonal_history_jacobian() const
+{
+  return rule_->diagonal_history_jacobian();
+}
+
 PowerLawInelasticity::PowerLawInelasticity(std::shared_ptr<Interpolate> A, 
                    std::shared_ptr<Interpolate> n) :
     A_(A), n_(n)
@@ -470,6 +485,11 @@ History PowerLawInelasticity::d_w_p_d_history(const Symmetric & stress,
   return History();
 }
 
+bool PowerLawInelasticity::diagonal_history_jacobian() const
+{
+  return true;
+}
+
 double PowerLawInelasticity::seq_(const Symmetric & stress) const
 {
   return sqrt(3.0/2.0) * stress.dev().norm();
@@ -660,4 +680,12 @@ bool CombinedInelasticity::use_nye() const
   return false;
 }
 
+bool CombinedInelasticity::diagonal_history_jacobian() const
+{
+  for (auto model : models_) {
+    if (not model->diagonal_history_jacobian()) return false;
+  }
+  return true;
+}
+
 } // namespace neml
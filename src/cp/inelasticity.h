@@ -83,6 +83,9 @@ class NEML_EXPORT InelasticModel: public NEMLObject {
 
   /// Whether this model uses the nye tensor
   virtual bool use_nye() const;
+
+  /// Whether the history/history block of the Jacobian is diagonal
+  virtual bool diagonal_history_jacobian() const;
 };
 
 /// This model returns zero for the plastic deformation, resulting model
@@ -164,6 +167,9 @@ class NEML_EXPORT NoInelasticity: public InelasticModel {
                                   const History & history,
                                   Lattice & lattice,
                                   double T, const History & fixed) const;
+
+  /// No history, so trivially diagonal
+  virtual bool diagonal_history_jacobian() const;
 };
 
 static Register<NoInelasticity> regNoInelasticity;
@@ -253,6 +259,9 @@ class NEML_EXPORT AsaroInelasticity: public InelasticModel {
   /// Whether this model uses the Nye tensor
   virtual bool use_nye() const;
 
+  /// Defer to the slip rule
+  virtual bool diagonal_history_jacobian() const;
+
  private:
   std::shared_ptr<SlipRule> rule_;
 };
@@ -344,6 +353,9 @@ class NEML_EXPORT PowerLawInelasticity: public InelasticModel {
                                   double T,
                                   const History & fixed) const;
 
+  /// No history, so trivially diagonal
+  virtual bool diagonal_history_jacobian() const;
+
  private:
   double seq_(const Symmetric & stress) const;
 
@@ -441,6 +453,9 @@ class NEML_EXPORT CombinedInelasticity: public InelasticModel {
   /// Whether this model uses the Nye tensor
   virtual bool use_nye() const;
 
+  /// Diagonal only if each of the individual models is diagonal
+  virtual bool diagonal_history_jacobian() const;
+
  private:
   std::vector<std::shared_ptr<InelasticModel>> models_;
 };
@@ -26,6 +26,7 @@ PYBIND11_MODULE(inelasticity, m) {
       .def("d_w_p_d_stress", &InelasticModel::d_w_p_d_stress)
       .def("d_w_p_d_history", &InelasticModel::d_w_p_d_history)
       .def_property_readonly("use_nye", &InelasticModel::use_nye)
+      .def_property_readonly("diagonal_history_jacobian", &InelasticModel::diagonal_history_jacobian)
       ;
 
   py::class_<NoInelasticity, InelasticModel, std::shared_ptr<NoInelasticity>>(m,
@@ -43,6 +43,11 @@ bool KinematicModel::use_nye() const
   return false;
 }
 
+bool KinematicModel::diagonal_history_jacobian() const
+{
+  return false;
+}
+
 StandardKinematicModel::StandardKinematicModel(
     std::shared_ptr<LinearElasticModel> emodel,
     std::shared_ptr<InelasticModel> imodel) :
@@ -275,4 +280,9 @@ bool StandardKinematicModel::use_nye() const
   return imodel_->use_nye();
 }
 
+bool StandardKinematicModel::diagonal_history_jacobian() const
+{
+  return imodel_->diagonal_history_jacobian();
+}
+
 } // namespace neml
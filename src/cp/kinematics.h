@@ -142,6 +142,9 @@ class NEML_EXPORT KinematicModel: public NEMLObject {
 
   /// Whether this model uses the Nye tensor
   virtual bool use_nye() const;
+
+  /// Whether the history/history block of the Jacobian is diagonal
+  virtual bool diagonal_history_jacobian() const;
 };
 
 /// My standard kinematic assumptions, outlined in the manual
@@ -263,6 +266,9 @@ class NEML_EXPORT StandardKinematicModel: public KinematicModel {
   /// Whether this model uses the Nye tensor
   virtual bool use_nye() const;
 
+  /// Defer to the inelastic model
+  virtual bool diagonal_history_jacobian() const;
+
  private:
   std::shared_ptr<LinearElasticModel> emodel_;
   std::shared_ptr<InelasticModel> imodel_;
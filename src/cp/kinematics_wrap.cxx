@@ -43,6 +43,7 @@ PYBIND11_MODULE(kinematics, m) {
       .def("elastic_strains", &KinematicModel::elastic_strains)
 
       .def_property_readonly("use_nye", &KinematicModel::use_nye)
+      .def_property_readonly("diagonal_history_jacobian", &KinematicModel::diagonal_history_jacobian)
       ;
 
   py::class_<StandardKinematicModel, KinematicModel, std::shared_ptr<StandardKinematicModel>>(m, "StandardKinematicModel")
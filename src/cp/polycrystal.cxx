@@ -1,15 +1,45 @@
 #include "polycrystal.h"
 
-#include "batch.h"
+#include "../math/nemlmath.h"
+#include "../trace.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 
 namespace neml {
 
 PolycrystalModel::PolycrystalModel(std::shared_ptr<SingleCrystalModel> model,
                                    std::vector<std::shared_ptr<Orientation>> qs,
-                                   int nthreads) :
-    model_(model), q0s_(qs), nthreads_(nthreads)
+                                   int nthreads,
+                                   std::vector<double> weights) :
+    PolycrystalModel(model, OrientationArray(qs), nthreads, weights)
+{
+
+}
+
+PolycrystalModel::PolycrystalModel(std::shared_ptr<SingleCrystalModel> model,
+                                   OrientationArray qs,
+                                   int nthreads,
+                                   std::vector<double> weights) :
+    model_(model), q0s_(std::move(qs)), nthreads_(nthreads), weights_(weights),
+    executor_(std::make_shared<OpenMPExecutor>(nthreads))
 {
+  if (weights_.size() == 0) {
+    weights_.assign(n(), 1.0 / n());
+    return;
+  }
 
+  if (weights_.size() != n()) {
+    throw std::invalid_argument("Need one weight for each orientation");
+  }
+  double total = 0.0;
+  for (auto w : weights_) {
+    if (w < 0.0) throw std::invalid_argument("Weights must be positive");
+    total += w;
+  }
+  if (total <= 0.0) throw std::invalid_argument("Weights must be positive");
+  for (auto & w : weights_) w /= total;
 }
 
 size_t PolycrystalModel::n() const
@@ -17,6 +47,16 @@ size_t PolycrystalModel::n() const
   return q0s_.size();
 }
 
+const OrientationArray & PolycrystalModel::initial_orientations() const
+{
+  return q0s_;
+}
+
+double PolycrystalModel::weight(size_t i) const
+{
+  return weights_[i];
+}
+
 size_t PolycrystalModel::nhist() const
 {
   return (model_->nstore() + 6 + 6 + 3) * n();
@@ -24,14 +64,19 @@ size_t PolycrystalModel::nhist() const
 
 int PolycrystalModel::init_hist(double * const hist) const
 {
-  for (size_t i = 0; i < n(); i++) {
-    model_->init_store(history(hist, i));
-    model_->set_active_orientation(history(hist,i), *q0s_[i]);
-
-    std::fill(stress(hist, i), stress(hist, i) + 6, 0);
-    std::fill(d(hist, i), d(hist, i) + 6, 0);
-    std::fill(w(hist, i), w(hist, i) + 3, 0);
-  }
+  // Each block first touches the grains it later updates
+  executor_->run([&](size_t b)
+  {
+    size_t begin, end;
+    block_range(b, executor_->nblocks(), n(), begin, end);
+    for (size_t i = begin; i < end; i++) {
+      model_->init_instance(history(hist, i), q0s_.get(i));
+
+      std::fill(stress(hist, i), stress(hist, i) + 6, 0);
+      std::fill(d(hist, i), d(hist, i) + 6, 0);
+      std::fill(w(hist, i), w(hist, i) + 3, 0);
+    }
+  });
 
   return 0;
 }
@@ -76,6 +121,58 @@ const double * PolycrystalModel::w(const double * const store, size_t i) const
   return &(store[n()*(model_->nstore() + 6 + 6) + i * 3]); 
 }
 
+void PolycrystalModel::set_executor(std::shared_ptr<BatchExecutor> executor)
+{
+  executor_ = executor;
+}
+
+size_t PolycrystalModel::nstore() const
+{
+  return nhist();
+}
+
+int PolycrystalModel::init_store(double * const store) const
+{
+  return init_hist(store);
+}
+
+double PolycrystalModel::alpha(double T) const
+{
+  return model_->alpha(T);
+}
+
+int PolycrystalModel::elastic_strains(const double * const s_np1,
+                                      double T_np1,
+                                      const double * const h_np1,
+                                      double * const e_np1) const
+{
+  std::fill(e_np1, e_np1+6, 0.0);
+  double e_local[6];
+  
+  for (size_t i = 0; i < n(); i++) {
+    model_->elastic_strains(stress(h_np1, i), T_np1, history(h_np1, i),
+                            e_local);
+    for (size_t j = 0; j < 6; j++) e_np1[j] += weight(i) * e_local[j];
+  }
+
+  return 0;
+}
+
+void PolycrystalModel::collect_solver_stats(bool on)
+{
+  model_->collect_solver_stats(on);
+}
+
+SolverStats PolycrystalModel::solver_stats() const
+{
+  return model_->solver_stats();
+}
+
+void PolycrystalModel::reset_solver_stats()
+{
+  model_->reset_solver_stats();
+}
+
 std::vector<Orientation> PolycrystalModel::orientations(double * const store) const
 {
   std::vector<Orientation> res;
@@ -87,8 +184,18 @@ std::vector<Orientation> PolycrystalModel::orientations(double * const store) co
 
 TaylorModel::TaylorModel(std::shared_ptr<SingleCrystalModel> model,
                          std::vector<std::shared_ptr<Orientation>> qs,
-                         int nthreads) :
-    PolycrystalModel(model, qs, nthreads)
+                         int nthreads,
+                         std::vector<double> weights) :
+    PolycrystalModel(model, qs, nthreads, weights)
+{
+
+}
+
+TaylorModel::TaylorModel(std::shared_ptr<SingleCrystalModel> model,
+                         OrientationArray qs,
+                         int nthreads,
+                         std::vector<double> weights) :
+    PolycrystalModel(model, std::move(qs), nthreads, weights)
 {
 
 }
@@ -105,6 +212,8 @@ ParameterSet TaylorModel::parameters()
   pset.add_parameter<NEMLObject>("model");
   pset.add_parameter<std::vector<NEMLObject>>("qs");
   pset.add_optional_parameter<int>("nthreads", 1);
+  pset.add_optional_parameter<std::vector<double>>("weights",
+                                                   std::vector<double>());
 
   return pset;
 }
@@ -114,17 +223,8 @@ std::unique_ptr<NEMLObject> TaylorModel::initialize(ParameterSet & params)
   return neml::make_unique<TaylorModel>(
       params.get_object_parameter<SingleCrystalModel>("model"),
       params.get_object_parameter_vector<Orientation>("qs"),
-      params.get_parameter<int>("nthreads"));
-}
-
-size_t TaylorModel::nstore() const
-{
-  return nhist();
-}
-
-int TaylorModel::init_store(double * const store) const
-{
-  return init_hist(store);
+      params.get_parameter<int>("nthreads"),
+      params.get_parameter<std::vector<double>>("weights"));
 }
 
 int TaylorModel::update_ld_inc(
@@ -136,94 +236,531 @@ int TaylorModel::update_ld_inc(
    double * const h_np1, const double * const h_n,
    double * const A_np1, double * const B_np1,
    double & u_np1, double u_n,
-   double & p_np1, double p_n)
+   double & p_np1, double p_n) const
 {
+  NEML_TRACE_SCOPE("update_ld_inc");
   std::fill(s_np1, s_np1+6, 0);
   std::fill(A_np1, A_np1+36, 0);
   std::fill(B_np1, B_np1+18, 0);
   u_np1 = 0;
   p_np1 = 0;
 
-  double * A_local = new double[36*n()];
-  double * B_local = new double[18*n()];
-  double * u_local = new double[n()];
-  double * p_local = new double[n()];
-
-  double * zero = new double[n()];
-  std::fill(zero, zero+n(), 0.0);
-
-  double * Ts_np1 = new double[n()];
-  std::fill(Ts_np1, Ts_np1+n(), T_np1);
-  double * Ts_n = new double[n()];
-  std::fill(Ts_n, Ts_n+n(), T_n);
+  std::vector<double> A_local(36*n());
+  std::vector<double> B_local(18*n());
+  std::vector<double> u_local(n());
+  std::vector<double> p_local(n());
+
+  size_t nb = executor_->nblocks();
+  std::vector<int> ier(nb, 0);
+
+  executor_->run([&](size_t b)
+  {
+    size_t begin, end;
+    block_range(b, nb, n(), begin, end);
+    for (size_t i = begin; i < end; i++) {
+      std::copy(d_np1, d_np1+6, d(h_np1, i));
+      std::copy(w_np1, w_np1+3, w(h_np1, i));
+      int ierr = model_->update_ld_inc(d(h_np1, i), d(h_n, i),
+                                       w(h_np1, i), w(h_n, i),
+                                       T_np1, T_n, t_np1, t_n,
+                                       stress(h_np1, i), stress(h_n, i),
+                                       history(h_np1, i), history(h_n, i),
+                                       &A_local[i*36], &B_local[i*18],
+                                       u_local[i], 0.0, p_local[i], 0.0);
+      if ((ierr != 0) and (ier[b] == 0)) ier[b] = ierr;
+    }
+  });
 
   for (size_t i = 0; i < n(); i++) {
-    std::copy(d_np1, d_np1+6, d(h_np1, i));
-    std::copy(w_np1, w_np1+3, w(h_np1, i));
+    double wi = weight(i);
+    for (size_t j = 0; j < 6; j++) s_np1[j] += wi * stress(h_np1, i)[j];
+    for (size_t j = 0; j < 36; j++) A_np1[j] += wi * A_local[i*36+j];
+    for (size_t j = 0; j < 18; j++) B_np1[j] += wi * B_local[i*18+j];
+    u_np1 += wi * u_local[i];
+    p_np1 += wi * p_local[i];
   }
 
-  int ier = evaluate_crystal_batch(*model_, n(), 
-                         d(h_np1, 0), d(h_n, 0),
-                         w(h_np1, 0), w(h_n, 0),
-                         Ts_np1, Ts_n,
-                         t_np1, t_n,
-                         stress(h_np1, 0), stress(h_n, 0),
-                         history(h_np1, 0), history(h_n, 0),
-                         A_local, B_local,
-                         u_local, zero,
-                         p_local, zero, nthreads_);
-  
-  delete [] zero;
-  delete [] Ts_np1;
-  delete [] Ts_n;
-                         
-  for (size_t i = 0; i < n(); i++) {
-    for (size_t j = 0; j < 6; j++) s_np1[j] += stress(h_np1, i)[j];
-    for (size_t j = 0; j < 36; j++) A_np1[j] += A_local[i*36+j];
-    for (size_t j = 0; j < 18; j++) B_np1[j] += B_local[i*18+j];
-    u_np1 += u_local[i];
-    p_np1 += p_local[i];
+  u_np1 += u_n;
+  p_np1 += p_n;
+
+  for (auto e : ier) {
+    if (e != 0) return e;
   }
 
-  delete [] A_local;
-  delete [] B_local;
-  delete [] u_local;
-  delete [] p_local;
+  return 0;
+}
+
+
+/// Maximum number of step halvings in the interaction Newton iteration
+static const int max_backtrack = 8;
 
-  for (size_t j = 0; j < 6; j++) s_np1[j] /= n();
-  for (size_t j = 0; j < 36; j++) A_np1[j] /= n();
-  for (size_t j = 0; j < 18; j++) B_np1[j] /= n();
+InteractionPolycrystalModel::InteractionPolycrystalModel(
+    std::shared_ptr<SingleCrystalModel> model,
+    std::vector<std::shared_ptr<Orientation>> qs,
+    int nthreads, std::vector<double> weights,
+    double rtol, double atol, int miter) :
+      PolycrystalModel(model, qs, nthreads, weights), rtol_(rtol),
+      atol_(atol), miter_(miter)
+{
 
-  u_np1 /= n();
-  p_np1 /= n();
+}
+
+int InteractionPolycrystalModel::update_ld_inc(
+   const double * const d_np1, const double * const d_n,
+   const double * const w_np1, const double * const w_n,
+   double T_np1, double T_n,
+   double t_np1, double t_n,
+   double * const s_np1, const double * const s_n,
+   double * const h_np1, const double * const h_n,
+   double * const A_np1, double * const B_np1,
+   double & u_np1, double u_n,
+   double & p_np1, double p_n) const
+{
+  NEML_TRACE_SCOPE("update_ld_inc");
+  double de[6];
+  sub_vec(d_np1, d_n, 6, de);
+
+  // Start from the Taylor guess
+  std::vector<double> e(6*n());
+  for (size_t i = 0; i < n(); i++) std::copy(de, de+6, &e[6*i]);
+
+  std::vector<double> A_local(36*n());
+  std::vector<double> B_local(18*n());
+  std::vector<double> u_local(n());
+  std::vector<double> p_local(n());
+  std::vector<double> C(36*n());
+  std::vector<double> q(6*n());
+
+  size_t nb = executor_->nblocks();
+  std::vector<int> ier(nb, 0);
+
+  double Lstar[36];
+  double G[36];
+  double ds[6];
+
+  // Backtrack when a full Newton step increases the residual, which
+  // happens for strongly rate sensitive grains
+  std::vector<double> e_prev(e);
+  double err_prev = 0.0;
+  int nback = 0;
+
+  int iter;
+  for (iter = 0; iter < miter_; iter++) {
+    std::fill(ier.begin(), ier.end(), 0);
+    executor_->run([&](size_t b)
+    {
+      size_t begin, end;
+      block_range(b, nb, n(), begin, end);
+      for (size_t i = begin; i < end; i++) {
+        add_vec(d(h_n, i), &e[6*i], 6, d(h_np1, i));
+        std::copy(w_np1, w_np1+3, w(h_np1, i));
+        int ierr = model_->update_ld_inc(d(h_np1, i), d(h_n, i),
+                                         w(h_np1, i), w(h_n, i),
+                                         T_np1, T_n, t_np1, t_n,
+                                         stress(h_np1, i), stress(h_n, i),
+                                         history(h_np1, i), history(h_n, i),
+                                         &A_local[i*36], &B_local[i*18],
+                                         u_local[i], 0.0, p_local[i], 0.0);
+        if ((ierr != 0) and (ier[b] == 0)) ier[b] = ierr;
+      }
+    });
+    for (auto err : ier) {
+      if (err != 0) return err;
+    }
+
+    int ierr = constraint_(&A_local[0], Lstar, h_n, h_np1);
+    if (ierr != 0) return ierr;
+
+    // Grain compliances C_i = (A_i + L*)^-1 and the residuals of the
+    // interaction law without the common stress increment
+    std::fill(G, G+36, 0.0);
+    double rhs[6];
+    std::copy(de, de+6, rhs);
+    double scale = 0.0;
+    for (size_t i = 0; i < n(); i++) {
+      double * Ci = &C[36*i];
+      add_vec(&A_local[36*i], Lstar, 36, Ci);
+      ierr = invert_mat(Ci, 6);
+      if (ierr != 0) return ierr;
+
+      double ediff[6], Le[6], Cq[6];
+      sub_vec(&e[6*i], de, 6, ediff);
+      mat_vec(Lstar, 6, ediff, 6, Le);
+      sub_vec(stress(h_np1, i), stress(h_n, i), 6, &q[6*i]);
+      add_vec(&q[6*i], Le, 6, &q[6*i]);
+      mat_vec(Ci, 6, &q[6*i], 6, Cq);
+
+      for (size_t j = 0; j < 6; j++) {
+        rhs[j] += weight(i) * (Cq[j] - e[6*i+j]);
+      }
+      for (size_t j = 0; j < 36; j++) G[j] += weight(i) * Ci[j];
+      scale = std::max(scale, norm2_vec(stress(h_np1, i), 6));
+    }
+
+    // Common stress increment that keeps the average strain increment
+    double Ginv[36];
+    std::copy(G, G+36, Ginv);
+    ierr = invert_mat(Ginv, 6);
+    if (ierr != 0) return ierr;
+    mat_vec(Ginv, 6, rhs, 6, ds);
+
+    double err = 0.0;
+    for (size_t i = 0; i < n(); i++) {
+      double r[6];
+      sub_vec(ds, &q[6*i], 6, r);
+      err = std::max(err, norm2_vec(r, 6));
+    }
+    if (err <= rtol_ * scale + atol_) break;
+
+    if ((iter > 0) and (err > err_prev) and (nback < max_backtrack)) {
+      for (size_t j = 0; j < e.size(); j++) {
+        e[j] = 0.5 * (e[j] + e_prev[j]);
+      }
+      nback++;
+      continue;
+    }
+    nback = 0;
+    err_prev = err;
+    e_prev = e;
+
+    for (size_t i = 0; i < n(); i++) {
+      double r[6], dei[6];
+      sub_vec(ds, &q[6*i], 6, r);
+      mat_vec(&C[36*i], 6, r, 6, dei);
+      add_vec(&e[6*i], dei, 6, &e[6*i]);
+    }
+  }
+  if (iter == miter_) return MAX_ITERATIONS;
+
+  // Average the grains
+  std::fill(s_np1, s_np1+6, 0);
+  u_np1 = 0;
+  p_np1 = 0;
+  double AC[36], H[18], LCB[18];
+  std::fill(AC, AC+36, 0.0);
+  std::fill(H, H+18, 0.0);
+  std::fill(LCB, LCB+18, 0.0);
+  for (size_t i = 0; i < n(); i++) {
+    double wi = weight(i);
+    double ACi[36], CBi[18], LCBi[18];
+    mat_mat(6, 6, 6, &A_local[36*i], &C[36*i], ACi);
+    mat_mat(6, 3, 6, &C[36*i], &B_local[18*i], CBi);
+    mat_mat(6, 3, 6, Lstar, CBi, LCBi);
+    for (size_t j = 0; j < 6; j++) s_np1[j] += wi * stress(h_np1, i)[j];
+    for (size_t j = 0; j < 36; j++) AC[j] += wi * ACi[j];
+    for (size_t j = 0; j < 18; j++) H[j] += wi * CBi[j];
+    for (size_t j = 0; j < 18; j++) LCB[j] += wi * LCBi[j];
+    u_np1 += wi * u_local[i];
+    p_np1 += wi * p_local[i];
+  }
+
+  // A = <A_i C_i> <C_i>^-1,  B = A <C_i B_i> + <L* C_i B_i>
+  int ierr = invert_mat(G, 6);
+  if (ierr != 0) return ierr;
+  mat_mat(6, 6, 6, AC, G, A_np1);
+  mat_mat(6, 3, 6, A_np1, H, B_np1);
+  for (size_t j = 0; j < 18; j++) B_np1[j] += LCB[j];
 
   u_np1 += u_n;
   p_np1 += p_n;
 
-  return ier;
+  return 0;
 }
 
-double TaylorModel::alpha(double T) const
+SachsModel::SachsModel(std::shared_ptr<SingleCrystalModel> model,
+                       std::vector<std::shared_ptr<Orientation>> qs,
+                       int nthreads, std::vector<double> weights,
+                       double rtol, double atol, int miter) :
+    InteractionPolycrystalModel(model, qs, nthreads, weights, rtol, atol,
+                                miter)
 {
-  return model_->alpha(T);
+
 }
 
-int TaylorModel::elastic_strains(const double * const s_np1, 
-                                 double T_np1, const double * const h_np1, 
-                                 double * const e_np1) const
+std::string SachsModel::type()
 {
-  std::fill(e_np1, e_np1+6, 0.0);
-  double e_local[6];
-  
-  for (size_t i = 0; i < n(); i++) {
-    model_->elastic_strains(stress(h_np1, i), T_np1, history(h_np1, i),
-                            e_local);
-    for (size_t j = 0; j < n(); j++) e_np1[j] += e_local[j];
+  return "SachsModel";
+}
+
+ParameterSet SachsModel::parameters()
+{
+  ParameterSet pset(SachsModel::type());
+
+  pset.add_parameter<NEMLObject>("model");
+  pset.add_parameter<std::vector<NEMLObject>>("qs");
+  pset.add_optional_parameter<int>("nthreads", 1);
+  pset.add_optional_parameter<std::vector<double>>("weights",
+                                                   std::vector<double>());
+  pset.add_optional_parameter<double>("rtol", 1.0e-6);
+  pset.add_optional_parameter<double>("atol", 1.0e-8);
+  pset.add_optional_parameter<int>("miter", 30);
+
+  return pset;
+}
+
+std::unique_ptr<NEMLObject> SachsModel::initialize(ParameterSet & params)
+{
+  return neml::make_unique<SachsModel>(
+      params.get_object_parameter<SingleCrystalModel>("model"),
+      params.get_object_parameter_vector<Orientation>("qs"),
+      params.get_parameter<int>("nthreads"),
+      params.get_parameter<std::vector<double>>("weights"),
+      params.get_parameter<double>("rtol"),
+      params.get_parameter<double>("atol"),
+      params.get_parameter<int>("miter"));
+}
+
+int SachsModel::constraint_(const double * const A, double * const Lstar,
+                            const double * const h_n,
+                            double * const h_np1) const
+{
+  std::fill(Lstar, Lstar+36, 0.0);
+  return 0;
+}
+
+SelfConsistentModel::SelfConsistentModel(
+    std::shared_ptr<SingleCrystalModel> model,
+    std::vector<std::shared_ptr<Orientation>> qs,
+    int nthreads, std::vector<double> weights,
+    double rtol, double atol, int miter, int sc_miter) :
+      InteractionPolycrystalModel(model, qs, nthreads, weights, rtol, atol,
+                                  miter), sc_miter_(sc_miter)
+{
+
+}
+
+std::string SelfConsistentModel::type()
+{
+  return "SelfConsistentModel";
+}
+
+ParameterSet SelfConsistentModel::parameters()
+{
+  ParameterSet pset(SelfConsistentModel::type());
+
+  pset.add_parameter<NEMLObject>("model");
+  pset.add_parameter<std::vector<NEMLObject>>("qs");
+  pset.add_optional_parameter<int>("nthreads", 1);
+  pset.add_optional_parameter<std::vector<double>>("weights",
+                                                   std::vector<double>());
+  pset.add_optional_parameter<double>("rtol", 1.0e-6);
+  pset.add_optional_parameter<double>("atol", 1.0e-8);
+  pset.add_optional_parameter<int>("miter", 30);
+  pset.add_optional_parameter<int>("sc_miter", 50);
+
+  return pset;
+}
+
+std::unique_ptr<NEMLObject> SelfConsistentModel::initialize(
+    ParameterSet & params)
+{
+  return neml::make_unique<SelfConsistentModel>(
+      params.get_object_parameter<SingleCrystalModel>("model"),
+      params.get_object_parameter_vector<Orientation>("qs"),
+      params.get_parameter<int>("nthreads"),
+      params.get_parameter<std::vector<double>>("weights"),
+      params.get_parameter<double>("rtol"),
+      params.get_parameter<double>("atol"),
+      params.get_parameter<int>("miter"),
+      params.get_parameter<int>("sc_miter"));
+}
+
+size_t SelfConsistentModel::nhist() const
+{
+  // Plus the effective tangent from the last step
+  return PolycrystalModel::nhist() + 36;
+}
+
+int SelfConsistentModel::init_hist(double * const hist) const
+{
+  int ier = PolycrystalModel::init_hist(hist);
+  double * L = &hist[PolycrystalModel::nhist()];
+  std::fill(L, L+36, 0.0);
+  return ier;
+}
+
+int SelfConsistentModel::constraint_(const double * const A,
+                                     double * const Lstar,
+                                     const double * const h_n,
+                                     double * const h_np1) const
+{
+  // Start from the last step, or the Voigt average on the first
+  double L[36];
+  const double * L_n = &h_n[PolycrystalModel::nhist()];
+  if (norm2_vec(L_n, 36) > 0.0) {
+    std::copy(L_n, L_n+36, L);
+  }
+  else {
+    std::fill(L, L+36, 0.0);
+    for (size_t i = 0; i < n(); i++) {
+      for (size_t j = 0; j < 36; j++) L[j] += weight(i) * A[36*i+j];
+    }
   }
 
-  for (size_t j = 0; j < n(); j++) e_np1[j] /= n();
+  double P[36], Ci[36], G[36], AC[36], ACi[36], L_next[36];
+  int k;
+  for (k = 0; k < sc_miter_; k++) {
+    int ier = sphere_polarization(L, P);
+    if (ier != 0) return ier;
+    ier = invert_mat(P, 6);
+    if (ier != 0) return ier;
+    sub_vec(P, L, 36, Lstar);
+
+    std::fill(G, G+36, 0.0);
+    std::fill(AC, AC+36, 0.0);
+    for (size_t i = 0; i < n(); i++) {
+      add_vec(&A[36*i], Lstar, 36, Ci);
+      ier = invert_mat(Ci, 6);
+      if (ier != 0) return ier;
+      mat_mat(6, 6, 6, &A[36*i], Ci, ACi);
+      for (size_t j = 0; j < 36; j++) {
+        G[j] += weight(i) * Ci[j];
+        AC[j] += weight(i) * ACi[j];
+      }
+    }
+    ier = invert_mat(G, 6);
+    if (ier != 0) return ier;
+    mat_mat(6, 6, 6, AC, G, L_next);
+
+    double diff[36];
+    sub_vec(L_next, L, 36, diff);
+    std::copy(L_next, L_next+36, L);
+    if (norm2_vec(diff, 36) <= 1.0e-8 * norm2_vec(L, 36)) break;
+  }
+  if (k == sc_miter_) return MAX_ITERATIONS;
+
+  // Constraint tensor consistent with the final tangent
+  int ier = sphere_polarization(L, P);
+  if (ier != 0) return ier;
+  ier = invert_mat(P, 6);
+  if (ier != 0) return ier;
+  sub_vec(P, L, 36, Lstar);
+
+  std::copy(L, L+36, &h_np1[PolycrystalModel::nhist()]);
 
   return 0;
 }
 
+/// Gauss-Legendre points and weights on [-1,1]
+static void gauss_legendre(int n, std::vector<double> & x,
+                           std::vector<double> & w)
+{
+  x.resize(n);
+  w.resize(n);
+  for (int i = 0; i < n; i++) {
+    double z = cos(M_PI * (i + 0.75) / (n + 0.5));
+    double dp = 1.0;
+    for (int it = 0; it < 100; it++) {
+      double p0 = 1.0, p1 = z;
+      for (int k = 2; k <= n; k++) {
+        double p2 = ((2.0 * k - 1.0) * z * p1 - (k - 1.0) * p0) / k;
+        p0 = p1;
+        p1 = p2;
+      }
+      dp = n * (z * p1 - p0) / (z * z - 1.0);
+      double dz = p1 / dp;
+      z -= dz;
+      if (fabs(dz) < 1.0e-15) break;
+    }
+    x[i] = z;
+    w[i] = 2.0 / ((1.0 - z * z) * dp * dp);
+  }
+}
+
+/// Quadrature over the upper half of the unit sphere, packed as
+/// [x, y, z, weight] with the weights normalized to integrate the average
+/// over the whole sphere of an even function
+static std::vector<double> sphere_points(int nt, int np)
+{
+  std::vector<double> x, wt;
+  gauss_legendre(nt, x, wt);
+
+  std::vector<double> pts;
+  for (int a = 0; a < nt; a++) {
+    double ct = 0.5 * (x[a] + 1.0);
+    double st = sqrt(1.0 - ct * ct);
+    for (int b = 0; b < np; b++) {
+      double phi = 2.0 * M_PI * b / np;
+      pts.push_back(st * cos(phi));
+      pts.push_back(st * sin(phi));
+      pts.push_back(ct);
+      pts.push_back(0.5 * wt[a] / np);
+    }
+  }
+
+  return pts;
+}
+
+int sphere_polarization(const double * const L, double * const P)
+{
+  //  P_ijkl = 1/(4 pi) int (K(xi)^-1)_ik xi_j xi_l dS, symmetrized, with
+  //  the acoustic tensor K_ik = L_ijkl xi_j xi_l.  The integrand is even
+  //  in xi, so integrate over the upper half sphere and double.
+  static const int nt = 16;
+  static const int np = 32;
+  static const std::vector<double> pts = sphere_points(nt, np);
+
+  double Lf[81];
+  mandel2full(L, Lf);
+
+  double Pf[81];
+  std::fill(Pf, Pf+81, 0.0);
+  for (size_t a = 0; a < pts.size() / 4; a++) {
+    const double * xi = &pts[4*a];
+    double f = pts[4*a+3];
+
+    double K[9];
+    std::fill(K, K+9, 0.0);
+    for (int i = 0; i < 3; i++) {
+      for (int k = 0; k < 3; k++) {
+        for (int j = 0; j < 3; j++) {
+          for (int l = 0; l < 3; l++) {
+            K[3*i+k] += Lf[(3*i+j)*9+3*k+l] * xi[j] * xi[l];
+          }
+        }
+      }
+    }
+
+    // Explicit 3x3 inverse, this is the inner loop
+    double N[9];
+    N[0] = K[4]*K[8] - K[5]*K[7];
+    N[1] = K[2]*K[7] - K[1]*K[8];
+    N[2] = K[1]*K[5] - K[2]*K[4];
+    N[3] = K[5]*K[6] - K[3]*K[8];
+    N[4] = K[0]*K[8] - K[2]*K[6];
+    N[5] = K[2]*K[3] - K[0]*K[5];
+    N[6] = K[3]*K[7] - K[4]*K[6];
+    N[7] = K[1]*K[6] - K[0]*K[7];
+    N[8] = K[0]*K[4] - K[1]*K[3];
+    double det = K[0]*N[0] + K[1]*N[3] + K[2]*N[6];
+    if (fabs(det) < std::numeric_limits<double>::min()) return LINALG_FAILURE;
+    for (int i = 0; i < 9; i++) N[i] *= f / det;
+
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        for (int k = 0; k < 3; k++) {
+          for (int l = 0; l < 3; l++) {
+            Pf[(3*i+j)*9+3*k+l] += N[3*i+k] * xi[j] * xi[l];
+          }
+        }
+      }
+    }
+  }
+
+  double Ps[81];
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      for (int k = 0; k < 3; k++) {
+        for (int l = 0; l < 3; l++) {
+          Ps[(3*i+j)*9+3*k+l] = 0.25 * (
+              Pf[(3*i+j)*9+3*k+l] + Pf[(3*j+i)*9+3*k+l] +
+              Pf[(3*i+j)*9+3*l+k] + Pf[(3*j+i)*9+3*l+k]);
+        }
+      }
+    }
+  }
+
+  return full2mandel(Ps, P);
+}
+
 }
@@ -3,6 +3,7 @@
 #include "../models.h"
 #include "../math/rotations.h"
 #include "singlecrystal.h"
+#include "batch.h"
 
 #include "../windows.h"
 
@@ -14,10 +15,22 @@ class NEML_EXPORT PolycrystalModel: public NEMLModel_ldi
  public:
   PolycrystalModel(std::shared_ptr<SingleCrystalModel> model,
                    std::vector<std::shared_ptr<Orientation>> qs,
-                   int nthreads);
+                   int nthreads,
+                   std::vector<double> weights = std::vector<double>());
+  /// All the grains share model, each starting from its own orientation
+  PolycrystalModel(std::shared_ptr<SingleCrystalModel> model,
+                   OrientationArray qs,
+                   int nthreads,
+                   std::vector<double> weights = std::vector<double>());
 
   size_t n() const;
 
+  /// Initial orientation of each grain, in the active convention
+  const OrientationArray & initial_orientations() const;
+
+  /// Volume fraction of grain i, equal fractions if no weights were given
+  double weight(size_t i) const;
+
   virtual size_t nhist() const;
   virtual int init_hist(double * const hist) const;
 
@@ -33,10 +46,28 @@ class NEML_EXPORT PolycrystalModel: public NEMLModel_ldi
 
   virtual std::vector<Orientation> orientations(double * const store) const;
 
+  /// Run the grains on a different executor, for example the caller's pool
+  void set_executor(std::shared_ptr<BatchExecutor> executor);
+
+  virtual size_t nstore() const;
+  virtual int init_store(double * const store) const;
+
+  virtual double alpha(double T) const;
+  virtual int elastic_strains(const double * const s_np1,
+                              double T_np1, const double * const h_np1,
+                              double * const e_np1) const;
+
+  /// The grains do the solves, so these act on the single crystal model
+  virtual void collect_solver_stats(bool on = true);
+  virtual SolverStats solver_stats() const;
+  virtual void reset_solver_stats();
+
  protected:
   std::shared_ptr<SingleCrystalModel> model_;
-  const std::vector<std::shared_ptr<Orientation>> q0s_;
+  const OrientationArray q0s_;
   int nthreads_;
+  std::vector<double> weights_;
+  std::shared_ptr<BatchExecutor> executor_;
 };
 
 class NEML_EXPORT TaylorModel: public PolycrystalModel
@@ -44,7 +75,13 @@ class NEML_EXPORT TaylorModel: public PolycrystalModel
  public:
   TaylorModel(std::shared_ptr<SingleCrystalModel> model,
               std::vector<std::shared_ptr<Orientation>> qs,
-              int nthreads);
+              int nthreads,
+              std::vector<double> weights = std::vector<double>());
+  /// Instanced grains, see PolycrystalModel
+  TaylorModel(std::shared_ptr<SingleCrystalModel> model,
+              OrientationArray qs,
+              int nthreads,
+              std::vector<double> weights = std::vector<double>());
 
   /// Type for the object system
   static std::string type();
@@ -53,8 +90,38 @@ class NEML_EXPORT TaylorModel: public PolycrystalModel
   /// Setup from a ParameterSet
   static std::unique_ptr<NEMLObject> initialize(ParameterSet & params);
 
-  virtual size_t nstore() const;
-  virtual int init_store(double * const store) const;
+  /// Large strain incremental update
+  virtual int update_ld_inc(
+     const double * const d_np1, const double * const d_n,
+     const double * const w_np1, const double * const w_n,
+     double T_np1, double T_n,
+     double t_np1, double t_n,
+     double * const s_np1, const double * const s_n,
+     double * const h_np1, const double * const h_n,
+     double * const A_np1, double * const B_np1,
+     double & u_np1, double u_n,
+     double & p_np1, double p_n) const;
+};
+
+static Register<TaylorModel> regTaylorModel;
+
+/// Grain strains from a linearized interaction law
+//  The strain increment of each grain satisfies
+//
+//    (s_i - s_i,n) - ds = -L* (de_i - de)
+//
+//  where ds is a common stress increment and the grain strain increments
+//  de_i average to the macroscale increment de.  The subclasses provide
+//  the constraint tensor L*.  The grain strains come from a Newton
+//  iteration in which all the grains update in parallel and the grain
+//  tangents give the Jacobian.
+class NEML_EXPORT InteractionPolycrystalModel: public PolycrystalModel
+{
+ public:
+  InteractionPolycrystalModel(std::shared_ptr<SingleCrystalModel> model,
+                              std::vector<std::shared_ptr<Orientation>> qs,
+                              int nthreads, std::vector<double> weights,
+                              double rtol, double atol, int miter);
 
   /// Large strain incremental update
   virtual int update_ld_inc(
@@ -66,14 +133,88 @@ class NEML_EXPORT TaylorModel: public PolycrystalModel
      double * const h_np1, const double * const h_n,
      double * const A_np1, double * const B_np1,
      double & u_np1, double u_n,
-     double & p_np1, double p_n);
+     double & p_np1, double p_n) const;
 
-  virtual double alpha(double T) const;
-  virtual int elastic_strains(const double * const s_np1,
-                              double T_np1, const double * const h_np1,
-                              double * const e_np1) const;
+ protected:
+  /// Constraint tensor L* from the current grain tangents
+  virtual int constraint_(const double * const A, double * const Lstar,
+                          const double * const h_n,
+                          double * const h_np1) const = 0;
+
+ protected:
+  double rtol_, atol_;
+  int miter_;
 };
 
-static Register<TaylorModel> regTaylorModel;
+/// Sachs (iso-stress) model, every grain carries the same stress
+//  This is the interaction law with L* = 0 and gives a lower bound on
+//  the stress, as the Taylor model gives an upper bound.
+class NEML_EXPORT SachsModel: public InteractionPolycrystalModel
+{
+ public:
+  SachsModel(std::shared_ptr<SingleCrystalModel> model,
+             std::vector<std::shared_ptr<Orientation>> qs,
+             int nthreads, std::vector<double> weights = std::vector<double>(),
+             double rtol = 1.0e-6, double atol = 1.0e-8, int miter = 30);
+
+  /// Type for the object system
+  static std::string type();
+  /// Parameters for the object system
+  static ParameterSet parameters();
+  /// Setup from a ParameterSet
+  static std::unique_ptr<NEMLObject> initialize(ParameterSet & params);
+
+ protected:
+  virtual int constraint_(const double * const A, double * const Lstar,
+                          const double * const h_n,
+                          double * const h_np1) const;
+};
+
+static Register<SachsModel> regSachsModel;
+
+/// Self-consistent model in the style of VPSC
+//  Each grain is a spherical inclusion in the homogenized medium, whose
+//  tangent L is the self-consistent average of the grain tangents A_i
+//
+//    L = <A_i (A_i + L*)^-1> <(A_i + L*)^-1>^-1,    L* = P(L)^-1 - L
+//
+//  with P the polarization tensor of a sphere in a medium with tangent L.
+//  Each Newton iteration solves this fixed point with the current grain
+//  tangents, so no extra grain updates are needed.  The converged L of
+//  each step is stored and starts the fixed point in the next step.
+class NEML_EXPORT SelfConsistentModel: public InteractionPolycrystalModel
+{
+ public:
+  SelfConsistentModel(std::shared_ptr<SingleCrystalModel> model,
+                      std::vector<std::shared_ptr<Orientation>> qs,
+                      int nthreads,
+                      std::vector<double> weights = std::vector<double>(),
+                      double rtol = 1.0e-6, double atol = 1.0e-8,
+                      int miter = 30, int sc_miter = 50);
+
+  /// Type for the object system
+  static std::string type();
+  /// Parameters for the object system
+  static ParameterSet parameters();
+  /// Setup from a ParameterSet
+  static std::unique_ptr<NEMLObject> initialize(ParameterSet & params);
+
+  virtual size_t nhist() const;
+  virtual int init_hist(double * const hist) const;
+
+ protected:
+  virtual int constraint_(const double * const A, double * const Lstar,
+                          const double * const h_n,
+                          double * const h_np1) const;
+
+ private:
+  int sc_miter_;
+};
+
+static Register<SelfConsistentModel> regSelfConsistentModel;
+
+/// Polarization tensor P of a spherical inclusion in a medium with the
+/// Mandel tangent L, so that the Eshelby tensor is S = P L
+NEML_EXPORT int sphere_polarization(const double * const L, double * const P);
 
 }
@@ -15,6 +15,9 @@ PYBIND11_MODULE(polycrystal, m) {
   
   py::class_<PolycrystalModel, NEMLModel_ldi, std::shared_ptr<PolycrystalModel>>(m, "PolycrystalModel")
       .def_property_readonly("n", &PolycrystalModel::n)
+      .def("weight", &PolycrystalModel::weight)
+      .def_property_readonly("initial_orientations",
+                             &PolycrystalModel::initial_orientations)
       .def("orientations", 
            [](PolycrystalModel & m, py::array_t<double, py::array::c_style> h) -> std::vector<Orientation>
            {
@@ -23,6 +26,9 @@ PYBIND11_MODULE(polycrystal, m) {
     ;
 
   py::class_<TaylorModel, PolycrystalModel, std::shared_ptr<TaylorModel>>(m, "TaylorModel")
+      .def(py::init<std::shared_ptr<SingleCrystalModel>, OrientationArray,
+           int, std::vector<double>>(), py::arg("model"), py::arg("qs"),
+           py::arg("nthreads") = 1, py::arg("weights") = std::vector<double>())
       .def(py::init([](py::args args, py::kwargs kwargs)
                     {
                       return create_object_python<TaylorModel>(args,
@@ -30,6 +36,40 @@ PYBIND11_MODULE(polycrystal, m) {
                                                                {"model", "qs"});
                     }))
     ;
+
+  py::class_<InteractionPolycrystalModel, PolycrystalModel, std::shared_ptr<InteractionPolycrystalModel>>(m, "InteractionPolycrystalModel")
+    ;
+
+  py::class_<SachsModel, InteractionPolycrystalModel, std::shared_ptr<SachsModel>>(m, "SachsModel")
+      .def(py::init([](py::args args, py::kwargs kwargs)
+                    {
+                      return create_object_python<SachsModel>(args,
+                                                              kwargs,
+                                                              {"model", "qs"});
+                    }))
+    ;
+
+  py::class_<SelfConsistentModel, InteractionPolycrystalModel, std::shared_ptr<SelfConsistentModel>>(m, "SelfConsistentModel")
+      .def(py::init([](py::args args, py::kwargs kwargs)
+                    {
+                      return create_object_python<SelfConsistentModel>(
+                          args, kwargs, {"model", "qs"});
+                    }))
+    ;
+
+  m.def("sphere_polarization",
+        [](py::array_t<double, py::array::c_style> L) -> py::array_t<double>
+        {
+          if ((L.request().ndim != 2) || (L.request().shape[0] != 6) ||
+              (L.request().shape[1] != 6)) {
+            throw std::runtime_error("The tangent must be a 6x6 matrix");
+          }
+          auto P = alloc_mat<double>(6, 6);
+          int ier = sphere_polarization(arr2ptr<double>(L),
+                                        arr2ptr<double>(P));
+          py_error(ier);
+          return P;
+        }, "Polarization tensor of a spherical inclusion");
 }
 
 }
@@ -1,5 +1,7 @@
 #include "singlecrystal.h"
 
+#include "../trace.h"
+
 namespace neml {
 
 SingleCrystalModel::SingleCrystalModel(
@@ -8,11 +10,31 @@ SingleCrystalModel::SingleCrystalModel(
     std::shared_ptr<Orientation> initial_angle,
     std::shared_ptr<Interpolate> alpha,
     bool update_rotation, double tol, int miter, bool verbose, 
-    int max_divide) :
+    int max_divide, bool block_solve, bool mixed_precision,
+    std::string predictor, bool adaptive_substep, double substep_tol,
+    std::string solver) :
       kinematics_(kinematics), lattice_(lattice), q0_(initial_angle), alpha_(alpha),
       update_rotation_(update_rotation), tol_(tol), miter_(miter),
-      verbose_(verbose), max_divide_(max_divide), stored_hist_(false)
-{
+      verbose_(verbose), max_divide_(max_divide), 
+      block_solve_(block_solve && kinematics->diagonal_history_jacobian()),
+      mixed_precision_(mixed_precision),
+      predictor_(parse_predictor(predictor)),
+      adaptive_substep_(adaptive_substep), substep_tol_(substep_tol),
+      solver_(parse_nonlinear_solver(solver)), stored_hist_(false)
+{
+  if (predictor_ == PREDICTOR_EXTRAPOLATE) {
+    throw std::invalid_argument("SingleCrystalModel does not support the "
+                                "extrapolate predictor, use none or euler");
+  }
+  if ((solver_ == NONLINEAR_BROYDEN) && (block_solve || mixed_precision)) {
+    throw std::invalid_argument("The broyden solver factors its own "
+                                "jacobian, block_solve and mixed_precision "
+                                "need the newton solver");
+  }
+  if (block_solve && mixed_precision) {
+    throw std::invalid_argument("block_solve and mixed_precision are "
+                                "alternative linear solves, pick one");
+  }
   populate_history(stored_hist_);
 }
 
@@ -41,6 +63,12 @@ ParameterSet SingleCrystalModel::parameters()
   pset.add_optional_parameter<int>("miter", 30);
   pset.add_optional_parameter<bool>("verbose", false);
   pset.add_optional_parameter<int>("max_divide", 6);
+  pset.add_optional_parameter<bool>("block_solve", false);
+  pset.add_optional_parameter<bool>("mixed_precision", false);
+  pset.add_optional_parameter<std::string>("predictor", std::string("none"));
+  pset.add_optional_parameter<bool>("adaptive_substep", false);
+  pset.add_optional_parameter<double>("substep_tol", 1.0e-4);
+  pset.add_optional_parameter<std::string>("solver", std::string("newton"));
 
   return pset;
 }
@@ -56,7 +84,13 @@ std::unique_ptr<NEMLObject> SingleCrystalModel::initialize(ParameterSet & params
       params.get_parameter<double>("tol"),
       params.get_parameter<int>("miter"),
       params.get_parameter<bool>("verbose"),
-      params.get_parameter<int>("max_divide"));
+      params.get_parameter<int>("max_divide"),
+      params.get_parameter<bool>("block_solve"),
+      params.get_parameter<bool>("mixed_precision"),
+      params.get_parameter<std::string>("predictor"),
+      params.get_parameter<bool>("adaptive_substep"),
+      params.get_parameter<double>("substep_tol"),
+      params.get_parameter<std::string>("solver"));
 }
 
 void SingleCrystalModel::populate_history(History & history) const
@@ -114,8 +148,9 @@ int SingleCrystalModel::update_ld_inc(
    double * const h_np1, const double * const h_n,
    double * const A_np1, double * const B_np1,
    double & u_np1, double u_n,
-   double & p_np1, double p_n)
+   double & p_np1, double p_n) const
 {
+  NEML_TRACE_SCOPE("update_ld_inc");
   // Setup everything in the appropriate wrappers
   const Symmetric D_np1(d_np1);
   const Skew W_np1(w_np1);
@@ -138,9 +173,9 @@ int SingleCrystalModel::update_ld_inc(
   History HF_np1 = gather_history_(h_np1);
   const History HF_n = gather_history_(h_n);
 
-  // There is a subtle race condition if you don't copy the lattice
-  // because that object now caches data
-  Lattice local_lattice = Lattice(*lattice_);
+  // The lattice caches its rotated slip systems per thread, so it can be
+  // shared rather than copied for each update
+  Lattice & local_lattice = *lattice_;
 
   // As the update is decoupled, split the histories into hardening/
   // orientation groups
@@ -160,8 +195,34 @@ int SingleCrystalModel::update_ld_inc(
   // Use S_np1 and H_np1 to iterate
   S_np1.copy_data(S_n.data());
   H_np1.copy_data(H_n.rawptr());
+
+  // The Broyden solver carries its jacobian factors between substeps
+  BroydenWorkspace work;
   
+  // Error controlled substepping replaces the bisection below
+  if (adaptive_substep_) {
+    int ier = update_controlled_(D, W, Q_n, local_lattice, T_n, T_np1, dt,
+                                 F_n, S_np1, H_np1, &work);
+    if (ier != 0) return ier;
+
+    // Tangent and rotation over the whole increment
+    History fixed = kinematics_->decouple(S_np1, D, W, Q_n, H_np1, 
+                                          local_lattice, T_np1, F_n);
+    SCTrialState trial(D, W, S_n, H_n, Q_n, local_lattice, T_np1, dt, 
+                       fixed);
+    calc_tangents_(S_np1, H_np1, &trial, A_np1, B_np1);
+    if (update_rotation_) {
+      HF_np1.get<Orientation>("rotation") = update_rot_(S_np1, H_np1, &trial);
+    }
+    else {
+      HF_np1.get<Orientation>("rotation") = Q_n;
+    }
+
+    progress = target;
+  }
+
   while (progress < target) {
+    NEML_TRACE_SCOPE("substep");
     double step = 1.0 / pow(2, subdiv);
 
     // Decouple the updates
@@ -177,11 +238,13 @@ int SingleCrystalModel::update_ld_inc(
                        fixed);
 
     // Solve the update
-    int ier = solve_substep_(&trial, S_np1, H_np1);
+    int ier = solve_substep_(&trial, S_np1, H_np1, &work);
 
     if (ier != 0) {
       subdiv++;
       cur_int_inc /= 2;
+      SolverStats * stats = local_solver_stats_();
+      if (stats != nullptr) stats->substep_divisions++;
 
       if (verbose_) {
         std::cout << "Taking adaptive substep" << std::endl;
@@ -253,6 +316,17 @@ int SingleCrystalModel::init_hist(double * const hist) const
   return 0;
 }
 
+int SingleCrystalModel::init_instance(double * const store,
+                                      const Orientation & q0) const
+{
+  int ier = init_store(store);
+  if (ier != 0) return ier;
+  History h = gather_history_(store);
+  h.get<Orientation>("rotation") = q0;
+  h.get<Orientation>("rotation0") = q0;
+  return 0;
+}
+
 double SingleCrystalModel::alpha(double T) const
 {
   return alpha_->value(T);
@@ -286,16 +360,33 @@ size_t SingleCrystalModel::nparams() const
   }
 }
 
-int SingleCrystalModel::init_x(double * const x, TrialState * ts)
+int SingleCrystalModel::init_x(double * const x, TrialState * ts) const
 {
   SCTrialState * ats = static_cast<SCTrialState*>(ts);
   std::copy(ats->S.data(), ats->S.data()+6, x);
   std::copy(ats->history.rawptr(), ats->history.rawptr()+ats->history.size(), &x[6]);
+
+  // Forward Euler predictor from the start of the step
+  if (predictor_ == PREDICTOR_EULER) {
+    Symmetric sdot = kinematics_->stress_rate(ats->S, ats->d, ats->w, ats->Q,
+                                              ats->history, ats->lattice,
+                                              ats->T, ats->fixed);
+    History hdot = kinematics_->history_rate(ats->S, ats->d, ats->w, ats->Q,
+                                             ats->history, ats->lattice,
+                                             ats->T, ats->fixed);
+    for (size_t i = 0; i < 6; i++) {
+      x[i] += sdot.data()[i] * ats->dt;
+    }
+    for (size_t i = 0; i < hdot.size(); i++) {
+      x[i+6] += hdot.rawptr()[i] * ats->dt;
+    }
+  }
+
   return 0;
 }
 
-int SingleCrystalModel::RJ(const double * const x, TrialState * ts,
-                           double * const R, double * const J)
+int SingleCrystalModel::R(const double * const x, TrialState * ts,
+                          double * const R) const
 {
   // Cast trial state
   SCTrialState * ats = static_cast<SCTrialState*>(ts);
@@ -321,6 +412,25 @@ int SingleCrystalModel::RJ(const double * const x, TrialState * ts,
     R[i+6] = H.rawptr()[i] - ats->history.rawptr()[i] - history_rate.rawptr()[i] * ats->dt;
   }
 
+  return 0;
+}
+
+int SingleCrystalModel::RJ(const double * const x, TrialState * ts,
+                           double * const R, double * const J) const
+{
+  int ier = SingleCrystalModel::R(x, ts, R);
+  if (ier != 0) return ier;
+
+  // Cast trial state
+  SCTrialState * ats = static_cast<SCTrialState*>(ts);
+
+  // Make nice objects
+  Symmetric S (x);
+  History H = ats->history.copy_blank();
+  H.copy_data(&x[6]);
+
+  History & fixed = ats->fixed;
+
   // Get all the Jacobian contributions
   SymSymR4 dSdS = kinematics_->d_stress_rate_d_stress(S, ats->d, ats->w, ats->Q,
                                                     H, ats->lattice, ats->T,
@@ -369,6 +479,24 @@ int SingleCrystalModel::RJ(const double * const x, TrialState * ts,
   return 0;
 }
 
+int SingleCrystalModel::linear_solve(const double * const J, 
+                                     double * const R) const
+{
+  if (block_solve_) {
+    return schur_solve_(J, R);
+  }
+  // The Newton convergence check still uses the double precision residual
+  if (mixed_precision_) {
+    return solve_mat_mixed(J, nparams(), R);
+  }
+  return Solvable::linear_solve(J, R);
+}
+
+bool SingleCrystalModel::block_solve() const
+{
+  return block_solve_;
+}
+
 Orientation SingleCrystalModel::get_active_orientation(
     double * const hist) const
 {
@@ -465,7 +593,7 @@ History SingleCrystalModel::gather_blank_history_() const
 
 void SingleCrystalModel::calc_tangents_(Symmetric & S, History & H,
                                         SCTrialState * ts,
-                                        double * const A, double * const B)
+                                        double * const A, double * const B) const
 {
   // Resetup x
   std::vector<double> xv(nparams());
@@ -514,12 +642,20 @@ void SingleCrystalModel::calc_tangents_(Symmetric & S, History & H,
   delete [] J;
 
   // Let the games begin
-  // J22 inverse
-  invert_mat(J22, nh);
-
   // J12 J22_inv
   double * M1 = new double [6*nh];
-  mat_mat(6, nh, nh, J12, J22, M1);
+  if (block_solve_) {
+    // J22 is diagonal, so just scale the columns
+    for (size_t i = 0; i < 6; i++) {
+      for (size_t j = 0; j < nh; j++) {
+        M1[CINDEX(i,j,nh)] = J12[CINDEX(i,j,nh)] / J22[CINDEX(j,j,nh)];
+      }
+    }
+  }
+  else {
+    invert_mat(J22, nh);
+    mat_mat(6, nh, nh, J12, J22, M1);
+  }
 
   // J12 J22_inv J21
   double * M2 = new double[6*6];
@@ -644,11 +780,20 @@ double SingleCrystalModel::calc_work_inc_(
 
 int SingleCrystalModel::solve_substep_(SCTrialState * ts,
                                        Symmetric & stress,
-                                       History & hist)
+                                       History & hist,
+                                       BroydenWorkspace * work) const
 {
   std::vector<double> xv(nparams());
   double * x = &xv[0];
-  int ier = solve(this, x, ts, tol_, miter_, verbose_);
+  int ier;
+  if (solver_ == NONLINEAR_BROYDEN) {
+    ier = broyden(this, x, ts, tol_, miter_, verbose_, false, nullptr,
+                  nullptr, nullptr, work, local_solver_stats_());
+  }
+  else {
+    ier = solve(this, x, ts, tol_, miter_, verbose_, false, nullptr,
+                nullptr, nullptr, local_solver_stats_());
+  }
 
   // Only dump into new stress and hist if we pass
   if (ier != 0) return ier;
@@ -660,6 +805,155 @@ int SingleCrystalModel::solve_substep_(SCTrialState * ts,
   return ier;
 }
 
+int SingleCrystalModel::schur_solve_(const double * const J, 
+                                     double * const R) const
+{
+  // J = [J11 J12; J21 J22] with J22 diagonal.  Eliminate the history
+  // block and solve the 6x6 Schur complement for the stress
+  size_t n = nparams();
+  size_t nh = n - 6;
+
+  std::vector<double> Dinv(nh);
+  for (size_t k = 0; k < nh; k++) {
+    double d = J[CINDEX((k+6),(k+6),n)];
+    // Singular diagonal, fall back on the dense solve
+    if (d == 0.0) return solve_mat(J, n, R);
+    Dinv[k] = 1.0 / d;
+  }
+
+  // S = J11 - J12 J22_inv J21, r = R1 - J12 J22_inv R2
+  double S[36];
+  double r[6];
+  for (size_t i = 0; i < 6; i++) {
+    r[i] = R[i];
+    for (size_t j = 0; j < 6; j++) {
+      S[CINDEX(i,j,6)] = J[CINDEX(i,j,n)];
+    }
+    for (size_t k = 0; k < nh; k++) {
+      double f = J[CINDEX(i,(k+6),n)] * Dinv[k];
+      r[i] -= f * R[k+6];
+      for (size_t j = 0; j < 6; j++) {
+        S[CINDEX(i,j,6)] -= f * J[CINDEX((k+6),j,n)];
+      }
+    }
+  }
+
+  int ier = solve_mat(S, 6, r);
+  if (ier != SUCCESS) return ier;
+
+  // Back substitute for the history, x2 = J22_inv (R2 - J21 x1)
+  for (size_t k = 0; k < nh; k++) {
+    double v = R[k+6];
+    for (size_t j = 0; j < 6; j++) {
+      v -= J[CINDEX((k+6),j,n)] * r[j];
+    }
+    R[k+6] = v * Dinv[k];
+  }
+  std::copy(r, r+6, R);
+
+  return 0;
+}
+
+int SingleCrystalModel::update_controlled_(
+    const Symmetric & D, const Skew & W, const Orientation & Q_n,
+    Lattice & lattice, double T_n, double T_np1, double dt,
+    const History & F_n, Symmetric & S, History & H,
+    BroydenWorkspace * work) const
+{
+  double min_step = 1.0 / pow(2, max_divide_);
+  double frac = 0.0;
+  double step = 1.0;
+
+  while (frac < 1.0) {
+    NEML_TRACE_SCOPE("substep");
+    step = std::min(step, 1.0 - frac);
+    double end = frac + step;
+    if (1.0 - end < min_step / 2.0) end = 1.0;
+    double mid = (frac + end) / 2.0;
+
+    // One full step and two half steps
+    Symmetric S_full(S);
+    History H_full = H.deepcopy();
+    int ier = partial_substep_(D, W, Q_n, lattice, T_n, T_np1, dt, frac, end,
+                               F_n, S_full, H_full, work);
+
+    Symmetric S_two(S);
+    History H_two = H.deepcopy();
+    if (ier == 0) {
+      ier = partial_substep_(D, W, Q_n, lattice, T_n, T_np1, dt, frac, mid,
+                             F_n, S_two, H_two, work);
+    }
+    if (ier == 0) {
+      ier = partial_substep_(D, W, Q_n, lattice, T_n, T_np1, dt, mid, end,
+                             F_n, S_two, H_two, work);
+    }
+
+    // The difference between the one and two step solutions estimates the
+    // local error in the two step solution
+    double err = 0.0;
+    if (ier == 0) {
+      for (size_t i = 0; i < 6; i++) {
+        double sc = substep_tol_ * (1.0 + std::max(fabs(S.data()[i]), 
+                                                   fabs(S_two.data()[i])));
+        err += pow((S_two.data()[i] - S_full.data()[i]) / sc, 2.0);
+      }
+      for (size_t i = 0; i < H.size(); i++) {
+        double sc = substep_tol_ * (1.0 + std::max(fabs(H.rawptr()[i]), 
+                                                   fabs(H_two.rawptr()[i])));
+        err += pow((H_two.rawptr()[i] - H_full.rawptr()[i]) / sc, 2.0);
+      }
+      err = sqrt(err / (6 + H.size()));
+      // The solver can "converge" on a NaN residual
+      if (not std::isfinite(err)) ier = LINALG_FAILURE;
+    }
+
+    // Failed solves just cut the step
+    if (ier != 0) {
+      if (step <= min_step) {
+        if (verbose_) {
+          std::cout << "Adaptive substepping failed!" << std::endl;
+        }
+        return ier;
+      }
+      step = std::max(step / 4.0, min_step);
+      SolverStats * stats = local_solver_stats_();
+      if (stats != nullptr) stats->substep_divisions++;
+      continue;
+    }
+
+    if (verbose_) {
+      std::cout << "Substep from " << frac << " to " << end 
+          << " with error " << err << std::endl;
+    }
+
+    // Accept if the error is small enough or we can't cut the step anymore
+    if ((err <= 1.0) || (step <= min_step)) {
+      S.copy_data(S_two.data());
+      H.copy_data(H_two.rawptr());
+      frac = end;
+    }
+
+    // Usual step size control, bounded growth and shrink
+    double fact = 4.0;
+    if (err > 0.0) fact = std::min(4.0, std::max(0.2, 0.9 / sqrt(err)));
+    step = std::max(step * fact, min_step);
+  }
+
+  return 0;
+}
+
+int SingleCrystalModel::partial_substep_(
+    const Symmetric & D, const Skew & W, const Orientation & Q_n,
+    Lattice & lattice, double T_n, double T_np1, double dt, double start,
+    double end, const History & F_n, Symmetric & S, History & H,
+    BroydenWorkspace * work) const
+{
+  double T = T_n + (T_np1 - T_n) * end;
+  History fixed = kinematics_->decouple(S, D, W, Q_n, H, lattice, T, F_n);
+  SCTrialState trial(D, W, S, H, Q_n, lattice, T, dt * (end - start), fixed);
+  return solve_substep_(&trial, S, H, work);
+}
+
 std::vector<std::string> SingleCrystalModel::not_updated_() const
 {
   if (use_nye()) {
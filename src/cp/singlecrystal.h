@@ -48,7 +48,12 @@ class NEML_EXPORT SingleCrystalModel: public NEMLModel_ldi, public Solvable
                      std::shared_ptr<Interpolate> alpha,
                      bool update_rotation,
                      double tol, int miter, bool verbose,
-                     int max_divide);
+                     int max_divide, bool block_solve = false,
+                     bool mixed_precision = false,
+                     std::string predictor = "none",
+                     bool adaptive_substep = false,
+                     double substep_tol = 1.0e-4,
+                     std::string solver = "newton");
   /// Destructor
   virtual ~SingleCrystalModel();
 
@@ -83,12 +88,16 @@ class NEML_EXPORT SingleCrystalModel: public NEMLModel_ldi, public Solvable
        double * const h_np1, const double * const h_n,
        double * const A_np1, double * const B_np1,
        double & u_np1, double u_n,
-       double & p_np1, double p_n);
+       double & p_np1, double p_n) const;
 
   /// Number of stored history variables
   virtual size_t nhist() const;
   /// Initialize history raw pointer array
   virtual int init_hist(double * const hist) const;
+  /// Initialize the stored variables of one point with its own orientation
+  //  Lets one model serve many grains, each starting from q0 (active
+  //  convention, like initial_angle) instead of the model's own angle
+  int init_instance(double * const store, const Orientation & q0) const;
 
   /// Instantaneous CTE
   virtual double alpha(double T) const;
@@ -101,10 +110,20 @@ class NEML_EXPORT SingleCrystalModel: public NEMLModel_ldi, public Solvable
   /// Number of nonlinear equations to solve in the integration
   virtual size_t nparams() const;
   /// Setup an initial guess for the nonlinear solution
-  virtual int init_x(double * const x, TrialState * ts);
+  virtual int init_x(double * const x, TrialState * ts) const;
   /// Integration residual and jacobian equations
   virtual int RJ(const double * const x, TrialState * ts, double * const R,
-                 double * const J);
+                 double * const J) const;
+  /// Integration residual alone
+  virtual int R(const double * const x, TrialState * ts,
+                double * const R) const;
+  /// Newton linear solve, eliminating a diagonal history block if possible
+  virtual int linear_solve(const double * const J, double * const R) const;
+
+  /// Whether the solver uses the block (Schur complement) linear solve
+  bool block_solve() const;
+  /// The crystal lattice
+  std::shared_ptr<Lattice> lattice() const {return lattice_;};
 
   /// Get the current orientation in the active convention (raw ptr history)
   Orientation get_active_orientation(double * const hist) const;
@@ -136,7 +155,7 @@ class NEML_EXPORT SingleCrystalModel: public NEMLModel_ldi, public Solvable
   History gather_blank_history_() const;
 
   void calc_tangents_(Symmetric & S, History & H,
-                      SCTrialState * ts, double * const A, double * const B);
+                      SCTrialState * ts, double * const A, double * const B) const;
   Orientation update_rot_(Symmetric & S_np1, History & H_np1, SCTrialState * ts) const;
   double calc_energy_inc_(const Symmetric & D_np1, const Symmetric & D_n,
                           const Symmetric & S_np1, const Symmetric & S_n) const;
@@ -146,7 +165,22 @@ class NEML_EXPORT SingleCrystalModel: public NEMLModel_ldi, public Solvable
                         const Orientation & Q_n, const History & H_np1,
                         const History & H_n) const;
 
-  int solve_substep_(SCTrialState * ts, Symmetric & stress, History & hist);
+  int solve_substep_(SCTrialState * ts, Symmetric & stress, History & hist,
+                     BroydenWorkspace * work) const;
+
+  int update_controlled_(const Symmetric & D, const Skew & W,
+                         const Orientation & Q_n, Lattice & lattice,
+                         double T_n, double T_np1, double dt,
+                         const History & F_n, Symmetric & S, History & H,
+                         BroydenWorkspace * work) const;
+  int partial_substep_(const Symmetric & D, const Skew & W,
+                       const Orientation & Q_n, Lattice & lattice,
+                       double T_n, double T_np1, double dt, 
+                       double start, double end,
+                       const History & F_n, Symmetric & S, History & H,
+                       BroydenWorkspace * work) const;
+
+  int schur_solve_(const double * const J, double * const R) const;
 
   std::vector<std::string> not_updated_() const;
 
@@ -160,6 +194,12 @@ class NEML_EXPORT SingleCrystalModel: public NEMLModel_ldi, public Solvable
   int miter_;
   bool verbose_;
   int max_divide_;
+  bool block_solve_;
+  bool mixed_precision_;
+  Predictor predictor_;
+  bool adaptive_substep_;
+  double substep_tol_;
+  NonlinearSolver solver_;
 
   History stored_hist_;
 };
@@ -25,6 +25,7 @@ PYBIND11_MODULE(singlecrystal, m) {
                                                                       {"kinematics", "lattice"});
                     }))
       .def("populate_history", &SingleCrystalModel::populate_history)
+      .def_property_readonly("lattice", &SingleCrystalModel::lattice)
       .def("init_history", &SingleCrystalModel::init_history)
       .def("strength",
            [](SingleCrystalModel & m, py::array_t<double, py::array::c_style> h, double T) -> double
@@ -84,6 +85,7 @@ PYBIND11_MODULE(singlecrystal, m) {
             m.set_active_orientation(arr2ptr<double>(hist), q);
            }, "Set the orientation using a active rotation (crystal -> sample)")
       .def_property_readonly("use_nye", &SingleCrystalModel::use_nye)
+      .def_property_readonly("block_solve", &SingleCrystalModel::block_solve)
       .def("update_nye",
            [](SingleCrystalModel & m, py::array_t<double, py::array::c_style> hist, py::array_t<double, py::array::c_style> nye)
            {
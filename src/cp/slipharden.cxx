@@ -7,6 +7,11 @@ bool SlipHardening::use_nye() const
   return false;
 }
 
+bool SlipHardening::diagonal_history_jacobian() const
+{
+  return false;
+}
+
 double SlipSingleHardening::hist_to_tau(
     size_t g, size_t i, const History & history, double T, 
     const History & fixed) const
@@ -120,6 +125,11 @@ double SlipSingleStrengthHardening::nye_part(const RankTwo & nye, double T) cons
   return 0.0;
 }
 
+bool SlipSingleStrengthHardening::diagonal_history_jacobian() const
+{
+  return true;
+}
+
 SumSlipSingleStrengthHardening::SumSlipSingleStrengthHardening(
     std::vector<std::shared_ptr<SlipSingleStrengthHardening>> models)
   :   models_(models)
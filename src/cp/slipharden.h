@@ -60,6 +60,10 @@ class NEML_EXPORT SlipHardening: public NEMLObject
 
   /// Whether this particular model uses the Nye tensor
   virtual bool use_nye() const;
+
+  /// Whether the rate of each history variable depends only on that
+  /// variable, i.e. the history/history block of the Jacobian is diagonal
+  virtual bool diagonal_history_jacobian() const;
 };
 
 /// Slip strength rules where all systems share the same strength
@@ -132,6 +136,9 @@ class NEML_EXPORT SlipSingleStrengthHardening: public SlipSingleHardening
   /// Actual implementation of any Nye contribution (defaults to zero)
   virtual double nye_part(const RankTwo & nye, double T) const;
 
+  /// A single scalar history variable is trivially diagonal
+  virtual bool diagonal_history_jacobian() const;
+
   /// Setup the scalar
   virtual double init_strength() const = 0;
 
@@ -20,6 +20,7 @@ PYBIND11_MODULE(slipharden, m) {
       .def("d_hist_d_s", &SlipHardening::d_hist_d_s)
       .def("d_hist_d_h", &SlipHardening::d_hist_d_h)
       .def_property_readonly("use_nye", &SlipHardening::use_nye)
+      .def_property_readonly("diagonal_history_jacobian", &SlipHardening::diagonal_history_jacobian)
       ;
 
   py::class_<SlipSingleHardening, SlipHardening,
@@ -58,6 +58,11 @@ bool SlipRule::use_nye() const
   return false;
 }
 
+bool SlipRule::diagonal_history_jacobian() const
+{
+  return false;
+}
+
 SlipStrengthSlipRule::SlipStrengthSlipRule(
     std::shared_ptr<SlipHardening> strength) :
       strength_(strength)
@@ -154,6 +159,11 @@ bool SlipStrengthSlipRule::use_nye() const
   return strength_->use_nye();
 }
 
+bool SlipStrengthSlipRule::diagonal_history_jacobian() const
+{
+  return strength_->diagonal_history_jacobian();
+}
+
 PowerLawSlipRule::PowerLawSlipRule(std::shared_ptr<SlipHardening> strength,
                                    std::shared_ptr<Interpolate> gamma0, 
                                    std::shared_ptr<Interpolate> n) :
@@ -76,6 +76,9 @@ class NEML_EXPORT SlipRule: public NEMLObject
 
   /// Whether this model uses the Nye tensor
   virtual bool use_nye() const;
+
+  /// Whether the history/history block of the Jacobian is diagonal
+  virtual bool diagonal_history_jacobian() const;
 };
 
 /// Class where all slip rules that give the system response proportional to some strength,
@@ -138,6 +141,9 @@ class NEML_EXPORT SlipStrengthSlipRule: public SlipRule
   /// Whether this model uses the Nye tensor
   virtual bool use_nye() const;
 
+  /// Defer to the hardening model
+  virtual bool diagonal_history_jacobian() const;
+
  private:
   std::shared_ptr<SlipHardening> strength_;
 };
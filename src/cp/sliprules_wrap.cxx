@@ -25,6 +25,7 @@ PYBIND11_MODULE(sliprules, m) {
       .def("d_sum_slip_d_stress", &SlipRule::d_sum_slip_d_stress)
       .def("d_sum_slip_d_hist", &SlipRule::d_sum_slip_d_hist)
       .def_property_readonly("use_nye", &SlipRule::use_nye)
+      .def_property_readonly("diagonal_history_jacobian", &SlipRule::diagonal_history_jacobian)
       ;
 
   py::class_<SlipStrengthSlipRule, SlipRule,
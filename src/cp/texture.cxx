@@ -0,0 +1,413 @@
+#include "texture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace neml {
+
+/// Standard normal number by Box-Muller, reproducible across libraries
+static double random_normal(std::mt19937_64 & rng)
+{
+  double u1 = 1.0 - random_uniform(rng);
+  double u2 = random_uniform(rng);
+  return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/// Rotation about a random axis with normally distributed components
+static Orientation random_scatter(std::mt19937_64 & rng, double width)
+{
+  double w[3];
+  for (int i = 0; i < 3; i++) w[i] = width * random_normal(rng);
+  double x = norm2_vec(w, 3);
+  if (x == 0.0) return Orientation();
+  for (int i = 0; i < 3; i++) w[i] /= x;
+  return Orientation::createAxisAngle(w, x);
+}
+
+std::vector<Orientation> OrientationDistribution::sample(
+    size_t n, unsigned long seed) const
+{
+  std::mt19937_64 rng(seed);
+  std::vector<Orientation> res;
+  res.reserve(n);
+  for (size_t i = 0; i < n; i++) {
+    res.emplace_back(draw(rng));
+  }
+  return res;
+}
+
+UniformDistribution::UniformDistribution()
+{
+
+}
+
+std::string UniformDistribution::type()
+{
+  return "UniformDistribution";
+}
+
+ParameterSet UniformDistribution::parameters()
+{
+  ParameterSet pset(UniformDistribution::type());
+
+  return pset;
+}
+
+std::unique_ptr<NEMLObject> UniformDistribution::initialize(
+    ParameterSet & params)
+{
+  return neml::make_unique<UniformDistribution>();
+}
+
+Orientation UniformDistribution::draw(std::mt19937_64 & rng) const
+{
+  return random_orientation(rng);
+}
+
+UnimodalDistribution::UnimodalDistribution(
+    std::shared_ptr<Orientation> center, double width) :
+    center_(center), width_(width)
+{
+  if (width < 0.0) {
+    throw std::invalid_argument("The distribution width must be positive");
+  }
+}
+
+std::string UnimodalDistribution::type()
+{
+  return "UnimodalDistribution";
+}
+
+ParameterSet UnimodalDistribution::parameters()
+{
+  ParameterSet pset(UnimodalDistribution::type());
+
+  pset.add_parameter<NEMLObject>("center");
+  pset.add_parameter<double>("width");
+
+  return pset;
+}
+
+std::unique_ptr<NEMLObject> UnimodalDistribution::initialize(
+    ParameterSet & params)
+{
+  return neml::make_unique<UnimodalDistribution>(
+      params.get_object_parameter<Orientation>("center"),
+      params.get_parameter<double>("width"));
+}
+
+Orientation UnimodalDistribution::draw(std::mt19937_64 & rng) const
+{
+  return random_scatter(rng, width_) * (*center_);
+}
+
+FiberDistribution::FiberDistribution(std::vector<double> h,
+                                     std::vector<double> y, double width) :
+    width_(width)
+{
+  if ((h.size() != 3) or (y.size() != 3)) {
+    throw std::invalid_argument("Fiber directions must have 3 components");
+  }
+  if (width < 0.0) {
+    throw std::invalid_argument("The distribution width must be positive");
+  }
+  Vector hv(h);
+  y_ = Vector(y).normalize();
+  hv = hv.normalize();
+
+  // rotate_to needs a well defined axis
+  Vector axis = hv.cross(y_);
+  if (axis.norm() > 1.0e-12) {
+    base_ = rotate_to(hv, y_);
+  }
+  else if (hv.dot(y_) < 0.0) {
+    // Any perpendicular axis will do for the half turn
+    Vector trial = (fabs(hv(0)) < 0.9) ? Vector(std::vector<double>({1,0,0}))
+        : Vector(std::vector<double>({0,1,0}));
+    Vector perp = hv.cross(trial).normalize();
+    base_ = Orientation::createAxisAngle(perp.data(), M_PI);
+  }
+}
+
+std::string FiberDistribution::type()
+{
+  return "FiberDistribution";
+}
+
+ParameterSet FiberDistribution::parameters()
+{
+  ParameterSet pset(FiberDistribution::type());
+
+  pset.add_parameter<std::vector<double>>("h");
+  pset.add_parameter<std::vector<double>>("y");
+  pset.add_parameter<double>("width");
+
+  return pset;
+}
+
+std::unique_ptr<NEMLObject> FiberDistribution::initialize(
+    ParameterSet & params)
+{
+  return neml::make_unique<FiberDistribution>(
+      params.get_parameter<std::vector<double>>("h"),
+      params.get_parameter<std::vector<double>>("y"),
+      params.get_parameter<double>("width"));
+}
+
+Orientation FiberDistribution::draw(std::mt19937_64 & rng) const
+{
+  double phi = 2.0 * M_PI * random_uniform(rng);
+  Orientation about = Orientation::createAxisAngle(y_.data(), phi);
+  return random_scatter(rng, width_) * about * base_;
+}
+
+MixtureDistribution::MixtureDistribution(
+    std::vector<std::shared_ptr<OrientationDistribution>> components,
+    std::vector<double> weights) :
+      components_(components)
+{
+  if ((components.size() == 0) or (components.size() != weights.size())) {
+    throw std::invalid_argument("Need one weight for each component");
+  }
+  double total = 0.0;
+  for (auto w : weights) {
+    if (w < 0.0) {
+      throw std::invalid_argument("Mixture weights must be positive");
+    }
+    total += w;
+    cumulative_.push_back(total);
+  }
+  if (total <= 0.0) {
+    throw std::invalid_argument("Mixture weights must be positive");
+  }
+  for (auto & c : cumulative_) c /= total;
+}
+
+std::string MixtureDistribution::type()
+{
+  return "MixtureDistribution";
+}
+
+ParameterSet MixtureDistribution::parameters()
+{
+  ParameterSet pset(MixtureDistribution::type());
+
+  pset.add_parameter<std::vector<NEMLObject>>("components");
+  pset.add_parameter<std::vector<double>>("weights");
+
+  return pset;
+}
+
+std::unique_ptr<NEMLObject> MixtureDistribution::initialize(
+    ParameterSet & params)
+{
+  return neml::make_unique<MixtureDistribution>(
+      params.get_object_parameter_vector<OrientationDistribution>(
+          "components"),
+      params.get_parameter<std::vector<double>>("weights"));
+}
+
+Orientation MixtureDistribution::draw(std::mt19937_64 & rng) const
+{
+  double u = random_uniform(rng);
+  size_t i = std::upper_bound(cumulative_.begin(), cumulative_.end(), u)
+      - cumulative_.begin();
+  i = std::min(i, components_.size() - 1);
+  return components_[i]->draw(rng);
+}
+
+/// Quotient c = a * b^-1 for unit quaternions
+static inline void qdiv(const double * const a, const double * const b,
+                        double * const c)
+{
+  c[0] = a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3];
+  c[1] = -a[0]*b[1] + a[1]*b[0] - a[2]*b[3] + a[3]*b[2];
+  c[2] = -a[0]*b[2] + a[2]*b[0] - a[3]*b[1] + a[1]*b[3];
+  c[3] = -a[0]*b[3] + a[3]*b[0] - a[1]*b[2] + a[2]*b[1];
+}
+
+/// Hamilton product c = a * b
+static inline void qmul(const double * const a, const double * const b,
+                        double * const c)
+{
+  c[0] = a[0]*b[0] - (a[1]*b[1] + a[2]*b[2] + a[3]*b[3]);
+  c[1] = a[0]*b[1] + a[1]*b[0] + a[2]*b[3] - a[3]*b[2];
+  c[2] = a[0]*b[2] + a[2]*b[0] + a[3]*b[1] - a[1]*b[3];
+  c[3] = a[0]*b[3] + a[3]*b[0] + a[1]*b[2] - a[2]*b[1];
+}
+
+/// Symmetry operator bringing a closest to b, and the cosine of half the
+/// disorientation angle
+static inline double closest_op(const double * const a, const double * const b,
+                                const std::vector<double> & ops, size_t & best)
+{
+  double x[4];
+  qdiv(a, b, x);
+  double cbest = -1.0;
+  for (size_t k = 0; k < ops.size() / 4; k++) {
+    const double * S = &ops[4*k];
+    double c = fabs(S[0]*x[0] - (S[1]*x[1] + S[2]*x[2] + S[3]*x[3]));
+    if (c > cbest) {
+      cbest = c;
+      best = k;
+    }
+  }
+  return std::min(cbest, 1.0);
+}
+
+/// Disorientation angle from the cosine of its half
+static inline double half_cos_to_angle(double c)
+{
+  return 2.0 * acos(c);
+}
+
+ReducedTexture reduce_texture(const std::vector<Orientation> & orientations,
+                              const std::vector<double> & weights,
+                              const SymmetryGroup & symmetry, size_t m,
+                              unsigned long seed, int miter)
+{
+  size_t n = orientations.size();
+  if ((m == 0) or (m > n)) {
+    throw std::invalid_argument("Need between 1 and n representatives");
+  }
+  if ((weights.size() != 0) and (weights.size() != n)) {
+    throw std::invalid_argument("Need one weight for each orientation");
+  }
+
+  std::vector<double> w(n, 1.0);
+  if (weights.size() != 0) w = weights;
+  for (auto wi : w) {
+    if (wi < 0.0) throw std::invalid_argument("Weights must be positive");
+  }
+  double total = std::accumulate(w.begin(), w.end(), 0.0);
+  if (total <= 0.0) {
+    throw std::invalid_argument("At least one weight must be nonzero");
+  }
+  if (miter < 1) {
+    throw std::invalid_argument("Need at least one iteration");
+  }
+
+  // Work with raw passive quaternions, where symmetry acts on the left
+  std::vector<double> P(4*n);
+  for (size_t i = 0; i < n; i++) {
+    Orientation p = orientations[i].inverse();
+    std::copy(p.quat(), p.quat() + 4, &P[4*i]);
+  }
+  std::vector<double> ops;
+  for (auto & op : symmetry.ops()) {
+    ops.insert(ops.end(), op.quat(), op.quat() + 4);
+  }
+
+  std::mt19937_64 rng(seed);
+  size_t kop;
+
+  // k-means++ seeding on weight * angle^2
+  std::vector<double> R(4*m);
+  std::vector<double> dist(n, std::numeric_limits<double>::infinity());
+  auto pick = [&](const std::vector<double> & p) -> size_t
+  {
+    double total = std::accumulate(p.begin(), p.end(), 0.0);
+    if (total <= 0.0) return 0;
+    double u = random_uniform(rng) * total;
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) {
+      sum += p[i];
+      if (u < sum) return i;
+    }
+    return n - 1;
+  };
+
+  std::vector<double> prob(w);
+  for (size_t k = 0; k < m; k++) {
+    size_t i = pick(prob);
+    std::copy(&P[4*i], &P[4*i] + 4, &R[4*k]);
+    for (size_t j = 0; j < n; j++) {
+      double a = half_cos_to_angle(closest_op(&P[4*j], &R[4*k], ops, kop));
+      dist[j] = std::min(dist[j], a);
+      prob[j] = w[j] * dist[j] * dist[j];
+    }
+  }
+
+  // Assign each orientation to its closest representative, returns true
+  // if any assignment changed
+  std::vector<size_t> assign(n, m);
+  auto assign_closest = [&]() -> bool
+  {
+    bool changed = false;
+    for (size_t i = 0; i < n; i++) {
+      double cbest = -1.0;
+      size_t kbest = 0;
+      for (size_t k = 0; k < m; k++) {
+        double c = closest_op(&P[4*i], &R[4*k], ops, kop);
+        if (c > cbest) {
+          cbest = c;
+          kbest = k;
+        }
+      }
+      dist[i] = half_cos_to_angle(cbest);
+      if (assign[i] != kbest) {
+        assign[i] = kbest;
+        changed = true;
+      }
+    }
+    return changed;
+  };
+
+  // Lloyd iterations
+  std::vector<double> mean(4*m);
+  std::vector<double> cweight(m);
+  bool converged = false;
+  for (int it = 0; it < miter; it++) {
+    if (not assign_closest()) {
+      converged = true;
+      break;
+    }
+
+    // Weighted chordal mean of the nearest symmetric equivalents
+    std::fill(mean.begin(), mean.end(), 0.0);
+    std::fill(cweight.begin(), cweight.end(), 0.0);
+    for (size_t i = 0; i < n; i++) {
+      size_t k = assign[i];
+      closest_op(&P[4*i], &R[4*k], ops, kop);
+      double q[4];
+      qmul(&ops[4*kop], &P[4*i], q);
+      double sgn = (dot_vec(q, &R[4*k], 4) < 0.0) ? -1.0 : 1.0;
+      for (int j = 0; j < 4; j++) mean[4*k+j] += sgn * w[i] * q[j];
+      cweight[k] += w[i];
+    }
+    for (size_t k = 0; k < m; k++) {
+      double nm = norm2_vec(&mean[4*k], 4);
+      if ((cweight[k] > 0.0) and (nm > 0.0)) {
+        for (int j = 0; j < 4; j++) R[4*k+j] = mean[4*k+j] / nm;
+      }
+      else {
+        // Restart an empty cluster at the worst fit orientation
+        size_t worst = std::max_element(dist.begin(), dist.end())
+            - dist.begin();
+        std::copy(&P[4*worst], &P[4*worst] + 4, &R[4*k]);
+        dist[worst] = 0.0;
+      }
+    }
+  }
+
+  // Stopping at miter leaves the assignment one update behind the
+  // representatives
+  if (not converged) assign_closest();
+
+  ReducedTexture res;
+  res.assignment = assign;
+  res.weights.assign(m, 0.0);
+  for (size_t i = 0; i < n; i++) res.weights[assign[i]] += w[i] / total;
+  for (size_t k = 0; k < m; k++) {
+    std::vector<double> rk(&R[4*k], &R[4*k] + 4);
+    res.orientations.push_back(Orientation(rk).inverse());
+  }
+  res.max_disorientation = *std::max_element(dist.begin(), dist.end());
+
+  return res;
+}
+
+} // namespace neml
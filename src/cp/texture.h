@@ -0,0 +1,149 @@
+#ifndef TEXTURE_H
+#define TEXTURE_H
+
+#include "../objects.h"
+#include "../math/rotations.h"
+#include "crystallography.h"
+
+#include "../windows.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace neml {
+
+/// Orientation distribution function that can be sampled
+//  Orientations are active rotations (crystal to lab), the same
+//  convention as the qs given to the polycrystal models.  Sampling from
+//  a seed gives the same orientations every time.
+class NEML_EXPORT OrientationDistribution: public NEMLObject {
+ public:
+  virtual ~OrientationDistribution() {};
+
+  /// Draw a single orientation
+  virtual Orientation draw(std::mt19937_64 & rng) const = 0;
+
+  /// Draw n orientations, reproducibly from a seed
+  std::vector<Orientation> sample(size_t n, unsigned long seed) const;
+};
+
+/// Uniform distribution over all orientations
+class NEML_EXPORT UniformDistribution: public OrientationDistribution {
+ public:
+  UniformDistribution();
+
+  /// String type for the object system
+  static std::string type();
+  /// Initialize from parameter set
+  static std::unique_ptr<NEMLObject> initialize(ParameterSet & params);
+  /// Default parameters
+  static ParameterSet parameters();
+
+  virtual Orientation draw(std::mt19937_64 & rng) const;
+};
+
+static Register<UniformDistribution> regUniformDistribution;
+
+/// Orientations scattered about a single preferred orientation
+//  The misorientation from the center is a rotation vector with
+//  normally distributed components with standard deviation width
+//  (radians)
+class NEML_EXPORT UnimodalDistribution: public OrientationDistribution {
+ public:
+  UnimodalDistribution(std::shared_ptr<Orientation> center, double width);
+
+  /// String type for the object system
+  static std::string type();
+  /// Initialize from parameter set
+  static std::unique_ptr<NEMLObject> initialize(ParameterSet & params);
+  /// Default parameters
+  static ParameterSet parameters();
+
+  virtual Orientation draw(std::mt19937_64 & rng) const;
+
+ private:
+  std::shared_ptr<Orientation> center_;
+  double width_;
+};
+
+static Register<UnimodalDistribution> regUnimodalDistribution;
+
+/// Fiber texture: crystal direction h along sample direction y
+//  Orientations are uniform about the fiber axis and scattered off it
+//  in the same way as UnimodalDistribution
+class NEML_EXPORT FiberDistribution: public OrientationDistribution {
+ public:
+  FiberDistribution(std::vector<double> h, std::vector<double> y,
+                    double width);
+
+  /// String type for the object system
+  static std::string type();
+  /// Initialize from parameter set
+  static std::unique_ptr<NEMLObject> initialize(ParameterSet & params);
+  /// Default parameters
+  static ParameterSet parameters();
+
+  virtual Orientation draw(std::mt19937_64 & rng) const;
+
+ private:
+  Vector y_;
+  Orientation base_;
+  double width_;
+};
+
+static Register<FiberDistribution> regFiberDistribution;
+
+/// Weighted mixture of other distributions
+class NEML_EXPORT MixtureDistribution: public OrientationDistribution {
+ public:
+  MixtureDistribution(
+      std::vector<std::shared_ptr<OrientationDistribution>> components,
+      std::vector<double> weights);
+
+  /// String type for the object system
+  static std::string type();
+  /// Initialize from parameter set
+  static std::unique_ptr<NEMLObject> initialize(ParameterSet & params);
+  /// Default parameters
+  static ParameterSet parameters();
+
+  virtual Orientation draw(std::mt19937_64 & rng) const;
+
+ private:
+  std::vector<std::shared_ptr<OrientationDistribution>> components_;
+  std::vector<double> cumulative_;
+};
+
+static Register<MixtureDistribution> regMixtureDistribution;
+
+/// Weighted representative orientations for a texture
+struct NEML_EXPORT ReducedTexture {
+  /// Representative orientations
+  std::vector<Orientation> orientations;
+  /// Weight of each representative, summing to one
+  std::vector<double> weights;
+  /// Representative for each of the original orientations
+  std::vector<size_t> assignment;
+  /// Largest disorientation (radians) of an orientation from its
+  /// representative
+  double max_disorientation;
+};
+
+/// Cluster n weighted orientations into m representative orientations
+//  A weighted k-means on the disorientation angle, seeded with k-means++
+//  from a reproducible generator.  Each representative is the weighted
+//  mean of its cluster after moving each member to the symmetric
+//  equivalent nearest the representative, and carries the total weight
+//  of the cluster.  The disorientation is the angle of
+//  SymmetryGroup::misorientation applied in the passive convention.
+//  Empty weights means equal weights.
+NEML_EXPORT ReducedTexture reduce_texture(
+    const std::vector<Orientation> & orientations,
+    const std::vector<double> & weights, const SymmetryGroup & symmetry,
+    size_t m, unsigned long seed = 0, int miter = 100);
+
+} // namespace neml
+
+#endif // TEXTURE_H
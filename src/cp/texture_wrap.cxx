@@ -0,0 +1,69 @@
+#include "../pyhelp.h" // include first to avoid redef warning
+
+#include "texture.h"
+
+namespace py = pybind11;
+
+PYBIND11_DECLARE_HOLDER_TYPE(T, std::shared_ptr<T>)
+
+namespace neml {
+
+PYBIND11_MODULE(texture, m) {
+  py::module::import("neml.objects");
+  py::module::import("neml.math.rotations");
+  py::module::import("neml.cp.crystallography");
+
+  m.doc() = "Sampling and reducing crystallographic textures";
+
+  py::class_<OrientationDistribution, NEMLObject, std::shared_ptr<OrientationDistribution>>(m, "OrientationDistribution")
+      .def("sample", &OrientationDistribution::sample,
+           py::arg("n"), py::arg("seed") = 0,
+           "Draw n orientations, reproducibly from a seed")
+      ;
+
+  py::class_<UniformDistribution, OrientationDistribution, std::shared_ptr<UniformDistribution>>(m, "UniformDistribution")
+      .def(py::init([](py::args args, py::kwargs kwargs)
+                    {
+                      return create_object_python<UniformDistribution>(
+                          args, kwargs, {});
+                    }))
+      ;
+
+  py::class_<UnimodalDistribution, OrientationDistribution, std::shared_ptr<UnimodalDistribution>>(m, "UnimodalDistribution")
+      .def(py::init([](py::args args, py::kwargs kwargs)
+                    {
+                      return create_object_python<UnimodalDistribution>(
+                          args, kwargs, {"center", "width"});
+                    }))
+      ;
+
+  py::class_<FiberDistribution, OrientationDistribution, std::shared_ptr<FiberDistribution>>(m, "FiberDistribution")
+      .def(py::init([](py::args args, py::kwargs kwargs)
+                    {
+                      return create_object_python<FiberDistribution>(
+                          args, kwargs, {"h", "y", "width"});
+                    }))
+      ;
+
+  py::class_<MixtureDistribution, OrientationDistribution, std::shared_ptr<MixtureDistribution>>(m, "MixtureDistribution")
+      .def(py::init([](py::args args, py::kwargs kwargs)
+                    {
+                      return create_object_python<MixtureDistribution>(
+                          args, kwargs, {"components", "weights"});
+                    }))
+      ;
+
+  py::class_<ReducedTexture>(m, "ReducedTexture")
+      .def_readonly("orientations", &ReducedTexture::orientations)
+      .def_readonly("weights", &ReducedTexture::weights)
+      .def_readonly("assignment", &ReducedTexture::assignment)
+      .def_readonly("max_disorientation", &ReducedTexture::max_disorientation)
+      ;
+
+  m.def("reduce_texture", &reduce_texture,
+        py::arg("orientations"), py::arg("weights"), py::arg("symmetry"),
+        py::arg("m"), py::arg("seed") = 0, py::arg("miter") = 100,
+        "Cluster weighted orientations into m representative orientations");
+}
+
+}
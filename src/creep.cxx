@@ -730,7 +730,7 @@ size_t CreepModel::nparams() const
   return 6; // the creep strain
 }
 
-int CreepModel::init_x(double * const x, TrialState * ts)
+int CreepModel::init_x(double * const x, TrialState * ts) const
 {
   CreepModelTrialState * tss = static_cast<CreepModelTrialState *>(ts);
 
@@ -740,7 +740,7 @@ int CreepModel::init_x(double * const x, TrialState * ts)
 }
 
 int CreepModel::RJ(const double * const x, TrialState * ts, 
-                     double * const R, double * const J)
+                     double * const R, double * const J) const
 {
   CreepModelTrialState * tss = static_cast<CreepModelTrialState *>(ts);
   
@@ -760,7 +760,7 @@ int CreepModel::RJ(const double * const x, TrialState * ts,
 
 // Helper for tangent
 int CreepModel::calc_tangent_(const double * const e_np1, 
-                              CreepModelTrialState & ts, double * const A_np1)
+                              CreepModelTrialState & ts, double * const A_np1) const
 {
   int ier;
   double R[6];
@@ -387,14 +387,14 @@ class NEML_EXPORT CreepModel: public NEMLObject, public Solvable {
   /// Number of solver parameters
   virtual size_t nparams() const;
   /// Setup the initial guess for the solver
-  virtual int init_x(double * const x, TrialState * ts);
+  virtual int init_x(double * const x, TrialState * ts) const;
   /// The nonlinear residual and jacobian to solve
   virtual int RJ(const double * const x, TrialState * ts, double * const R,
-                 double * const J);
+                 double * const J) const;
 
  private:
   int calc_tangent_(const double * const e_np1, CreepModelTrialState & ts,
-                    double * const A_np1);
+                    double * const A_np1) const;
 
  protected:
   const double tol_;
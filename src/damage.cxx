@@ -1,5 +1,6 @@
 #include "damage.h"
 #include "elasticity.h"
+#include "trace.h"
 
 #include <cmath>
 
@@ -54,8 +55,9 @@ int NEMLScalarDamagedModel_sd::update_sd(
     double * const h_np1, const double * const h_n,
     double * const A_np1,
     double & u_np1, double u_n,
-    double & p_np1, double p_n)
+    double & p_np1, double p_n) const
 {
+  NEML_TRACE_SCOPE("update_sd");
   if (ekill_ and (h_n[0] >= dkill_)) {
     return ekill_update_(T_np1, e_np1, s_np1, h_np1, h_n, A_np1, u_np1, u_n, p_np1, p_n);
   }
@@ -68,7 +70,8 @@ int NEMLScalarDamagedModel_sd::update_sd(
   // Call solve
   std::vector<double> xv(nparams());
   double * x = &xv[0];
-  ier = solve(this, x, &tss, tol_, miter_, verbose_);
+  ier = solve(this, x, &tss, tol_, miter_, verbose_, false, nullptr,
+              nullptr, nullptr, local_solver_stats_());
   if (ier != SUCCESS) return ier;
   
   // Do actual stress update
@@ -117,7 +120,7 @@ size_t NEMLScalarDamagedModel_sd::nparams() const
   return 7;
 }
 
-int NEMLScalarDamagedModel_sd::init_x(double * const x, TrialState * ts)
+int NEMLScalarDamagedModel_sd::init_x(double * const x, TrialState * ts) const
 {
   SDTrialState * tss = static_cast<SDTrialState *>(ts);
   std::copy(tss->s_n, tss->s_n+6, x);
@@ -127,40 +130,22 @@ int NEMLScalarDamagedModel_sd::init_x(double * const x, TrialState * ts)
 }
 
 int NEMLScalarDamagedModel_sd::RJ(const double * const x, TrialState * ts, 
-                                  double * const R, double * const J)
+                                  double * const R, double * const J) const
 {
   SDTrialState * tss = static_cast<SDTrialState *>(ts);
+  double s_prime_np1[6];
+  int res = residual_(x, tss, R, s_prime_np1);
+  if (res != SUCCESS) return res;
+
   const double * s_curr = x;
   double w_curr = x[6];
   double s_prime_curr[6];
   for (int i=0; i<6; i++)  s_prime_curr[i] = s_curr[i] / (1-w_curr);
 
-  int res;
-  double s_prime_np1[6];
   double s_prime_n[6];
-  double A_prime_np1[36];
-  std::vector<double> h_np1_v(base_->nhist());
-  double * h_np1 = &h_np1_v[0];
-  double u_np1;
-  double p_np1;
-  
   std::copy(tss->s_n, tss->s_n+6, s_prime_n);
   for (int i=0; i<6; i++) s_prime_n[i] /= (1-tss->w_n);
 
-  res = base_->update_sd(tss->e_np1, tss->e_n, tss->T_np1, tss->T_n,
-                   tss->t_np1, tss->t_n, s_prime_np1, s_prime_n,
-                   h_np1, &tss->h_n[0],
-                   A_prime_np1, u_np1, tss->u_n, p_np1, tss->p_n);
-  if (res != SUCCESS) return res;
-  
-  for (int i=0; i<6; i++) R[i] = s_curr[i] - (1-w_curr) * s_prime_np1[i];
-
-  double w_np1;
-  res = damage(w_curr, tss->w_n, tss->e_np1, tss->e_n, s_prime_curr, s_prime_n,
-         tss->T_np1, tss->T_n, tss->t_np1, tss->t_n, &w_np1);
-  if (res != SUCCESS) return res;
-  R[6] = w_curr - w_np1;
-
   std::fill(J, J+49, 0.0);
   for (int i=0; i<6; i++) {
     J[CINDEX(i,i,7)] = 1.0; 
@@ -189,12 +174,58 @@ int NEMLScalarDamagedModel_sd::RJ(const double * const x, TrialState * ts,
   return 0;
 }
 
+int NEMLScalarDamagedModel_sd::R(const double * const x, TrialState * ts, 
+                                 double * const R) const
+{
+  SDTrialState * tss = static_cast<SDTrialState *>(ts);
+  double s_prime_np1[6];
+  return residual_(x, tss, R, s_prime_np1);
+}
+
+int NEMLScalarDamagedModel_sd::residual_(const double * const x,
+                                         SDTrialState * tss,
+                                         double * const R,
+                                         double * const s_prime_np1) const
+{
+  const double * s_curr = x;
+  double w_curr = x[6];
+  double s_prime_curr[6];
+  for (int i=0; i<6; i++)  s_prime_curr[i] = s_curr[i] / (1-w_curr);
+
+  int res;
+  double s_prime_n[6];
+  double A_prime_np1[36];
+  std::vector<double> h_np1_v(base_->nhist());
+  double * h_np1 = &h_np1_v[0];
+  double u_np1;
+  double p_np1;
+  
+  std::copy(tss->s_n, tss->s_n+6, s_prime_n);
+  for (int i=0; i<6; i++) s_prime_n[i] /= (1-tss->w_n);
+
+  res = base_->update_sd(tss->e_np1, tss->e_n, tss->T_np1, tss->T_n,
+                   tss->t_np1, tss->t_n, s_prime_np1, s_prime_n,
+                   h_np1, &tss->h_n[0],
+                   A_prime_np1, u_np1, tss->u_n, p_np1, tss->p_n);
+  if (res != SUCCESS) return res;
+  
+  for (int i=0; i<6; i++) R[i] = s_curr[i] - (1-w_curr) * s_prime_np1[i];
+
+  double w_np1;
+  res = damage(w_curr, tss->w_n, tss->e_np1, tss->e_n, s_prime_curr, s_prime_n,
+         tss->T_np1, tss->T_n, tss->t_np1, tss->t_n, &w_np1);
+  if (res != SUCCESS) return res;
+  R[6] = w_curr - w_np1;
+
+  return 0;
+}
+
 int NEMLScalarDamagedModel_sd::make_trial_state(
     const double * const e_np1, const double * const e_n,
     double T_np1, double T_n, double t_np1, double t_n,
     const double * const s_n, const double * const h_n,
     double u_n, double p_n,
-    SDTrialState & tss)
+    SDTrialState & tss) const
 {
   std::copy(e_np1, e_np1+6, tss.e_np1);
   std::copy(e_n, e_n+6, tss.e_n);
@@ -217,7 +248,7 @@ int NEMLScalarDamagedModel_sd::tangent_(
     const double * const s_np1, const double * const s_n,
     double T_np1, double T_n, double t_np1, double t_n,
     double w_np1, double w_n, const double * const A_prime,
-    double * const A)
+    double * const A) const
 {
   double s_prime_np1[6];
   for (int i=0; i<6; i++) s_prime_np1[i] = s_np1[i] / (1.0 - w_np1);
@@ -263,7 +294,7 @@ int NEMLScalarDamagedModel_sd::ekill_update_(double T_np1,
                                              const double * const h_n,
                                              double * const A_np1, 
                                              double & u_np1, double u_n,
-                                             double & p_np1, double p_n)
+                                             double & p_np1, double p_n) const
 {
   std::copy(h_n, h_n + nhist(), h_np1);
   h_np1[0] = 1.0;
@@ -785,34 +816,16 @@ int MaxPrincipalEffectiveStress::effective(const double * const s, double & eff)
 
 int MaxPrincipalEffectiveStress::deffective(const double * const s, double * const deff) const
 {
-  double vectors[9];
   double values[3];
-  int ier = eigenvalues_sym(s, values);
+  double dvalues[18];
+  int ier = eigenvalue_derivatives_sym(s, values, dvalues);
 
   if (values[2] < 0.0) {
     std::fill(deff, deff+6, 0.0);
-    return 0.0;
-  }
-
-  ier = eigenvectors_sym(s, vectors);
-  double * v = &(vectors[6]);
-
-  double full[9];
-  double nf = 0.0;
-  for (int i=0; i<3; i++) {
-    nf += v[i] * v[i];
-    for (int j=0; j<3; j++) {
-      full[CINDEX(i,j,3)] = v[i]*v[j];
-    }
-  }
-
-  if (nf != 0) {
-    for (int i=0; i<9; i++) {
-      full[i] /= nf;
-    }
+    return ier;
   }
 
-  sym(full, deff);
+  std::copy(&dvalues[CINDEX(2,0,6)], &dvalues[CINDEX(2,0,6)]+6, deff);
 
   return ier;
 }
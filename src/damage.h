@@ -36,7 +36,7 @@ class NEML_EXPORT NEMLDamagedModel_sd: public NEMLModel_sd {
       double * const h_np1, const double * const h_n,
       double * const A_np1,
       double & u_np1, double u_n,
-      double & p_np1, double p_n) = 0;
+      double & p_np1, double p_n) const = 0;
 
   /// Number of damage variables
   virtual size_t ndamage() const = 0;
@@ -84,7 +84,7 @@ class NEML_EXPORT NEMLScalarDamagedModel_sd: public NEMLDamagedModel_sd, public
       double * const h_np1, const double * const h_n,
       double * const A_np1,
       double & u_np1, double u_n,
-      double & p_np1, double p_n);
+      double & p_np1, double p_n) const;
 
   /// Equal to 1
   virtual size_t ndamage() const;
@@ -94,16 +94,19 @@ class NEML_EXPORT NEMLScalarDamagedModel_sd: public NEMLDamagedModel_sd, public
   /// Number of parameters for the solver
   virtual size_t nparams() const;
   /// Initialize the solver vector
-  virtual int init_x(double * const x, TrialState * ts);
+  virtual int init_x(double * const x, TrialState * ts) const;
   /// The actual nonlinear residual and Jacobian to solve
   virtual int RJ(const double * const x, TrialState * ts,double * const R,
-                 double * const J);
+                 double * const J) const;
+  /// The nonlinear residual alone
+  virtual int R(const double * const x, TrialState * ts,
+                double * const R) const;
   /// Setup a trial state from known information
   int make_trial_state(const double * const e_np1, const double * const e_n,
                        double T_np1, double T_n, double t_np1, double t_n,
                        const double * const s_n, const double * const h_n,
                        double u_n, double p_n,
-                       SDTrialState & tss);
+                       SDTrialState & tss) const;
 
   /// The scalar damage model
   virtual int damage(double d_np1, double d_n,
@@ -135,17 +138,19 @@ class NEML_EXPORT NEMLScalarDamagedModel_sd: public NEMLDamagedModel_sd, public
                      double * const dd) const = 0;
 
  protected:
+  int residual_(const double * const x, SDTrialState * tss,
+                double * const R, double * const s_prime_np1) const;
   int tangent_(const double * const e_np1, const double * const e_n,
                const double * const s_np1, const double * const s_n,
                double T_np1, double T_n, double t_np1, double t_n,
                double w_np1, double w_n, const double * const A_prime,
-               double * const A);
+               double * const A) const;
   int ekill_update_(double T_np1, const double * const e_np1, 
                     double * const s_np1, 
                     double * const h_np1, const double * const h_n,
                     double * A_np1, 
                     double & u_np1, double u_n, 
-                    double & p_np1, double p_n);
+                    double & p_np1, double p_n) const;
 
  protected:
   double tol_;
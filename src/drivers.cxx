@@ -0,0 +1,1320 @@
+#include "drivers.h"
+
+#include "math/nemlmath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace neml {
+
+/// Plain or backtracking Newton-Raphson, matching neml.nlsolvers.newton
+static int driver_newton(DriverRJ & RJ, size_t n, double * const x,
+                         double rtol, double atol, int miter,
+                         bool linesearch, bool verbose)
+{
+  std::vector<double> R(n), J(n*n), a(n), xt(n), Rt(n), Jt(n*n), Ja(n);
+
+  int ier = RJ(x, &R[0], &J[0]);
+  if (ier != SUCCESS) return ier;
+
+  double nR = norm2_vec(&R[0], n);
+  double nR0 = nR;
+  int i = 0;
+
+  if (verbose) {
+    std::cout << "Iter.\tnR\t\tnR/nR0" << std::endl;
+    std::cout << i << "\t" << nR << "\t" << 1.0 << std::endl;
+  }
+
+  while ((nR > rtol * nR0) && (nR > atol)) {
+    std::copy(R.begin(), R.end(), a.begin());
+    ier = solve_mat(&J[0], n, &a[0]);
+    if (ier != SUCCESS) return ier;
+
+    double f = 1.0;
+    if (linesearch) {
+      // Backtracking along -a, with tau = 0.5 and c = 1.0e-4
+      const double tau = 0.5;
+      const double c = 1.0e-4;
+      for (size_t k = 0; k < n; k++) a[k] = -a[k];
+      mat_vec(&J[0], n, &a[0], n, &Ja[0]);
+      int nback = 0;
+      while (true) {
+        for (size_t k = 0; k < n; k++) xt[k] = x[k] + f * a[k];
+        ier = RJ(&xt[0], &Rt[0], &Jt[0]);
+        if (ier != SUCCESS) return ier;
+        double cv = norm2_vec(&Rt[0], n);
+        for (size_t k = 0; k < n; k++) Rt[k] = R[k] + c * f * Ja[k];
+        if (not (cv > norm2_vec(&Rt[0], n))) break;
+        f *= tau;
+        if (++nback > 100) return MAX_ITERATIONS;
+      }
+      for (size_t k = 0; k < n; k++) a[k] = -a[k];
+    }
+
+    for (size_t k = 0; k < n; k++) x[k] -= a[k] * f;
+    ier = RJ(x, &R[0], &J[0]);
+    if (ier != SUCCESS) return ier;
+    nR = norm2_vec(&R[0], n);
+    i++;
+
+    if (verbose) {
+      std::cout << i << "\t" << nR << "\t" << nR / nR0 << "\t" << f
+          << std::endl;
+    }
+
+    if (i > miter) return MAX_ITERATIONS;
+  }
+
+  return SUCCESS;
+}
+
+/// numpy.linspace
+static std::vector<double> linspace(double start, double stop, int num)
+{
+  std::vector<double> y(num);
+  if (num == 1) {
+    y[0] = start;
+    return y;
+  }
+  double div = num - 1;
+  double delta = stop - start;
+  double step = delta / div;
+  for (int i = 0; i < num; i++) {
+    if (step == 0.0) y[i] = i / div * delta + start;
+    else y[i] = i * step + start;
+  }
+  if (num > 1) y[num-1] = stop;
+  return y;
+}
+
+/// numpy.logspace, base 10
+static std::vector<double> logspace(double start, double stop, int num)
+{
+  std::vector<double> y = linspace(start, stop, num);
+  for (auto & yi : y) yi = std::pow(10.0, yi);
+  return y;
+}
+
+Driver_sd::Driver_sd(std::shared_ptr<NEMLModel> model, double T_init,
+                     bool verbose, double rtol, double atol, int miter,
+                     bool no_thermal_strain) :
+    model_(model), verbose_(verbose), rtol_(rtol), atol_(atol),
+    miter_(miter), nts_(no_thermal_strain),
+    strain_(6, 0.0), mstrain_(6, 0.0), tstrain_(6, 0.0), stress_(6, 0.0),
+    stored_(model->nstore()), T_({T_init}), t_({0.0}), u_({0.0}),
+    p_({0.0}), h_trial_(model->nstore())
+{
+  int ier = model_->init_store(&stored_[0]);
+  if (ier != SUCCESS) {
+    throw std::runtime_error("Could not initialize the model history");
+  }
+}
+
+int Driver_sd::set_initial_history(const double * const hist)
+{
+  std::copy(hist, hist + nstore(), stored_.begin());
+  return SUCCESS;
+}
+
+size_t Driver_sd::nsteps() const
+{
+  return t_.size();
+}
+
+size_t Driver_sd::nstore() const
+{
+  return model_->nstore();
+}
+
+void Driver_sd::update_thermal_strain_(double T_np1,
+                                       double * const enext) const
+{
+  if (nts_) {
+    std::fill(enext, enext + 6, 0.0);
+    return;
+  }
+  double T_n = T_.back();
+  double dT = T_np1 - T_n;
+  double a_np1 = model_->alpha(T_np1);
+  double a_n = model_->alpha(T_n);
+
+  const double * const eth_n = &tstrain_[tstrain_.size()-6];
+  for (int i = 0; i < 6; i++) {
+    enext[i] = eth_n[i] + ((i < 3) ? dT * (a_np1 + a_n) / 2 : 0.0);
+  }
+}
+
+int Driver_sd::trial_(const double * const e_np1, const double * const enext,
+                      double t_np1, double T_np1)
+{
+  double em[6];
+  for (int i = 0; i < 6; i++) em[i] = e_np1[i] - enext[i];
+
+  return model_->update_sd(em, &mstrain_[mstrain_.size()-6],
+                           T_np1, T_.back(), t_np1, t_.back(),
+                           s_trial_, stress_n(), &h_trial_[0], stored_n(),
+                           A_trial_, u_trial_, u_.back(),
+                           p_trial_, p_.back());
+}
+
+void Driver_sd::commit_(const double * const e_np1,
+                        const double * const enext,
+                        double t_np1, double T_np1)
+{
+  double e[6], em[6], eth[6];
+  for (int i = 0; i < 6; i++) {
+    e[i] = e_np1[i];
+    eth[i] = enext[i];
+    em[i] = e[i] - eth[i];
+  }
+
+  strain_.insert(strain_.end(), e, e + 6);
+  mstrain_.insert(mstrain_.end(), em, em + 6);
+  tstrain_.insert(tstrain_.end(), eth, eth + 6);
+  stress_.insert(stress_.end(), s_trial_, s_trial_ + 6);
+  stored_.insert(stored_.end(), h_trial_.begin(), h_trial_.end());
+  T_.push_back(T_np1);
+  t_.push_back(t_np1);
+  u_.push_back(u_trial_);
+  p_.push_back(p_trial_);
+}
+
+int Driver_sd::solve_try_(DriverRJ RJ, size_t n, double * const x,
+                          const std::vector<double> & extra)
+{
+  // Each successful solve ends with a call to RJ at the solution, so
+  // the trial state is left at the converged values
+  std::vector<std::vector<double>> guesses;
+  guesses.emplace_back(x, x + n);
+  for (size_t i = 0; i < extra.size() / n; i++) {
+    guesses.emplace_back(extra.begin() + i * n, extra.begin() + (i+1) * n);
+  }
+
+  for (auto & xi : guesses) {
+    for (bool linesearch : {false, true}) {
+      std::copy(xi.begin(), xi.end(), x);
+      int ier = driver_newton(RJ, n, x, rtol_, atol_, miter_, linesearch,
+                              verbose_);
+      if (ier == SUCCESS) return SUCCESS;
+    }
+  }
+
+  return MAX_ITERATIONS;
+}
+
+int Driver_sd::strain_step(const double * const e_np1, double t_np1,
+                           double T_np1)
+{
+  double enext[6];
+  update_thermal_strain_(T_np1, enext);
+
+  int ier = trial_(e_np1, enext, t_np1, T_np1);
+  if (ier != SUCCESS) return ier;
+
+  commit_(e_np1, enext, t_np1, T_np1);
+
+  return SUCCESS;
+}
+
+int Driver_sd::stress_step(const double * const s_np1, double t_np1,
+                           double T_np1)
+{
+  double enext[6];
+  update_thermal_strain_(T_np1, enext);
+
+  double s_target[6];
+  std::copy(s_np1, s_np1 + 6, s_target);
+
+  DriverRJ RJ = [&](const double * const e, double * const R,
+                    double * const J) -> int
+  {
+    int ier = trial_(e, enext, t_np1, T_np1);
+    if (ier != SUCCESS) return ier;
+    for (int i = 0; i < 6; i++) R[i] = s_trial_[i] - s_target[i];
+    std::copy(A_trial_, A_trial_ + 36, J);
+    return SUCCESS;
+  };
+
+  double x[6];
+  std::copy(strain_n(), strain_n() + 6, x);
+
+  std::vector<double> extra;
+  if (nsteps() > 1) {
+    const double * const e_nm1 = &strain_[strain_.size()-12];
+    for (int i = 0; i < 6; i++) {
+      extra.push_back(strain_n()[i] + (strain_n()[i] - e_nm1[i]));
+    }
+  }
+
+  int ier = solve_try_(RJ, 6, x, extra);
+  if (ier != SUCCESS) return ier;
+
+  commit_(x, enext, t_np1, T_np1);
+
+  return SUCCESS;
+}
+
+int Driver_sd::erate_step(const double * const sdir_in, double erate,
+                          double t_np1, double T_np1, double * const einc,
+                          double & ainc, bool guess)
+{
+  double sdir[6];
+  double ns = norm2_vec(sdir_in, 6);
+  for (int i = 0; i < 6; i++) sdir[i] = sdir_in[i] / ns;
+
+  double dt = t_np1 - t_n();
+  double enext[6];
+  update_thermal_strain_(T_np1, enext);
+
+  double e_n[6], s_n[6];
+  std::copy(strain_n(), strain_n() + 6, e_n);
+  std::copy(stress_n(), stress_n() + 6, s_n);
+
+  DriverRJ RJ = [&](const double * const x, double * const R,
+                    double * const J) -> int
+  {
+    double a = x[0];
+    double e[6];
+    for (int i = 0; i < 6; i++) e[i] = e_n[i] + x[i+1];
+    int ier = trial_(e, enext, t_np1, T_np1);
+    if (ier != SUCCESS) return ier;
+
+    for (int i = 0; i < 6; i++) R[i] = s_trial_[i] - (sdir[i] * a + s_n[i]);
+    R[6] = dot_vec(&x[1], sdir, 6) / dt - erate;
+
+    std::fill(J, J + 49, 0.0);
+    for (int i = 0; i < 6; i++) {
+      J[CINDEX(i,0,7)] = -sdir[i];
+      for (int j = 0; j < 6; j++) {
+        J[CINDEX(i,(j+1),7)] = A_trial_[CINDEX(i,j,6)];
+      }
+      J[CINDEX(6,(i+1),7)] = sdir[i] / dt;
+    }
+    return SUCCESS;
+  };
+
+  double x[7];
+  if (guess) {
+    x[0] = ainc;
+    std::copy(einc, einc + 6, &x[1]);
+  }
+  else {
+    x[0] = 1.0;
+    for (int i = 0; i < 6; i++) x[i+1] = sdir[i] / 10000.0;
+  }
+
+  int ier = solve_try_(RJ, 7, x);
+  if (ier != SUCCESS) return ier;
+
+  double e_np1[6];
+  for (int i = 0; i < 6; i++) e_np1[i] = e_n[i] + x[i+1];
+  commit_(e_np1, enext, t_np1, T_np1);
+
+  std::copy(&x[1], &x[7], einc);
+  ainc = x[0];
+
+  return SUCCESS;
+}
+
+int Driver_sd::erate_einc_step(const double * const sdir, double erate,
+                               double einc, double T_np1,
+                               double * const einc_v, double & ainc,
+                               bool guess)
+{
+  double dt = einc / erate;
+  return erate_step(sdir, erate, t_n() + dt, T_np1, einc_v, ainc, guess);
+}
+
+int Driver_sd::srate_sinc_step(const double * const sdir, double srate,
+                               double sinc, double T_np1)
+{
+  double s_np1[6];
+  bool zero = true;
+  for (int i = 0; i < 6; i++) zero = zero && (std::fabs(sdir[i]) <= 1.0e-8);
+
+  double ns = norm2_vec(sdir, 6);
+  for (int i = 0; i < 6; i++) {
+    if (zero) s_np1[i] = stress_n()[i];
+    else s_np1[i] = stress_n()[i] + sdir[i] / ns * sinc;
+  }
+
+  double dt;
+  if (isclose(srate, 0.0)) dt = 0.0;
+  else {
+    double ds[6];
+    for (int i = 0; i < 6; i++) ds[i] = s_np1[i] - stress_n()[i];
+    dt = std::fabs(dot_vec(ds, sdir, 6) / srate);
+  }
+
+  return stress_step(s_np1, t_n() + dt, T_np1);
+}
+
+int Driver_sd::strain_hold_step(int i, double t_np1, double T_np1, double q,
+                                double E)
+{
+  if (not isclose(q, 1.0) and isclose(E, -1.0)) {
+    throw std::invalid_argument("You must supply the Youngs modulus");
+  }
+
+  double enext[6];
+  update_thermal_strain_(T_np1, enext);
+
+  int oset[5];
+  for (int j = 0, k = 0; j < 6; j++) {
+    if (j != i) oset[k++] = j;
+  }
+
+  double e_n[6], s_n[6];
+  std::copy(strain_n(), strain_n() + 6, e_n);
+  std::copy(stress_n(), stress_n() + 6, s_n);
+
+  DriverRJ RJ = [&](const double * const e, double * const R,
+                    double * const J) -> int
+  {
+    int ier = trial_(e, enext, t_np1, T_np1);
+    if (ier != SUCCESS) return ier;
+
+    R[0] = (e[i] - e_n[i]) + (s_trial_[i] - s_n[i]) / E * (q - 1);
+    for (int k = 0; k < 5; k++) R[k+1] = s_trial_[oset[k]] - s_n[oset[k]];
+
+    for (int j = 0; j < 6; j++) {
+      J[CINDEX(0,j,6)] = A_trial_[CINDEX(i,j,6)] / E * (q - 1);
+      for (int k = 0; k < 5; k++) {
+        J[CINDEX((k+1),j,6)] = A_trial_[CINDEX(oset[k],j,6)];
+      }
+    }
+    J[CINDEX(0,i,6)] += 1.0;
+    return SUCCESS;
+  };
+
+  double x[6];
+  std::copy(e_n, e_n + 6, x);
+
+  int ier = solve_try_(RJ, 6, x);
+  if (ier != SUCCESS) return ier;
+
+  commit_(x, enext, t_np1, T_np1);
+
+  return SUCCESS;
+}
+
+int Driver_sd::jump_step(const double * const s_np1,
+                         const double * const h_np1, double t_np1,
+                         double u_np1, double p_np1)
+{
+  double e[6], eth[6];
+  std::copy(strain_n(), strain_n() + 6, e);
+  std::copy(tstrain_.end() - 6, tstrain_.end(), eth);
+
+  std::copy(s_np1, s_np1 + 6, s_trial_);
+  std::copy(h_np1, h_np1 + nstore(), h_trial_.begin());
+  u_trial_ = u_np1;
+  p_trial_ = p_np1;
+
+  commit_(e, eth, t_np1, T_.back());
+
+  return SUCCESS;
+}
+
+/// Linear interpolation on sorted data
+static double interp(const std::vector<double> & x,
+                     const std::vector<double> & y, double xi)
+{
+  size_t j = std::upper_bound(x.begin(), x.end(), xi) - x.begin();
+  if (j == 0) j = 1;
+  if (j >= x.size()) j = x.size() - 1;
+  double dx = x[j] - x[j-1];
+  if (dx == 0.0) return y[j];
+  return y[j-1] + (y[j] - y[j-1]) * (xi - x[j-1]) / dx;
+}
+
+/// Offset yield stress, or infinity if the offset line doesn't intersect
+static double offset_yield(const std::vector<double> & strain,
+                           const std::vector<double> & stress,
+                           double E, double offset)
+{
+  size_t n = strain.size();
+  std::vector<size_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                   return std::fabs(strain[a]) < std::fabs(strain[b]);});
+  std::vector<double> x(n), y(n);
+  for (size_t i = 0; i < n; i++) {
+    x[i] = std::fabs(strain[order[i]]);
+    y[i] = std::fabs(stress[order[i]]);
+  }
+
+  double b = *std::max_element(strain.begin(), strain.end());
+  auto f = [&](double e) { return interp(x, y, e) - E * (e - offset); };
+
+  double fa = f(0.0);
+  double fb = f(b);
+  if ((fa * fb > 0.0) or (b > x.back()) or std::isnan(fa * fb)) {
+    return std::numeric_limits<double>::infinity();
+  }
+  if (fa == 0.0) return E * (0.0 - offset);
+  if (fb == 0.0) return E * (b - offset);
+
+  // The function is linear between data points, so bracket and solve
+  std::vector<double> nodes = {0.0};
+  for (auto xi : x) if ((xi > 0.0) && (xi < b)) nodes.push_back(xi);
+  nodes.push_back(b);
+  for (size_t i = 1; i < nodes.size(); i++) {
+    double f0 = f(nodes[i-1]);
+    double f1 = f(nodes[i]);
+    if (f1 == 0.0) return E * (nodes[i] - offset);
+    if (f0 * f1 < 0.0) {
+      double e = nodes[i-1] - f0 * (nodes[i] - nodes[i-1]) / (f1 - f0);
+      return E * (e - offset);
+    }
+  }
+
+  return std::numeric_limits<double>::infinity();
+}
+
+int uniaxial_test(std::shared_ptr<NEMLModel> model, double erate,
+                  UniaxialTestResults & res, double T, double emax,
+                  int nsteps, const std::vector<double> & sdir,
+                  double offset, const std::vector<double> & history,
+                  const std::vector<double> & tdir)
+{
+  double e_inc = emax / nsteps;
+  Driver_sd driver(model, T);
+  if (history.size() > 0) {
+    if (history.size() != model->nstore()) return INCOMPATIBLE_VECTORS;
+    driver.set_initial_history(&history[0]);
+  }
+
+  res.strain = {0.0};
+  res.stress = {0.0};
+
+  double einc[6];
+  double ainc;
+  for (int i = 0; i < nsteps; i++) {
+    int ier = driver.erate_einc_step(&sdir[0], erate, e_inc, T, einc, ainc,
+                                     i > 0);
+    if (ier != SUCCESS) return ier;
+    res.strain.push_back(dot_vec(driver.strain_n(), &sdir[0], 6));
+    res.stress.push_back(dot_vec(driver.stress_n(), &sdir[0], 6));
+  }
+
+  res.youngs = std::fabs(res.stress[1]) / std::fabs(res.strain[1]);
+  const double * const e1 = &driver.strain()[6];
+  res.poissons = -dot_vec(e1, &tdir[0], 6) / dot_vec(e1, &sdir[0], 6);
+  res.yield = offset_yield(res.strain, res.stress, res.youngs, offset);
+
+  res.energy_density = driver.u();
+  res.plastic_work = driver.p();
+
+  return SUCCESS;
+}
+
+/// Increments shrinking faster than this are treated as a decaying transient
+static const double cycle_decay = 0.9;
+
+/// Extrapolate a quantity k cycles past its values at the end of the last
+/// three cycles, x1 being the most recent
+//  Increments that shrink geometrically follow the geometric series,
+//  so the jump does not overshoot the transient, anything else is linear
+static double cycle_extrapolate(double x1, double x2, double x3, int k)
+{
+  double d1 = x1 - x2;
+  double d2 = x2 - x3;
+  if (std::fabs(d1) < cycle_decay * std::fabs(d2)) {
+    double r = d1 / d2;
+    return x1 + d1 * r * (1.0 - std::pow(r, k)) / (1.0 - r);
+  }
+  return x1 + k * d1;
+}
+
+/// Largest number of cycles to extrapolate over, zero if the state has
+/// not stabilized
+//  ends has the end states of the last three integrated cycles, range
+//  the variation of each variable over the last cycle.  Decaying
+//  variables must have nearly settled, for the others the error estimated
+//  from the second difference must be small.  Both are relative to
+//  jump_tol times the size of the variable.
+static int cycle_jump(const std::vector<std::vector<double>> & ends,
+                      const std::vector<double> & range, size_t ncheck,
+                      size_t istress, double jump_tol, double jump_stress,
+                      int max_jump)
+{
+  const std::vector<double> & e1 = ends[ends.size()-1];
+  const std::vector<double> & e2 = ends[ends.size()-2];
+  const std::vector<double> & e3 = ends[ends.size()-3];
+
+  // The stress components share a scale so that components that should be
+  // zero, but are not quite because of the solver tolerance, do not count
+  double sscale = 0.0;
+  for (size_t i = 0; i < 6; i++) {
+    sscale = std::max(sscale, std::fabs(e1[i]) + range[i]);
+  }
+
+  double k = max_jump;
+  for (size_t i = 0; i < ncheck; i++) {
+    double d1 = e1[i] - e2[i];
+    double d2 = e2[i] - e3[i];
+    double dd = d1 - d2;
+    if (not std::isfinite(dd)) return 0;
+    if (dd == 0.0) continue;
+    double tol = jump_tol * ((i < 6) ? sscale : std::fabs(e1[i]) + range[i]);
+    if (tol == 0.0) return 0;
+
+    if (std::fabs(d1) < cycle_decay * std::fabs(d2)) {
+      // The rest of the transient
+      double r = std::fabs(d1 / d2);
+      if (std::fabs(d1) * r / (1.0 - r) > tol) return 0;
+    }
+    else {
+      // Linear extrapolation over k cycles misses k(k+1)/2 second differences
+      double c = 2.0 * tol / std::fabs(dd);
+      k = std::min(k, std::floor((std::sqrt(1.0 + 4.0 * c) - 1.0) / 2.0));
+    }
+  }
+
+  for (int j = 1; j <= k; j++) {
+    double ds = cycle_extrapolate(e1[istress], e2[istress], e3[istress], j)
+        - e1[istress];
+    if (std::fabs(ds) > jump_stress) return j - 1;
+  }
+
+  return (int) k;
+}
+
+/// Strain controlled cycles, jumping ahead if max_jump > 0
+static int strain_cyclic_(std::shared_ptr<NEMLModel> model, double emax,
+                          double R, double erate, int ncycles,
+                          CyclicTestResults & res, double T, int nsteps,
+                          const std::vector<double> & sdir,
+                          const std::vector<double> & hold_time, int n_hold,
+                          bool check_dmg, double dtol, int min_cycle,
+                          int max_jump, double jump_tol, double jump_stress)
+{
+  Driver_sd driver(model, T);
+  double emin = emax * R;
+  double hold[2] = {0.0, 0.0};
+  if (hold_time.size() > 0) {
+    hold[0] = hold_time[0];
+    hold[1] = hold_time.size() > 1 ? hold_time[1] : hold_time[0];
+  }
+  std::vector<double> rdir(6);
+  for (int i = 0; i < 6; i++) rdir[i] = -sdir[i];
+
+  res = CyclicTestResults();
+  res.strain = {0.0};
+  res.stress = {0.0};
+  res.time = {0.0};
+
+  double einc[6];
+  double ainc;
+
+  // Check damage and store the step
+  auto record = [&](double dt) -> int
+  {
+    if (check_dmg && (driver.stored_n()[0] > dtol)) return DAMAGE_EXCEEDED;
+    res.strain.push_back(dot_vec(driver.strain_n(), &sdir[0], 6));
+    res.stress.push_back(dot_vec(driver.stress_n(), &sdir[0], 6));
+    res.time.push_back(res.time.back() + dt);
+    return SUCCESS;
+  };
+
+  // Strain ramp, reversing the previous increment as the first guess
+  auto ramp = [&](const std::vector<double> & dir, double e_inc) -> int
+  {
+    for (int i = 0; i < nsteps; i++) {
+      if (i == 0) {
+        for (int j = 0; j < 6; j++) einc[j] = -einc[j];
+        ainc = -ainc;
+      }
+      int ier = driver.erate_einc_step(&dir[0], erate, e_inc, T, einc, ainc,
+                                       true);
+      if (ier != SUCCESS) return ier;
+      ier = record(e_inc / erate);
+      if (ier != SUCCESS) return ier;
+    }
+    return SUCCESS;
+  };
+
+  // Hold at zero strain rate
+  auto hold_step = [&](double ht) -> int
+  {
+    double dt = ht / n_hold;
+    for (int i = 0; i < n_hold; i++) {
+      std::fill(einc, einc + 6, 0.0);
+      ainc = -1.0;
+      int ier = driver.erate_step(&sdir[0], 0.0, res.time.back() + dt, T,
+                                  einc, ainc, true);
+      if (ier != SUCCESS) return ier;
+      ier = record(dt);
+      if (ier != SUCCESS) return ier;
+    }
+    return SUCCESS;
+  };
+
+  // First half cycle
+  double e_inc = emax / nsteps;
+  for (int i = 0; i < nsteps; i++) {
+    int ier = driver.erate_einc_step(&sdir[0], erate, e_inc, T, einc, ainc,
+                                     i > 0);
+    if (ier != SUCCESS) return ier;
+    ier = record(e_inc / erate);
+    if (ier != SUCCESS) return ier;
+  }
+
+  // State at the end of each cycle since the last jump, the stress in
+  // sdir is appended to the stress and history so the jump criteria
+  // can see it
+  size_t nh = driver.nstore();
+  size_t nstate = 6 + nh + 1 + 2;
+  std::vector<std::vector<double>> ends;
+  std::vector<double> range(nstate);
+  auto cycle_end = [&]() -> std::vector<double>
+  {
+    std::vector<double> e(driver.stress_n(), driver.stress_n() + 6);
+    e.insert(e.end(), driver.stored_n(), driver.stored_n() + nh);
+    e.push_back(res.stress.back());
+    e.push_back(driver.u().back());
+    e.push_back(driver.p().back());
+    return e;
+  };
+  double period = 2.0 * std::fabs(emax - emin) / erate + hold[0] + hold[1];
+  int nint = 0;
+
+  // Cycle until done or the model fails
+  for (int s = 0; s < ncycles; s++) {
+    if ((max_jump > 0) && (nint >= min_cycle) && (ends.size() >= 3)) {
+      int k = std::min(cycle_jump(ends, range, 6 + nh, 6 + nh, jump_tol,
+                                  jump_stress, max_jump), ncycles - s);
+      if (k >= 2) {
+        std::vector<double> e(nstate);
+        for (size_t i = 0; i < nstate; i++) {
+          e[i] = cycle_extrapolate(ends[2][i], ends[1][i], ends[0][i], k);
+        }
+
+        if (not (check_dmg && (e[6] > dtol))) {
+          driver.jump_step(&e[0], &e[6], res.time.back() + k * period,
+                           e[nstate-2], e[nstate-1]);
+          if (record(k * period) != SUCCESS) break;
+
+          size_t n = res.max.size();
+          s += k - 1;
+          res.cycles.push_back(s);
+          res.max.push_back(cycle_extrapolate(res.max[n-1], res.max[n-2],
+                                              res.max[n-3], k));
+          res.min.push_back(cycle_extrapolate(res.min[n-1], res.min[n-2],
+                                              res.min[n-3], k));
+          res.mean.push_back((res.max.back() + res.min.back()) / 2);
+          res.energy_density.push_back(driver.u().back());
+          res.plastic_work.push_back(driver.p().back());
+          res.extrapolated.push_back(1);
+
+          ends.clear();
+          continue;
+        }
+      }
+    }
+
+    if ((hold[0] > 0.0) && (hold_step(hold[0]) != SUCCESS)) break;
+
+    size_t si = driver.nsteps();
+    if (ramp(rdir, std::fabs(emin - emax) / nsteps) != SUCCESS) break;
+
+    if ((hold[1] > 0.0) && (hold_step(hold[1]) != SUCCESS)) break;
+
+    if (ramp(sdir, std::fabs(emax - emin) / nsteps) != SUCCESS) break;
+
+    auto first = res.stress.begin() + si;
+    if (std::any_of(first, res.stress.end(),
+                    [](double v) {return std::isnan(v);})) break;
+
+    res.cycles.push_back(s);
+    res.max.push_back(*std::max_element(first, res.stress.end()));
+    res.min.push_back(*std::min_element(first, res.stress.end()));
+    res.mean.push_back((res.max.back() + res.min.back()) / 2);
+    res.energy_density.push_back(driver.u().back());
+    res.plastic_work.push_back(driver.p().back());
+    res.extrapolated.push_back(0);
+    nint++;
+
+    if (max_jump > 0) {
+      std::vector<double> lower = cycle_end();
+      std::vector<double> upper = lower;
+      for (size_t j = si; j < driver.nsteps(); j++) {
+        for (size_t i = 0; i < 6; i++) {
+          lower[i] = std::min(lower[i], driver.stress()[j*6+i]);
+          upper[i] = std::max(upper[i], driver.stress()[j*6+i]);
+        }
+        for (size_t i = 0; i < nh; i++) {
+          lower[6+i] = std::min(lower[6+i], driver.stored()[j*nh+i]);
+          upper[6+i] = std::max(upper[6+i], driver.stored()[j*nh+i]);
+        }
+      }
+      for (size_t i = 0; i < nstate; i++) range[i] = upper[i] - lower[i];
+
+      ends.push_back(cycle_end());
+      if (ends.size() > 3) ends.erase(ends.begin());
+    }
+  }
+
+  res.history.assign(driver.stored_n(), driver.stored_n() + driver.nstore());
+
+  return SUCCESS;
+}
+
+int strain_cyclic(std::shared_ptr<NEMLModel> model, double emax, double R,
+                  double erate, int ncycles, CyclicTestResults & res,
+                  double T, int nsteps, const std::vector<double> & sdir,
+                  const std::vector<double> & hold_time, int n_hold,
+                  bool check_dmg, double dtol)
+{
+  return strain_cyclic_(model, emax, R, erate, ncycles, res, T, nsteps, sdir,
+                        hold_time, n_hold, check_dmg, dtol, 0, 0, 0.0, 0.0);
+}
+
+int strain_cyclic_extrapolated(std::shared_ptr<NEMLModel> model, double emax,
+                               double R, double erate, int ncycles,
+                               CyclicTestResults & res, double T, int nsteps,
+                               const std::vector<double> & sdir,
+                               const std::vector<double> & hold_time,
+                               int n_hold, bool check_dmg, double dtol,
+                               int min_cycle, int max_jump, double jump_tol,
+                               double jump_stress)
+{
+  if (min_cycle < 2) {
+    throw std::invalid_argument("Need at least two cycles before a jump");
+  }
+  return strain_cyclic_(model, emax, R, erate, ncycles, res, T, nsteps, sdir,
+                        hold_time, n_hold, check_dmg, dtol, min_cycle,
+                        max_jump, jump_tol, jump_stress);
+}
+
+int strain_cyclic_followup(std::shared_ptr<NEMLModel> model, double emax,
+                           double R, double erate, int ncycles,
+                           CyclicTestResults & res, double q, double T,
+                           int nsteps, int sind,
+                           const std::vector<double> & hold_time, int n_hold,
+                           bool check_dmg, double dtol, bool logspace)
+{
+  if ((sind < 0) || (sind > 5)) {
+    throw std::invalid_argument("sind must be between 0 and 5");
+  }
+  std::vector<double> sdir(6, 0.0);
+  sdir[sind] = 1.0;
+  std::vector<double> rdir(6, 0.0);
+  rdir[sind] = -1.0;
+
+  UniaxialTestResults ures;
+  int ier = uniaxial_test(model, erate, ures, T, 1.0e-4, 2);
+  if (ier != SUCCESS) return ier;
+  double E = ures.youngs;
+
+  Driver_sd driver(model, T);
+  double emin = emax * R;
+  double hold[2] = {0.0, 0.0};
+  if (hold_time.size() > 0) {
+    hold[0] = hold_time[0];
+    hold[1] = hold_time.size() > 1 ? hold_time[1] : hold_time[0];
+  }
+
+  res = CyclicTestResults();
+  res.strain = {0.0};
+  res.stress = {0.0};
+  res.time = {0.0};
+
+  double einc[6];
+  double ainc;
+
+  auto record = [&](double dt) -> int
+  {
+    if (check_dmg && (driver.stored_n()[0] > dtol)) return DAMAGE_EXCEEDED;
+    res.strain.push_back(dot_vec(driver.strain_n(), &sdir[0], 6));
+    res.stress.push_back(dot_vec(driver.stress_n(), &sdir[0], 6));
+    res.time.push_back(res.time.back() + dt);
+    return SUCCESS;
+  };
+
+  // Strain ramp, starting from no strain and a stress increment of a0
+  auto ramp = [&](const std::vector<double> & dir, double a0,
+                  double e_inc) -> int
+  {
+    for (int i = 0; i < nsteps; i++) {
+      if (i == 0) {
+        std::fill(einc, einc + 6, 0.0);
+        ainc = a0;
+      }
+      int ier = driver.erate_einc_step(&dir[0], erate, e_inc, T, einc, ainc,
+                                       true);
+      if (ier != SUCCESS) return ier;
+      ier = record(e_inc / erate);
+      if (ier != SUCCESS) return ier;
+    }
+    return SUCCESS;
+  };
+
+  // Hold strain component sind with follow up
+  auto hold_step = [&](double ht) -> int
+  {
+    std::vector<double> dts;
+    if (logspace) {
+      std::vector<double> ts = neml::logspace(0, std::log10(ht), n_hold+1);
+      for (int i = 0; i < n_hold; i++) dts.push_back(ts[i+1] - ts[i]);
+    }
+    else {
+      dts.assign(n_hold, ht / n_hold);
+    }
+    for (auto dt : dts) {
+      int ier = driver.strain_hold_step(sind, res.time.back() + dt, T, q, E);
+      if (ier != SUCCESS) return ier;
+      ier = record(dt);
+      if (ier != SUCCESS) return ier;
+    }
+    return SUCCESS;
+  };
+
+  // First half cycle
+  double e_inc = emax / nsteps;
+  for (int i = 0; i < nsteps; i++) {
+    ier = driver.erate_einc_step(&sdir[0], erate, e_inc, T, einc, ainc,
+                                 i > 0);
+    if (ier != SUCCESS) return ier;
+    ier = record(e_inc / erate);
+    if (ier != SUCCESS) return ier;
+  }
+
+  // Cycle until done or the model fails
+  for (int s = 0; s < ncycles; s++) {
+    if ((hold[0] > 0.0) && (hold_step(hold[0]) != SUCCESS)) break;
+
+    size_t si = driver.nsteps();
+    if (ramp(rdir, -1.0, std::fabs(emin - emax) / nsteps) != SUCCESS) break;
+
+    if ((hold[1] > 0.0) && (hold_step(hold[1]) != SUCCESS)) break;
+
+    if (ramp(sdir, 1.0, std::fabs(emax - emin) / nsteps) != SUCCESS) break;
+
+    auto first = res.stress.begin() + si;
+    if (std::any_of(first, res.stress.end(),
+                    [](double v) {return std::isnan(v);})) break;
+
+    res.cycles.push_back(s);
+    res.max.push_back(*std::max_element(first, res.stress.end()));
+    res.min.push_back(*std::min_element(first, res.stress.end()));
+    res.mean.push_back((res.max.back() + res.min.back()) / 2);
+    res.energy_density.push_back(driver.u().back());
+    res.plastic_work.push_back(driver.p().back());
+  }
+
+  res.history.assign(driver.stored_n(), driver.stored_n() + driver.nstore());
+
+  return SUCCESS;
+}
+
+int stress_cyclic(std::shared_ptr<NEMLModel> model, double smax, double R,
+                  double srate, int ncycles, CyclicTestResults & res,
+                  double T, int nsteps, const std::vector<double> & sdir,
+                  const std::vector<double> & hold_time, int n_hold,
+                  double etol)
+{
+  Driver_sd driver(model, T);
+  double smin = smax * R;
+  double hold[2] = {0.0, 0.0};
+  if (hold_time.size() > 0) {
+    hold[0] = hold_time[0];
+    hold[1] = hold_time.size() > 1 ? hold_time[1] : hold_time[0];
+  }
+
+  res = CyclicTestResults();
+  res.strain = {0.0};
+  res.stress = {0.0};
+
+  // Check the strain increment and store the step
+  auto record = [&]() -> int
+  {
+    const double * const e_np1 = driver.strain_n();
+    const double * const e_n = e_np1 - 6;
+    double de[6];
+    for (int i = 0; i < 6; i++) de[i] = e_np1[i] - e_n[i];
+    if (norm2_vec(de, 6) > etol) return MAX_ITERATIONS;
+    res.strain.push_back(dot_vec(driver.strain_n(), &sdir[0], 6));
+    res.stress.push_back(dot_vec(driver.stress_n(), &sdir[0], 6));
+    return SUCCESS;
+  };
+
+  auto ramp = [&](double s_inc) -> int
+  {
+    for (int i = 0; i < nsteps; i++) {
+      int ier = driver.srate_sinc_step(&sdir[0], srate, s_inc, T);
+      if (ier != SUCCESS) return ier;
+      ier = record();
+      if (ier != SUCCESS) return ier;
+    }
+    return SUCCESS;
+  };
+
+  auto hold_step = [&](double ht) -> int
+  {
+    double dt = ht / n_hold;
+    for (int i = 0; i < n_hold; i++) {
+      int ier = driver.stress_step(driver.stress_n(), driver.t_n() + dt, T);
+      if (ier != SUCCESS) return ier;
+      ier = record();
+      if (ier != SUCCESS) return ier;
+    }
+    return SUCCESS;
+  };
+
+  // First half cycle
+  double s_inc = smax / nsteps;
+  for (int i = 0; i < nsteps; i++) {
+    int ier = driver.srate_sinc_step(&sdir[0], srate, s_inc, T);
+    if (ier != SUCCESS) return ier;
+    res.strain.push_back(dot_vec(driver.strain_n(), &sdir[0], 6));
+    res.stress.push_back(dot_vec(driver.stress_n(), &sdir[0], 6));
+  }
+
+  for (int s = 0; s < ncycles; s++) {
+    size_t si = driver.nsteps();
+    if ((hold[0] > 0.0) && (hold_step(hold[0]) != SUCCESS)) break;
+    if (ramp((smin - smax) / nsteps) != SUCCESS) break;
+    if ((hold[1] > 0.0) && (hold_step(hold[1]) != SUCCESS)) break;
+    if (ramp((smax - smin) / nsteps) != SUCCESS) break;
+
+    auto first = res.strain.begin() + si;
+    res.cycles.push_back(s);
+    res.max.push_back(*std::max_element(first, res.strain.end()));
+    res.min.push_back(*std::min_element(first, res.strain.end()));
+    res.mean.push_back((res.max.back() + res.min.back()) / 2);
+    res.energy_density.push_back(driver.u().back());
+    res.plastic_work.push_back(driver.p().back());
+  }
+
+  res.time = driver.t();
+
+  return SUCCESS;
+}
+
+int stress_relaxation(std::shared_ptr<NEMLModel> model, double emax,
+                      double erate, double hold, StressRelaxationResults & res,
+                      double T, int nsteps, int nsteps_up, int index,
+                      double tc, bool logspace, double q)
+{
+  Driver_sd driver(model, T);
+  res.time = {0.0};
+  res.strain = {0.0};
+  res.stress = {0.0};
+
+  UniaxialTestResults ures;
+  int ier = uniaxial_test(model, erate, ures, T, 1.0e-4, 2);
+  if (ier != SUCCESS) return ier;
+  double E = ures.youngs;
+
+  // Ramp up
+  std::vector<double> sdir(6, 0.0);
+  sdir[index] = tc;
+  double einc = emax / nsteps_up;
+  double eincg[6];
+  double ainc;
+  for (int i = 0; i < nsteps_up; i++) {
+    ier = driver.erate_einc_step(&sdir[0], erate, einc, T, eincg, ainc,
+                                 i > 0);
+    if (ier != SUCCESS) return ier;
+    res.time.push_back(driver.t_n());
+    res.strain.push_back(dot_vec(driver.strain_n(), &sdir[0], 6));
+    res.stress.push_back(dot_vec(driver.stress_n(), &sdir[0], 6));
+  }
+
+  size_t ri = driver.nsteps();
+
+  // Hold
+  std::vector<double> dts;
+  if (logspace) {
+    std::vector<double> ts = neml::logspace(0, std::log10(hold), nsteps+1);
+    for (int i = 0; i < nsteps; i++) dts.push_back(ts[i+1] - ts[i]);
+  }
+  else {
+    dts.assign(nsteps, hold / nsteps);
+  }
+  for (auto dt : dts) {
+    ier = driver.strain_hold_step(index, driver.t_n() + dt, T, q, E);
+    if (ier != SUCCESS) return ier;
+    res.time.push_back(driver.t_n());
+    res.strain.push_back(dot_vec(driver.strain_n(), &sdir[0], 6));
+    res.stress.push_back(dot_vec(driver.stress_n(), &sdir[0], 6));
+  }
+
+  res.rtime.clear();
+  res.rrate.clear();
+  res.rstress.clear();
+  res.rstrain.clear();
+  for (size_t i = ri; i + 1 < res.time.size(); i++) {
+    res.rtime.push_back(res.time[i] - res.time[ri]);
+    res.rrate.push_back(-(res.stress[i+1] - res.stress[i]) /
+                        (res.time[i+1] - res.time[i]));
+    res.rstress.push_back(res.stress[i]);
+    res.rstrain.push_back(res.strain[i]);
+  }
+
+  return SUCCESS;
+}
+
+int creep(std::shared_ptr<NEMLModel> model, double smax, double srate,
+          double hold, CreepResults & res, double T, int nsteps,
+          int nsteps_up, const std::vector<double> & sdir, bool logspace,
+          const std::vector<double> & history, double elimit, bool check_dmg,
+          double dtol)
+{
+  Driver_sd driver(model, T);
+  if (history.size() > 0) {
+    if (history.size() != model->nstore()) return INCOMPATIBLE_VECTORS;
+    driver.set_initial_history(&history[0]);
+  }
+  res.time = {0.0};
+  res.strain = {0.0};
+  res.stress = {0.0};
+
+  // Ramp up
+  double sinc = smax / nsteps_up;
+  for (int i = 0; i < nsteps_up; i++) {
+    int ier = driver.srate_sinc_step(&sdir[0], srate, sinc, T);
+    if (ier != SUCCESS) return ier;
+    res.time.push_back(driver.t_n());
+    res.strain.push_back(dot_vec(driver.strain_n(), &sdir[0], 6));
+    res.stress.push_back(dot_vec(driver.stress_n(), &sdir[0], 6));
+  }
+
+  size_t ri = driver.nsteps();
+
+  double t0 = res.time.back();
+  std::vector<double> ts;
+  if (logspace) ts = neml::logspace(0, std::log10(hold), nsteps);
+  else ts = linspace(0, hold, nsteps);
+  for (auto & t : ts) t += t0;
+
+  // Hold, stopping without an error if the model fails
+  res.failed = false;
+  for (auto t : ts) {
+    double s[6];
+    std::copy(driver.stress_n(), driver.stress_n() + 6, s);
+    if (driver.stress_step(s, t, T) != SUCCESS) {
+      res.failed = true;
+      break;
+    }
+    const double * const e = driver.strain_n();
+    if (std::any_of(e, e + 6, [](double v) {return std::isnan(v);}) or
+        std::any_of(e, e + 6,
+                    [elimit](double v) {return std::fabs(v) > elimit;})) {
+      res.failed = true;
+      break;
+    }
+    double ed = dot_vec(e, &sdir[0], 6);
+    if (ed < res.strain.back()) {
+      res.failed = true;
+      break;
+    }
+    if (check_dmg && (driver.stored_n()[0] > dtol)) {
+      res.failed = true;
+      break;
+    }
+
+    res.time.push_back(t);
+    res.strain.push_back(ed);
+    res.stress.push_back(dot_vec(driver.stress_n(), &sdir[0], 6));
+  }
+
+  res.rtime.clear();
+  res.rrate.clear();
+  res.rstrain.clear();
+  res.tstrain.clear();
+  for (size_t i = ri; i + 1 < res.time.size(); i++) {
+    res.rrate.push_back((res.strain[i+1] - res.strain[i]) /
+                        (res.time[i+1] - res.time[i]));
+    res.rtime.push_back(res.time[i] - res.time[ri]);
+    res.rstrain.push_back(res.strain[i] - res.strain[ri]);
+    res.tstrain.push_back(res.strain[i]);
+  }
+
+  return SUCCESS;
+}
+
+int rate_jump_test(std::shared_ptr<NEMLModel> model,
+                   const std::vector<double> & erates, RateJumpResults & res,
+                   double T, double e_per, int nsteps_per,
+                   const std::vector<double> & sdir,
+                   const std::vector<double> & history,
+                   const std::vector<double> & strains)
+{
+  if ((strains.size() > 0) && (strains.size() != erates.size())) {
+    throw std::invalid_argument("Need one strain rate for each strain");
+  }
+
+  Driver_sd driver(model, T);
+  if (history.size() > 0) {
+    if (history.size() != model->nstore()) return INCOMPATIBLE_VECTORS;
+    driver.set_initial_history(&history[0]);
+  }
+
+  res.strain = {0.0};
+  res.stress = {0.0};
+
+  double einc[6];
+  double ainc;
+  auto step = [&](double erate, double e_inc, bool guess) -> int
+  {
+    int ier = driver.erate_einc_step(&sdir[0], erate, e_inc, T, einc, ainc,
+                                     guess);
+    if (ier != SUCCESS) return ier;
+    res.strain.push_back(dot_vec(driver.strain_n(), &sdir[0], 6));
+    res.stress.push_back(dot_vec(driver.stress_n(), &sdir[0], 6));
+    return SUCCESS;
+  };
+
+  if (strains.size() == 0) {
+    double e_inc = e_per / nsteps_per;
+    for (auto erate : erates) {
+      for (int i = 0; i < nsteps_per; i++) {
+        int ier = step(erate, e_inc, i > 0);
+        if (ier != SUCCESS) return ier;
+      }
+    }
+  }
+  else {
+    double e_prev = 0.0;
+    for (size_t j = 0; j < strains.size(); j++) {
+      double e_inc = (strains[j] - e_prev) / nsteps_per;
+      e_prev = strains[j];
+      while (res.strain.back() < strains[j]) {
+        int ier = step(erates[j], e_inc, false);
+        if (ier != SUCCESS) return ier;
+      }
+    }
+  }
+
+  res.energy_density = driver.u();
+  res.plastic_work = driver.p();
+
+  return SUCCESS;
+}
+
+int thermomechanical_strain_raw(std::shared_ptr<NEMLModel> model,
+                                const std::vector<double> & time,
+                                const std::vector<double> & temperature,
+                                const std::vector<double> & strain,
+                                ThermomechanicalResults & res,
+                                const std::vector<double> & sdir,
+                                int substep)
+{
+  size_t n = time.size();
+  if ((n == 0) || (temperature.size() != n) || (strain.size() != n)) {
+    throw std::invalid_argument("time, temperature, and strain must have "
+                                "the same, nonzero, length");
+  }
+
+  Driver_sd driver(model, temperature[0]);
+  res.stress = {0.0};
+  res.mechanical_strain = {0.0};
+
+  double einc[6];
+  double ainc;
+  size_t i;
+  for (i = 1; i < n; i++) {
+    int ier = SUCCESS;
+    for (int k = 0; (k < substep) && (ier == SUCCESS); k++) {
+      double de = (strain[i] - strain[i-1]) / substep;
+      double dt = (time[i] - time[i-1]) / substep;
+      double dT = (temperature[i] - temperature[i-1]) / substep;
+
+      double ei_np1 = de * (k+1) + strain[i-1];
+      double ti_np1 = dt * (k+1) + time[i-1];
+      double Ti_np1 = dT * (k+1) + temperature[i-1];
+      double ei_n = de * k + strain[i-1];
+      double ti_n = dt * k + time[i-1];
+
+      double erate = (ei_np1 - ei_n) / (ti_np1 - ti_n);
+      ier = driver.erate_step(&sdir[0], erate, ti_np1, Ti_np1, einc, ainc,
+                              i > 1);
+    }
+    if (ier != SUCCESS) break;
+
+    const double * const em = &driver.mechanical_strain().end()[-6];
+    res.stress.push_back(dot_vec(driver.stress_n(), &sdir[0], 6));
+    res.mechanical_strain.push_back(dot_vec(em, &sdir[0], 6));
+  }
+
+  res.time.assign(time.begin(), time.begin() + i);
+  res.temperature.assign(temperature.begin(), temperature.begin() + i);
+  res.strain.assign(strain.begin(), strain.begin() + i);
+
+  return SUCCESS;
+}
+
+int isochronous_curve(std::shared_ptr<NEMLModel> model, double time,
+                      IsochronousResults & res, double T, double emax,
+                      double srate, double ds, int max_cut, int nsteps,
+                      const std::vector<double> & history, bool check_dmg,
+                      double dtol)
+{
+  // Strain at the end of a creep test, false if the test did not run
+  auto creep_strain = [&](double stress, double & e, bool & failed) -> bool
+  {
+    CreepResults cres;
+    if (creep(model, stress, srate, time, cres, T, nsteps, 150,
+              {1,0,0,0,0,0}, false, history, 1.0, check_dmg,
+              dtol) != SUCCESS) return false;
+    if (cres.tstrain.size() == 0) return false;
+    e = cres.tstrain.back();
+    failed = cres.failed;
+    return true;
+  };
+
+  res.strain = {0.0};
+  res.stress = {0.0};
+  int ncut = 0;
+  bool failed = false;
+  while (res.strain.back() < emax) {
+    double target = res.stress.back() + ds;
+    double e;
+    if (creep_strain(target, e, failed)) {
+      if (failed) break;
+      res.stress.push_back(target);
+      res.strain.push_back(e);
+    }
+    else {
+      ncut++;
+      if (ncut > max_cut) {
+        // The steps were quite large, so assume the curve goes flat
+        res.stress.push_back(res.stress.back());
+        res.strain.push_back(emax);
+        break;
+      }
+      ds /= 2;
+    }
+  }
+
+  if (failed) {
+    res.stress.push_back(res.stress.back());
+    res.strain.push_back(emax);
+  }
+
+  // Interpolate the last point back to emax
+  size_t n = res.strain.size();
+  std::vector<size_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                   return res.strain[a] < res.strain[b];});
+  std::vector<double> x(n), y(n);
+  for (size_t i = 0; i < n; i++) {
+    x[i] = res.strain[order[i]];
+    y[i] = res.stress[order[i]];
+  }
+  res.stress.back() = interp(x, y, emax);
+  res.strain.back() = emax;
+
+  return SUCCESS;
+}
+
+} // namespace neml
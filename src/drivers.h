@@ -0,0 +1,282 @@
+#ifndef DRIVERS_H
+#define DRIVERS_H
+
+#include "models.h"
+
+#include "nemlerror.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "windows.h"
+
+namespace neml {
+
+/// Residual and jacobian function for the driver nonlinear solves
+typedef std::function<int(const double * const, double * const,
+                          double * const)> DriverRJ;
+
+/// Small strain driver, a native version of neml.drivers.Driver_sd
+//  Keeps the full history of the load path.  The time-dependent
+//  quantities are stored flattened, one row per step, i.e. strain() is
+//  (nsteps,6) and stored() is (nsteps,nstore).
+//
+//  All the step methods return an error code and only add a step to
+//  the history if the update succeeded.
+class NEML_EXPORT Driver_sd {
+ public:
+  Driver_sd(std::shared_ptr<NEMLModel> model, double T_init = 0.0,
+            bool verbose = false, double rtol = 1.0e-6,
+            double atol = 1.0e-10, int miter = 25,
+            bool no_thermal_strain = false);
+
+  /// Replace the initial internal variables, e.g. to start damaged
+  int set_initial_history(const double * const hist);
+
+  /// Strain controlled step
+  int strain_step(const double * const e_np1, double t_np1, double T_np1);
+  /// Stress controlled step
+  int stress_step(const double * const s_np1, double t_np1, double T_np1);
+  /// Drive in a stress direction at a prescribed strain rate
+  //  On input einc and ainc are the guesses for the strain and stress
+  //  increments, if guess is true, on output they are the converged values
+  int erate_step(const double * const sdir, double erate, double t_np1,
+                 double T_np1, double * const einc, double & ainc,
+                 bool guess = false);
+  /// As erate_step, but give the strain increment instead of the time
+  int erate_einc_step(const double * const sdir, double erate, double einc,
+                      double T_np1, double * const einc_v, double & ainc,
+                      bool guess = false);
+  /// Stress controlled step given the stress rate and increment
+  int srate_sinc_step(const double * const sdir, double srate, double sinc,
+                      double T_np1);
+  /// Hold strain component i, keeping the other stresses constant
+  //  q is the follow up factor, which requires Young's modulus E
+  int strain_hold_step(int i, double t_np1, double T_np1, double q = 1.0,
+                       double E = -1.0);
+  /// Add a step with the given state at the current strain and temperature
+  //  Used to skip ahead over a block of extrapolated cycles
+  int jump_step(const double * const s_np1, const double * const h_np1,
+                double t_np1, double u_np1, double p_np1);
+
+  /// Number of steps stored, including the initial state
+  size_t nsteps() const;
+  /// Number of stored variables per step
+  size_t nstore() const;
+
+  /// Total strain
+  const std::vector<double> & strain() const {return strain_;};
+  /// Mechanical strain
+  const std::vector<double> & mechanical_strain() const {return mstrain_;};
+  /// Thermal strain
+  const std::vector<double> & thermal_strain() const {return tstrain_;};
+  /// Stress
+  const std::vector<double> & stress() const {return stress_;};
+  /// Stored variables
+  const std::vector<double> & stored() const {return stored_;};
+  /// Temperature
+  const std::vector<double> & T() const {return T_;};
+  /// Time
+  const std::vector<double> & t() const {return t_;};
+  /// Strain energy density
+  const std::vector<double> & u() const {return u_;};
+  /// Plastic dissipation
+  const std::vector<double> & p() const {return p_;};
+
+  /// Last strain
+  const double * strain_n() const {return &strain_[strain_.size()-6];};
+  /// Last stress
+  const double * stress_n() const {return &stress_[stress_.size()-6];};
+  /// Last stored variables
+  const double * stored_n() const {return &stored_[stored_.size()-nstore()];};
+  /// Last time
+  double t_n() const {return t_.back();};
+
+ private:
+  void update_thermal_strain_(double T_np1, double * const enext) const;
+  int trial_(const double * const e_np1, const double * const enext,
+             double t_np1, double T_np1);
+  void commit_(const double * const e_np1, const double * const enext,
+               double t_np1, double T_np1);
+  int solve_try_(DriverRJ RJ, size_t n, double * const x,
+                 const std::vector<double> & extra = {});
+
+ private:
+  std::shared_ptr<NEMLModel> model_;
+  bool verbose_;
+  double rtol_, atol_;
+  int miter_;
+  bool nts_;
+
+  std::vector<double> strain_, mstrain_, tstrain_, stress_, stored_;
+  std::vector<double> T_, t_, u_, p_;
+
+  // Results of the last trial update
+  double s_trial_[6];
+  std::vector<double> h_trial_;
+  double A_trial_[36];
+  double u_trial_, p_trial_;
+};
+
+/// Results of a uniaxial_test
+struct NEML_EXPORT UniaxialTestResults {
+  std::vector<double> strain, stress, energy_density, plastic_work;
+  double youngs, yield, poissons;
+};
+
+/// Results of a strain_cyclic or stress_cyclic test
+//  For strain control max/min/mean are stresses, for stress control strains
+struct NEML_EXPORT CyclicTestResults {
+  std::vector<double> strain, stress, time;
+  std::vector<int> cycles;
+  std::vector<double> max, min, mean, energy_density, plastic_work;
+  std::vector<double> history;
+  std::vector<int> extrapolated;
+};
+
+/// Results of a stress_relaxation test
+struct NEML_EXPORT StressRelaxationResults {
+  std::vector<double> time, strain, stress;
+  std::vector<double> rtime, rrate, rstress, rstrain;
+};
+
+/// Results of a creep test
+struct NEML_EXPORT CreepResults {
+  std::vector<double> time, strain, stress;
+  std::vector<double> rtime, rrate, rstrain, tstrain;
+  bool failed;
+};
+
+/// Results of a rate_jump_test
+struct NEML_EXPORT RateJumpResults {
+  std::vector<double> strain, stress, energy_density, plastic_work;
+};
+
+/// Results of a thermomechanical_strain_raw test
+struct NEML_EXPORT ThermomechanicalResults {
+  std::vector<double> time, temperature, strain, stress, mechanical_strain;
+};
+
+/// Results of an isochronous_curve
+struct NEML_EXPORT IsochronousResults {
+  std::vector<double> strain, stress;
+};
+
+/// Uniaxial stress/strain curve, as neml.drivers.uniaxial_test
+NEML_EXPORT int uniaxial_test(std::shared_ptr<NEMLModel> model, double erate,
+                  UniaxialTestResults & res, double T = 300.0,
+                  double emax = 0.05, int nsteps = 250,
+                  const std::vector<double> & sdir = {1,0,0,0,0,0},
+                  double offset = 0.2/100.0,
+                  const std::vector<double> & history = {},
+                  const std::vector<double> & tdir = {0,1,0,0,0,0});
+
+/// Strain controlled cyclic test, as neml.drivers.strain_cyclic
+//  hold_time gives the tension and compression hold times, a single
+//  entry applies to both
+NEML_EXPORT int strain_cyclic(std::shared_ptr<NEMLModel> model, double emax,
+                  double R, double erate, int ncycles,
+                  CyclicTestResults & res, double T = 300.0, int nsteps = 50,
+                  const std::vector<double> & sdir = {1,0,0,0,0,0},
+                  const std::vector<double> & hold_time = {},
+                  int n_hold = 25, bool check_dmg = false,
+                  double dtol = 0.75);
+
+/// Strain controlled cyclic test that jumps over stabilized cycles
+//  After each integrated cycle the driver compares the changes in the
+//  stress and history over the last two cycles.  Once the state changes
+//  at a near constant rate per cycle it extrapolates the cycle end state
+//  forward by up to max_jump cycles and then resumes integrating.  The
+//  number of cycles in a jump is limited so that the extrapolation error
+//  estimated from the second difference stays below jump_tol relative to
+//  the size of each variable (its value plus its range over the cycle)
+//  and so that the stress in sdir changes by no more than jump_stress.
+//
+//  A jump gives one entry in the results, for the last skipped cycle,
+//  with extrapolated set to 1.  min_cycle integrated cycles come before
+//  the first jump and at least three integrated cycles follow each jump,
+//  since the next jump extrapolates from the last three cycle ends.
+NEML_EXPORT int strain_cyclic_extrapolated(std::shared_ptr<NEMLModel> model,
+                  double emax, double R, double erate, int ncycles,
+                  CyclicTestResults & res, double T = 300.0, int nsteps = 50,
+                  const std::vector<double> & sdir = {1,0,0,0,0,0},
+                  const std::vector<double> & hold_time = {},
+                  int n_hold = 25, bool check_dmg = false,
+                  double dtol = 0.75, int min_cycle = 3, int max_jump = 100,
+                  double jump_tol = 1.0e-3, double jump_stress = 5.0);
+
+/// Strain controlled cyclic test with elastic follow up, as
+/// neml.drivers.strain_cyclic_followup
+//  Cycles strain component sind and holds it with strain_hold_step using
+//  the follow up factor q.  logspace spaces the hold steps
+//  logarithmically, from a first time of one.
+NEML_EXPORT int strain_cyclic_followup(std::shared_ptr<NEMLModel> model,
+                  double emax, double R, double erate, int ncycles,
+                  CyclicTestResults & res, double q = 1.0, double T = 300.0,
+                  int nsteps = 50, int sind = 0,
+                  const std::vector<double> & hold_time = {},
+                  int n_hold = 25, bool check_dmg = false,
+                  double dtol = 0.75, bool logspace = false);
+
+/// Stress controlled cyclic test, as neml.drivers.stress_cyclic
+NEML_EXPORT int stress_cyclic(std::shared_ptr<NEMLModel> model, double smax,
+                  double R, double srate, int ncycles,
+                  CyclicTestResults & res, double T = 300.0, int nsteps = 50,
+                  const std::vector<double> & sdir = {1,0,0,0,0,0},
+                  const std::vector<double> & hold_time = {},
+                  int n_hold = 10, double etol = 0.1);
+
+/// Stress relaxation test, as neml.drivers.stress_relaxation
+NEML_EXPORT int stress_relaxation(std::shared_ptr<NEMLModel> model,
+                  double emax, double erate, double hold,
+                  StressRelaxationResults & res, double T = 300.0,
+                  int nsteps = 250, int nsteps_up = 50, int index = 0,
+                  double tc = 1.0, bool logspace = false, double q = 1.0);
+
+/// Creep test, as neml.drivers.creep
+NEML_EXPORT int creep(std::shared_ptr<NEMLModel> model, double smax,
+                  double srate, double hold, CreepResults & res,
+                  double T = 300.0, int nsteps = 250, int nsteps_up = 150,
+                  const std::vector<double> & sdir = {1,0,0,0,0,0},
+                  bool logspace = false,
+                  const std::vector<double> & history = {},
+                  double elimit = 1.0, bool check_dmg = false,
+                  double dtol = 0.75);
+
+/// Uniaxial strain rate jump test, as neml.drivers.rate_jump_test
+//  Strains by e_per in nsteps_per steps at each rate or, if strains is
+//  not empty, up to each strain at the matching rate
+NEML_EXPORT int rate_jump_test(std::shared_ptr<NEMLModel> model,
+                  const std::vector<double> & erates, RateJumpResults & res,
+                  double T = 300.0, double e_per = 0.01,
+                  int nsteps_per = 100,
+                  const std::vector<double> & sdir = {1,0,0,0,0,0},
+                  const std::vector<double> & history = {},
+                  const std::vector<double> & strains = {});
+
+/// Follow a measured strain and temperature history, as
+/// neml.drivers.thermomechanical_strain_raw
+//  Stops without an error at the first point that fails.  Unlike the
+//  python version the results end with the last converged point and
+//  mechanical_strain is the mechanical, not the thermal, strain.
+NEML_EXPORT int thermomechanical_strain_raw(std::shared_ptr<NEMLModel> model,
+                  const std::vector<double> & time,
+                  const std::vector<double> & temperature,
+                  const std::vector<double> & strain,
+                  ThermomechanicalResults & res,
+                  const std::vector<double> & sdir = {1,0,0,0,0,0},
+                  int substep = 1);
+
+/// Isochronous stress-strain curve from a series of creep tests, as
+/// neml.drivers.isochronous_curve
+NEML_EXPORT int isochronous_curve(std::shared_ptr<NEMLModel> model,
+                  double time, IsochronousResults & res, double T = 300.0,
+                  double emax = 0.05, double srate = 1.0, double ds = 10.0,
+                  int max_cut = 4, int nsteps = 250,
+                  const std::vector<double> & history = {},
+                  bool check_dmg = false, double dtol = 0.75);
+
+} // namespace neml
+
+#endif // DRIVERS_H
@@ -39,6 +39,9 @@ class NEML_EXPORT LinearElasticModel: public NEMLObject {
   virtual double G(double T, const Orientation & Q, const Vector & b,
                    const Vector & n) const;
 
+  /// Elastic models do not change once made, so identical ones are shared
+  static bool interned() {return true;};
+
 };
 
 /// Isotropic shear modulus generating properties from shear and bulk models
@@ -0,0 +1,345 @@
+#include "ensemble.h"
+
+#include "parse.h"
+#include "interpolate.h"
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+namespace neml {
+
+/// Split a parameter path into its parts
+static std::vector<std::string> split_path(const std::string & path)
+{
+  std::vector<std::string> parts;
+  std::stringstream ss(path);
+  std::string part;
+  while (std::getline(ss, part, '/')) {
+    if (part != "") parts.push_back(part);
+  }
+  if (parts.size() == 0) {
+    throw std::invalid_argument("Empty parameter path");
+  }
+  return parts;
+}
+
+/// Follow the deferred parameter sets down to the set holding the scalar
+static ParameterSet & follow_path(ParameterSet & params,
+                                  const std::vector<std::string> & parts,
+                                  const std::string & path)
+{
+  ParameterSet * current = &params;
+  for (size_t i = 0; i < parts.size() - 1; i++) {
+    if (not current->is_defered_parameter(parts[i])) {
+      throw std::invalid_argument("Parameter path " + path +
+                                  " is not a chain of parameter sets");
+    }
+    current = &current->get_defered_parameter(parts[i]);
+  }
+
+  const std::string & leaf = parts.back();
+  if (not current->is_parameter(leaf) or
+      current->is_defered_parameter(leaf)) {
+    throw std::invalid_argument("Parameter path " + path +
+                                " does not end in a scalar parameter");
+  }
+  ParamType ptype = current->get_object_type(leaf);
+  if ((ptype != TYPE_DOUBLE) and (ptype != TYPE_NEML_OBJECT)) {
+    throw std::invalid_argument("Parameter path " + path +
+                                " does not end in a scalar parameter");
+  }
+
+  return *current;
+}
+
+ModelEnsemble::ModelEnsemble(std::string fname, std::string mname,
+                             const std::vector<std::string> & names) :
+    xml_(true), mname_(mname), names_(names)
+{
+  rapidxml::file<> xmlFile(fname.c_str());
+  text_ = std::string(xmlFile.data());
+  make_xml_(nullptr, &base_);
+}
+
+ModelEnsemble::ModelEnsemble(const ParameterSet & params,
+                             const std::vector<std::string> & names) :
+    xml_(false), params_(params), names_(names)
+{
+  make_pset_(nullptr, &base_);
+}
+
+size_t ModelEnsemble::nparams() const
+{
+  return names_.size();
+}
+
+const std::vector<std::string> & ModelEnsemble::names() const
+{
+  return names_;
+}
+
+const std::vector<double> & ModelEnsemble::base_values() const
+{
+  return base_;
+}
+
+std::shared_ptr<NEMLModel> ModelEnsemble::make_model(
+    const double * const values) const
+{
+  if (xml_) return make_xml_(values, nullptr);
+  else return make_pset_(values, nullptr);
+}
+
+std::shared_ptr<NEMLModel> ModelEnsemble::make_xml_(
+    const double * const values, std::vector<double> * base) const
+{
+  // rapidxml parses in place, so work on a copy of the file
+  std::vector<char> buffer(text_.begin(), text_.end());
+  buffer.push_back('\0');
+  rapidxml::xml_document<> doc;
+  doc.parse<0>(&buffer[0]);
+
+  rapidxml::xml_node<> * found = doc.first_node()->first_node(
+      mname_.c_str());
+  if (found == nullptr) {
+    throw std::invalid_argument("Model " + mname_ + " not found");
+  }
+
+  for (size_t i = 0; i < names_.size(); i++) {
+    rapidxml::xml_node<> * node = found;
+    for (auto & part : split_path(names_[i])) {
+      node = node->first_node(part.c_str());
+      if (node == nullptr) {
+        throw std::invalid_argument("Parameter path " + names_[i] +
+                                    " not found");
+      }
+    }
+    rapidxml::xml_node<> * data = node->first_node();
+    if ((data == nullptr) or (data->type() != rapidxml::node_data)) {
+      throw std::invalid_argument("Parameter path " + names_[i] +
+                                  " does not end in a scalar parameter");
+    }
+
+    if (base != nullptr) base->push_back(get_double(node));
+    if (values != nullptr) {
+      std::stringstream ss;
+      ss << std::setprecision(17) << values[i];
+      data->value(doc.allocate_string(ss.str().c_str()));
+    }
+  }
+
+  auto model = std::dynamic_pointer_cast<NEMLModel>(get_object(found));
+  if (model == nullptr) {
+    throw InvalidType(found->name(), get_type_of_node(found), "NEMLModel");
+  }
+
+  return model;
+}
+
+std::shared_ptr<NEMLModel> ModelEnsemble::make_pset_(
+    const double * const values, std::vector<double> * base) const
+{
+  ParameterSet params = params_;
+
+  for (size_t i = 0; i < names_.size(); i++) {
+    auto parts = split_path(names_[i]);
+    const std::string & leaf = parts.back();
+
+    // Reading a parameter resolves the deferred sets, so use a copy
+    if (base != nullptr) {
+      ParameterSet copy = params_;
+      ParameterSet & target = follow_path(copy, parts, names_[i]);
+      if (target.get_object_type(leaf) == TYPE_DOUBLE) {
+        base->push_back(target.get_parameter<double>(leaf));
+      }
+      else {
+        auto v = std::dynamic_pointer_cast<ConstantInterpolate>(
+            target.get_parameter<std::shared_ptr<NEMLObject>>(leaf));
+        if (v == nullptr) {
+          throw std::invalid_argument("Parameter path " + names_[i] +
+                                      " is not a constant interpolate");
+        }
+        base->push_back(v->value(0.0));
+      }
+    }
+
+    ParameterSet & target = follow_path(params, parts, names_[i]);
+    if (values != nullptr) {
+      if (target.get_object_type(leaf) == TYPE_DOUBLE) {
+        target.assign_parameter(leaf, values[i]);
+      }
+      else {
+        target.assign_parameter(leaf, std::shared_ptr<NEMLObject>(
+                std::make_shared<ConstantInterpolate>(values[i])));
+      }
+    }
+  }
+
+  return Factory::Creator()->create<NEMLModel>(params);
+}
+
+size_t EnsembleTest::nout() const
+{
+  size_t n = 0;
+  for (auto & block : outputs()) n += block.second;
+  return n;
+}
+
+UniaxialEnsembleTest::UniaxialEnsembleTest(double erate, double T,
+                                           double emax, int nsteps) :
+    erate_(erate), T_(T), emax_(emax), nsteps_(nsteps)
+{
+
+}
+
+std::vector<std::pair<std::string, size_t>>
+UniaxialEnsembleTest::outputs() const
+{
+  return {{"youngs", 1}, {"yield", 1}, {"poissons", 1},
+    {"stress", nsteps_ + 1}};
+}
+
+int UniaxialEnsembleTest::run(std::shared_ptr<NEMLModel> model,
+                              double * const out) const
+{
+  UniaxialTestResults res;
+  int ier = uniaxial_test(model, erate_, res, T_, emax_, nsteps_);
+  if (ier != SUCCESS) return ier;
+
+  out[0] = res.youngs;
+  out[1] = res.yield;
+  out[2] = res.poissons;
+  std::copy(res.stress.begin(), res.stress.end(), &out[3]);
+
+  return SUCCESS;
+}
+
+CreepEnsembleTest::CreepEnsembleTest(double smax, double srate, double hold,
+                                     double T, int nsteps, int nsteps_up,
+                                     bool logspace, double elimit) :
+    smax_(smax), srate_(srate), hold_(hold), T_(T), nsteps_(nsteps),
+    nsteps_up_(nsteps_up), logspace_(logspace), elimit_(elimit)
+{
+
+}
+
+std::vector<std::pair<std::string, size_t>> CreepEnsembleTest::outputs() const
+{
+  size_t n = nsteps_ + nsteps_up_ + 1;
+  return {{"failed", 1}, {"final_time", 1}, {"final_strain", 1},
+    {"min_rate", 1}, {"time", n}, {"strain", n}};
+}
+
+int CreepEnsembleTest::run(std::shared_ptr<NEMLModel> model,
+                           double * const out) const
+{
+  CreepResults res;
+  int ier = creep(model, smax_, srate_, hold_, res, T_, nsteps_, nsteps_up_,
+                  {1,0,0,0,0,0}, logspace_, {}, elimit_);
+  if (ier != SUCCESS) return ier;
+
+  double min_rate = std::numeric_limits<double>::quiet_NaN();
+  for (auto r : res.rrate) {
+    if (std::isfinite(r) and (std::isnan(min_rate) or (r < min_rate))) {
+      min_rate = r;
+    }
+  }
+
+  size_t n = nsteps_ + nsteps_up_ + 1;
+  out[0] = res.failed ? 1.0 : 0.0;
+  out[1] = res.time.back();
+  out[2] = res.strain.back();
+  out[3] = min_rate;
+  std::copy(res.time.begin(), res.time.end(), &out[4]);
+  std::copy(res.strain.begin(), res.strain.end(), &out[4+n]);
+
+  return SUCCESS;
+}
+
+StrainCyclicEnsembleTest::StrainCyclicEnsembleTest(double emax, double R,
+                                                   double erate, int ncycles,
+                                                   double T, int nsteps,
+                                                   const std::vector<double> &
+                                                   hold_time, int n_hold) :
+    emax_(emax), R_(R), erate_(erate), ncycles_(ncycles), T_(T),
+    nsteps_(nsteps), hold_time_(hold_time), n_hold_(n_hold)
+{
+
+}
+
+std::vector<std::pair<std::string, size_t>>
+StrainCyclicEnsembleTest::outputs() const
+{
+  return {{"cycles", 1}, {"max", ncycles_}, {"min", ncycles_},
+    {"mean", ncycles_}};
+}
+
+int StrainCyclicEnsembleTest::run(std::shared_ptr<NEMLModel> model,
+                                  double * const out) const
+{
+  CyclicTestResults res;
+  int ier = strain_cyclic(model, emax_, R_, erate_, ncycles_, res, T_,
+                          nsteps_, {1,0,0,0,0,0}, hold_time_, n_hold_);
+  if (ier != SUCCESS) return ier;
+
+  out[0] = res.cycles.size();
+  std::copy(res.max.begin(), res.max.end(), &out[1]);
+  std::copy(res.min.begin(), res.min.end(), &out[1+ncycles_]);
+  std::copy(res.mean.begin(), res.mean.end(), &out[1+2*ncycles_]);
+
+  return SUCCESS;
+}
+
+int run_ensemble(const ModelEnsemble & ensemble, const EnsembleTest & test,
+                 size_t n, const double * const values,
+                 double * const results, int * const errors, int nthreads)
+{
+  size_t np = ensemble.nparams();
+  size_t no = test.nout();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  std::fill(results, results + n * no, nan);
+
+#ifdef USE_OMP
+  omp_set_num_threads(nthreads);
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+  for (size_t i = 0; i < n; i++) {
+    std::shared_ptr<NEMLModel> model;
+    errors[i] = SUCCESS;
+
+    // Construction goes through the shared factory, so do one at a time
+#ifdef USE_OMP
+#pragma omp critical (neml_ensemble_create)
+#endif
+    {
+      try {
+        model = ensemble.make_model(&values[i*np]);
+      }
+      catch (std::exception & e) {
+        errors[i] = UNKNOWN_ERROR;
+      }
+    }
+    if (errors[i] != SUCCESS) continue;
+
+    try {
+      errors[i] = test.run(model, &results[i*no]);
+    }
+    catch (std::exception & e) {
+      errors[i] = UNKNOWN_ERROR;
+    }
+    if (errors[i] != SUCCESS) {
+      std::fill(&results[i*no], &results[(i+1)*no], nan);
+    }
+  }
+
+  return SUCCESS;
+}
+
+} // namespace neml
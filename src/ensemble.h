@@ -0,0 +1,143 @@
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include "objects.h"
+#include "models.h"
+#include "drivers.h"
+
+#include "nemlerror.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "windows.h"
+
+namespace neml {
+
+/// A model definition plus a set of named scalar parameters to vary
+//  Parameters are given as paths from the model down to the scalar, for
+//  example "flow/hardening/iso/s0".  Scalars can be double parameters or
+//  constant interpolates.
+class NEML_EXPORT ModelEnsemble {
+ public:
+  /// Model mname in an XML file, the paths follow the XML nodes
+  ModelEnsemble(std::string fname, std::string mname,
+                const std::vector<std::string> & names);
+  /// Model given by a parameter set, the paths follow deferred parameter
+  /// sets and end in a double or Interpolate parameter
+  ModelEnsemble(const ParameterSet & params,
+                const std::vector<std::string> & names);
+
+  /// Number of parameters to vary
+  size_t nparams() const;
+  /// The parameter paths
+  const std::vector<std::string> & names() const;
+  /// Parameter values in the base model
+  const std::vector<double> & base_values() const;
+
+  /// Construct the model for the given parameter values
+  std::shared_ptr<NEMLModel> make_model(const double * const values) const;
+
+ private:
+  std::shared_ptr<NEMLModel> make_xml_(const double * const values,
+                                       std::vector<double> * base) const;
+  std::shared_ptr<NEMLModel> make_pset_(const double * const values,
+                                        std::vector<double> * base) const;
+
+ private:
+  bool xml_;
+  std::string text_, mname_;
+  ParameterSet params_;
+  std::vector<std::string> names_;
+  std::vector<double> base_;
+};
+
+/// A load path to run on every member of an ensemble
+//  Each test writes a fixed number of summary values per model, split
+//  into named blocks.  Blocks that do not fill, for example because a
+//  test stopped early, are padded with NaN.
+class NEML_EXPORT EnsembleTest {
+ public:
+  virtual ~EnsembleTest() {};
+
+  /// Names and widths of the output blocks
+  virtual std::vector<std::pair<std::string, size_t>> outputs() const = 0;
+  /// Total number of outputs per model
+  size_t nout() const;
+
+  /// Run the test on a model, writing nout values
+  virtual int run(std::shared_ptr<NEMLModel> model,
+                  double * const out) const = 0;
+};
+
+/// Uniaxial tension
+//  Outputs youngs, yield, poissons, and the stress at each step
+class NEML_EXPORT UniaxialEnsembleTest: public EnsembleTest {
+ public:
+  UniaxialEnsembleTest(double erate, double T = 300.0, double emax = 0.05,
+                       int nsteps = 250);
+
+  virtual std::vector<std::pair<std::string, size_t>> outputs() const;
+  virtual int run(std::shared_ptr<NEMLModel> model, double * const out) const;
+
+ private:
+  double erate_, T_, emax_;
+  int nsteps_;
+};
+
+/// Creep test
+//  Outputs failed (0 or 1), the final time and strain, the minimum
+//  creep rate, and the time and strain at each step
+class NEML_EXPORT CreepEnsembleTest: public EnsembleTest {
+ public:
+  CreepEnsembleTest(double smax, double srate, double hold, double T = 300.0,
+                    int nsteps = 250, int nsteps_up = 150,
+                    bool logspace = false, double elimit = 1.0);
+
+  virtual std::vector<std::pair<std::string, size_t>> outputs() const;
+  virtual int run(std::shared_ptr<NEMLModel> model, double * const out) const;
+
+ private:
+  double smax_, srate_, hold_, T_;
+  int nsteps_, nsteps_up_;
+  bool logspace_;
+  double elimit_;
+};
+
+/// Strain controlled cyclic test
+//  Outputs the number of cycles completed and the maximum, minimum, and
+//  mean stress in each cycle
+class NEML_EXPORT StrainCyclicEnsembleTest: public EnsembleTest {
+ public:
+  StrainCyclicEnsembleTest(double emax, double R, double erate, int ncycles,
+                           double T = 300.0, int nsteps = 50,
+                           const std::vector<double> & hold_time = {},
+                           int n_hold = 25);
+
+  virtual std::vector<std::pair<std::string, size_t>> outputs() const;
+  virtual int run(std::shared_ptr<NEMLModel> model, double * const out) const;
+
+ private:
+  double emax_, R_, erate_;
+  int ncycles_;
+  double T_;
+  int nsteps_;
+  std::vector<double> hold_time_;
+  int n_hold_;
+};
+
+/// Run a test on n variants of a model, optionally in parallel
+//  values is (n,nparams), results is (n,nout), and errors (n) gets the
+//  error code for each variant.  Failed variants give rows of NaN and
+//  do not stop the others.
+NEML_EXPORT int run_ensemble(const ModelEnsemble & ensemble,
+                             const EnsembleTest & test, size_t n,
+                             const double * const values,
+                             double * const results, int * const errors,
+                             int nthreads = 1);
+
+} // namespace neml
+
+#endif // ENSEMBLE_H
@@ -19,6 +19,33 @@ int GeneralFlowRule::work_rate(const double * const s,
   return 0;
 }
 
+size_t GeneralFlowRule::nwork() const
+{
+  return 0;
+}
+
+int GeneralFlowRule::evaluate(const double * const s,
+                              const double * const alpha,
+                              const double * const edot, double T,
+                              double Tdot,
+                              double * const sdot, double * const d_sdot_ds,
+                              double * const d_sdot_da,
+                              double * const adot, double * const d_adot_ds,
+                              double * const d_adot_da, double * const work)
+{
+  int ier = this->s(s, alpha, edot, T, Tdot, sdot);
+  if (ier != SUCCESS) return ier;
+  ier = ds_ds(s, alpha, edot, T, Tdot, d_sdot_ds);
+  if (ier != SUCCESS) return ier;
+  ier = ds_da(s, alpha, edot, T, Tdot, d_sdot_da);
+  if (ier != SUCCESS) return ier;
+  ier = a(s, alpha, edot, T, Tdot, adot);
+  if (ier != SUCCESS) return ier;
+  ier = da_ds(s, alpha, edot, T, Tdot, d_adot_ds);
+  if (ier != SUCCESS) return ier;
+  return da_da(s, alpha, edot, T, Tdot, d_adot_da);
+}
+
 int GeneralFlowRule::set_elastic_model(std::shared_ptr<LinearElasticModel>
                                        emodel)
 {
@@ -328,6 +355,49 @@ int TVPFlowRule::da_de(const double * const s, const double * const alpha,
   return 0;
 }
 
+size_t TVPFlowRule::nwork() const
+{
+  return 6 * nhist() + flow_->nwork();
+}
+
+int TVPFlowRule::evaluate(const double * const s,
+                          const double * const alpha,
+                          const double * const edot, double T,
+                          double Tdot,
+                          double * const sdot, double * const d_sdot_ds,
+                          double * const d_sdot_da,
+                          double * const adot, double * const d_adot_ds,
+                          double * const d_adot_da, double * const work)
+{
+  int nh = nhist();
+
+  // The flow rule gives the inelastic strain rate, the history rate and
+  // their partials at once, the history rate parts are already final
+  double erate[6], d_erate_ds[36];
+  double * d_erate_da = work;
+  int ier = flow_->evaluate(s, alpha, T, Tdot, erate, d_erate_ds, d_erate_da,
+                            adot, d_adot_ds, d_adot_da, &work[6*nh]);
+  if (ier != SUCCESS) return ier;
+
+  double C[36];
+  elastic_->C(T, C);
+
+  // Stress rate
+  double ee[6];
+  for (int i=0; i<6; i++) ee[i] = edot[i] - erate[i];
+  mat_vec(C, 6, ee, 6, sdot);
+
+  // Stress rate wrt stress
+  for (int i=0; i<36; i++) d_erate_ds[i] = -d_erate_ds[i];
+  mat_mat(6, 6, 6, C, d_erate_ds, d_sdot_ds);
+
+  // Stress rate wrt history
+  for (int i=0; i<6*nh; i++) d_erate_da[i] = -d_erate_da[i];
+  mat_mat(6, nh, 6, C, d_erate_da, d_sdot_da);
+
+  return 0;
+}
+
 int TVPFlowRule::work_rate(const double * const s,
                                     const double * const alpha,
                                     const double * const edot, double T,
@@ -61,6 +61,22 @@ class NEML_EXPORT GeneralFlowRule: public NEMLObject {
                 double Tdot,
                 double * const d_adot) = 0;
 
+  /// Size of the scratch evaluate needs
+  virtual size_t nwork() const;
+
+  /// Rates and their partials wrt stress and history in one call
+  //  This is what the integrator needs for each residual and Jacobian.
+  //  The default calls the individual methods; implementations can
+  //  override it to share the work common to the rates and partials.
+  //  work has room for nwork() doubles.
+  virtual int evaluate(const double * const s, const double * const alpha,
+                const double * const edot, double T,
+                double Tdot,
+                double * const sdot, double * const d_sdot_ds,
+                double * const d_sdot_da,
+                double * const adot, double * const d_adot_ds,
+                double * const d_adot_da, double * const work);
+
   /// The implementation needs to define inelastic dissipation
   virtual int work_rate(const double * const s, const double * const alpha,
                 const double * const edot, double T,
@@ -137,6 +153,18 @@ class NEML_EXPORT TVPFlowRule : public GeneralFlowRule {
                 double Tdot,
                 double * const d_adot);
 
+  /// Scratch for the inelastic strain rate partial and the flow rule
+  virtual size_t nwork() const;
+
+  /// Rates and partials from one fused flow rule call
+  virtual int evaluate(const double * const s, const double * const alpha,
+                const double * const edot, double T,
+                double Tdot,
+                double * const sdot, double * const d_sdot_ds,
+                double * const d_sdot_da,
+                double * const adot, double * const d_adot_ds,
+                double * const d_adot_da, double * const work);
+
   /// The implementation needs to define inelastic dissipation
   virtual int work_rate(const double * const s, const double * const alpha,
                 const double * const edot, double T,
@@ -109,6 +109,26 @@ PYBIND11_MODULE(general_flow, m) {
             py_error(ier);
             return f;
            }, "History rate derivative with respect to strain.")
+      .def("evaluate",
+           [](GeneralFlowRule & m, py::array_t<double, py::array::c_style> s, py::array_t<double, py::array::c_style> alpha, py::array_t<double, py::array::c_style> edot, double T, double Tdot) -> py::tuple
+           {
+            auto sdot = alloc_vec<double>(6);
+            auto d_sdot_ds = alloc_mat<double>(6,6);
+            auto d_sdot_da = alloc_mat<double>(6,m.nhist());
+            auto adot = alloc_vec<double>(m.nhist());
+            auto d_adot_ds = alloc_mat<double>(m.nhist(),6);
+            auto d_adot_da = alloc_mat<double>(m.nhist(),m.nhist());
+            std::vector<double> work(m.nwork());
+            int ier = m.evaluate(arr2ptr<double>(s), arr2ptr<double>(alpha), 
+                          arr2ptr<double>(edot), T, Tdot,
+                          arr2ptr<double>(sdot), arr2ptr<double>(d_sdot_ds),
+                          arr2ptr<double>(d_sdot_da), arr2ptr<double>(adot),
+                          arr2ptr<double>(d_adot_ds),
+                          arr2ptr<double>(d_adot_da), work.data());
+            py_error(ier);
+            return py::make_tuple(sdot, d_sdot_ds, d_sdot_da, adot,
+                                  d_adot_ds, d_adot_da);
+           }, "Stress rate, history rate, and their partials with respect to stress and history.")
       
       .def("work_rate",
            [](GeneralFlowRule & m, py::array_t<double, py::array::c_style> s, py::array_t<double, py::array::c_style> alpha, py::array_t<double, py::array::c_style> edot, double T, double Tdot) -> double
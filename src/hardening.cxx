@@ -717,8 +717,9 @@ int Chaboche::h(const double * const s, const double * const alpha, double T,
   std::vector<double> c = eval_vector(c_, T);
 
   for (int i=0; i<n_; i++) {
+    double gi = gmodels_[i]->gamma(alpha[0], T);
     for (int j=0; j<6; j++) {
-      hv[1+i*6+j] = - 2.0 / 3.0 * c[i] * nv[j] - sqrt(2.0/3.0) * gmodels_[i]->gamma(alpha[0], T) * alpha[1+i*6+j];
+      hv[1+i*6+j] = - 2.0 / 3.0 * c[i] * nv[j] - sqrt(2.0/3.0) * gi * alpha[1+i*6+j];
     }
   }
 
@@ -816,8 +817,9 @@ int Chaboche::dh_da(const double * const s, const double * const alpha, double T
   
   // Fill in the gamma part
   for (int i=0; i<n_; i++) {
+    double gi = gmodels_[i]->gamma(alpha[0], T);
     for (int j=0; j<6; j++) {
-      dhv[CINDEX((1+i*6+j),(1+i*6+j),nh)] -= sqrt(2.0/3.0) * gmodels_[i]->gamma(alpha[0], T);
+      dhv[CINDEX((1+i*6+j),(1+i*6+j),nh)] -= sqrt(2.0/3.0) * gi;
     }
   }
 
@@ -835,9 +837,9 @@ int Chaboche::dh_da(const double * const s, const double * const alpha, double T
 
   // Fill in the alpha part
   for (int i=0; i<n_; i++) {
+    double dgi = gmodels_[i]->dgamma(alpha[0], T);
     for (int j=0; j<6; j++) {
-      dhv[CINDEX((1+i*6+j),0,nhist())] = -sqrt(2.0/3.0) * 
-          gmodels_[i]->dgamma(alpha[0], T) * alpha[1+i*6+j];
+      dhv[CINDEX((1+i*6+j),0,nh)] = -sqrt(2.0/3.0) * dgi * alpha[1+i*6+j];
     }
   }
 
@@ -856,6 +858,7 @@ int Chaboche::h_time(const double * const s, const double * const alpha,
   double Xi[6];
   double nXi;
   for (int i=0; i<n_; i++) {
+    if (A[i] == 0.0) continue;
     std::copy(&alpha[1+i*6], &alpha[1+(i+1)*6], Xi);
     nXi = norm2_vec(Xi, 6);
     for (int j=0; j<6; j++) {
@@ -896,10 +899,12 @@ int Chaboche::dh_da_time(const double * const s, const double * const alpha,
   int ia,ib;
   double d;
   for (int i=0; i<n; i++) {
+    if (A[i] == 0.0) continue;
     std::copy(&alpha[1+i*6], &alpha[1+(i+1)*6], Xi);
     nXi = norm2_vec(Xi, 6);
     normalize_vec(Xi, 6);
     outer_vec(Xi, 6, Xi, 6, XX);
+    double pa = -A[i] * sqrt(3.0/2.0) * pow(nXi, a[i]-1.0);
     for (int j=0; j<6; j++) {
       ia = 1 + i*6 + j;
       for (int k=0; k<6; k++) {
@@ -910,8 +915,7 @@ int Chaboche::dh_da_time(const double * const s, const double * const alpha,
         else {
           d = 0.0;
         }
-        dhv[CINDEX(ia,ib,nh)] = -A[i] * sqrt(3.0/2.0) * pow(nXi, a[i]-1.0) * (
-            d + (a[i] - 1.0) * XX[CINDEX(j,k,6)]);
+        dhv[CINDEX(ia,ib,nh)] = pa * (d + (a[i] - 1.0) * XX[CINDEX(j,k,6)]);
       }
     }
   }
@@ -25,6 +25,9 @@ class NEML_EXPORT Interpolate: public NEMLObject {
   /// Is the interpolate valid?
   bool valid() const;
 
+  /// Interpolates do not change once made, so identical ones are shared
+  static bool interned() {return true;};
+
  protected:
   bool valid_;
 };
@@ -83,7 +83,7 @@ size_t LarsonMillerRelation::nparams() const
   return 1;
 }
 
-int LarsonMillerRelation::init_x(double * const x, TrialState * ts)
+int LarsonMillerRelation::init_x(double * const x, TrialState * ts) const
 {
   x[0] = 50000.0; // A reasonable LMP...
 
@@ -91,7 +91,7 @@ int LarsonMillerRelation::init_x(double * const x, TrialState * ts)
 }
 
 int LarsonMillerRelation::RJ(const double * const x, TrialState * ts, 
-                             double * const R, double * const J)
+                             double * const R, double * const J) const
 {
   LMTrialState * tss = static_cast<LMTrialState*>(ts);
 
@@ -39,11 +39,11 @@ class NEML_EXPORT LarsonMillerRelation: public NEMLObject, public Solvable {
   /// Number of solver parameters
   virtual size_t nparams() const;
   /// Setup an iteration vector in the solver
-  virtual int init_x(double * const x, TrialState * ts);
+  virtual int init_x(double * const x, TrialState * ts) const;
   /// Solver function returning the residual and jacobian of the nonlinear
   /// system of equations integrating the model
   virtual int RJ(const double * const x, TrialState * ts, double * const R,
-                 double * const J);
+                 double * const J) const;
 
  protected:
   std::shared_ptr<Interpolate> fn_;
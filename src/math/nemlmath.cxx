@@ -6,6 +6,7 @@
 #include <iostream>
 #include <limits>
 #include <algorithm>
+#include <vector>
 
 namespace neml {
 
@@ -985,6 +986,109 @@ int solve_mat(const double * const A, int n, double * const x)
   return 0;
 }
 
+int factor_mat(const double * const A, int n, double * const LU,
+               int * const ipiv)
+{
+  int info;
+  for (int i=0; i<n; i++) {
+    for (int j=0; j<n; j++) {
+      LU[CINDEX(i,j,n)] = A[CINDEX(j,i,n)];
+    }
+  }
+
+  dgetrf_(n, n, LU, n, ipiv, info);
+
+  if (info > 0) return LINALG_FAILURE;
+
+  return 0;
+}
+
+int solve_factored(const double * const LU, const int * const ipiv, int n,
+                   double * const x)
+{
+  int info;
+  dgetrs_("N", n, 1, LU, n, ipiv, x, n, info);
+
+  if (info != 0) return LINALG_FAILURE;
+
+  return 0;
+}
+
+namespace {
+/// Scratch for solve_mat_mixed, kept per thread so repeated solves of the
+/// same size do not allocate
+struct MixedScratch {
+  std::vector<int> ipiv;
+  std::vector<float> B, r;
+  std::vector<double> b, rd;
+
+  void resize(int n)
+  {
+    ipiv.resize(n);
+    B.resize(n*n);
+    r.resize(n);
+    b.resize(n);
+    rd.resize(n);
+  }
+};
+}
+
+int solve_mat_mixed(const double * const A, int n, double * const x,
+                    int nrefine)
+{
+  static thread_local MixedScratch scratch;
+  scratch.resize(n);
+  int * ipiv = scratch.ipiv.data();
+  float * B = scratch.B.data();
+  float * r = scratch.r.data();
+  double * b = scratch.b.data();
+  double * rd = scratch.rd.data();
+
+  int info;
+  for (int i=0; i<n; i++) {
+    for (int j=0; j<n; j++) {
+      B[CINDEX(i,j,n)] = (float) A[CINDEX(j,i,n)];
+    }
+  }
+
+  sgetrf_(n, n, B, n, ipiv, info);
+  if (info != 0) {
+    // Singular (or overflowed) in single precision, do it the usual way
+    return solve_mat(A, n, x);
+  }
+
+  std::copy(x, x+n, b);
+
+  for (int i=0; i<n; i++) r[i] = (float) b[i];
+  sgetrs_("N", n, 1, B, n, ipiv, r, n, info);
+  for (int i=0; i<n; i++) x[i] = r[i];
+
+  // Refine with the residual b - A x in double
+  for (int k=0; k<=nrefine; k++) {
+    for (int i=0; i<n; i++) {
+      rd[i] = b[i];
+      for (int j=0; j<n; j++) {
+        rd[i] -= A[CINDEX(i,j,n)] * x[j];
+      }
+    }
+    if (k == nrefine) break;
+    for (int i=0; i<n; i++) r[i] = (float) rd[i];
+    sgetrs_("N", n, 1, B, n, ipiv, r, n, info);
+    for (int i=0; i<n; i++) x[i] += r[i];
+  }
+
+  // If the matrix is too poorly conditioned for the single precision
+  // factorization the refinement stalls, so fall back on the double solve
+  double nr = norm2_vec(rd, n);
+  double nb = norm2_vec(b, n);
+  if (not (nr <= sqrt(std::numeric_limits<double>::epsilon()) * nb)) {
+    std::copy(b, b+n, x);
+    return solve_mat(A, n, x);
+  }
+
+  return 0;
+}
+
 /*
  *  No error checking in this function, as it is assumed to be non-critical
  */
@@ -1198,32 +1302,141 @@ double factorial(int n)
   return (double) fact(n);
 }
 
-int eigenvalues_sym(const double * const s, double * values)
+/// Cyclic Jacobi iteration for a symmetric 3x3 matrix
+//  The matrix is given by its diagonal d and off diagonal o = (a01, a02,
+//  a12).  On output d has the eigenvalues sorted in ascending order and
+//  the rows of V are the matching unit eigenvectors.  The rotations are
+//  exact for repeated eigenvalues, so these need no special treatment.
+static int jacobi_sym3_(double * const d, double * const o, double * const V)
 {
-  double F[9];
-  usym(s, F);
-  
-  int swork = 15;
-  double work[15];
-  int info = 0;
+  std::fill(V, V+9, 0.0);
+  V[0] = V[4] = V[8] = 1.0;
 
-  dsyev_("N", "U", 3, F, 3, values, work, swork, info);
+  // Converged once the off diagonal is below roundoff in the diagonal
+  double scale = 0.0;
+  for (int i = 0; i < 3; i++) {
+    scale = std::max(scale, std::max(fabs(d[i]), fabs(o[i])));
+  }
+  double tol = std::numeric_limits<double>::epsilon() * scale;
+
+  // For each rotation: p, q, the third index r, and the positions of
+  // a_pq, a_rp, and a_rq in o
+  const int rot[3][6] = {{0,1,2, 0,1,2}, {0,2,1, 1,0,2}, {1,2,0, 2,0,1}};
+  bool converged = false;
+  for (int sweep = 0; sweep < 50; sweep++) {
+    if (fabs(o[0]) + fabs(o[1]) + fabs(o[2]) <= tol) {
+      converged = true;
+      break;
+    }
 
-  return info;
+    for (auto & r : rot) {
+      int p = r[0];
+      int q = r[1];
+      double apq = o[r[3]];
+      if (fabs(apq) <= 0.1 * tol) continue;
+
+      double theta = (d[q] - d[p]) / (2.0 * apq);
+      double t = 1.0 / (fabs(theta) + sqrt(theta * theta + 1.0));
+      if (theta < 0.0) t = -t;
+      double c = 1.0 / sqrt(t * t + 1.0);
+      double sn = t * c;
+
+      // A <- R^T A R, with R the rotation in the p-q plane
+      d[p] -= t * apq;
+      d[q] += t * apq;
+      o[r[3]] = 0.0;
+      double arp = o[r[4]];
+      double arq = o[r[5]];
+      o[r[4]] = c * arp - sn * arq;
+      o[r[5]] = sn * arp + c * arq;
+
+      // Accumulate the eigenvectors as rows
+      for (int k = 0; k < 3; k++) {
+        double vpk = V[CINDEX(p,k,3)];
+        double vqk = V[CINDEX(q,k,3)];
+        V[CINDEX(p,k,3)] = c * vpk - sn * vqk;
+        V[CINDEX(q,k,3)] = sn * vpk + c * vqk;
+      }
+    }
+  }
+  if (not converged) return LINALG_FAILURE;
+
+  // Sort ascending, like LAPACK
+  for (int i = 0; i < 2; i++) {
+    int m = i;
+    for (int j = i + 1; j < 3; j++) {
+      if (d[j] < d[m]) m = j;
+    }
+    if (m != i) {
+      std::swap(d[i], d[m]);
+      std::swap_ranges(&V[CINDEX(i,0,3)], &V[CINDEX(i,0,3)] + 3,
+                       &V[CINDEX(m,0,3)]);
+    }
+  }
+
+  return 0;
+}
+
+/// Split a Mandel vector into the diagonal and off diagonal for Jacobi
+static void mandel_to_jacobi_(const double * const s, double * const d,
+                              double * const o)
+{
+  std::copy(s, s+3, d);
+  o[0] = s[5] / sqrt(2.0);
+  o[1] = s[4] / sqrt(2.0);
+  o[2] = s[3] / sqrt(2.0);
+}
+
+int eigenvalues_sym(const double * const s, double * values)
+{
+  double o[3], V[9];
+  mandel_to_jacobi_(s, values, o);
+
+  return jacobi_sym3_(values, o, V);
 }
 
 int eigenvectors_sym(const double * const s, double * vectors)
 {
-  usym(s, vectors);
+  double d[3], o[3];
+  mandel_to_jacobi_(s, d, o);
 
-  int swork = 15;
-  double work[15];
-  int info = 0;
-  double values[3];
+  return jacobi_sym3_(d, o, vectors);
+}
 
-  dsyev_("V", "U", 3, vectors, 3, values, work, swork, info);
+int eigenvalue_derivatives_sym(const double * const s, double * const values,
+                               double * const dvalues)
+{
+  double o[3], V[9];
+  mandel_to_jacobi_(s, values, o);
+
+  int ier = jacobi_sym3_(values, o, V);
+  if (ier != 0) return ier;
+
+  // Eigenvalues closer than this count as repeated
+  double scale = std::max(fabs(values[0]), fabs(values[2]));
+  double tol = 1.0e-10 * scale;
+
+  // Each derivative is the projector onto its eigenvector, averaged over
+  // any group of repeated eigenvalues
+  double P[3][6];
+  for (int i = 0; i < 3; i++) {
+    double full[9];
+    outer_vec(&V[CINDEX(i,0,3)], 3, &V[CINDEX(i,0,3)], 3, full);
+    sym(full, P[i]);
+  }
+  for (int i = 0; i < 3; i++) {
+    int n = 0;
+    std::fill(&dvalues[CINDEX(i,0,6)], &dvalues[CINDEX(i,0,6)] + 6, 0.0);
+    for (int j = 0; j < 3; j++) {
+      if (fabs(values[j] - values[i]) <= tol) {
+        for (int k = 0; k < 6; k++) dvalues[CINDEX(i,k,6)] += P[j][k];
+        n++;
+      }
+    }
+    for (int k = 0; k < 6; k++) dvalues[CINDEX(i,k,6)] /= n;
+  }
 
-  return info;
+  return 0;
 }
 
 double I1(const double * const s)
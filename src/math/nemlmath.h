@@ -19,6 +19,9 @@ extern "C" {
   void dgetrf_(const int & m, const int & n, double* A, const int & lda, int* ipiv, int & info);
   void dgetri_(const int & n, double* A, const int & lda, int* ipiv, double* work, const int & lwork, int & info);
   void dgesv_(const int & n, const int & nrhs, double * A, const int & lda, int * ipiv, double * b, const int & ldb, int & info);
+  void dgetrs_(const char * trans, const int & n, const int & nrhs, const double * A, const int & lda, const int * ipiv, double * b, const int & ldb, int & info);
+  void sgetrf_(const int & m, const int & n, float * A, const int & lda, int * ipiv, int & info);
+  void sgetrs_(const char * trans, const int & n, const int & nrhs, const float * A, const int & lda, const int * ipiv, float * b, const int & ldb, int & info);
   void dgemv_(const char * trans, const int & m, const int & n, const double & alpha, const double * A, const int & lda, const double * x, const int & incx, const double & beta, double * y, const int & incy);
   void dgemm_(const char * transa, const char * transb, const int & m, const int & n, const int & k, const double & alpha, const double * A, const int & lda, const double * B, const int & ldb, const double & beta, double * C, const int & ldc);
   void dger_(const int & m, const int & n, const double & alpha, const double * x, const int & incx, const double * y, const int & incy, double * A, const int & lda);
@@ -140,6 +143,22 @@ NEML_EXPORT int invert_mat(double* const A, int n);
 /// Solve unsymmetric system
 NEML_EXPORT int solve_mat(const double * const A, int n, double * const x);
 
+/// LU factorize an unsymmetric matrix for later solves with solve_factored
+//  LU and ipiv must hold n*n and n entries
+NEML_EXPORT int factor_mat(const double * const A, int n, double * const LU,
+                           int * const ipiv);
+
+/// Solve an unsymmetric system given the factors from factor_mat
+NEML_EXPORT int solve_factored(const double * const LU,
+                               const int * const ipiv, int n,
+                               double * const x);
+
+/// Solve unsymmetric system with a single precision factorization followed
+/// by nrefine steps of iterative refinement with double precision residuals,
+/// falling back on solve_mat if the refined solution is not accurate
+NEML_EXPORT int solve_mat_mixed(const double * const A, int n, double * const x,
+                                int nrefine = 2);
+
 /// Get the condition number of a matrix
 NEML_EXPORT double condition(const double * const A, int n);
 
@@ -189,11 +208,20 @@ NEML_EXPORT int fact(int n);
 NEML_EXPORT double factorial(int n);
 
 /// Get the eigenvalues of a symmetric 3x3 matrix in Mandel notation
+//  Uses Jacobi rotations rather than LAPACK, values are in ascending order
 NEML_EXPORT int eigenvalues_sym(const double * const s, double * values);
 
 /// Get the eigenvectors of a symmetric 3x3 matrix (row major)
 NEML_EXPORT int eigenvectors_sym(const double * const s, double * vectors);
 
+/// Eigenvalues of a symmetric 3x3 matrix and their derivatives
+//  dvalues is 3x6, the Mandel derivative of each eigenvalue with respect
+//  to s.  For repeated eigenvalues the derivative is not unique, these
+//  get the derivative of the mean of the group.
+NEML_EXPORT int eigenvalue_derivatives_sym(const double * const s,
+                                           double * const values,
+                                           double * const dvalues);
+
 /// First principal invariant
 NEML_EXPORT double I1(const double * const s);
 
@@ -556,6 +556,30 @@ PYBIND11_MODULE(nemlmath, m) {
           return b;
         }, "Solve Ax=b.");
 
+   m.def("solve_mat_mixed",
+        [](py::array_t<double, py::array::c_style> A, py::array_t<double, py::array::c_style> b, int nrefine) -> py::array_t<double>
+        {
+          if (A.request().ndim != 2) {
+            throw LinalgError("A is not a matrix!");
+          }
+          if (A.request().shape[0] != A.request().shape[1]) {
+            throw LinalgError("A is not square!");
+          }
+          if (b.request().ndim != 1) {
+            throw LinalgError("b is not a vector!");
+          }
+          if (A.request().shape[0] != b.request().shape[0]) {
+            throw LinalgError("A and b are not conformable!");
+          }
+
+          int ier = solve_mat_mixed(arr2ptr<double>(A), A.request().shape[0], 
+                                    arr2ptr<double>(b), nrefine);
+          py_error(ier);
+
+          return b;
+        }, "Solve Ax=b with a single precision factorization and double precision refinement.",
+        py::arg("A"), py::arg("b"), py::arg("nrefine") = 2);
+
    m.def("condition",
         [](py::array_t<double, py::array::c_style> A) -> double
         {
@@ -600,6 +624,20 @@ PYBIND11_MODULE(nemlmath, m) {
            return V;
          }, "Eigenvectors of a symmetric matrix.");
 
+   m.def("eigenvalue_derivatives_sym",
+         [](py::array_t<double, py::array::c_style> s) -> std::tuple<py::array_t<double>, py::array_t<double>>
+         {
+           auto vals = alloc_vec<double>(3);
+           auto dvals = alloc_mat<double>(3,6);
+
+           int ier = eigenvalue_derivatives_sym(arr2ptr<double>(s),
+                                                arr2ptr<double>(vals),
+                                                arr2ptr<double>(dvals));
+           py_error(ier);
+
+           return std::make_tuple(vals, dvals);
+         }, "Eigenvalues of a symmetric matrix and their derivatives.");
+
    m.def("I1",
          [](py::array_t<double, py::array::c_style> s) -> double
          {
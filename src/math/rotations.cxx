@@ -405,8 +405,8 @@ ParameterSet Orientation::parameters()
   ParameterSet pset(Orientation::type());
 
   pset.add_parameter<std::vector<double>>("angles");
-  pset.add_optional_parameter<std::string>("angle_type", "radians");
-  pset.add_optional_parameter<std::string>("angle_convention", "kocks");
+  pset.add_optional_parameter<std::string>("angle_type", std::string("radians"));
+  pset.add_optional_parameter<std::string>("angle_convention", std::string("kocks"));
 
   return pset;
 }
@@ -991,17 +991,25 @@ RankFour Orientation::apply(const RankFour & a) const
   return res;
 }
 
-SymSymR4 Orientation::apply(const SymSymR4 & a) const
+void Orientation::to_symmetric_rotation(double * const R) const
 {
-  SymSymR4 res;
-
   double M[9];
   to_matrix(M);
 
   const double f1 = 1.0;
   const double f2 = sqrt(2.0);
   const double f3 = sqrt(2.0);
-  double R[36] = {f1*M[0]*M[0],f1*M[1]*M[1],f1*M[2]*M[2],f3*M[1]*M[2],f3*M[2]*M[0],f3*M[0]*M[1],f1*M[3]*M[3],f1*M[4]*M[4],f1*M[5]*M[5],f3*M[4]*M[5],f3*M[5]*M[3],f3*M[3]*M[4],f1*M[6]*M[6],f1*M[7]*M[7],f1*M[8]*M[8],f3*M[7]*M[8],f3*M[8]*M[6],f3*M[6]*M[7],f2*M[3]*M[6],f2*M[4]*M[7],f2*M[5]*M[8],(M[4]*M[8]+M[5]*M[7]),(M[5]*M[6]+M[3]*M[8]),(M[3]*M[7]+M[4]*M[6]),f2*M[6]*M[0],f2*M[7]*M[1],f2*M[8]*M[2],(M[7]*M[2]+M[8]*M[1]),(M[8]*M[0]+M[6]*M[2]),(M[6]*M[1]+M[7]*M[0]),f2*M[0]*M[3],f2*M[1]*M[4],f2*M[2]*M[5],(M[1]*M[5]+M[2]*M[4]),(M[2]*M[3]+M[0]*M[5]),(M[0]*M[4]+M[1]*M[3])};
+  const double RR[36] = {f1*M[0]*M[0],f1*M[1]*M[1],f1*M[2]*M[2],f3*M[1]*M[2],f3*M[2]*M[0],f3*M[0]*M[1],f1*M[3]*M[3],f1*M[4]*M[4],f1*M[5]*M[5],f3*M[4]*M[5],f3*M[5]*M[3],f3*M[3]*M[4],f1*M[6]*M[6],f1*M[7]*M[7],f1*M[8]*M[8],f3*M[7]*M[8],f3*M[8]*M[6],f3*M[6]*M[7],f2*M[3]*M[6],f2*M[4]*M[7],f2*M[5]*M[8],(M[4]*M[8]+M[5]*M[7]),(M[5]*M[6]+M[3]*M[8]),(M[3]*M[7]+M[4]*M[6]),f2*M[6]*M[0],f2*M[7]*M[1],f2*M[8]*M[2],(M[7]*M[2]+M[8]*M[1]),(M[8]*M[0]+M[6]*M[2]),(M[6]*M[1]+M[7]*M[0]),f2*M[0]*M[3],f2*M[1]*M[4],f2*M[2]*M[5],(M[1]*M[5]+M[2]*M[4]),(M[2]*M[3]+M[0]*M[5]),(M[0]*M[4]+M[1]*M[3])};
+
+  std::copy(RR, RR+36, R);
+}
+
+SymSymR4 Orientation::apply(const SymSymR4 & a) const
+{
+  SymSymR4 res;
+
+  double R[36];
+  to_symmetric_rotation(R);
 
   rotate_matrix(6, 6, R, a.data(), res.s());
 
@@ -1015,6 +1023,79 @@ double Orientation::distance(const Orientation & other) const
   return acos(d);
 }
 
+OrientationArray::OrientationArray(size_t n) :
+    n_(n), data_(4*n, 0.0)
+{
+  std::fill(data_.begin(), data_.begin() + n_, 1.0);
+}
+
+OrientationArray::OrientationArray(const std::vector<Orientation> & qs) :
+    OrientationArray(qs.size())
+{
+  for (size_t i = 0; i < n_; i++) {
+    set(i, qs[i]);
+  }
+}
+
+OrientationArray::OrientationArray(
+    const std::vector<std::shared_ptr<Orientation>> & qs) :
+    OrientationArray(qs.size())
+{
+  for (size_t i = 0; i < n_; i++) {
+    set(i, *qs[i]);
+  }
+}
+
+OrientationArray OrientationArray::from_quaternions(size_t n,
+                                                    const double * const quats)
+{
+  OrientationArray res(n);
+  for (size_t i = 0; i < n; i++) {
+    // Through an Orientation so the quaternions come out normalized
+    res.set(i, Orientation(std::vector<double>(&quats[i*4], &quats[i*4+4])));
+  }
+  return res;
+}
+
+size_t OrientationArray::size() const
+{
+  return n_;
+}
+
+Orientation OrientationArray::get(size_t i) const
+{
+  double q[4];
+  quaternion(i, q);
+  return Orientation(std::vector<double>(q, q+4));
+}
+
+void OrientationArray::set(size_t i, const Orientation & q)
+{
+  const double * const v = q.quat();
+  for (size_t j = 0; j < 4; j++) {
+    data_[j*n_+i] = v[j];
+  }
+}
+
+void OrientationArray::quaternion(size_t i, double * const q) const
+{
+  for (size_t j = 0; j < 4; j++) {
+    q[j] = data_[j*n_+i];
+  }
+}
+
+void OrientationArray::to_quaternions(double * const quats) const
+{
+  for (size_t i = 0; i < n_; i++) {
+    quaternion(i, &quats[i*4]);
+  }
+}
+
+const double * OrientationArray::component(size_t j) const
+{
+  return data_.data() + j*n_;
+}
+
 std::vector<Orientation> random_orientations(int n)
 {
   double u[3];
@@ -1041,6 +1122,37 @@ std::vector<Orientation> random_orientations(int n)
   return result;
 }
 
+std::vector<Orientation> random_orientations(int n, unsigned long seed)
+{
+  std::mt19937_64 rng(seed);
+  std::vector<Orientation> result;
+  result.reserve(n);
+  for (int i=0; i<n; i++) {
+    result.emplace_back(random_orientation(rng));
+  }
+  return result;
+}
+
+Orientation random_orientation(std::mt19937_64 & rng)
+{
+  double u[3];
+  for (int j=0; j<3; j++) {
+    u[j] = random_uniform(rng);
+  }
+
+  double w = sqrt(1.0-u[0]) * sin(2.0 * M_PI * u[1]);
+  double x = sqrt(1.0-u[0]) * cos(2.0 * M_PI * u[1]);
+  double y = sqrt(u[0]) * sin(2.0 * M_PI * u[2]);
+  double z = sqrt(u[0]) * cos(2.0 * M_PI * u[2]);
+
+  return Orientation({w,x,y,z});
+}
+
+double random_uniform(std::mt19937_64 & rng)
+{
+  return (rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
 Orientation wexp(const Skew & w)
 {
   const double * wv = w.data();
@@ -7,6 +7,7 @@
 #include "../objects.h"
 
 #include <complex>
+#include <random>
 #include <vector>
 #include <string>
 
@@ -208,6 +209,8 @@ class NEML_EXPORT Orientation: public Quaternion {
   /// Convert to hyperspherical coordinates
   void to_hyperspherical(double & a1, double & a2, double & a3,
                          std::string angles = "radians") const;
+  /// 6x6 matrix rotating a Symmetric tensor stored as a Mandel vector
+  void to_symmetric_rotation(double * const R) const;
 
   // Annoyingly the operators must be for the most part redefined
   /// Opposite
@@ -261,11 +264,63 @@ NEML_EXPORT Orientation operator*(const Orientation & lhs, const Orientation & r
 /// Compose a rotation with the inverse of a rotation
 NEML_EXPORT Orientation operator/(const Orientation & lhs, const Orientation & rhs);
 
+/// A compact array of orientations
+//    The quaternions are stored component by component (all the scalar
+//    parts, then all the first vector components, and so on) in one
+//    block, 32 bytes a point, rather than as separate Orientation objects.
+//    This is the cheap way to give many points sharing one model their
+//    own orientations.
+class NEML_EXPORT OrientationArray {
+ public:
+  /// n identity orientations
+  explicit OrientationArray(size_t n = 0);
+  /// Copy in a vector of orientations
+  OrientationArray(const std::vector<Orientation> & qs);
+  /// Copy in a vector of pointers to orientations
+  OrientationArray(const std::vector<std::shared_ptr<Orientation>> & qs);
+
+  /// Copy in a row major (n,4) array of quaternions [s v1 v2 v3]
+  static OrientationArray from_quaternions(size_t n,
+                                           const double * const quats);
+
+  /// Number of orientations
+  size_t size() const;
+
+  /// Orientation i
+  Orientation get(size_t i) const;
+  /// Set orientation i
+  void set(size_t i, const Orientation & q);
+
+  /// Write orientation i into a raw [s v1 v2 v3] quaternion
+  void quaternion(size_t i, double * const q) const;
+  /// Write all the orientations as a row major (n,4) array
+  void to_quaternions(double * const quats) const;
+
+  /// Component j (0 is the scalar part) of all the orientations
+  const double * component(size_t j) const;
+
+ private:
+  size_t n_;
+  std::vector<double> data_;
+};
+
 /// Generate n random orientations
 //    This algorithm comes from LaValle, 2006 who I believe grabbed it
 //    from Shoemake, 1992
 NEML_EXPORT std::vector<Orientation> random_orientations(int n);
 
+/// Generate n random orientations, reproducibly from a seed
+NEML_EXPORT std::vector<Orientation> random_orientations(int n,
+                                                         unsigned long seed);
+
+/// Draw a single uniformly distributed orientation from a generator
+NEML_EXPORT Orientation random_orientation(std::mt19937_64 & rng);
+
+/// Uniform random number in [0,1) from a generator
+//    Computed directly from the raw bits so the stream of numbers is the
+//    same with any standard library
+NEML_EXPORT double random_uniform(std::mt19937_64 & rng);
+
 /// Exponential map of a skew tensor in my convention
 NEML_EXPORT Orientation wexp(const Skew & w);
 
@@ -236,7 +236,48 @@ PYBIND11_MODULE(rotations, m) {
       .def("distance", &Orientation::distance)
       ;
   
-  m.def("random_orientations", &random_orientations);
+  py::class_<OrientationArray, std::shared_ptr<OrientationArray>>(m, "OrientationArray")
+      .def(py::init<size_t>(), py::arg("n") = 0)
+      .def(py::init<const std::vector<Orientation> &>(), py::arg("qs"))
+      .def(py::init([](py::array_t<double, py::array::c_style> quats)
+                    {
+                      if ((quats.request().ndim != 2) ||
+                          (quats.request().shape[1] != 4)) {
+                        throw std::runtime_error("Quaternions must be an (n,4) array");
+                      }
+                      return OrientationArray::from_quaternions(
+                          quats.request().shape[0], arr2ptr<double>(quats));
+                    }), py::arg("quats"))
+      .def("__len__", &OrientationArray::size)
+      .def("__getitem__",
+           [](const OrientationArray & me, size_t i) -> Orientation
+           {
+            if (i >= me.size()) throw py::index_error();
+            return me.get(i);
+           })
+      .def("__setitem__",
+           [](OrientationArray & me, size_t i, const Orientation & q)
+           {
+            if (i >= me.size()) throw py::index_error();
+            me.set(i, q);
+           })
+      .def_property_readonly("quats",
+           [](const OrientationArray & me) -> py::array_t<double>
+           {
+            auto res = alloc_mat<double>(me.size(), 4);
+            me.to_quaternions(arr2ptr<double>(res));
+            return res;
+           }, "The orientations as an (n,4) array of quaternions")
+      ;
+
+  m.def("random_orientations",
+        static_cast<std::vector<Orientation> (*)(int)>(&random_orientations),
+        "Generate n random orientations", py::arg("n"));
+  m.def("random_orientations",
+        static_cast<std::vector<Orientation> (*)(int, unsigned long)>(
+            &random_orientations),
+        "Generate n random orientations, reproducibly from a seed",
+        py::arg("n"), py::arg("seed"));
   m.def("wexp", &wexp);
   m.def("wlog", &wlog);
   m.def("distance", &distance);
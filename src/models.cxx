@@ -1,13 +1,50 @@
 #include "models.h"
+#include "replay.h"
 
 #include "math/nemlmath.h"
 #include "nemlerror.h"
+#include "trace.h"
 
 #include <cassert>
 #include <limits>
+#include <cmath>
 
 namespace neml {
 
+// NEMLModel implementation
+void NEMLModel::collect_solver_stats(bool on)
+{
+  solver_stats_.enable(on);
+}
+
+SolverStats NEMLModel::solver_stats() const
+{
+  return solver_stats_.merged();
+}
+
+void NEMLModel::reset_solver_stats()
+{
+  solver_stats_.reset();
+}
+
+SolverStats * NEMLModel::local_solver_stats_() const
+{
+  return solver_stats_.local();
+}
+
+void NEMLModel::set_recorder(std::shared_ptr<UpdateRecorder> recorder)
+{
+  recorder_ = recorder;
+  if (recorder_ && (recorder_->iteration_threshold() > 0)) {
+    collect_solver_stats(true);
+  }
+}
+
+const std::shared_ptr<UpdateRecorder> & NEMLModel::recorder() const
+{
+  return recorder_;
+}
+
 // NEMLModel_sd implementation
 NEMLModel_sd::NEMLModel_sd(
     std::shared_ptr<LinearElasticModel> emodel,
@@ -33,7 +70,7 @@ int NEMLModel_sd::update_ld_inc(
     double * const h_np1, const double * const h_n,
     double * const A_np1, double * const B_np1,
     double & u_np1, double u_n,
-    double & p_np1, double p_n)
+    double & p_np1, double p_n) const
 {
   int ier;
   double base_A_np1[36];
@@ -107,7 +144,7 @@ int NEMLModel_sd::set_elastic_model(std::shared_ptr<LinearElasticModel> emodel)
 
 int NEMLModel_sd::calc_tangent_(const double * const D, const double * const W,
                                 const double * const C, const double * const S,
-                                double * const A, double * const B)
+                                double * const A, double * const B) const
 {
   int ier;
   double J[81];
@@ -165,7 +202,7 @@ int NEMLModel_ldi::update_sd(
    double * const h_np1, const double * const h_n,
    double * const A_np1,
    double & u_np1, double u_n,
-   double & p_np1, double p_n)
+   double & p_np1, double p_n) const
 {
   double W[3] = {0,0,0};
   double B[18];
@@ -189,10 +226,12 @@ SubstepModel_sd::SubstepModel_sd(std::shared_ptr<LinearElasticModel> emodel,
                                  std::shared_ptr<Interpolate> alpha,
                                  bool truesdell, 
                                  double tol, int miter, bool verbose,                                 
-                                 int max_divide, bool force_divide) :
+                                 int max_divide, bool force_divide,
+                                 bool adaptive_substep, double substep_tol) :
     NEMLModel_sd(emodel, alpha, truesdell), 
     tol_(tol), miter_(miter), verbose_(verbose),
-    max_divide_(max_divide), force_divide_(force_divide)
+    max_divide_(max_divide), force_divide_(force_divide),
+    adaptive_substep_(adaptive_substep), substep_tol_(substep_tol)
 {
 
 }
@@ -205,8 +244,14 @@ int SubstepModel_sd::update_sd(
     double * const h_np1, const double * const h_n,
     double * const A_np1,
     double & u_np1, double u_n,
-    double & p_np1, double p_n)
+    double & p_np1, double p_n) const
 {
+  NEML_TRACE_SCOPE("update_sd");
+  if (adaptive_substep_) {
+    return update_controlled_(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1, s_n,
+                              h_np1, h_n, A_np1, u_np1, u_n, p_np1, p_n);
+  }
+
 // Setup the substep parameters
   int nd = 0;                     // Number of times we subdivided
   int tf = pow(2, max_divide_);   // Total integer step count
@@ -245,6 +290,7 @@ int SubstepModel_sd::update_sd(
   std::fill(A_old, A_old+(nparams()*6), 0.0);
 
   while (cs < tf) {
+    NEML_TRACE_SCOPE("substep");
     // targets
     double sm = (double) (cs + cm) / (double) tf;
     double sf = (double) cm / (double) tf;
@@ -269,6 +315,8 @@ int SubstepModel_sd::update_sd(
       nd += 1;
       if (nd >= max_divide_) return ier;  // Failed entirely
       cm /= 2;
+      SolverStats * stats = local_solver_stats_();
+      if (stats != nullptr) stats->substep_divisions++;
       continue;
     }
     
@@ -307,6 +355,146 @@ int SubstepModel_sd::update_sd(
   return 0;
 }
 
+int SubstepModel_sd::update_controlled_(
+    const double * const e_np1, const double * const e_n,
+    double T_np1, double T_n,
+    double t_np1, double t_n,
+    double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n,
+    double * const A_np1,
+    double & u_np1, double u_n,
+    double & p_np1, double p_n) const
+{
+  size_t n = nparams();
+  size_t nh = nhist();
+  // Only the history actually integrated enters the error estimate
+  size_t ne = 6 + std::min(nh, n - 6);
+  double min_step = 1.0 / pow(2, max_divide_);
+
+  // Current (accepted) state, as a fraction of the increment
+  double frac = 0.0;
+  double e_past[6];
+  std::copy(e_n, e_n+6, e_past);
+  std::vector<double> y_past(6 + nh);
+  std::copy(s_n, s_n+6, y_past.begin());
+  std::copy(h_n, h_n+nh, y_past.begin()+6);
+  double T_past = T_n;
+  double t_past = t_n;
+  double u_past = u_n;
+  double p_past = p_n;
+
+  // One full and two half substeps
+  double e_half[6], e_next[6];
+  std::vector<double> y_full(6 + nh), y_half(6 + nh), y_two(6 + nh);
+  double u_full, p_full, u_half, p_half, u_two, p_two;
+
+  // Tangent storage, chained across the accepted substeps
+  std::vector<double> A_old(n * 6, 0.0), A_new(n * 6);
+  std::vector<double> A_inc(n * n), E_inc(n * 6);
+  std::vector<double> A_1(n * n), E_1(n * 6), A_2(n * n), E_2(n * 6);
+
+  double step = 1.0;
+  while (frac < 1.0) {
+    NEML_TRACE_SCOPE("substep");
+    step = std::min(step, 1.0 - frac);
+    double fh = frac + step / 2.0;
+    double ff = frac + step;
+    if (1.0 - ff < min_step / 2.0) ff = 1.0;
+
+    for (size_t i = 0; i < 6; i++) {
+      e_half[i] = e_n[i] + fh * (e_np1[i] - e_n[i]);
+      e_next[i] = e_n[i] + ff * (e_np1[i] - e_n[i]);
+    }
+    double T_half = T_n + fh * (T_np1 - T_n);
+    double T_next = T_n + ff * (T_np1 - T_n);
+    double t_half = t_n + fh * (t_np1 - t_n);
+    double t_next = t_n + ff * (t_np1 - t_n);
+
+    int ier = update_step(e_next, e_past, T_next, T_past, t_next, t_past,
+                          &y_full[0], &y_past[0], &y_full[6], &y_past[6],
+                          &A_inc[0], &E_inc[0], u_full, u_past, p_full, 
+                          p_past);
+    if (ier == SUCCESS) {
+      ier = update_step(e_half, e_past, T_half, T_past, t_half, t_past,
+                        &y_half[0], &y_past[0], &y_half[6], &y_past[6],
+                        &A_1[0], &E_1[0], u_half, u_past, p_half, p_past);
+    }
+    if (ier == SUCCESS) {
+      ier = update_step(e_next, e_half, T_next, T_half, t_next, t_half,
+                        &y_two[0], &y_half[0], &y_two[6], &y_half[6],
+                        &A_2[0], &E_2[0], u_two, u_half, p_two, p_half);
+    }
+
+    // Backward Euler has a second order local error, so the difference
+    // between one step and two half steps estimates the error in the 
+    // half steps
+    double err = 0.0;
+    if (ier == SUCCESS) {
+      for (size_t i = 0; i < ne; i++) {
+        double sc = substep_tol_ * (1.0 + std::max(fabs(y_past[i]), 
+                                                   fabs(y_two[i])));
+        err += pow((y_two[i] - y_full[i]) / sc, 2.0);
+      }
+      err = sqrt(err / ne);
+      // The solver can "converge" on a NaN residual
+      if (not std::isfinite(err)) ier = LINALG_FAILURE;
+    }
+
+    // Failed solves just cut the step
+    if (ier != SUCCESS) {
+      if (step <= min_step) return ier;
+      step = std::max(step / 4.0, min_step);
+      SolverStats * stats = local_solver_stats_();
+      if (stats != nullptr) stats->substep_divisions++;
+      continue;
+    }
+
+    // Accept if the error is small enough or we can't cut the step anymore
+    if ((err <= 1.0) || (step <= min_step)) {
+      for (size_t i = 0; i < n*6; i++) A_old[i] += E_1[i] * (fh - frac);
+      mat_mat(n, 6, n, &A_1[0], &A_old[0], &A_new[0]);
+      for (size_t i = 0; i < n*6; i++) A_old[i] = A_new[i] + E_2[i] * (ff - fh);
+      mat_mat(n, 6, n, &A_2[0], &A_old[0], &A_new[0]);
+      A_old = A_new;
+
+      frac = ff;
+      std::copy(e_next, e_next+6, e_past);
+      y_past = y_two;
+      T_past = T_next;
+      t_past = t_next;
+      u_past = u_two;
+      p_past = p_two;
+    }
+    
+    // Usual step size control, bounded growth and shrink
+    double fact = 4.0;
+    if (err > 0.0) fact = std::min(4.0, std::max(0.2, 0.9 / sqrt(err)));
+    step = std::max(step * fact, min_step);
+  }
+
+  std::copy(y_past.begin(), y_past.begin()+6, s_np1);
+  std::copy(y_past.begin()+6, y_past.end(), h_np1);
+  u_np1 = u_past;
+  p_np1 = p_past;
+
+  // Extract the leading 6x6 part of the A matrix
+  for (size_t i = 0; i < 6; i++) {
+    for (size_t j = 0; j < 6; j++) {
+      A_np1[CINDEX(i,j,6)] = A_old[CINDEX(i,j,6)];
+    }
+  }
+
+  return 0;
+}
+
+void SubstepModel_sd::elastic_history(
+    double t_np1, double t_n,
+    const double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n) const
+{
+  std::copy(h_n, h_n+nhist(), h_np1);
+}
+
 int SubstepModel_sd::update_step(
     const double * const e_np1, const double * const e_n,
     double T_np1, double T_n,
@@ -315,7 +503,7 @@ int SubstepModel_sd::update_step(
     double * const h_np1, const double * const h_n,
     double * const A, double * const E,
     double & u_np1, double u_n,
-    double & p_np1, double p_n)
+    double & p_np1, double p_n) const
 {
   // Setup the trial state
   TrialState * ts = setup(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_n, h_n);
@@ -331,7 +519,7 @@ int SubstepModel_sd::update_step(
     mat_vec(C, 6, de, 6, s_np1);
     for (size_t i = 0; i < 6; i++) s_np1[i] += s_n[i];
     // History
-    std::copy(h_n, h_n+nhist(), h_np1);
+    elastic_history(t_np1, t_n, s_np1, s_n, h_np1, h_n);
     // Jacobian for substepping
     std::fill(A, A+(nparams()*nparams()), 0.0);
     for (size_t i = 0; i < 6; i++) A[CINDEX(i,i,nparams())] = 1.0;
@@ -352,8 +540,7 @@ int SubstepModel_sd::update_step(
   
   // Solve the system
   double * x = new double [nparams()]; 
-  int ier = solve(this, x, ts, tol_, miter_, verbose_, false, nullptr, 
-                  A); // Keep jacobian
+  int ier = integrate(ts, x, A); // Keep jacobian
   if (ier != SUCCESS) {
     delete [] x;
     delete ts;
@@ -398,6 +585,13 @@ int SubstepModel_sd::update_step(
   return ier;
 }
 
+int SubstepModel_sd::integrate(TrialState * ts, double * const x,
+                               double * const A) const
+{
+  return solve(this, x, ts, tol_, miter_, verbose_, false, nullptr, A,
+               nullptr, local_solver_stats_());
+}
+
 // Implementation of small strain elasticity
 SmallStrainElasticity::SmallStrainElasticity(
     std::shared_ptr<LinearElasticModel> elastic,
@@ -453,8 +647,9 @@ int SmallStrainElasticity::update_sd(
        double * const h_np1, const double * const h_n,
        double * const A_np1,
        double & u_np1, double u_n,
-       double & p_np1, double p_n)
+       double & p_np1, double p_n) const
 {
+  NEML_TRACE_SCOPE("update_sd");
   int ier = elastic_->C(T_np1, A_np1);
   if (ier != SUCCESS) return ier;
   mat_vec(A_np1, 6, e_np1, 6, s_np1);
@@ -479,9 +674,11 @@ SmallStrainPerfectPlasticity::SmallStrainPerfectPlasticity(
     std::shared_ptr<Interpolate> alpha,
     double tol, int miter,
     bool verbose, int max_divide,
-    bool force_divide, bool truesdell) :
+    bool force_divide, bool truesdell,
+    bool adaptive_substep, double substep_tol) :
       SubstepModel_sd(elastic, alpha, truesdell, tol, miter, verbose, 
-                      max_divide, force_divide),
+                      max_divide, force_divide, adaptive_substep, 
+                      substep_tol),
       surface_(surface), ys_(ys)
 {
 
@@ -507,6 +704,8 @@ ParameterSet SmallStrainPerfectPlasticity::parameters()
   pset.add_optional_parameter<bool>("verbose", false);
   pset.add_optional_parameter<int>("max_divide", 4);
   pset.add_optional_parameter<bool>("force_divide", false);
+  pset.add_optional_parameter<bool>("adaptive_substep", false);
+  pset.add_optional_parameter<double>("substep_tol", 1.0e-4);
 
   pset.add_optional_parameter<bool>("truesdell", true);
 
@@ -525,7 +724,9 @@ std::unique_ptr<NEMLObject> SmallStrainPerfectPlasticity::initialize(ParameterSe
       params.get_parameter<bool>("verbose"),
       params.get_parameter<int>("max_divide"),
       params.get_parameter<bool>("force_divide"),
-      params.get_parameter<bool>("truesdell")
+      params.get_parameter<bool>("truesdell"),
+      params.get_parameter<bool>("adaptive_substep"),
+      params.get_parameter<double>("substep_tol")
       ); 
 }
 
@@ -544,7 +745,7 @@ TrialState * SmallStrainPerfectPlasticity::setup(
     double T_np1, double T_n,
     double t_np1, double t_n,
     const double * const s_n,
-    const double * const h_n)
+    const double * const h_n) const
 {
   SSPPTrialState * tss = new SSPPTrialState();
   make_trial_state(e_np1, e_n, T_np1, T_n, t_np1, T_n,
@@ -558,7 +759,7 @@ bool SmallStrainPerfectPlasticity::elastic_step(
     double T_np1, double T_n,
     double t_np1, double t_n,
     const double * const s_n,
-    const double * const h_n)
+    const double * const h_n) const
 {
   const SSPPTrialState * tss = static_cast<const SSPPTrialState*>(ts);
   double fv;
@@ -572,7 +773,7 @@ int SmallStrainPerfectPlasticity::update_internal(
     double T_np1, double T_n,
     double t_np1, double t_n,
     double * const s_np1, const double * const s_n,
-    double * const h_np1, const double * const h_n)
+    double * const h_np1, const double * const h_n) const
 {
   std::copy(x, x+6, s_np1);
   return 0;
@@ -585,7 +786,7 @@ int SmallStrainPerfectPlasticity::strain_partial(
     double t_np1, double t_n,
     const double * const s_np1, const double * const s_n,
     const double * const h_np1, const double * const h_n,
-    double * const de)
+    double * const de) const
 {
   const SSPPTrialState * tss = static_cast<const SSPPTrialState*>(ts);
   std::fill(de, de+(6*nparams()), 0.0);
@@ -607,7 +808,7 @@ int SmallStrainPerfectPlasticity::work_and_energy(
     double * const s_np1, const double * const s_n,
     double * const h_np1, const double * const h_n,
     double & u_np1, double u_n,
-    double & p_np1, double p_n)
+    double & p_np1, double p_n) const
 {
   const SSPPTrialState * tss = static_cast<const SSPPTrialState*>(ts);
 
@@ -638,7 +839,7 @@ size_t SmallStrainPerfectPlasticity::nparams() const
   return 7;
 }
 
-int SmallStrainPerfectPlasticity::init_x(double * const x, TrialState * ts)
+int SmallStrainPerfectPlasticity::init_x(double * const x, TrialState * ts) const
 {
   SSPPTrialState * tss = static_cast<SSPPTrialState *>(ts);
   std::copy(tss->s_tr, tss->s_tr+6, x);
@@ -649,7 +850,7 @@ int SmallStrainPerfectPlasticity::init_x(double * const x, TrialState * ts)
 
 int SmallStrainPerfectPlasticity::RJ(
     const double * const x, TrialState * ts, double * const R,
-    double * const J)
+    double * const J) const
 {
   SSPPTrialState * tss = static_cast<SSPPTrialState *>(ts);
   const double * const s_np1 = x;
@@ -712,7 +913,7 @@ int SmallStrainPerfectPlasticity::make_trial_state(
     const double * const e_np1, const double * const e_n,
     double T_np1, double T_n, double t_np1, double t_n,
     const double * const s_n, const double * const h_n,
-    SSPPTrialState & ts)
+    SSPPTrialState & ts) const
 {
   ts.ys = -ys_->value(T_np1);
   ts.T = T_np1;
@@ -743,9 +944,11 @@ SmallStrainRateIndependentPlasticity::SmallStrainRateIndependentPlasticity(
     std::shared_ptr<RateIndependentFlowRule> flow, 
     std::shared_ptr<Interpolate> alpha, bool truesdell,
     double tol, int miter, bool verbose,
-    int max_divide, bool force_divide) : 
+    int max_divide, bool force_divide,
+    bool adaptive_substep, double substep_tol) : 
       SubstepModel_sd(elastic, alpha, truesdell, tol, miter, verbose,
-                      max_divide, force_divide),
+                      max_divide, force_divide, adaptive_substep,
+                      substep_tol),
       flow_(flow)
 {
 
@@ -773,6 +976,8 @@ ParameterSet SmallStrainRateIndependentPlasticity::parameters()
 
   pset.add_optional_parameter<int>("max_divide", 4);
   pset.add_optional_parameter<bool>("force_divide", false);
+  pset.add_optional_parameter<bool>("adaptive_substep", false);
+  pset.add_optional_parameter<double>("substep_tol", 1.0e-4);
 
 
   return pset;
@@ -789,7 +994,9 @@ std::unique_ptr<NEMLObject> SmallStrainRateIndependentPlasticity::initialize(Par
       params.get_parameter<int>("miter"),
       params.get_parameter<bool>("verbose"),
       params.get_parameter<int>("max_divide"),
-      params.get_parameter<bool>("force_divide")
+      params.get_parameter<bool>("force_divide"),
+      params.get_parameter<bool>("adaptive_substep"),
+      params.get_parameter<double>("substep_tol")
       ); 
 }
 
@@ -808,7 +1015,7 @@ TrialState * SmallStrainRateIndependentPlasticity::setup(
     double T_np1, double T_n,
     double t_np1, double t_n,
     const double * const s_n,
-    const double * const h_n)
+    const double * const h_n) const
 {
   SSRIPTrialState * tss = new SSRIPTrialState();
   make_trial_state(e_np1, e_n, T_np1, T_n, t_np1, T_n,
@@ -822,7 +1029,7 @@ bool SmallStrainRateIndependentPlasticity::elastic_step(
     double T_np1, double T_n,
     double t_np1, double t_n,
     const double * const s_n,
-    const double * const h_n)
+    const double * const h_n) const
 {
   const SSRIPTrialState * tss = static_cast<const SSRIPTrialState *>(ts);
 
@@ -837,7 +1044,7 @@ int SmallStrainRateIndependentPlasticity::update_internal(
     double T_np1, double T_n,
     double t_np1, double t_n,
     double * const s_np1, const double * const s_n,
-    double * const h_np1, const double * const h_n)
+    double * const h_np1, const double * const h_n) const
 {
   std::copy(x, x+6, s_np1);
   std::copy(x+6, x+6+nhist(), h_np1);
@@ -851,7 +1058,7 @@ int SmallStrainRateIndependentPlasticity::strain_partial(
     double t_np1, double t_n,
     const double * const s_np1, const double * const s_n,
     const double * const h_np1, const double * const h_n,
-    double * const de)
+    double * const de) const
 {
   const SSRIPTrialState * tss = static_cast<const SSRIPTrialState *>(ts);
   std::fill(de, de+(6*nparams()), 0.0);
@@ -872,7 +1079,7 @@ int SmallStrainRateIndependentPlasticity::work_and_energy(
     double * const s_np1, const double * const s_n,
     double * const h_np1, const double * const h_n,
     double & u_np1, double u_n,
-    double & p_np1, double p_n)
+    double & p_np1, double p_n) const
 {
   const SSRIPTrialState * tss = static_cast<const SSRIPTrialState *>(ts);
 
@@ -904,7 +1111,7 @@ size_t SmallStrainRateIndependentPlasticity::nparams() const
   return 6 + flow_->nhist() + 1;
 }
 
-int SmallStrainRateIndependentPlasticity::init_x(double * const x, TrialState * ts)
+int SmallStrainRateIndependentPlasticity::init_x(double * const x, TrialState * ts) const
 {
   SSRIPTrialState * tss = static_cast<SSRIPTrialState *>(ts);
   std::copy(tss->s_tr, tss->s_tr+6, x);
@@ -915,7 +1122,7 @@ int SmallStrainRateIndependentPlasticity::init_x(double * const x, TrialState *
 
 int SmallStrainRateIndependentPlasticity::RJ(const double * const x, 
                                              TrialState * ts, 
-                                             double * const R, double * const J)
+                                             double * const R, double * const J) const
 {
   SSRIPTrialState * tss = static_cast<SSRIPTrialState *>(ts);
 
@@ -1044,6 +1251,44 @@ int SmallStrainRateIndependentPlasticity::RJ(const double * const x,
   return 0;
 }
 
+int SmallStrainRateIndependentPlasticity::R(const double * const x, 
+                                            TrialState * ts, 
+                                            double * const R) const
+{
+  SSRIPTrialState * tss = static_cast<SSRIPTrialState *>(ts);
+
+  int nh = flow_->nhist();
+
+  const double * const s_np1 = &x[0];
+  const double * const alpha  = &x[6];
+  const double & dg = x[6+nh];
+
+  double g[6];
+  int ier = flow_->g(s_np1, alpha, tss->T, g); 
+  if (ier != SUCCESS) return ier;
+  ier = flow_->h(s_np1, alpha, tss->T, &R[6]);
+  if (ier != SUCCESS) return ier;
+  double f;
+  ier = flow_->f(s_np1, alpha, tss->T, f);
+  if (ier != SUCCESS) return ier;
+
+  double R1[6];
+  for (int i=0; i<6; i++) {
+    R1[i] = tss->e_np1[i] - tss->ep_tr[i] - g[i] * dg;
+  }
+  mat_vec(tss->C, 6, R1, 6, R);
+  for (int i=0; i<6; i++) {
+    R[i] = s_np1[i] - R[i];
+  }
+
+  for (int i=0; i<nh; i++) {
+    R[i+6] = alpha[i] - tss->h_tr[i] - R[i+6] * dg;
+  }
+  R[6+nh] = f;
+
+  return 0;
+}
+
 const std::shared_ptr<const LinearElasticModel> SmallStrainRateIndependentPlasticity::elastic() const
 {
   return elastic_;
@@ -1053,7 +1298,7 @@ int SmallStrainRateIndependentPlasticity::make_trial_state(
     const double * const e_np1, const double * const e_n,
     double T_np1, double T_n, double t_np1, double t_n,
     const double * const s_n, const double * const h_n,
-    SSRIPTrialState & ts)
+    SSRIPTrialState & ts) const
 {
   // Save e_np1
   std::copy(e_np1, e_np1+6, ts.e_np1);
@@ -1156,8 +1401,9 @@ int SmallStrainCreepPlasticity::update_sd(
        double * const h_np1, const double * const h_n,
        double * const A_np1,
        double & u_np1, double u_n,
-       double & p_np1, double p_n)
+       double & p_np1, double p_n) const
 {
+  NEML_TRACE_SCOPE("update_sd");
 
   // Solve the system to get the update
   SSCPTrialState ts;
@@ -1166,7 +1412,8 @@ int SmallStrainCreepPlasticity::update_sd(
 
   std::vector<double> xv(nparams());
   double * x = &xv[0];
-  ier = solve(this, x, &ts, tol_, miter_, verbose_);
+  ier = solve(this, x, &ts, tol_, miter_, verbose_, false, nullptr,
+              nullptr, nullptr, local_solver_stats_());
   if (ier != 0) return ier;
 
   // Store the ep strain
@@ -1216,7 +1463,7 @@ size_t SmallStrainCreepPlasticity::nparams() const
   return 6;
 }
 
-int SmallStrainCreepPlasticity::init_x(double * const x, TrialState * ts)
+int SmallStrainCreepPlasticity::init_x(double * const x, TrialState * ts) const
 {
   SSCPTrialState * tss = static_cast<SSCPTrialState*>(ts);
 
@@ -1227,15 +1474,44 @@ int SmallStrainCreepPlasticity::init_x(double * const x, TrialState * ts)
 }
 
 int SmallStrainCreepPlasticity::RJ(const double * const x, TrialState * ts, 
-                                   double * const R, double * const J)
+                                   double * const R, double * const J) const
+{
+  SSCPTrialState * tss = static_cast<SSCPTrialState*>(ts);
+
+  double A_np1[36];
+  double B[36];
+  int ier = residual_(x, tss, R, A_np1, B);
+  if (ier != 0) return ier;
+  
+  // The Jacobian is a straightforward combination of the two derivatives
+  ier = mat_mat(6, 6, 6, B, A_np1, J);
+  for (int i=0; i<6; i++) J[CINDEX(i,i,6)] += 1.0;
+  for (int i=0; i<36; i++) J[i] *= sf_;
+
+  return ier;
+}
+
+int SmallStrainCreepPlasticity::R(const double * const x, TrialState * ts, 
+                                  double * const R) const
 {
   SSCPTrialState * tss = static_cast<SSCPTrialState*>(ts);
 
+  // The component updates give their tangents anyway
+  double A_np1[36];
+  double B[36];
+  return residual_(x, tss, R, A_np1, B);
+}
+
+int SmallStrainCreepPlasticity::residual_(const double * const x,
+                                          SSCPTrialState * tss,
+                                          double * const R,
+                                          double * const A_np1,
+                                          double * const B) const
+{
   int ier;
 
   // First update the elastic-plastic model
   double s_np1[6];
-  double A_np1[36];
   std::vector<double> h_np1;
   h_np1.resize(plastic_->nhist());
   double u_np1, u_n;
@@ -1255,7 +1531,6 @@ int SmallStrainCreepPlasticity::RJ(const double * const x, TrialState * ts,
   // Then update the creep strain
   double creep_old[6];
   double creep_new[6];
-  double B[36];
   for (int i=0; i<6; i++) {
     creep_old[i] = tss->e_n[i] - tss->ep_strain[i];
   }
@@ -1267,20 +1542,15 @@ int SmallStrainCreepPlasticity::RJ(const double * const x, TrialState * ts,
   for (int i=0; i<6; i++) {
     R[i] = (x[i] + creep_new[i] - tss->e_np1[i]) * sf_;
   }
-  
-  // The Jacobian is a straightforward combination of the two derivatives
-  ier = mat_mat(6, 6, 6, B, A_np1, J);
-  for (int i=0; i<6; i++) J[CINDEX(i,i,6)] += 1.0;
-  for (int i=0; i<36; i++) J[i] *= sf_;
 
-  return ier;
+  return 0;
 }
 
 int SmallStrainCreepPlasticity::make_trial_state(
     const double * const e_np1, const double * const e_n,
     double T_np1, double T_n, double t_np1, double t_n,
     const double * const s_n, const double * const h_n,
-    SSCPTrialState & ts)
+    SSCPTrialState & ts) const
 {
   int nh = plastic_->nhist();
   ts.h_n.resize(nh);
@@ -1300,7 +1570,7 @@ int SmallStrainCreepPlasticity::make_trial_state(
 }
 
 int SmallStrainCreepPlasticity::form_tangent_(
-    double * const A, double * const B, double * const A_np1)
+    double * const A, double * const B, double * const A_np1) const
 {
   // Okay, what we really want to do is
   // (A^-1 + B)^-1
@@ -1348,10 +1618,19 @@ GeneralIntegrator::GeneralIntegrator(std::shared_ptr<LinearElasticModel> elastic
                                      std::shared_ptr<Interpolate> alpha,
                                      bool truesdell, double tol, int miter,
                                      bool verbose, int max_divide,
-                                     bool force_divide) :
+                                     bool force_divide, bool mixed_precision,
+                                     std::string predictor,
+                                     bool adaptive_explicit,
+                                     double explicit_tol,
+                                     int explicit_max_steps,
+                                     bool adaptive_substep,
+                                     double substep_tol) :
     SubstepModel_sd(elastic, alpha, truesdell, tol, miter, verbose, max_divide,
-                    force_divide),
-    rule_(rule)
+                    force_divide, adaptive_substep, substep_tol),
+    rule_(rule), mixed_precision_(mixed_precision),
+    predictor_(parse_predictor(predictor)),
+    adaptive_explicit_(adaptive_explicit), explicit_tol_(explicit_tol),
+    explicit_max_steps_(explicit_max_steps)
 {
 
 }
@@ -1377,6 +1656,13 @@ ParameterSet GeneralIntegrator::parameters()
   pset.add_optional_parameter<bool>("verbose", false);
   pset.add_optional_parameter<int>("max_divide", 4);
   pset.add_optional_parameter<bool>("force_divide", false);
+  pset.add_optional_parameter<bool>("adaptive_substep", false);
+  pset.add_optional_parameter<double>("substep_tol", 1.0e-4);
+  pset.add_optional_parameter<bool>("mixed_precision", false);
+  pset.add_optional_parameter<std::string>("predictor", std::string("none"));
+  pset.add_optional_parameter<bool>("adaptive_explicit", false);
+  pset.add_optional_parameter<double>("explicit_tol", 1.0e-4);
+  pset.add_optional_parameter<int>("explicit_max_steps", 20);
 
   return pset;
 }
@@ -1392,7 +1678,14 @@ std::unique_ptr<NEMLObject> GeneralIntegrator::initialize(ParameterSet & params)
       params.get_parameter<int>("miter"),
       params.get_parameter<bool>("verbose"),
       params.get_parameter<int>("max_divide"),
-      params.get_parameter<bool>("force_divide")
+      params.get_parameter<bool>("force_divide"),
+      params.get_parameter<bool>("mixed_precision"),
+      params.get_parameter<std::string>("predictor"),
+      params.get_parameter<bool>("adaptive_explicit"),
+      params.get_parameter<double>("explicit_tol"),
+      params.get_parameter<int>("explicit_max_steps"),
+      params.get_parameter<bool>("adaptive_substep"),
+      params.get_parameter<double>("substep_tol")
       ); 
 }
 
@@ -1401,7 +1694,7 @@ TrialState * GeneralIntegrator::setup(
     double T_np1, double T_n,
     double t_np1, double t_n,
     const double * const s_n,
-    const double * const h_n)
+    const double * const h_n) const
 {
   GITrialState * tss = new GITrialState();
   make_trial_state(e_np1, e_n, T_np1, T_n, t_np1, t_n, 
@@ -1415,7 +1708,7 @@ bool GeneralIntegrator::elastic_step(
     double T_np1, double T_n,
     double t_np1, double t_n,
     const double * const s_n,
-    const double * const h_n)
+    const double * const h_n) const
 {
   double de[6];
   sub_vec(e_np1, e_n, 6, de);
@@ -1429,16 +1722,45 @@ bool GeneralIntegrator::elastic_step(
   return false;
 }
 
+void GeneralIntegrator::elastic_history(
+    double t_np1, double t_n,
+    const double * const s_np1, const double * const s_n,
+    double * const h_np1, const double * const h_n) const
+{
+  size_t nh = rule_->nhist();
+  std::copy(h_n, h_n+nh, h_np1);
+
+  // The rates of the last inelastic step no longer describe the material,
+  // so the next step starts from no rate instead of extrapolating them
+  if (predictor_ == PREDICTOR_EXTRAPOLATE) {
+    std::fill(&h_np1[nh], &h_np1[nh]+6+nh, 0.0);
+  }
+}
+
 int GeneralIntegrator::update_internal(
     const double * const x,
     const double * const e_np1, const double * const e_n,
     double T_np1, double T_n,
     double t_np1, double t_n,
     double * const s_np1, const double * const s_n,
-    double * const h_np1, const double * const h_n)
+    double * const h_np1, const double * const h_n) const
 {
+  size_t nh = rule_->nhist();
   std::copy(x, x+6, s_np1);
-  std::copy(x+6, x+6+nhist(), h_np1);
+  std::copy(x+6, x+6+nh, h_np1);
+
+  // Save the rates over the step for the next predictor
+  if (predictor_ == PREDICTOR_EXTRAPOLATE) {
+    double dt = t_np1 - t_n;
+    double * rate = &h_np1[nh];
+    if (dt > 0.0) {
+      for (size_t i = 0; i < 6; i++) rate[i] = (x[i] - s_n[i]) / dt;
+      for (size_t i = 0; i < nh; i++) rate[i+6] = (x[i+6] - h_n[i]) / dt;
+    }
+    else {
+      std::copy(&h_n[nh], &h_n[nh]+6+nh, rate);
+    }
+  }
 
   return 0;
 }
@@ -1450,7 +1772,7 @@ int GeneralIntegrator::strain_partial(
     double t_np1, double t_n,
     const double * const s_np1, const double * const s_n,
     const double * const h_np1, const double * const h_n,
-    double * de)
+    double * de) const
 {
   const GITrialState * tss = static_cast<const GITrialState*>(ts);
   
@@ -1468,10 +1790,10 @@ int GeneralIntegrator::strain_partial(
 
   if (ier != SUCCESS) return ier;
 
-  double * ehist = new double [6*nhist()];
+  double * ehist = new double [6*rule_->nhist()];
 
   ier = rule_->da_de(s_np1, h_np1, tss->e_dot, tss->T, tss->Tdot, ehist);
-  for (size_t i = 0; i < nhist(); i++) {
+  for (size_t i = 0; i < rule_->nhist(); i++) {
     for (size_t j = 0; j < 6; j++) {
       de[CINDEX((i+6),j,6)] = ehist[CINDEX(i,j,6)];
     }
@@ -1490,7 +1812,7 @@ int GeneralIntegrator::work_and_energy(
     double * const s_np1, const double * const s_n,
     double * const h_np1, const double * const h_n,
     double & u_np1, double u_n,
-    double & p_np1, double p_n)
+    double & p_np1, double p_n) const
 {
   const GITrialState * tss = static_cast<const GITrialState *>(ts);
 
@@ -1514,30 +1836,37 @@ int GeneralIntegrator::work_and_energy(
 
 size_t GeneralIntegrator::nhist() const
 {
+  // The extrapolation predictor stores the last stress and history rates
+  if (predictor_ == PREDICTOR_EXTRAPOLATE) {
+    return 6 + 2 * rule_->nhist();
+  }
   return rule_->nhist();
 }
 
 int GeneralIntegrator::init_hist(double * const hist) const
 {
+  if (predictor_ == PREDICTOR_EXTRAPOLATE) {
+    std::fill(&hist[rule_->nhist()], &hist[nhist()], 0.0);
+  }
   return rule_->init_hist(hist);
 }
 
 size_t GeneralIntegrator::nparams() const
 {
-  return 6 + nhist();
+  return 6 + rule_->nhist();
 }
 
-int GeneralIntegrator::init_x(double * const x, TrialState * ts)
+int GeneralIntegrator::init_x(double * const x, TrialState * ts) const
 {
   GITrialState * tss = static_cast<GITrialState*>(ts);
   std::copy(tss->s_guess, tss->s_guess+6, x);
-  std::copy(tss->h_n.begin(), tss->h_n.end(), &x[6]);
+  std::copy(tss->h_guess.begin(), tss->h_guess.end(), &x[6]);
 
   return 0;
 }
 
 int GeneralIntegrator::RJ(const double * const x, TrialState * ts,
-                          double * const R, double * const J)
+                          double * const R, double * const J) const
 {
   GITrialState * tss = static_cast<GITrialState*>(ts);
 
@@ -1548,26 +1877,34 @@ int GeneralIntegrator::RJ(const double * const x, TrialState * ts,
   // Helps with vectorization
   // Really as I declared both const this shouldn't be necessary but hey
   // I don't design optimizing compilers for a living
-  int nhist = this->nhist();
+  int nhist = rule_->nhist();
   int nparams = this->nparams();
 
-  // Residual calculation
-  int ier = rule_->s(s_np1, h_np1, tss->e_dot, tss->T, tss->Tdot, R);
+  // Rates and all the partials in one call, writing the history
+  // blocks and the rule's own scratch into space kept with the trial state
+  tss->work.resize(6*nhist + nhist*6 + nhist*nhist + rule_->nwork());
+  double * J12 = tss->work.data();
+  double * J21 = J12 + 6*nhist;
+  double * J22 = J12 + 12*nhist;
+  double J11[36];
+  int ier = rule_->evaluate(s_np1, h_np1, tss->e_dot, tss->T, tss->Tdot,
+                            R, J11, J12, &R[6], J21, J22,
+                            J22 + nhist*nhist);
   if (ier != SUCCESS) return ier;
+
+  // More vectorization
+  double dt = tss->dt;
+
+  // Residual calculation
   for (int i=0; i<6; i++) {
-    R[i] = s_np1[i] - tss->s_n[i] - R[i] * tss->dt;
+    R[i] = s_np1[i] - tss->s_n[i] - R[i] * dt;
   }
-  ier = rule_->a(s_np1, h_np1, tss->e_dot, tss->T, tss->Tdot, &R[6]);
-  if (ier != SUCCESS) return ier;
   for (int i=0; i<nhist; i++) {
-    R[i+6] = h_np1[i] - tss->h_n[i] - R[i+6] * tss->dt;
+    R[i+6] = h_np1[i] - tss->h_n[i] - R[i+6] * dt;
   }
 
   // Jacobian calculation
-  double J11[36];
-  ier = rule_->ds_ds(s_np1, h_np1, tss->e_dot, tss->T, tss->Tdot, J11);
-  if (ier != SUCCESS) return ier;
-  for (int i=0; i<36; i++) J11[i] *= tss->dt;
+  for (int i=0; i<36; i++) J11[i] *= dt;
   for (int i=0; i<6; i++) J11[CINDEX(i,i,6)] -= 1.0;
   for (int i=0; i<6; i++) {
     for (int j=0; j<6; j++) {
@@ -1575,33 +1912,18 @@ int GeneralIntegrator::RJ(const double * const x, TrialState * ts,
     }
   }
   
-  std::vector<double> J12v(6*nhist);
-  double * J12 = &J12v[0];
-  ier = rule_->ds_da(s_np1, h_np1, tss->e_dot, tss->T, tss->Tdot, J12);
-  if (ier != SUCCESS) return ier;
   for (int i=0; i<6; i++) {
     for (int j=0; j<nhist; j++) {
-      J[CINDEX(i,(j+6),nparams)] = -J12[CINDEX(i,j,nhist)] * tss->dt;
+      J[CINDEX(i,(j+6),nparams)] = -J12[CINDEX(i,j,nhist)] * dt;
     }
   }
   
-  std::vector<double> J21v(nhist*6);
-  double * J21 = &J21v[0];
-  ier = rule_->da_ds(s_np1, h_np1, tss->e_dot, tss->T, tss->Tdot, J21);
-  if (ier != SUCCESS) return ier;
   for (int i=0; i<nhist; i++) {
     for (int j=0; j<6; j++) {
-      J[CINDEX((i+6),j,nparams)] = -J21[CINDEX(i,j,6)] * tss->dt;
+      J[CINDEX((i+6),j,nparams)] = -J21[CINDEX(i,j,6)] * dt;
     }
   }
   
-  std::vector<double> J22v(nhist*nhist);
-  double * J22 = &J22v[0];
-  ier = rule_->da_da(s_np1, h_np1, tss->e_dot, tss->T, tss->Tdot, J22);
-  if (ier != SUCCESS) return ier;
-
-  // More vectorization
-  double dt = tss->dt;
   for (int i=0; i<nhist*nhist; i++) J22[i] *= dt;
   for (int i=0; i<nhist; i++) J22[CINDEX(i,i,nhist)] -= 1.0;
 
@@ -1614,12 +1936,199 @@ int GeneralIntegrator::RJ(const double * const x, TrialState * ts,
   return 0;
 }
 
+int GeneralIntegrator::R(const double * const x, TrialState * ts,
+                         double * const R) const
+{
+  GITrialState * tss = static_cast<GITrialState*>(ts);
+
+  const double * s_np1 = x;
+  const double * const h_np1 = &x[6];
+  int nhist = rule_->nhist();
+  double dt = tss->dt;
+
+  int ier = rule_->s(s_np1, h_np1, tss->e_dot, tss->T, tss->Tdot, R);
+  if (ier != SUCCESS) return ier;
+  for (int i=0; i<6; i++) {
+    R[i] = s_np1[i] - tss->s_n[i] - R[i] * dt;
+  }
+  ier = rule_->a(s_np1, h_np1, tss->e_dot, tss->T, tss->Tdot, &R[6]);
+  if (ier != SUCCESS) return ier;
+  for (int i=0; i<nhist; i++) {
+    R[i+6] = h_np1[i] - tss->h_n[i] - R[i+6] * dt;
+  }
+
+  return 0;
+}
+
+int GeneralIntegrator::linear_solve(const double * const J, double * const R) const
+{
+  // Convergence is still checked against the double precision residual,
+  // so this only changes the path to, not the quality of, the solution
+  if (mixed_precision_) {
+    return solve_mat_mixed(J, nparams(), R);
+  }
+  return SubstepModel_sd::linear_solve(J, R);
+}
+
+
+int GeneralIntegrator::integrate(TrialState * ts, double * const x,
+                                 double * const A) const
+{
+  if (adaptive_explicit_) {
+    int ier = explicit_integrate_(static_cast<GITrialState*>(ts), x);
+    if (ier == SUCCESS) {
+      // The tangent still comes from the implicit Jacobian at the
+      // final state, but we skip all the Newton iterations
+      std::vector<double> R(nparams());
+      ier = RJ(x, ts, &R[0], A);
+      if (ier != SUCCESS) return ier;
+      stats_.local().explicit_steps++;
+      stats_.local().last_explicit = true;
+      return SUCCESS;
+    }
+    stats_.local().fallbacks++;
+  }
+
+  stats_.local().implicit_steps++;
+  stats_.local().last_explicit = false;
+  return SubstepModel_sd::integrate(ts, x, A);
+}
+
+Predictor parse_predictor(const std::string & name)
+{
+  if (name == "none") return PREDICTOR_NONE;
+  if (name == "euler") return PREDICTOR_EULER;
+  if (name == "extrapolate") return PREDICTOR_EXTRAPOLATE;
+  throw std::invalid_argument("Unknown predictor " + name);
+}
+
+void GIStats::merge(const GIStats & other)
+{
+  explicit_steps += other.explicit_steps;
+  implicit_steps += other.implicit_steps;
+  fallbacks += other.fallbacks;
+  explicit_substeps += other.explicit_substeps;
+  rejected_substeps += other.rejected_substeps;
+}
+
+GIStats GeneralIntegrator::stats() const
+{
+  GIStats total;
+  stats_.all([&total](const GIStats & t) {total.merge(t);});
+  const GIStats * mine = stats_.existing();
+  if (mine != nullptr) total.last_explicit = mine->last_explicit;
+  return total;
+}
+
+void GeneralIntegrator::reset_stats()
+{
+  stats_.reset();
+}
+
+int GeneralIntegrator::explicit_integrate_(GITrialState * ts,
+                                           double * const x) const
+{
+  // Bogacki-Shampine 3(2) pair, with the first stage of the next step 
+  // the same as the last stage of this one
+  size_t n = nparams();
+  std::vector<double> y(n), yt(n), y3(n), yn(n);
+  std::vector<double> k1(n), k2(n), k3(n), k4(n);
+
+  std::copy(ts->s_n, ts->s_n+6, y.begin());
+  std::copy(ts->h_n.begin(), ts->h_n.end(), y.begin()+6);
+  
+  int ier = explicit_rate_(ts, 0.0, &y[0], &k1[0]);
+  if (ier != SUCCESS) return ier;
+
+  double t = 0.0;
+  double h = ts->dt;
+  int steps = 0;
+
+  while (t < ts->dt) {
+    // Needing too many steps means the problem is stiff
+    if (steps >= explicit_max_steps_) return MAX_ITERATIONS;
+    steps++;
+
+    h = std::min(h, ts->dt - t);
+
+    for (size_t i = 0; i < n; i++) yt[i] = y[i] + h / 2.0 * k1[i];
+    ier = explicit_rate_(ts, t + h / 2.0, &yt[0], &k2[0]);
+    if (ier != SUCCESS) return ier;
+
+    for (size_t i = 0; i < n; i++) y3[i] = y[i] + 3.0 * h / 4.0 * k2[i];
+    ier = explicit_rate_(ts, t + 3.0 * h / 4.0, &y3[0], &k3[0]);
+    if (ier != SUCCESS) return ier;
+
+    for (size_t i = 0; i < n; i++) {
+      yn[i] = y[i] + h * (2.0 / 9.0 * k1[i] + 1.0 / 3.0 * k2[i] 
+                          + 4.0 / 9.0 * k3[i]);
+    }
+    ier = explicit_rate_(ts, t + h, &yn[0], &k4[0]);
+    if (ier != SUCCESS) return ier;
+
+    // Scaled RMS of the difference between the third and second order 
+    // solutions
+    double err = 0.0;
+    for (size_t i = 0; i < n; i++) {
+      double ei = h * (-5.0 / 72.0 * k1[i] + 1.0 / 12.0 * k2[i] 
+                       + 1.0 / 9.0 * k3[i] - 1.0 / 8.0 * k4[i]);
+      double sc = explicit_tol_ * (1.0 + std::max(fabs(y[i]), fabs(yn[i])));
+      err += (ei / sc) * (ei / sc);
+    }
+    err = sqrt(err / n);
+    if (not std::isfinite(err)) return LINALG_FAILURE;
+
+    if (err <= 1.0) {
+      // Estimate the dominant eigenvalue from the last two stages, the
+      // step is limited by stability instead of accuracy if h * rho
+      // approaches the edge of the real stability interval (~2.5)
+      double dk = 0.0;
+      double dy = 0.0;
+      for (size_t i = 0; i < n; i++) {
+        dk += (k4[i] - k3[i]) * (k4[i] - k3[i]);
+        dy += (yn[i] - y3[i]) * (yn[i] - y3[i]);
+      }
+      if ((dy > 0.0) && (h * sqrt(dk / dy) > 2.5)) return MAX_ITERATIONS;
+
+      t += h;
+      y = yn;
+      k1 = k4;
+      stats_.local().explicit_substeps++;
+    }
+    else {
+      stats_.local().rejected_substeps++;
+    }
+
+    // Usual step size control
+    double fact = 5.0;
+    if (err > 0.0) fact = std::min(5.0, std::max(0.2, 0.9 * pow(err, 
+                                                                -1.0/3.0)));
+    h *= fact;
+  }
+
+  std::copy(y.begin(), y.end(), x);
+
+  return SUCCESS;
+}
+
+int GeneralIntegrator::explicit_rate_(GITrialState * ts, double tau,
+                                      const double * const y,
+                                      double * const ydot) const
+{
+  // Temperature varies linearly through the step
+  double T = ts->T - ts->Tdot * (ts->dt - tau);
+
+  int ier = rule_->s(y, &y[6], ts->e_dot, T, ts->Tdot, ydot);
+  if (ier != SUCCESS) return ier;
+
+  return rule_->a(y, &y[6], ts->e_dot, T, ts->Tdot, &ydot[6]);
+}
 
 int GeneralIntegrator::make_trial_state(
     const double * const e_np1, const double * const e_n,
     double T_np1, double T_n, double t_np1, double t_n,
     const double * const s_n, const double * const h_n,
-    GITrialState & ts)
+    GITrialState & ts) const
 {
   // Basic
   ts.dt = t_np1 - t_n;
@@ -1641,8 +2150,9 @@ int GeneralIntegrator::make_trial_state(
   std::copy(s_n, s_n+6, ts.s_n);
 
   // Last history
-  ts.h_n.resize(nhist());
-  std::copy(h_n, h_n+nhist(), ts.h_n.begin());
+  size_t nh = rule_->nhist();
+  ts.h_n.resize(nh);
+  std::copy(h_n, h_n+nh, ts.h_n.begin());
 
   // Elastic guess
   double C[36];
@@ -1651,6 +2161,36 @@ int GeneralIntegrator::make_trial_state(
   sub_vec(e_np1, e_n, 6, de);
   mat_vec(C, 6, de, 6, ts.s_guess);
   add_vec(ts.s_guess, s_n, 6, ts.s_guess);
+  ts.h_guess = ts.h_n;
+
+  if (ts.dt <= 0.0) return 0;
+
+  if (predictor_ == PREDICTOR_EULER) {
+    // Explicit forward Euler step from the last converged state
+    int ier = rule_->s(s_n, h_n, ts.e_dot, ts.T, ts.Tdot, ts.s_guess);
+    if (ier != SUCCESS) return ier;
+    ier = rule_->a(s_n, h_n, ts.e_dot, ts.T, ts.Tdot, &ts.h_guess[0]);
+    if (ier != SUCCESS) return ier;
+    for (size_t i = 0; i < 6; i++) {
+      ts.s_guess[i] = s_n[i] + ts.s_guess[i] * ts.dt;
+    }
+    for (size_t i = 0; i < nh; i++) {
+      ts.h_guess[i] = h_n[i] + ts.h_guess[i] * ts.dt;
+    }
+  }
+  else if (predictor_ == PREDICTOR_EXTRAPOLATE) {
+    // Linear extrapolation with the rates from the last converged step,
+    // unless there isn't one yet
+    const double * rate = &h_n[nh];
+    if (norm2_vec(rate, 6 + nh) > 0.0) {
+      for (size_t i = 0; i < 6; i++) {
+        ts.s_guess[i] = s_n[i] + rate[i] * ts.dt;
+      }
+      for (size_t i = 0; i < nh; i++) {
+        ts.h_guess[i] = h_n[i] + rate[i+6] * ts.dt;
+      }
+    }
+  }
 
   return 0;
 }
@@ -1720,8 +2260,9 @@ int KMRegimeModel::update_sd(
     double * const h_np1, const double * const h_n,
     double * const A_np1,
     double & u_np1, double u_n,
-    double & p_np1, double p_n)
+    double & p_np1, double p_n) const
 {
+  NEML_TRACE_SCOPE("update_sd");
   // Calculate activation energy
   double g = activation_energy_(e_np1, e_n, T_np1, t_np1, t_n);
 
@@ -1752,7 +2293,7 @@ int KMRegimeModel::init_hist(double * const hist) const
 double KMRegimeModel::activation_energy_(const double * const e_np1, 
                                          const double * const e_n,
                                          double T_np1,
-                                         double t_np1, double t_n)
+                                         double t_np1, double t_n) const
 {
   double dt = t_np1 - t_n;
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "solvers.h"
+#include "perthread.h"
 #include "objects.h"
 #include "elasticity.h"
 #include "ri_flow.h"
@@ -19,6 +20,8 @@
 
 namespace neml {
 
+class UpdateRecorder;
+
 /// NEML material model interface definitions
 //  All material models inherit from this base class.  It defines interfaces
 //  and provides the methods for reading in material parameters.
@@ -38,7 +41,7 @@ class NEML_EXPORT NEMLModel: public NEMLObject {
        double * const h_np1, const double * const h_n,
        double * const A_np1,
        double & u_np1, double u_n,
-       double & p_np1, double p_n) = 0;
+       double & p_np1, double p_n) const = 0;
 
    /// Large strain incremental update
    virtual int update_ld_inc(
@@ -50,7 +53,7 @@ class NEML_EXPORT NEMLModel: public NEMLObject {
        double * const h_np1, const double * const h_n,
        double * const A_np1, double * const B_np1,
        double & u_np1, double u_n,
-       double & p_np1, double p_n) = 0;
+       double & p_np1, double p_n) const = 0;
 
    /// Number of internal variables that are true material history
    virtual size_t nhist() const = 0;
@@ -63,6 +66,30 @@ class NEML_EXPORT NEMLModel: public NEMLObject {
    virtual int elastic_strains(const double * const s_np1,
                                double T_np1, const double * const h_np1,
                                double * const e_np1) const = 0;
+
+   /// Turn collection of solver statistics on or off (default off)
+   virtual void collect_solver_stats(bool on = true);
+   /// Solver statistics summed over all threads
+   virtual SolverStats solver_stats() const;
+   /// Zero the solver statistics
+   virtual void reset_solver_stats();
+
+   /// Capture updates made through the C and python interfaces
+   //  nullptr stops recording.  An iteration threshold turns on the
+   //  solver statistics, which supply the iteration counts.
+   void set_recorder(std::shared_ptr<UpdateRecorder> recorder);
+   /// The current recorder, nullptr if not recording
+   const std::shared_ptr<UpdateRecorder> & recorder() const;
+
+  protected:
+   /// Statistics for the calling thread, nullptr if not collecting
+   SolverStats * local_solver_stats_() const;
+
+  private:
+   friend class UpdateRecorder;
+
+   mutable StatsCollector solver_stats_;
+   std::shared_ptr<UpdateRecorder> recorder_;
 };
 
 /// Large deformation incremental update model
@@ -80,7 +107,7 @@ class NEML_EXPORT NEMLModel_ldi: public NEMLModel {
        double * const h_np1, const double * const h_n,
        double * const A_np1,
        double & u_np1, double u_n,
-       double & p_np1, double p_n);
+       double & p_np1, double p_n) const;
 
    /// Large strain incremental update
    virtual int update_ld_inc(
@@ -92,7 +119,7 @@ class NEML_EXPORT NEMLModel_ldi: public NEMLModel {
        double * const h_np1, const double * const h_n,
        double * const A_np1, double * const B_np1,
        double & u_np1, double u_n,
-       double & p_np1, double p_n) = 0;
+       double & p_np1, double p_n) const = 0;
 
    /// Number of stored variables
    virtual size_t nstore() const;
@@ -123,7 +150,7 @@ class NEML_EXPORT NEMLModel_sd: public NEMLModel {
        double * const h_np1, const double * const h_n,
        double * const A_np1,
        double & u_np1, double u_n,
-       double & p_np1, double p_n) = 0;
+       double & p_np1, double p_n) const = 0;
 
    /// Large strain incremental update
    virtual int update_ld_inc(
@@ -135,7 +162,7 @@ class NEML_EXPORT NEMLModel_sd: public NEMLModel {
        double * const h_np1, const double * const h_n,
        double * const A_np1, double * const B_np1,
        double & u_np1, double u_n,
-       double & p_np1, double p_n);
+       double & p_np1, double p_n) const;
 
    /// Number of stored variables
    virtual size_t nstore() const;
@@ -163,7 +190,7 @@ class NEML_EXPORT NEMLModel_sd: public NEMLModel {
   private:
    int calc_tangent_(const double * const D, const double * const W,
                      const double * const C, const double * const S,
-                     double * const A, double * const B);
+                     double * const A, double * const B) const;
 
   protected:
    std::shared_ptr<LinearElasticModel> elastic_;
@@ -180,7 +207,8 @@ class SubstepModel_sd: public NEMLModel_sd, public Solvable {
   SubstepModel_sd(std::shared_ptr<LinearElasticModel> emodel,
                   std::shared_ptr<Interpolate> alpha,
                   bool truesdell, double tol, int miter, bool verbose,
-                  int max_divide, bool force_divide);
+                  int max_divide, bool force_divide,
+                  bool adaptive_substep = false, double substep_tol = 1.0e-4);
 
   /// Complete substep update
   virtual int update_sd(
@@ -191,7 +219,7 @@ class SubstepModel_sd: public NEMLModel_sd, public Solvable {
       double * const h_np1, const double * const h_n,
       double * const A_np1,
       double & u_np1, double u_n,
-      double & p_np1, double p_n);
+      double & p_np1, double p_n) const;
 
   /// Single step update
   virtual int update_step(
@@ -202,7 +230,7 @@ class SubstepModel_sd: public NEMLModel_sd, public Solvable {
       double * const h_np1, const double * const h_n,
       double * const A, double * const E,
       double & u_np1, double u_n,
-      double & p_np1, double p_n);
+      double & p_np1, double p_n) const;
 
   /// Setup the trial state
   virtual TrialState * setup(
@@ -210,7 +238,7 @@ class SubstepModel_sd: public NEMLModel_sd, public Solvable {
       double T_np1, double T_n,
       double t_np1, double t_n,
       const double * const s_n,
-      const double * const h_n) = 0;
+      const double * const h_n) const = 0;
 
   /// Ignore update and take an elastic step
   virtual bool elastic_step(
@@ -219,7 +247,13 @@ class SubstepModel_sd: public NEMLModel_sd, public Solvable {
       double T_np1, double T_n,
       double t_np1, double t_n,
       const double * const s_n,
-      const double * const h_n) = 0;
+      const double * const h_n) const = 0;
+
+  /// History at the end of an elastic step, by default unchanged
+  virtual void elastic_history(
+      double t_np1, double t_n,
+      const double * const s_np1, const double * const s_n,
+      double * const h_np1, const double * const h_n) const;
 
   /// Interpret the x vector
   virtual int update_internal(
@@ -228,7 +262,7 @@ class SubstepModel_sd: public NEMLModel_sd, public Solvable {
       double T_np1, double T_n,
       double t_np1, double t_n,
       double * const s_np1, const double * const s_n,
-      double * const h_np1, const double * const h_n) = 0;
+      double * const h_np1, const double * const h_n) const = 0;
 
   /// Minus the partial derivative of the residual with respect to the strain
   virtual int strain_partial(
@@ -238,7 +272,7 @@ class SubstepModel_sd: public NEMLModel_sd, public Solvable {
       double t_np1, double t_n,
       const double * const s_np1, const double * const s_n,
       const double * const h_np1, const double * const h_n,
-      double * const de) = 0;
+      double * const de) const = 0;
 
   /// Do the work calculation
   virtual int work_and_energy(
@@ -249,7 +283,24 @@ class SubstepModel_sd: public NEMLModel_sd, public Solvable {
       double * const s_np1, const double * const s_n,
       double * const h_np1, const double * const h_n,
       double & u_np1, double u_n,
-      double & p_np1, double p_n) = 0;
+      double & p_np1, double p_n) const = 0;
+
+  /// Integrate the step for the x vector, returning the Jacobian in A
+  //  Defaults to the implicit Newton solve
+  virtual int integrate(TrialState * ts, double * const x,
+                        double * const A) const;
+
+ protected:
+  /// Substep update with the size chosen by a step doubling error estimate
+  int update_controlled_(
+      const double * const e_np1, const double * const e_n,
+      double T_np1, double T_n,
+      double t_np1, double t_n,
+      double * const s_np1, const double * const s_n,
+      double * const h_np1, const double * const h_n,
+      double * const A_np1,
+      double & u_np1, double u_n,
+      double & p_np1, double p_n) const;
 
  protected:
   double tol_;
@@ -257,6 +308,8 @@ class SubstepModel_sd: public NEMLModel_sd, public Solvable {
   bool verbose_;
   int max_divide_;
   bool force_divide_;
+  bool adaptive_substep_;
+  double substep_tol_;
 };
 
 /// Small strain linear elasticity
@@ -284,7 +337,7 @@ class NEML_EXPORT SmallStrainElasticity: public NEMLModel_sd {
       double * const h_np1, const double * const h_n,
       double * const A_np1,
       double & u_np1, double u_n,
-      double & p_np1, double p_n);
+      double & p_np1, double p_n) const;
   /// Number of history variables (=0)
   virtual size_t nhist() const;
   /// Initialize history (none to setup)
@@ -337,6 +390,31 @@ class GITrialState : public TrialState {
   double T, Tdot, dt;             // Temperature, temperature rate, time inc.
   std::vector<double> h_n;        // Previous history
   double s_guess[6];              // Reasonable guess at the next stress
+  std::vector<double> h_guess;    // Reasonable guess at the next history
+  std::vector<double> work;       // Jacobian blocks, reused between calls
+};
+
+/// Starting point of the Newton iterations in a step
+enum Predictor {
+  PREDICTOR_NONE        = 0,  // Values at the start of the step
+  PREDICTOR_EULER       = 1,  // Forward Euler step from the start of the step
+  PREDICTOR_EXTRAPOLATE = 2   // Rates of the last step carried forward
+};
+
+/// Convert a predictor name ("none", "euler" or "extrapolate") to the enum
+NEML_EXPORT Predictor parse_predictor(const std::string & name);
+
+/// Counts of the integration paths taken by the GeneralIntegrator
+struct NEML_EXPORT GIStats {
+  /// Add the counts of another set of statistics into this one
+  void merge(const GIStats & other);
+
+  size_t explicit_steps = 0;      // Steps integrated explicitly
+  size_t implicit_steps = 0;      // Steps integrated implicitly
+  size_t fallbacks = 0;           // Explicit attempts abandoned for implicit
+  size_t explicit_substeps = 0;   // Accepted explicit substeps
+  size_t rejected_substeps = 0;   // Rejected explicit substeps
+  bool last_explicit = false;     // Path taken on the last step
 };
 
 /// Small strain, associative, perfect plasticity
@@ -358,7 +436,9 @@ class NEML_EXPORT SmallStrainPerfectPlasticity: public SubstepModel_sd {
                                bool verbose,
                                int max_divide,
                                bool force_divide,
-                               bool truesdell);
+                               bool truesdell,
+                               bool adaptive_substep = false,
+                               double substep_tol = 1.0e-4);
 
   /// Type for the object system
   static std::string type();
@@ -375,10 +455,10 @@ class NEML_EXPORT SmallStrainPerfectPlasticity: public SubstepModel_sd {
   /// Number of nonlinear equations to solve in the integration
   virtual size_t nparams() const;
   /// Setup an initial guess for the nonlinear solution
-  virtual int init_x(double * const x, TrialState * ts);
+  virtual int init_x(double * const x, TrialState * ts) const;
   /// Integration residual and jacobian equations
   virtual int RJ(const double * const x, TrialState * ts, double * const R,
-                 double * const J);
+                 double * const J) const;
 
   /// Setup the trial state
   virtual TrialState * setup(
@@ -386,7 +466,7 @@ class NEML_EXPORT SmallStrainPerfectPlasticity: public SubstepModel_sd {
       double T_np1, double T_n,
       double t_np1, double t_n,
       const double * const s_n,
-      const double * const h_n);
+      const double * const h_n) const;
   
   /// Take an elastic step
   virtual bool elastic_step(
@@ -395,7 +475,7 @@ class NEML_EXPORT SmallStrainPerfectPlasticity: public SubstepModel_sd {
       double T_np1, double T_n,
       double t_np1, double t_n,
       const double * const s_n,
-      const double * const h_n);
+      const double * const h_n) const;
 
   /// Interpret the x vector
   virtual int update_internal(
@@ -404,7 +484,7 @@ class NEML_EXPORT SmallStrainPerfectPlasticity: public SubstepModel_sd {
       double T_np1, double T_n,
       double t_np1, double t_n,
       double * const s_np1, const double * const s_n,
-      double * const h_np1, const double * const h_n);
+      double * const h_np1, const double * const h_n) const;
 
   /// Minus the partial derivative of the residual with respect to the strain
   virtual int strain_partial(
@@ -414,7 +494,7 @@ class NEML_EXPORT SmallStrainPerfectPlasticity: public SubstepModel_sd {
       double t_np1, double t_n,
       const double * const s_np1, const double * const s_n,
       const double * const h_np1, const double * const h_n,
-      double * de);
+      double * de) const;
 
   /// Do the work calculation
   virtual int work_and_energy(
@@ -425,7 +505,7 @@ class NEML_EXPORT SmallStrainPerfectPlasticity: public SubstepModel_sd {
       double * const s_np1, const double * const s_n,
       double * const h_np1, const double * const h_n,
       double & u_np1, double u_n,
-      double & p_np1, double p_n);
+      double & p_np1, double p_n) const;
 
   /// Helper to return the yield stress
   double ys(double T) const;
@@ -434,7 +514,7 @@ class NEML_EXPORT SmallStrainPerfectPlasticity: public SubstepModel_sd {
   int make_trial_state(const double * const e_np1, const double * const e_n,
                        double T_np1, double T_n, double t_np1, double t_n,
                        const double * const s_n, const double * const h_n,
-                       SSPPTrialState & ts);
+                       SSPPTrialState & ts) const;
 
  private:
   std::shared_ptr<YieldSurface> surface_;
@@ -457,7 +537,9 @@ class NEML_EXPORT SmallStrainRateIndependentPlasticity: public SubstepModel_sd {
                                        std::shared_ptr<RateIndependentFlowRule> flow,
                                        std::shared_ptr<Interpolate> alpha, bool truesdell,
                                        double tol, int miter, bool verbose,
-                                       int max_divide, bool force_divide);
+                                       int max_divide, bool force_divide,
+                                       bool adaptive_substep = false,
+                                       double substep_tol = 1.0e-4);
 
   /// Type for the object system
   static std::string type();
@@ -477,7 +559,7 @@ class NEML_EXPORT SmallStrainRateIndependentPlasticity: public SubstepModel_sd {
       double T_np1, double T_n,
       double t_np1, double t_n,
       const double * const s_n,
-      const double * const h_n);
+      const double * const h_n) const;
 
   /// Ignore update and take an elastic step
   virtual bool elastic_step(
@@ -486,7 +568,7 @@ class NEML_EXPORT SmallStrainRateIndependentPlasticity: public SubstepModel_sd {
       double T_np1, double T_n,
       double t_np1, double t_n,
       const double * const s_n,
-      const double * const h_n);
+      const double * const h_n) const;
 
   /// Interpret the x vector
   virtual int update_internal(
@@ -495,7 +577,7 @@ class NEML_EXPORT SmallStrainRateIndependentPlasticity: public SubstepModel_sd {
       double T_np1, double T_n,
       double t_np1, double t_n,
       double * const s_np1, const double * const s_n,
-      double * const h_np1, const double * const h_n);
+      double * const h_np1, const double * const h_n) const;
 
   /// Minus the partial derivative of the residual with respect to the strain
   virtual int strain_partial(
@@ -505,7 +587,7 @@ class NEML_EXPORT SmallStrainRateIndependentPlasticity: public SubstepModel_sd {
       double t_np1, double t_n,
       const double * const s_np1, const double * const s_n,
       const double * const h_np1, const double * const h_n,
-      double * const de);
+      double * const de) const;
 
   /// Do the work calculation
   virtual int work_and_energy(
@@ -516,16 +598,19 @@ class NEML_EXPORT SmallStrainRateIndependentPlasticity: public SubstepModel_sd {
       double * const s_np1, const double * const s_n,
       double * const h_np1, const double * const h_n,
       double & u_np1, double u_n,
-      double & p_np1, double p_n);
+      double & p_np1, double p_n) const;
 
   /// Number of solver parameters
   virtual size_t nparams() const;
   /// Setup an iteration vector in the solver
-  virtual int init_x(double * const x, TrialState * ts);
+  virtual int init_x(double * const x, TrialState * ts) const;
   /// Solver function returning the residual and jacobian of the nonlinear
   /// system of equations integrating the model
   virtual int RJ(const double * const x, TrialState * ts, double * const R,
-                 double * const J);
+                 double * const J) const;
+  /// Solver function returning the residual alone
+  virtual int R(const double * const x, TrialState * ts,
+                double * const R) const;
 
   /// Return the elastic model for subobjects
   const std::shared_ptr<const LinearElasticModel> elastic() const;
@@ -534,7 +619,7 @@ class NEML_EXPORT SmallStrainRateIndependentPlasticity: public SubstepModel_sd {
   int make_trial_state(const double * const e_np1, const double * const e_n,
                        double T_np1, double T_n, double t_np1, double t_n,
                        const double * const s_n, const double * const h_n,
-                       SSRIPTrialState & ts);
+                       SSRIPTrialState & ts) const;
 
  private:
   std::shared_ptr<RateIndependentFlowRule> flow_;
@@ -576,7 +661,7 @@ class NEML_EXPORT SmallStrainCreepPlasticity: public NEMLModel_sd, public Solvab
       double * const h_np1, const double * const h_n,
       double * const A_np1,
       double & u_np1, double u_n,
-      double & p_np1, double p_n);
+      double & p_np1, double p_n) const;
 
   /// Number of history variables matches the base model
   virtual size_t nhist() const;
@@ -586,23 +671,28 @@ class NEML_EXPORT SmallStrainCreepPlasticity: public NEMLModel_sd, public Solvab
   /// The number of parameters in the nonlinear equation
   virtual size_t nparams() const;
   /// Initialize the nonlinear solver
-  virtual int init_x(double * const x, TrialState * ts);
+  virtual int init_x(double * const x, TrialState * ts) const;
   /// Residual equation to solve and corresponding jacobian
   virtual int RJ(const double * const x, TrialState * ts, double * const R,
-                 double * const J);
+                 double * const J) const;
+  /// Residual equation to solve alone
+  virtual int R(const double * const x, TrialState * ts,
+                double * const R) const;
 
   /// Setup a trial state from known information
   int make_trial_state(const double * const e_np1, const double * const e_n,
                        double T_np1, double T_n, double t_np1, double t_n,
                        const double * const s_n, const double * const h_n,
-                       SSCPTrialState & ts);
+                       SSCPTrialState & ts) const;
 
   /// Set a new elastic model
   virtual int set_elastic_model(std::shared_ptr<LinearElasticModel> emodel);
 
  private:
   int form_tangent_(double * const A, double * const B,
-                    double * const A_np1);
+                    double * const A_np1) const;
+  int residual_(const double * const x, SSCPTrialState * tss,
+                double * const R, double * const A_np1, double * const B) const;
 
  private:
   std::shared_ptr<NEMLModel_sd> plastic_;
@@ -628,7 +718,14 @@ class NEML_EXPORT GeneralIntegrator: public SubstepModel_sd {
                     std::shared_ptr<GeneralFlowRule> rule,
                     std::shared_ptr<Interpolate> alpha,
                     bool truesdell, double tol, int miter, bool verbose,
-                    int max_divide, bool force_divide);
+                    int max_divide, bool force_divide,
+                    bool mixed_precision = false,
+                    std::string predictor = "none",
+                    bool adaptive_explicit = false,
+                    double explicit_tol = 1.0e-4,
+                    int explicit_max_steps = 20,
+                    bool adaptive_substep = false,
+                    double substep_tol = 1.0e-4);
 
   /// Type for the object system
   static std::string type();
@@ -643,7 +740,7 @@ class NEML_EXPORT GeneralIntegrator: public SubstepModel_sd {
       double T_np1, double T_n,
       double t_np1, double t_n,
       const double * const s_n,
-      const double * const h_n);
+      const double * const h_n) const;
   
   /// Take an elastic step
   virtual bool elastic_step(
@@ -652,7 +749,13 @@ class NEML_EXPORT GeneralIntegrator: public SubstepModel_sd {
       double T_np1, double T_n,
       double t_np1, double t_n,
       const double * const s_n,
-      const double * const h_n);
+      const double * const h_n) const;
+
+  /// Refresh the stored rates for the extrapolation predictor
+  virtual void elastic_history(
+      double t_np1, double t_n,
+      const double * const s_np1, const double * const s_n,
+      double * const h_np1, const double * const h_n) const;
 
   /// Interpret the x vector
   virtual int update_internal(
@@ -661,7 +764,7 @@ class NEML_EXPORT GeneralIntegrator: public SubstepModel_sd {
       double T_np1, double T_n,
       double t_np1, double t_n,
       double * const s_np1, const double * const s_n,
-      double * const h_np1, const double * const h_n);
+      double * const h_np1, const double * const h_n) const;
 
   /// Minus the partial derivative of the residual with respect to the strain
   virtual int strain_partial(
@@ -671,7 +774,7 @@ class NEML_EXPORT GeneralIntegrator: public SubstepModel_sd {
       double t_np1, double t_n,
       const double * const s_np1, const double * const s_n,
       const double * const h_np1, const double * const h_n,
-      double * de);
+      double * de) const;
 
   /// Do the work calculation
   virtual int work_and_energy(
@@ -682,7 +785,7 @@ class NEML_EXPORT GeneralIntegrator: public SubstepModel_sd {
       double * const s_np1, const double * const s_n,
       double * const h_np1, const double * const h_n,
       double & u_np1, double u_n,
-      double & p_np1, double p_n);
+      double & p_np1, double p_n) const;
 
   /// Number of history variables
   virtual size_t nhist() const;
@@ -692,22 +795,49 @@ class NEML_EXPORT GeneralIntegrator: public SubstepModel_sd {
   /// Number of nonlinear equations
   virtual size_t nparams() const;
   /// Initialize a guess for the nonlinear iterations
-  virtual int init_x(double * const x, TrialState * ts);
+  virtual int init_x(double * const x, TrialState * ts) const;
   /// The residual and jacobian for the nonlinear solve
   virtual int RJ(const double * const x, TrialState * ts,
-                 double * const R, double * const J);
+                 double * const R, double * const J) const;
+  /// The residual alone for the nonlinear solve
+  virtual int R(const double * const x, TrialState * ts,
+                double * const R) const;
+  /// Newton linear solve, optionally in mixed precision
+  virtual int linear_solve(const double * const J, double * const R) const;
+
+  /// Try the explicit integrator first, if enabled
+  virtual int integrate(TrialState * ts, double * const x,
+                        double * const A) const;
+
+  /// Statistics on the integration paths taken so far, over all threads
+  //  last_explicit is the path of the calling thread's last step
+  GIStats stats() const;
+  /// Reset the path statistics
+  void reset_stats();
 
   /// Initialize a trial state
   int make_trial_state(const double * const e_np1, const double * const e_n,
                        double T_np1, double T_n, double t_np1, double t_n,
                        const double * const s_n, const double * const h_n,
-                       GITrialState & ts);
+                       GITrialState & ts) const;
 
   /// Set a new elastic model
   virtual int set_elastic_model(std::shared_ptr<LinearElasticModel> emodel);
 
  private:
+  /// Embedded Runge-Kutta integration of the step, fails if stiff
+  int explicit_integrate_(GITrialState * ts, double * const x) const;
+  /// Rates of the stress and history a time tau into the step
+  int explicit_rate_(GITrialState * ts, double tau, const double * const y,
+                     double * const ydot) const;
+
   std::shared_ptr<GeneralFlowRule> rule_;
+  bool mixed_precision_;
+  Predictor predictor_;
+  bool adaptive_explicit_;
+  double explicit_tol_;
+  int explicit_max_steps_;
+  mutable PerThread<GIStats> stats_;
 };
 
 static Register<GeneralIntegrator> regGeneralIntegrator;
@@ -756,7 +886,7 @@ class NEML_EXPORT KMRegimeModel: public NEMLModel_sd {
       double * const h_np1, const double * const h_n,
       double * const A_np1,
       double & u_np1, double u_n,
-      double & p_np1, double p_n);
+      double & p_np1, double p_n) const;
 
   /// The number of model history variables
   virtual size_t nhist() const;
@@ -770,7 +900,7 @@ class NEML_EXPORT KMRegimeModel: public NEMLModel_sd {
   double activation_energy_(const double * const e_np1,
                             const double * const e_n,
                             double T_np1,
-                            double t_np1, double t_n);
+                            double t_np1, double t_n) const;
 
  private:
   std::vector<std::shared_ptr<NEMLModel_sd>> models_;
@@ -1,6 +1,8 @@
 #include "pyhelp.h" // include first to avoid annoying redef warning
 
 #include "models.h"
+#include "batch.h"
+#include "replay.h"
 
 #include "nemlerror.h"
 
@@ -10,6 +12,46 @@ PYBIND11_DECLARE_HOLDER_TYPE(T, std::shared_ptr<T>)
 
 namespace neml {
 
+/// Check the shape of a batch input array
+static void check_batch(py::array_t<double, py::array::c_style> arr, 
+                        std::string name, std::vector<size_t> shape)
+{
+  auto info = arr.request();
+  bool ok = ((size_t) info.ndim == shape.size());
+  for (size_t i = 0; ok && (i < shape.size()); i++) {
+    ok = ((size_t) info.shape[i] == shape[i]);
+  }
+  if (not ok) {
+    throw std::runtime_error(name + " does not have the right shape");
+  }
+}
+
+/// Either use the caller's output array, without copying, or allocate one
+static py::array_t<double> batch_output(py::object out, size_t i,
+                                        std::string name,
+                                        std::vector<size_t> shape)
+{
+  if (out.is_none()) {
+    if (shape.size() == 1) return alloc_vec<double>(shape[0]);
+    else if (shape.size() == 2) return alloc_mat<double>(shape[0], shape[1]);
+    else return alloc_3d<double>(shape[0], shape[1], shape[2]);
+  }
+
+  py::object item = out.cast<py::sequence>()[i];
+  if (not py::isinstance<py::array_t<double, py::array::c_style>>(item)) {
+    throw std::runtime_error("Output " + name + 
+                             " must be a C contiguous float64 array");
+  }
+  auto arr = py::reinterpret_borrow<py::array_t<double, 
+       py::array::c_style>>(item);
+  if (not arr.writeable()) {
+    throw std::runtime_error("Output " + name + " is not writeable");
+  }
+  check_batch(arr, "Output " + name, shape);
+
+  return arr;
+}
+
 PYBIND11_MODULE(models, m) {
   py::module::import("neml.objects");
   py::module::import("neml.solvers");
@@ -18,6 +60,11 @@ PYBIND11_MODULE(models, m) {
   
   py::class_<NEMLModel, NEMLObject, std::shared_ptr<NEMLModel>>(m, "NEMLModel")
       .def_property_readonly("nstore", &NEMLModel::nstore, "Number of variables the program needs to store.")
+      .def("collect_solver_stats", &NEMLModel::collect_solver_stats, "Turn collection of solver statistics on or off.",
+           py::arg("on") = true)
+      .def_property_readonly("solver_stats", &NEMLModel::solver_stats, "Solver statistics summed over all threads.")
+      .def("reset_solver_stats", &NEMLModel::reset_solver_stats, "Zero the solver statistics.")
+      .def_property("recorder", &NEMLModel::recorder, &NEMLModel::set_recorder, "Recorder capturing the updates, None if not recording.")
       .def("init_store",
            [](NEMLModel & m) -> py::array_t<double>
            {
@@ -44,7 +91,7 @@ PYBIND11_MODULE(models, m) {
             auto A_np1 = alloc_mat<double>(6,6);
             double u_np1, p_np1;
 
-            int ier = m.update_sd(arr2ptr<double>(e_np1), arr2ptr<double>(e_n), T_np1, T_n, t_np1, t_n, arr2ptr<double>(s_np1), arr2ptr<double>(s_n), arr2ptr<double>(h_np1), arr2ptr<double>(h_n), arr2ptr<double>(A_np1), u_np1, u_n, p_np1, p_n);
+            int ier = recorded_update_sd(m, arr2ptr<double>(e_np1), arr2ptr<double>(e_n), T_np1, T_n, t_np1, t_n, arr2ptr<double>(s_np1), arr2ptr<double>(s_n), arr2ptr<double>(h_np1), arr2ptr<double>(h_n), arr2ptr<double>(A_np1), u_np1, u_n, p_np1, p_n);
             py_error(ier);
 
             return std::make_tuple(s_np1, h_np1, A_np1, u_np1, p_np1);
@@ -59,12 +106,137 @@ PYBIND11_MODULE(models, m) {
             auto B_np1 = alloc_mat<double>(6,3);
             double u_np1, p_np1;
 
-            int ier = m.update_ld_inc(arr2ptr<double>(d_np1), arr2ptr<double>(d_n), arr2ptr<double>(w_np1), arr2ptr<double>(w_n), T_np1, T_n, t_np1, t_n, arr2ptr<double>(s_np1), arr2ptr<double>(s_n), arr2ptr<double>(h_np1), arr2ptr<double>(h_n), arr2ptr<double>(A_np1), arr2ptr<double>(B_np1), u_np1, u_n, p_np1, p_n);
+            int ier = recorded_update_ld_inc(m, arr2ptr<double>(d_np1), arr2ptr<double>(d_n), arr2ptr<double>(w_np1), arr2ptr<double>(w_n), T_np1, T_n, t_np1, t_n, arr2ptr<double>(s_np1), arr2ptr<double>(s_n), arr2ptr<double>(h_np1), arr2ptr<double>(h_n), arr2ptr<double>(A_np1), arr2ptr<double>(B_np1), u_np1, u_n, p_np1, p_n);
             py_error(ier);
 
             return std::make_tuple(s_np1, h_np1, A_np1, B_np1, u_np1, p_np1);
 
            }, "Large deformation incremental update.")
+      .def("update_sd_batch",
+           [](NEMLModel & m, py::array_t<double, py::array::c_style> e_np1, py::array_t<double, py::array::c_style> e_n, py::array_t<double, py::array::c_style> T_np1, py::array_t<double, py::array::c_style> T_n, double t_np1, double t_n, py::array_t<double, py::array::c_style> s_n, py::array_t<double, py::array::c_style> h_n, py::array_t<double, py::array::c_style> u_n, py::array_t<double, py::array::c_style> p_n, int nthreads, py::object out) -> py::tuple
+           {
+            size_t n = e_np1.request().ndim > 0 ? e_np1.request().shape[0] : 0;
+            size_t nh = m.nstore();
+            check_batch(e_np1, "e_np1", {n, 6});
+            check_batch(e_n, "e_n", {n, 6});
+            check_batch(T_np1, "T_np1", {n});
+            check_batch(T_n, "T_n", {n});
+            check_batch(s_n, "s_n", {n, 6});
+            check_batch(h_n, "h_n", {n, nh});
+            check_batch(u_n, "u_n", {n});
+            check_batch(p_n, "p_n", {n});
+            if (not out.is_none() && (py::len(out) != 5)) {
+              throw std::runtime_error("out should be (s_np1, h_np1, A_np1, u_np1, p_np1)");
+            }
+
+            auto s_np1 = batch_output(out, 0, "s_np1", {n, 6});
+            auto h_np1 = batch_output(out, 1, "h_np1", {n, nh});
+            auto A_np1 = batch_output(out, 2, "A_np1", {n, 6, 6});
+            auto u_np1 = batch_output(out, 3, "u_np1", {n});
+            auto p_np1 = batch_output(out, 4, "p_np1", {n});
+
+            // Grab the pointers before releasing the GIL
+            double * e_np1_ptr = arr2ptr<double>(e_np1);
+            double * e_n_ptr = arr2ptr<double>(e_n);
+            double * T_np1_ptr = arr2ptr<double>(T_np1);
+            double * T_n_ptr = arr2ptr<double>(T_n);
+            double * s_np1_ptr = arr2ptr<double>(s_np1);
+            double * s_n_ptr = arr2ptr<double>(s_n);
+            double * h_np1_ptr = arr2ptr<double>(h_np1);
+            double * h_n_ptr = arr2ptr<double>(h_n);
+            double * A_np1_ptr = arr2ptr<double>(A_np1);
+            double * u_np1_ptr = arr2ptr<double>(u_np1);
+            double * u_n_ptr = arr2ptr<double>(u_n);
+            double * p_np1_ptr = arr2ptr<double>(p_np1);
+            double * p_n_ptr = arr2ptr<double>(p_n);
+
+            int ier;
+            {
+              py::gil_scoped_release release;
+              ier = evaluate_sd_batch(m, n, e_np1_ptr, e_n_ptr, T_np1_ptr,
+                                      T_n_ptr, t_np1, t_n, s_np1_ptr, s_n_ptr,
+                                      h_np1_ptr, h_n_ptr, A_np1_ptr, 
+                                      u_np1_ptr, u_n_ptr, p_np1_ptr, p_n_ptr,
+                                      nthreads);
+            }
+            py_error(ier);
+
+            return py::make_tuple(s_np1, h_np1, A_np1, u_np1, p_np1);
+           }, "Small deformation update for a batch of points.",
+           py::arg("e_np1"), py::arg("e_n"), py::arg("T_np1"), py::arg("T_n"),
+           py::arg("t_np1"), py::arg("t_n"), py::arg("s_n"), py::arg("h_n"),
+           py::arg("u_n"), py::arg("p_n"), py::arg("nthreads") = 1,
+           py::arg("out") = py::none())
+      .def("update_ld_inc_batch",
+           [](NEMLModel & m, py::array_t<double, py::array::c_style> d_np1, py::array_t<double, py::array::c_style> d_n, py::array_t<double, py::array::c_style> w_np1, py::array_t<double, py::array::c_style> w_n, py::array_t<double, py::array::c_style> T_np1, py::array_t<double, py::array::c_style> T_n, double t_np1, double t_n, py::array_t<double, py::array::c_style> s_n, py::array_t<double, py::array::c_style> h_n, py::array_t<double, py::array::c_style> u_n, py::array_t<double, py::array::c_style> p_n, int nthreads, py::object out) -> py::tuple
+           {
+            size_t n = d_np1.request().ndim > 0 ? d_np1.request().shape[0] : 0;
+            size_t nh = m.nstore();
+            check_batch(d_np1, "d_np1", {n, 6});
+            check_batch(d_n, "d_n", {n, 6});
+            check_batch(w_np1, "w_np1", {n, 3});
+            check_batch(w_n, "w_n", {n, 3});
+            check_batch(T_np1, "T_np1", {n});
+            check_batch(T_n, "T_n", {n});
+            check_batch(s_n, "s_n", {n, 6});
+            check_batch(h_n, "h_n", {n, nh});
+            check_batch(u_n, "u_n", {n});
+            check_batch(p_n, "p_n", {n});
+            if (not out.is_none() && (py::len(out) != 6)) {
+              throw std::runtime_error("out should be (s_np1, h_np1, A_np1, B_np1, u_np1, p_np1)");
+            }
+
+            auto s_np1 = batch_output(out, 0, "s_np1", {n, 6});
+            auto h_np1 = batch_output(out, 1, "h_np1", {n, nh});
+            auto A_np1 = batch_output(out, 2, "A_np1", {n, 6, 6});
+            auto B_np1 = batch_output(out, 3, "B_np1", {n, 6, 3});
+            auto u_np1 = batch_output(out, 4, "u_np1", {n});
+            auto p_np1 = batch_output(out, 5, "p_np1", {n});
+
+            // Grab the pointers before releasing the GIL
+            double * d_np1_ptr = arr2ptr<double>(d_np1);
+            double * d_n_ptr = arr2ptr<double>(d_n);
+            double * w_np1_ptr = arr2ptr<double>(w_np1);
+            double * w_n_ptr = arr2ptr<double>(w_n);
+            double * T_np1_ptr = arr2ptr<double>(T_np1);
+            double * T_n_ptr = arr2ptr<double>(T_n);
+            double * s_np1_ptr = arr2ptr<double>(s_np1);
+            double * s_n_ptr = arr2ptr<double>(s_n);
+            double * h_np1_ptr = arr2ptr<double>(h_np1);
+            double * h_n_ptr = arr2ptr<double>(h_n);
+            double * A_np1_ptr = arr2ptr<double>(A_np1);
+            double * B_np1_ptr = arr2ptr<double>(B_np1);
+            double * u_np1_ptr = arr2ptr<double>(u_np1);
+            double * u_n_ptr = arr2ptr<double>(u_n);
+            double * p_np1_ptr = arr2ptr<double>(p_np1);
+            double * p_n_ptr = arr2ptr<double>(p_n);
+
+            int ier;
+            {
+              py::gil_scoped_release release;
+              ier = evaluate_ld_inc_batch(m, n, d_np1_ptr, d_n_ptr, w_np1_ptr,
+                                          w_n_ptr, T_np1_ptr, T_n_ptr, t_np1,
+                                          t_n, s_np1_ptr, s_n_ptr, h_np1_ptr,
+                                          h_n_ptr, A_np1_ptr, B_np1_ptr,
+                                          u_np1_ptr, u_n_ptr, p_np1_ptr,
+                                          p_n_ptr, nthreads);
+            }
+            py_error(ier);
+
+            return py::make_tuple(s_np1, h_np1, A_np1, B_np1, u_np1, p_np1);
+           }, "Large deformation incremental update for a batch of points.",
+           py::arg("d_np1"), py::arg("d_n"), py::arg("w_np1"), py::arg("w_n"),
+           py::arg("T_np1"), py::arg("T_n"), py::arg("t_np1"), py::arg("t_n"),
+           py::arg("s_n"), py::arg("h_n"), py::arg("u_n"), py::arg("p_n"),
+           py::arg("nthreads") = 1, py::arg("out") = py::none())
+      .def("init_store_batch",
+           [](NEMLModel & m, size_t n) -> py::array_t<double>
+           {
+            auto h = alloc_mat<double>(n, m.nstore());
+            int ier = init_store_batch(m, n, arr2ptr<double>(h));
+            py_error(ier);
+            return h;
+           }, "Initialize stored variables for a batch of points.")
 
       .def("alpha", &NEMLModel::alpha)
       .def("elastic_strains",
@@ -114,6 +286,57 @@ PYBIND11_MODULE(models, m) {
   py::class_<GITrialState, TrialState>(m, "GITrialState")
       ;
 
+  py::class_<UpdateRecorder, std::shared_ptr<UpdateRecorder>>(m, "UpdateRecorder")
+      .def(py::init<std::string, size_t, double, size_t>(),
+           py::arg("fname"), py::arg("sample_every") = 0,
+           py::arg("time_threshold") = 0.0,
+           py::arg("iteration_threshold") = 0)
+      .def_property_readonly("fname", &UpdateRecorder::fname, "Log file.")
+      .def_property_readonly("calls", &UpdateRecorder::calls, "Calls made through the recorder.")
+      .def_property_readonly("recorded", &UpdateRecorder::recorded, "Calls captured in the log.")
+      ;
+
+  py::class_<RecordedUpdate>(m, "RecordedUpdate")
+      .def_readonly("large", &RecordedUpdate::large, "True for update_ld_inc.")
+      .def_readonly("e_np1", &RecordedUpdate::e_np1, "Next strain or deformation rate.")
+      .def_readonly("e_n", &RecordedUpdate::e_n, "Previous strain or deformation rate.")
+      .def_readonly("w_np1", &RecordedUpdate::w_np1, "Next vorticity.")
+      .def_readonly("w_n", &RecordedUpdate::w_n, "Previous vorticity.")
+      .def_readonly("T_np1", &RecordedUpdate::T_np1, "Next temperature.")
+      .def_readonly("T_n", &RecordedUpdate::T_n, "Previous temperature.")
+      .def_readonly("t_np1", &RecordedUpdate::t_np1, "Next time.")
+      .def_readonly("t_n", &RecordedUpdate::t_n, "Previous time.")
+      .def_readonly("s_n", &RecordedUpdate::s_n, "Previous stress.")
+      .def_readonly("h_n", &RecordedUpdate::h_n, "Previous stored variables.")
+      .def_readonly("u_n", &RecordedUpdate::u_n, "Previous energy.")
+      .def_readonly("p_n", &RecordedUpdate::p_n, "Previous dissipation.")
+      .def_readonly("ier", &RecordedUpdate::ier, "Error code of the recorded call.")
+      .def_readonly("time", &RecordedUpdate::time, "Wall time of the recorded call.")
+      .def_readonly("iterations", &RecordedUpdate::iterations, "Solver iterations of the recorded call.")
+      .def_readonly("s_np1", &RecordedUpdate::s_np1, "Stress returned by the recorded call.")
+      ;
+
+  m.def("read_update_log", &read_update_log, "Read the updates captured in a log.");
+  m.def("replay_update",
+        [](NEMLModel & model, const RecordedUpdate & rec) -> py::array_t<double>
+        {
+          std::vector<double> s;
+          int ier = replay_update(model, rec, s);
+          py_error(ier);
+          auto s_np1 = alloc_vec<double>(6);
+          std::copy(s.begin(), s.end(), arr2ptr<double>(s_np1));
+          return s_np1;
+        }, "Rerun a captured update, returning the new stress.");
+
+  py::class_<GIStats>(m, "GIStats")
+      .def_readonly("explicit_steps", &GIStats::explicit_steps, "Steps integrated explicitly.")
+      .def_readonly("implicit_steps", &GIStats::implicit_steps, "Steps integrated implicitly.")
+      .def_readonly("fallbacks", &GIStats::fallbacks, "Explicit attempts abandoned for implicit.")
+      .def_readonly("explicit_substeps", &GIStats::explicit_substeps, "Accepted explicit substeps.")
+      .def_readonly("rejected_substeps", &GIStats::rejected_substeps, "Rejected explicit substeps.")
+      .def_readonly("last_explicit", &GIStats::last_explicit, "Path taken on the last step.")
+      ;
+
   py::class_<SmallStrainPerfectPlasticity, SubstepModel_sd, Solvable, std::shared_ptr<SmallStrainPerfectPlasticity>>(m, "SmallStrainPerfectPlasticity")
       .def(py::init([](py::args args, py::kwargs kwargs)
         {
@@ -213,6 +436,8 @@ PYBIND11_MODULE(models, m) {
               py_error(ier);
               return ts;
            }, "Setup trial state for solve.")
+      .def_property_readonly("stats", &GeneralIntegrator::stats, "Statistics on the integration paths taken.")
+      .def("reset_stats", &GeneralIntegrator::reset_stats, "Reset the path statistics.")
       ;
 
   py::class_<KMRegimeModel, NEMLModel_sd, std::shared_ptr<KMRegimeModel>>(m, "KMRegimeModel")
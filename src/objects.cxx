@@ -1,7 +1,85 @@
 #include "objects.h"
 
+#include "trace.h"
+
+#include <cstdint>
+#include <cstring>
+
 namespace neml {
 
+namespace {
+
+/// Writes one parameter value into a canonical key
+class KeyWriter: public boost::static_visitor<> {
+ public:
+  KeyWriter(std::ostringstream & out) : out_(out) {};
+
+  void operator()(double v) const
+  {
+    // The exact bits, so values that print alike stay distinct
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(double));
+    out_ << "d" << std::hex << bits << std::dec;
+  }
+
+  void operator()(int v) const
+  {
+    out_ << "i" << v;
+  }
+
+  void operator()(bool v) const
+  {
+    out_ << "b" << v;
+  }
+
+  void operator()(const std::vector<double> & v) const
+  {
+    out_ << "v" << v.size() << "[";
+    for (auto x : v) {
+      (*this)(x);
+      out_ << ",";
+    }
+    out_ << "]";
+  }
+
+  void operator()(const std::shared_ptr<NEMLObject> & v) const
+  {
+    out_ << "o" << v.get();
+  }
+
+  void operator()(const std::vector<std::shared_ptr<NEMLObject>> & v) const
+  {
+    out_ << "O" << v.size() << "[";
+    for (auto & x : v) {
+      (*this)(x);
+      out_ << ",";
+    }
+    out_ << "]";
+  }
+
+  void operator()(const std::string & v) const
+  {
+    out_ << "s" << v.size() << ":" << v;
+  }
+
+  void operator()(const list_systems & v) const
+  {
+    out_ << "l" << v.size() << "[";
+    for (auto & sys : v) {
+      for (auto i : sys.first) out_ << i << " ";
+      out_ << ";";
+      for (auto i : sys.second) out_ << i << " ";
+      out_ << ",";
+    }
+    out_ << "]";
+  }
+
+ private:
+  std::ostringstream & out_;
+};
+
+} // namespace
+
 ParameterSet::ParameterSet() :
     type_("invalid")
 {
@@ -29,6 +107,20 @@ void ParameterSet::assign_defered_parameter(std::string name, ParameterSet value
   defered_params_[name] = value;
 }
 
+bool ParameterSet::is_defered_parameter(std::string name) const
+{
+  return defered_params_.find(name) != defered_params_.end();
+}
+
+ParameterSet & ParameterSet::get_defered_parameter(std::string name)
+{
+  auto it = defered_params_.find(name);
+  if (it == defered_params_.end()) {
+    throw UnknownParameter(type(), name);
+  }
+  return it->second;
+}
+
 ParamType ParameterSet::get_object_type(std::string name)
 {
   return param_types_[name];
@@ -66,6 +158,22 @@ bool ParameterSet::fully_assigned()
   return true;
 }
 
+std::string ParameterSet::canonical_key()
+{
+  resolve_objects_();
+
+  // params_ is ordered by name, so the order of assignment does not matter
+  std::ostringstream out;
+  out << type_.size() << ":" << type_;
+  KeyWriter writer(out);
+  for (auto & p : params_) {
+    out << "|" << p.first << "=";
+    boost::apply_visitor(writer, p.second);
+  }
+
+  return out.str();
+}
+
 void ParameterSet::resolve_objects_()
 {
   for (auto it = defered_params_.begin(); it != defered_params_.end(); ++it) {
@@ -86,38 +194,75 @@ ParameterSet Factory::provide_parameters(std::string type)
 
 std::shared_ptr<NEMLObject> Factory::create(ParameterSet & params)
 {
+  NEML_TRACE_SCOPE("Factory::create");
   if (not params.fully_assigned()) {
     throw UndefinedParameters(params.type(), params.unassigned_parameters());
   }
   
-  try {
-    return creators_[params.type()](params);
-  }
-  catch (std::exception & e) {
+  // Errors thrown by the constructors themselves go to the caller
+  auto it = creators_.find(params.type());
+  if (it == creators_.end()) {
     throw UnregisteredError(params.type());
   }
+
+  if (interning_ && (interned_types_.count(params.type()) != 0)) {
+    return create_interned_(params, it->second);
+  }
+
+  std::shared_ptr<NEMLObject> made = it->second(params);
+  made->freeze();
+  return made;
 }
 
 std::unique_ptr<NEMLObject> Factory::create_unique(ParameterSet & params)
 {
+  NEML_TRACE_SCOPE("Factory::create");
   if (not params.fully_assigned()) {
     throw UndefinedParameters(params.type(), params.unassigned_parameters());
   }
 
-  try {
-    return creators_[params.type()](params);
-  }
-  catch (std::exception & e) {
-      throw UnregisteredError(params.type());
+  // Errors thrown by the constructors themselves go to the caller
+  auto it = creators_.find(params.type());
+  if (it == creators_.end()) {
+    throw UnregisteredError(params.type());
   }
+
+  return it->second(params);
 }
 
 void Factory::register_type(std::string type,
                             std::function<std::unique_ptr<NEMLObject>(ParameterSet &)> creator,
-                            std::function<ParameterSet()> setup)
+                            std::function<ParameterSet()> setup,
+                            bool interned)
 {
   creators_[type] = creator;
   setups_[type] = setup;
+  if (interned) {
+    interned_types_.insert(type);
+  }
+  else {
+    interned_types_.erase(type);
+  }
+}
+
+void Factory::set_interning(bool on)
+{
+  interning_ = on;
+}
+
+bool Factory::interning() const
+{
+  return interning_;
+}
+
+size_t Factory::interned_objects()
+{
+  std::lock_guard<std::mutex> guard(intern_lock_);
+  size_t n = 0;
+  for (auto & entry : interned_) {
+    if (not entry.second.expired()) n++;
+  }
+  return n;
 }
 
 Factory * Factory::Creator()
@@ -126,4 +271,51 @@ Factory * Factory::Creator()
   return &creator;
 }
 
+Factory::Factory() :
+    interning_(true), purge_size_(64)
+{
+
+}
+
+std::shared_ptr<NEMLObject> Factory::create_interned_(
+    ParameterSet & params,
+    const std::function<std::unique_ptr<NEMLObject>(ParameterSet &)> & creator)
+{
+  std::string key = params.canonical_key();
+  {
+    std::lock_guard<std::mutex> guard(intern_lock_);
+    auto found = interned_.find(key);
+    if (found != interned_.end()) {
+      std::shared_ptr<NEMLObject> existing = found->second.lock();
+      if (existing) return existing;
+    }
+  }
+
+  // Construct without the lock, in case the constructor makes objects too
+  std::shared_ptr<NEMLObject> made = creator(params);
+  made->freeze();
+
+  std::lock_guard<std::mutex> guard(intern_lock_);
+  std::weak_ptr<NEMLObject> & entry = interned_[key];
+  std::shared_ptr<NEMLObject> existing = entry.lock();
+  if (existing) return existing;
+  entry = made;
+
+  // Drop the entries of objects that no longer exist once the table has
+  // doubled since the last sweep
+  if (interned_.size() >= purge_size_) {
+    for (auto it = interned_.begin(); it != interned_.end();) {
+      if (it->second.expired()) {
+        it = interned_.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+    purge_size_ = std::max<size_t>(64, 2 * interned_.size());
+  }
+
+  return made;
+}
+
 } // namespace neml
@@ -1,11 +1,15 @@
 #ifndef OBJECTS_H
 #define OBJECTS_H
 
+#include <atomic>
 #include <string>
 #include <sstream>
 #include <vector>
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <memory>
+#include <mutex>
 #include <functional>
 #include <stdexcept>
 #include <algorithm>
@@ -30,6 +34,17 @@ std::unique_ptr<T> make_unique(Args&&... args) {
 class NEML_EXPORT NEMLObject {
  public:
   virtual ~NEMLObject() {};
+
+  /// Whether identical objects made by the Factory can be one shared object
+  //  Types that are never changed after construction return true, and the
+  //  Factory then hands out a single instance for each distinct parameter
+  //  set.
+  static bool interned() {return false;};
+
+  /// Called on each object Factory::create hands out, which may be shared
+  //  Types that could still be changed after construction should refuse
+  //  to be from then on.
+  virtual void freeze() {};
 };
 
 // This version supports the following types of objects as parameters:
@@ -93,11 +108,13 @@ class NEML_EXPORT UnknownParameter: public std::exception {
     ss << "Object of type " << object_ << " has no parameter "
         << name_ << "!";
 
-    return ss.str().c_str();
+    msg_ = ss.str();
+    return msg_.c_str();
   }
 
  private:
   std::string object_, name_;
+  mutable std::string msg_;
 };
 
 /// Error to call if you try a bad cast
@@ -114,8 +131,12 @@ class NEML_EXPORT WrongTypeError: public std::exception {
 
     ss << "Cannot convert object to the correct type!";
 
-    return ss.str().c_str();
+    msg_ = ss.str();
+    return msg_.c_str();
   }
+
+ private:
+  mutable std::string msg_;
 };
 
 /// Parameters for objects created through the NEMLObject interface
@@ -167,6 +188,12 @@ class NEML_EXPORT ParameterSet {
   /// Assign a parameter set to be used to create an object later
   void assign_defered_parameter(std::string name, ParameterSet value);
 
+  /// Check if a parameter is a deferred parameter set
+  bool is_defered_parameter(std::string name) const;
+
+  /// Get a deferred parameter set, e.g. to modify it before creation
+  ParameterSet & get_defered_parameter(std::string name);
+
   /// Helper method to get a NEMLObject and cast it to subtype in one go
   template<typename T>
   std::shared_ptr<T> get_object_parameter(std::string name)
@@ -214,6 +241,12 @@ class NEML_EXPORT ParameterSet {
   /// Check to make sure this parameter set is ready to go
   bool fully_assigned();
 
+  /// Text that is the same for two sets exactly when they make identical
+  /// objects
+  //  Numbers are written bit for bit and object parameters by address, so
+  //  the objects made from interned children compare equal.
+  std::string canonical_key();
+
  private:
   /// Run down the chain of deferred objects and actually construct them
   void resolve_objects_();
@@ -264,17 +297,38 @@ class NEML_EXPORT Factory {
     }
   }
 
-  /// Register a type with an identifier, create method, and parameter set
+  /// Register a type with an identifier, create method, and parameter set,
+  /// optionally sharing identical instances
   void register_type(std::string type,
                      std::function<std::unique_ptr<NEMLObject>(ParameterSet &)> creator,
-                     std::function<ParameterSet()> setup);
+                     std::function<ParameterSet()> setup,
+                     bool interned = false);
+
+  /// Turn the sharing of identical interned objects on or off
+  void set_interning(bool on);
+  /// Whether identical interned objects are shared
+  bool interning() const;
+  /// Number of live shared objects
+  size_t interned_objects();
 
   /// Static factor instance
   static Factory * Creator();
 
  private:
+  Factory();
+
+  std::shared_ptr<NEMLObject> create_interned_(
+      ParameterSet & params,
+      const std::function<std::unique_ptr<NEMLObject>(ParameterSet &)> & creator);
+
   std::map<std::string, std::function<std::unique_ptr<NEMLObject>(ParameterSet &)>> creators_;
   std::map<std::string, std::function<ParameterSet()>> setups_;
+
+  std::set<std::string> interned_types_;
+  std::atomic<bool> interning_;
+  std::mutex intern_lock_;
+  std::unordered_map<std::string, std::weak_ptr<NEMLObject>> interned_;
+  size_t purge_size_;
 };
 
 /// Little object used for auto registration
@@ -283,7 +337,8 @@ class NEML_EXPORT Register {
  public:
   Register()
   {
-    Factory::Creator()->register_type(T::type(), &T::initialize, &T::parameters);
+    Factory::Creator()->register_type(T::type(), &T::initialize, &T::parameters,
+                                      T::interned());
   }
 };
 
@@ -306,12 +361,14 @@ class NEML_EXPORT UndefinedParameters: public std::exception {
       ss << "\t" << *it << " ";
     }
 
-    return ss.str().c_str();
+    msg_ = ss.str();
+    return msg_.c_str();
   }
 
  private:
   std::string name_;
   std::vector<std::string> unassigned_;
+  mutable std::string msg_;
 };
 
 /// Error to throw if the class isn't registered
@@ -329,11 +386,13 @@ class NEML_EXPORT UnregisteredError: public std::exception {
 
     ss << "Object named " << name_ << " not registered with factory!";
 
-    return ss.str().c_str();
+    msg_ = ss.str();
+    return msg_.c_str();
   };
 
  private:
   std::string name_;
+  mutable std::string msg_;
 };
 
 } //namespace neml
@@ -1,6 +1,7 @@
 #include "pyhelp.h" // include first to avoid annoying redef warning
 
 #include "objects.h"
+#include "trace.h"
 
 namespace py = pybind11;
 
@@ -13,6 +14,32 @@ PYBIND11_MODULE(objects, m) {
 
   py::class_<NEMLObject, std::shared_ptr<NEMLObject>>(m, "NEMLObject")
       ;
+
+  m.def("set_interning",
+        [](bool on)
+        {
+          Factory::Creator()->set_interning(on);
+        }, "Turn the sharing of identical objects made by the factory on or off.",
+        py::arg("on"));
+  m.def("interning",
+        []() -> bool
+        {
+          return Factory::Creator()->interning();
+        }, "Whether identical objects made by the factory are shared.");
+  m.def("interned_objects",
+        []() -> size_t
+        {
+          return Factory::Creator()->interned_objects();
+        }, "Number of live objects shared by the factory.");
+
+  m.def("tracing_compiled", &tracing_compiled, "Whether the library was built with the trace markers.");
+  m.def("start_tracing", &start_tracing, "Start recording the trace markers.");
+  m.def("stop_tracing", &stop_tracing, "Stop recording the trace markers.");
+  m.def("tracing", &tracing, "Whether the trace markers are being recorded.");
+  m.def("clear_trace", &clear_trace, "Discard the recorded events.");
+  m.def("trace_events", &trace_events, "Total number of recorded events.");
+  m.def("write_trace", &write_trace, "Write the recorded events as Chrome trace JSON.",
+        py::arg("fname"));
 }
 
 } // namespace neml
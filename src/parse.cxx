@@ -2,6 +2,15 @@
 
 namespace neml {
 
+/// A ConstantInterpolate made by the Factory, so equal values are shared
+static std::shared_ptr<NEMLObject> make_constant_(double v)
+{
+  ParameterSet params = Factory::Creator()->provide_parameters(
+      ConstantInterpolate::type());
+  params.assign_parameter("v", v);
+  return Factory::Creator()->create(params);
+}
+
 std::shared_ptr<NEMLModel> parse_string(std::string input)
 {
   // Parse the string to the rapidxml representation
@@ -120,7 +129,7 @@ std::shared_ptr<NEMLObject> get_object(const rapidxml::xml_node<> * node)
   // Special case: could be a ConstantInterpolate
   std::string type = get_type_of_node(node);
   if (type == "none") {
-    return std::make_shared<ConstantInterpolate>(get_double(node));
+    return make_constant_(get_double(node));
   }
   else {
     ParameterSet params = get_parameters(node);
@@ -199,7 +208,7 @@ std::vector<std::shared_ptr<NEMLObject>> get_vector_object(
       (node->first_node()->type() == rapidxml::node_data)) {
     std::vector<double> data = get_vector_double(node);
     for (auto v : data) {
-      joined.push_back(neml::make_unique<ConstantInterpolate>(v));
+      joined.push_back(make_constant_(v));
     }
     return joined;
   }
@@ -94,12 +94,14 @@ class NodeNotFound: public std::exception {
     ss << "Node with name " << node_name_
         << " was not found near line " << line_ << "!";
 
-    return ss.str().c_str();
+    msg_ = ss.str();
+    return msg_.c_str();
   };
 
  private:
   std::string node_name_;
   int line_;
+  mutable std::string msg_;
 };
 
 /// If a node is not unique (and it should be)
@@ -117,12 +119,14 @@ class DuplicateNode: public std::exception {
 
       ss << "Multiple nodes with name " << node_name_ << " were found!";
 
-      return ss.str().c_str();
+      msg_ = ss.str();
+      return msg_.c_str();
     };
 
   private:
     std::string node_name_;
     int line_;
+    mutable std::string msg_;
 };
 
 /// If the object can't be converted
@@ -141,11 +145,13 @@ class InvalidType: public std::exception {
     ss << "Node with name " << name_ << " and type " << type_
         << "cannot be converted to the correct type " << ctype_ << "!";
 
-    return ss.str().c_str();
+    msg_ = ss.str();
+    return msg_.c_str();
   };
 
  private:
   const std::string name_, type_, ctype_;
+  mutable std::string msg_;
 };
 
 /// If a parameter doesn't exist
@@ -163,12 +169,14 @@ class UnknownParameterXML: public std::exception {
 
     ss << "Object " << name_ << " does not have a parameter called " << param_ << "!";
 
-    return ss.str().c_str();
+    msg_ = ss.str();
+    return msg_.c_str();
   };
 
  private:
   const std::string name_, param_;
 
+  mutable std::string msg_;
 };
 
 /// The object isn't in the factory
@@ -186,12 +194,14 @@ class UnregisteredXML: public std::exception {
 
     ss << "Node named " << name_ << " has an unregistered type of " << type_ << "!";
 
-    return ss.str().c_str();
+    msg_ = ss.str();
+    return msg_.c_str();
   };
 
  private:
   const std::string name_, type_;
 
+  mutable std::string msg_;
 };
 
 } // namespace neml
@@ -0,0 +1,74 @@
+#include "perthread.h"
+
+namespace neml {
+
+namespace {
+
+/// One thread's entry for one owner slot
+struct ThreadEntry {
+  size_t generation = 0;
+  void * p = nullptr;
+};
+
+/// Each thread's entries, indexed by owner slot
+//  Owners give their slot back when they die and the next owner reuses
+//  it, so a thread's table only grows to the largest number of owners
+//  alive at once.  The generation tells the new owner of a slot apart
+//  from the entries an earlier owner left behind.
+thread_local std::vector<ThreadEntry> thread_entries;
+
+/// The free slots and the generation counter
+struct Slots {
+  std::mutex lock;
+  std::vector<size_t> free;
+  size_t nslots = 0;
+  size_t generation = 0;
+};
+
+Slots & slots()
+{
+  static Slots s;
+  return s;
+}
+
+} // namespace
+
+PerThreadBase::PerThreadBase()
+{
+  Slots & s = slots();
+  std::lock_guard<std::mutex> guard(s.lock);
+  if (s.free.empty()) {
+    slot_ = s.nslots++;
+  }
+  else {
+    slot_ = s.free.back();
+    s.free.pop_back();
+  }
+  generation_ = ++s.generation;
+}
+
+PerThreadBase::~PerThreadBase()
+{
+  Slots & s = slots();
+  std::lock_guard<std::mutex> guard(s.lock);
+  s.free.push_back(slot_);
+}
+
+void * PerThreadBase::find_() const
+{
+  const std::vector<ThreadEntry> & te = thread_entries;
+  if ((slot_ < te.size()) && (te[slot_].generation == generation_)) {
+    return te[slot_].p;
+  }
+  return nullptr;
+}
+
+void PerThreadBase::remember_(void * p) const
+{
+  std::vector<ThreadEntry> & te = thread_entries;
+  if (te.size() <= slot_) te.resize(slot_ + 1);
+  te[slot_].generation = generation_;
+  te[slot_].p = p;
+}
+
+} // namespace neml
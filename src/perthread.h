@@ -0,0 +1,86 @@
+#ifndef PERTHREAD_H
+#define PERTHREAD_H
+
+#include "windows.h"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace neml {
+
+/// Untyped part of PerThread: the slots and the per-thread lookup
+class NEML_EXPORT PerThreadBase {
+ protected:
+  PerThreadBase();
+  PerThreadBase(const PerThreadBase &) = delete;
+  PerThreadBase & operator=(const PerThreadBase &) = delete;
+  ~PerThreadBase();
+
+  /// The calling thread's entry, nullptr if it does not have one yet
+  void * find_() const;
+  /// Make p the calling thread's entry
+  void remember_(void * p) const;
+
+ private:
+  size_t slot_;
+  size_t generation_;
+};
+
+/// One T for each thread that asks for one
+//  local() returns the calling thread's own T, so the owner can keep
+//  scratch data or counters in it during an update without a lock, even
+//  when one object is shared by many threads.  A copy starts out empty,
+//  since the entries belong to the threads using the original.  all() and
+//  reset() should be called between updates, not during them.
+template <class T>
+class PerThread : public PerThreadBase {
+ public:
+  PerThread() {};
+  PerThread(const PerThread &) : PerThreadBase() {};
+  PerThread & operator=(const PerThread &) {return *this;};
+
+  /// The calling thread's entry, created on first use
+  T & local()
+  {
+    T * mine = static_cast<T*>(find_());
+    if (mine == nullptr) {
+      std::lock_guard<std::mutex> guard(lock_);
+      items_.emplace_back(new T());
+      mine = items_.back().get();
+      remember_(mine);
+    }
+    return *mine;
+  }
+
+  /// The calling thread's entry, nullptr if it has not made one
+  const T * existing() const
+  {
+    return static_cast<const T*>(find_());
+  }
+
+  /// Call f on every thread's entry
+  template <class F>
+  void all(F f) const
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    for (auto & item : items_) f(*item);
+  }
+
+  /// Reset every thread's entry to a default T
+  //  The threads keep pointers to their entries, so this works in place
+  void reset()
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    for (auto & item : items_) *item = T();
+  }
+
+ private:
+  mutable std::mutex lock_;
+  std::vector<std::unique_ptr<T>> items_;
+};
+
+} // namespace neml
+
+#endif // PERTHREAD_H
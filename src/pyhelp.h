@@ -158,7 +158,9 @@ std::shared_ptr<T> create_object_python(py::args args, py::kwargs kwargs,
                             item.second.cast<py::object>());
   }
 
-  return Factory::Creator()->create<T>(pset);
+  // Objects built from python belong to the caller, who may still change
+  // them, so they are never shared
+  return std::shared_ptr<T>(Factory::Creator()->create_unique<T>(pset));
 }
 
 } // namespace neml
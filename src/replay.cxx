@@ -0,0 +1,402 @@
+#include "replay.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace neml {
+
+namespace {
+
+/// Start of every log, followed by the format version
+const char log_magic[8] = {'N', 'E', 'M', 'L', 'L', 'O', 'G', '\0'};
+const std::uint32_t log_version = 1;
+
+typedef std::chrono::steady_clock replay_clock;
+
+template <class T>
+void put(std::ostream & out, const T & v)
+{
+  out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+void put(std::ostream & out, const std::vector<double> & v)
+{
+  out.write(reinterpret_cast<const char*>(v.data()),
+            v.size() * sizeof(double));
+}
+
+template <class T>
+T get(std::istream & in)
+{
+  T v;
+  in.read(reinterpret_cast<char*>(&v), sizeof(T));
+  return v;
+}
+
+void get(std::istream & in, std::vector<double> & v, size_t n)
+{
+  v.resize(n);
+  in.read(reinterpret_cast<char*>(v.data()), n * sizeof(double));
+}
+
+/// Numeric environment variable, 0 if not set
+double env_number(const char * name)
+{
+  const char * value = std::getenv(name);
+  if ((value == nullptr) || (*value == '\0')) return 0.0;
+  return std::atof(value);
+}
+
+} // namespace
+
+/// Stream shared by all the recorders of one file
+struct UpdateRecorder::LogFile {
+  std::mutex lock;
+  std::ofstream out;
+  /// Calls over all the recorders of the file, for the sampling
+  std::atomic<size_t> calls;
+};
+
+RecordedUpdate::RecordedUpdate() :
+    large(false), T_np1(0), T_n(0), t_np1(0), t_n(0), u_n(0), p_n(0),
+    ier(0), time(0), iterations(0)
+{
+
+}
+
+UpdateRecorder::UpdateRecorder(std::string fname, size_t sample_every,
+                               double time_threshold,
+                               size_t iteration_threshold) :
+    fname_(fname), sample_every_(sample_every),
+    time_threshold_(time_threshold),
+    iteration_threshold_(iteration_threshold), calls_(0), recorded_(0)
+{
+  // Open files live for the whole run, so the recorders made for each call
+  // by a UMAT do not reopen them
+  static std::mutex files_lock;
+  static std::map<std::string, std::shared_ptr<LogFile>> files;
+
+  std::lock_guard<std::mutex> guard(files_lock);
+  auto found = files.find(fname_);
+  if (found != files.end()) {
+    log_ = found->second;
+    return;
+  }
+
+  log_ = std::make_shared<LogFile>();
+  log_->calls = 0;
+  log_->out.open(fname_, std::ios::binary | std::ios::app);
+  if (not log_->out) {
+    throw std::runtime_error("Could not open update log " + fname_);
+  }
+  log_->out.seekp(0, std::ios::end);
+  if (log_->out.tellp() == 0) {
+    log_->out.write(log_magic, sizeof(log_magic));
+    put(log_->out, log_version);
+    log_->out.flush();
+  }
+  files[fname_] = log_;
+}
+
+std::shared_ptr<UpdateRecorder> UpdateRecorder::from_environment()
+{
+  const char * fname = std::getenv("NEML_RECORD");
+  if ((fname == nullptr) || (*fname == '\0')) return nullptr;
+
+  return std::make_shared<UpdateRecorder>(
+      fname, (size_t) env_number("NEML_RECORD_EVERY"),
+      env_number("NEML_RECORD_TIME"),
+      (size_t) env_number("NEML_RECORD_ITERATIONS"));
+}
+
+int UpdateRecorder::update_sd(NEMLModel & model,
+                              const double * const e_np1,
+                              const double * const e_n,
+                              double T_np1, double T_n,
+                              double t_np1, double t_n,
+                              double * const s_np1, const double * const s_n,
+                              double * const h_np1, const double * const h_n,
+                              double * const A_np1,
+                              double & u_np1, double u_n,
+                              double & p_np1, double p_n)
+{
+  // Copy the inputs first, the caller may reuse the arrays for the output
+  RecordedUpdate rec;
+  size_t nh = model.nstore();
+  rec.e_np1.assign(e_np1, e_np1+6);
+  rec.e_n.assign(e_n, e_n+6);
+  rec.T_np1 = T_np1;
+  rec.T_n = T_n;
+  rec.t_np1 = t_np1;
+  rec.t_n = t_n;
+  rec.s_n.assign(s_n, s_n+6);
+  rec.h_n.assign(h_n, h_n+nh);
+  rec.u_n = u_n;
+  rec.p_n = p_n;
+
+  size_t iters = iterations_(model);
+  auto start = replay_clock::now();
+  rec.ier = model.update_sd(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1, s_n,
+                            h_np1, h_n, A_np1, u_np1, u_n, p_np1, p_n);
+  rec.time = std::chrono::duration<double>(replay_clock::now() -
+                                           start).count();
+  rec.iterations = iterations_(model) - iters;
+
+  if (keep_(rec.time, rec.iterations)) {
+    rec.s_np1.assign(s_np1, s_np1+6);
+    write_(rec);
+  }
+
+  return rec.ier;
+}
+
+int UpdateRecorder::update_ld_inc(NEMLModel & model,
+                                  const double * const d_np1,
+                                  const double * const d_n,
+                                  const double * const w_np1,
+                                  const double * const w_n,
+                                  double T_np1, double T_n,
+                                  double t_np1, double t_n,
+                                  double * const s_np1,
+                                  const double * const s_n,
+                                  double * const h_np1,
+                                  const double * const h_n,
+                                  double * const A_np1, double * const B_np1,
+                                  double & u_np1, double u_n,
+                                  double & p_np1, double p_n)
+{
+  RecordedUpdate rec;
+  size_t nh = model.nstore();
+  rec.large = true;
+  rec.e_np1.assign(d_np1, d_np1+6);
+  rec.e_n.assign(d_n, d_n+6);
+  rec.w_np1.assign(w_np1, w_np1+3);
+  rec.w_n.assign(w_n, w_n+3);
+  rec.T_np1 = T_np1;
+  rec.T_n = T_n;
+  rec.t_np1 = t_np1;
+  rec.t_n = t_n;
+  rec.s_n.assign(s_n, s_n+6);
+  rec.h_n.assign(h_n, h_n+nh);
+  rec.u_n = u_n;
+  rec.p_n = p_n;
+
+  size_t iters = iterations_(model);
+  auto start = replay_clock::now();
+  rec.ier = model.update_ld_inc(d_np1, d_n, w_np1, w_n, T_np1, T_n,
+                                t_np1, t_n, s_np1, s_n, h_np1, h_n,
+                                A_np1, B_np1, u_np1, u_n, p_np1, p_n);
+  rec.time = std::chrono::duration<double>(replay_clock::now() -
+                                           start).count();
+  rec.iterations = iterations_(model) - iters;
+
+  if (keep_(rec.time, rec.iterations)) {
+    rec.s_np1.assign(s_np1, s_np1+6);
+    write_(rec);
+  }
+
+  return rec.ier;
+}
+
+const std::string & UpdateRecorder::fname() const
+{
+  return fname_;
+}
+
+size_t UpdateRecorder::iteration_threshold() const
+{
+  return iteration_threshold_;
+}
+
+size_t UpdateRecorder::calls() const
+{
+  return calls_;
+}
+
+size_t UpdateRecorder::recorded() const
+{
+  return recorded_;
+}
+
+size_t UpdateRecorder::iterations_(NEMLModel & model) const
+{
+  SolverStats * stats = model.local_solver_stats_();
+  if (stats == nullptr) return 0;
+  return stats->iterations;
+}
+
+bool UpdateRecorder::keep_(double time, size_t iterations)
+{
+  calls_++;
+  size_t call = log_->calls++;
+
+  if ((sample_every_ == 0) && (time_threshold_ <= 0.0) &&
+      (iteration_threshold_ == 0)) return true;
+
+  if ((sample_every_ > 0) && ((call % sample_every_) == 0)) return true;
+  if ((time_threshold_ > 0.0) && (time > time_threshold_)) return true;
+  if ((iteration_threshold_ > 0) && (iterations >= iteration_threshold_))
+    return true;
+
+  return false;
+}
+
+void UpdateRecorder::write_(const RecordedUpdate & rec)
+{
+  std::lock_guard<std::mutex> guard(log_->lock);
+  std::ostream & out = log_->out;
+
+  put(out, (std::uint8_t) rec.large);
+  put(out, (std::uint32_t) rec.h_n.size());
+  put(out, rec.e_np1);
+  put(out, rec.e_n);
+  if (rec.large) {
+    put(out, rec.w_np1);
+    put(out, rec.w_n);
+  }
+  put(out, rec.T_np1);
+  put(out, rec.T_n);
+  put(out, rec.t_np1);
+  put(out, rec.t_n);
+  put(out, rec.s_n);
+  put(out, rec.h_n);
+  put(out, rec.u_n);
+  put(out, rec.p_n);
+  put(out, (std::int32_t) rec.ier);
+  put(out, rec.time);
+  put(out, (std::uint64_t) rec.iterations);
+  put(out, rec.s_np1);
+
+  // Flush every record, the run being diagnosed may well crash
+  out.flush();
+  recorded_++;
+}
+
+int recorded_update_sd(NEMLModel & model,
+                       const double * const e_np1, const double * const e_n,
+                       double T_np1, double T_n,
+                       double t_np1, double t_n,
+                       double * const s_np1, const double * const s_n,
+                       double * const h_np1, const double * const h_n,
+                       double * const A_np1,
+                       double & u_np1, double u_n,
+                       double & p_np1, double p_n)
+{
+  const std::shared_ptr<UpdateRecorder> & rec = model.recorder();
+  if (rec) {
+    return rec->update_sd(model, e_np1, e_n, T_np1, T_n, t_np1, t_n,
+                          s_np1, s_n, h_np1, h_n, A_np1, u_np1, u_n,
+                          p_np1, p_n);
+  }
+  return model.update_sd(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1, s_n,
+                         h_np1, h_n, A_np1, u_np1, u_n, p_np1, p_n);
+}
+
+int recorded_update_ld_inc(NEMLModel & model,
+                           const double * const d_np1,
+                           const double * const d_n,
+                           const double * const w_np1,
+                           const double * const w_n,
+                           double T_np1, double T_n,
+                           double t_np1, double t_n,
+                           double * const s_np1, const double * const s_n,
+                           double * const h_np1, const double * const h_n,
+                           double * const A_np1, double * const B_np1,
+                           double & u_np1, double u_n,
+                           double & p_np1, double p_n)
+{
+  const std::shared_ptr<UpdateRecorder> & rec = model.recorder();
+  if (rec) {
+    return rec->update_ld_inc(model, d_np1, d_n, w_np1, w_n, T_np1, T_n,
+                              t_np1, t_n, s_np1, s_n, h_np1, h_n, A_np1,
+                              B_np1, u_np1, u_n, p_np1, p_n);
+  }
+  return model.update_ld_inc(d_np1, d_n, w_np1, w_n, T_np1, T_n, t_np1, t_n,
+                             s_np1, s_n, h_np1, h_n, A_np1, B_np1, u_np1,
+                             u_n, p_np1, p_n);
+}
+
+std::vector<RecordedUpdate> read_update_log(std::string fname)
+{
+  std::ifstream in(fname, std::ios::binary);
+  if (not in) {
+    throw std::runtime_error("Could not open update log " + fname);
+  }
+
+  char magic[sizeof(log_magic)];
+  in.read(magic, sizeof(magic));
+  std::uint32_t version = get<std::uint32_t>(in);
+  if (not in || (std::memcmp(magic, log_magic, sizeof(magic)) != 0) ||
+      (version != log_version)) {
+    throw std::runtime_error(fname + " is not a NEML update log");
+  }
+
+  std::vector<RecordedUpdate> updates;
+  while (true) {
+    std::uint8_t large = get<std::uint8_t>(in);
+    if (in.eof()) break;
+
+    RecordedUpdate rec;
+    rec.large = (large != 0);
+    size_t nh = get<std::uint32_t>(in);
+    get(in, rec.e_np1, 6);
+    get(in, rec.e_n, 6);
+    if (rec.large) {
+      get(in, rec.w_np1, 3);
+      get(in, rec.w_n, 3);
+    }
+    rec.T_np1 = get<double>(in);
+    rec.T_n = get<double>(in);
+    rec.t_np1 = get<double>(in);
+    rec.t_n = get<double>(in);
+    get(in, rec.s_n, 6);
+    get(in, rec.h_n, nh);
+    rec.u_n = get<double>(in);
+    rec.p_n = get<double>(in);
+    rec.ier = get<std::int32_t>(in);
+    rec.time = get<double>(in);
+    rec.iterations = get<std::uint64_t>(in);
+    get(in, rec.s_np1, 6);
+
+    // A run that died mid record leaves a partial one at the end
+    if (not in) break;
+    updates.push_back(rec);
+  }
+
+  return updates;
+}
+
+int replay_update(NEMLModel & model, const RecordedUpdate & rec,
+                  std::vector<double> & s_np1)
+{
+  if (rec.h_n.size() != model.nstore()) {
+    throw std::invalid_argument("The recorded update does not match the "
+                                "model's number of stored variables");
+  }
+
+  s_np1.resize(6);
+  std::vector<double> h_np1(rec.h_n.size());
+  double A_np1[36];
+  double B_np1[18];
+  double u_np1, p_np1;
+
+  if (rec.large) {
+    return model.update_ld_inc(&rec.e_np1[0], &rec.e_n[0], &rec.w_np1[0],
+                               &rec.w_n[0], rec.T_np1, rec.T_n, rec.t_np1,
+                               rec.t_n, &s_np1[0], &rec.s_n[0],
+                               h_np1.data(), rec.h_n.data(), A_np1, B_np1,
+                               u_np1, rec.u_n, p_np1, rec.p_n);
+  }
+  return model.update_sd(&rec.e_np1[0], &rec.e_n[0], rec.T_np1, rec.T_n,
+                         rec.t_np1, rec.t_n, &s_np1[0], &rec.s_n[0],
+                         h_np1.data(), rec.h_n.data(), A_np1, u_np1,
+                         rec.u_n, p_np1, rec.p_n);
+}
+
+} // namespace neml
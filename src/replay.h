@@ -0,0 +1,136 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "models.h"
+
+#include "windows.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace neml {
+
+/// The inputs and outcome of one captured update_sd or update_ld_inc call
+struct NEML_EXPORT RecordedUpdate {
+  RecordedUpdate();
+
+  /// True for update_ld_inc, false for update_sd
+  bool large;
+  /// Strain (update_sd) or deformation rate (update_ld_inc), 6 each
+  std::vector<double> e_np1, e_n;
+  /// Vorticity, 3 each, empty for update_sd
+  std::vector<double> w_np1, w_n;
+  double T_np1, T_n, t_np1, t_n;
+  /// Stress and history (nstore) at the start of the step
+  std::vector<double> s_n, h_n;
+  double u_n, p_n;
+
+  /// Error code returned by the recorded call
+  int ier;
+  /// Wall time of the recorded call (seconds)
+  double time;
+  /// Solver iterations of the recorded call, if the model collects them
+  size_t iterations;
+  /// Stress the recorded call returned
+  std::vector<double> s_np1;
+};
+
+/// Writes the inputs of selected updates to a compact binary log
+//  A call is captured if it is one of every sample_every calls, if it
+//  takes longer than time_threshold seconds, or if the model's solves take
+//  at least iteration_threshold iterations; a zero turns that test off and
+//  if all three are off every call is captured.  Recorders of the same file
+//  share one stream and append to it, so models that are created and
+//  destroyed for each call, as in the Abaqus UMAT, build up a single log.
+class NEML_EXPORT UpdateRecorder {
+ public:
+  UpdateRecorder(std::string fname, size_t sample_every = 0,
+                 double time_threshold = 0.0,
+                 size_t iteration_threshold = 0);
+
+  /// Set up from NEML_RECORD (the file), NEML_RECORD_EVERY,
+  /// NEML_RECORD_TIME and NEML_RECORD_ITERATIONS, nullptr if NEML_RECORD
+  /// is not set
+  static std::shared_ptr<UpdateRecorder> from_environment();
+
+  /// Call model.update_sd, capturing the call if it meets the criteria
+  int update_sd(NEMLModel & model,
+                const double * const e_np1, const double * const e_n,
+                double T_np1, double T_n,
+                double t_np1, double t_n,
+                double * const s_np1, const double * const s_n,
+                double * const h_np1, const double * const h_n,
+                double * const A_np1,
+                double & u_np1, double u_n,
+                double & p_np1, double p_n);
+
+  /// Call model.update_ld_inc, capturing the call if it meets the criteria
+  int update_ld_inc(NEMLModel & model,
+                    const double * const d_np1, const double * const d_n,
+                    const double * const w_np1, const double * const w_n,
+                    double T_np1, double T_n,
+                    double t_np1, double t_n,
+                    double * const s_np1, const double * const s_n,
+                    double * const h_np1, const double * const h_n,
+                    double * const A_np1, double * const B_np1,
+                    double & u_np1, double u_n,
+                    double & p_np1, double p_n);
+
+  const std::string & fname() const;
+  size_t iteration_threshold() const;
+  /// Number of calls made through this recorder
+  size_t calls() const;
+  /// Number of calls captured by this recorder
+  size_t recorded() const;
+
+ private:
+  struct LogFile;
+
+  size_t iterations_(NEMLModel & model) const;
+  bool keep_(double time, size_t iterations);
+  void write_(const RecordedUpdate & rec);
+
+  std::string fname_;
+  size_t sample_every_;
+  double time_threshold_;
+  size_t iteration_threshold_;
+  std::shared_ptr<LogFile> log_;
+  std::atomic<size_t> calls_;
+  std::atomic<size_t> recorded_;
+};
+
+/// update_sd through the model's recorder, if it has one
+NEML_EXPORT int recorded_update_sd(NEMLModel & model,
+                const double * const e_np1, const double * const e_n,
+                double T_np1, double T_n,
+                double t_np1, double t_n,
+                double * const s_np1, const double * const s_n,
+                double * const h_np1, const double * const h_n,
+                double * const A_np1,
+                double & u_np1, double u_n,
+                double & p_np1, double p_n);
+
+/// update_ld_inc through the model's recorder, if it has one
+NEML_EXPORT int recorded_update_ld_inc(NEMLModel & model,
+                const double * const d_np1, const double * const d_n,
+                const double * const w_np1, const double * const w_n,
+                double T_np1, double T_n,
+                double t_np1, double t_n,
+                double * const s_np1, const double * const s_n,
+                double * const h_np1, const double * const h_n,
+                double * const A_np1, double * const B_np1,
+                double & u_np1, double u_n,
+                double & p_np1, double p_n);
+
+/// Read every update captured in a log
+NEML_EXPORT std::vector<RecordedUpdate> read_update_log(std::string fname);
+
+/// Rerun a captured update on a model, returning the new stress in s_np1
+NEML_EXPORT int replay_update(NEMLModel & model, const RecordedUpdate & rec,
+                              std::vector<double> & s_np1);
+
+} // namespace neml
+
+#endif // REPLAY_H
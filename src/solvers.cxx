@@ -2,34 +2,206 @@
 
 #include "math/nemlmath.h"
 #include "nemlerror.h"
+#include "trace.h"
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <stdexcept>
 #include <vector>
 
 namespace neml {
 
+namespace {
+
+typedef std::chrono::steady_clock stats_clock;
+
+double since_(stats_clock::time_point start)
+{
+  return std::chrono::duration<double>(stats_clock::now() - start).count();
+}
+
+// The wrappers below only time and count the calls if collecting
+
+int call_RJ_(const Solvable * system, const double * const x, TrialState * ts,
+             double * const R, double * const J, SolverStats * stats)
+{
+  NEML_TRACE_SCOPE("RJ");
+  if (stats == nullptr) return system->RJ(x, ts, R, J);
+  auto start = stats_clock::now();
+  int ier = system->RJ(x, ts, R, J);
+  stats->rj_time += since_(start);
+  stats->rj_calls++;
+  return ier;
+}
+
+int call_R_(const Solvable * system, const double * const x, TrialState * ts,
+            double * const R, SolverStats * stats)
+{
+  NEML_TRACE_SCOPE("R");
+  if (stats == nullptr) return system->R(x, ts, R);
+  auto start = stats_clock::now();
+  int ier = system->R(x, ts, R);
+  stats->rj_time += since_(start);
+  stats->r_calls++;
+  return ier;
+}
+
+int call_linear_solve_(const Solvable * system, const double * const J,
+                       double * const R, SolverStats * stats)
+{
+  NEML_TRACE_SCOPE("linear_solve");
+  if (stats == nullptr) return system->linear_solve(J, R);
+  auto start = stats_clock::now();
+  int ier = system->linear_solve(J, R);
+  stats->linear_time += since_(start);
+  stats->linear_solves++;
+  return ier;
+}
+
+int call_factor_(const double * const A, int n, double * const LU,
+                 int * const ipiv, SolverStats * stats)
+{
+  if (stats == nullptr) return factor_mat(A, n, LU, ipiv);
+  auto start = stats_clock::now();
+  int ier = factor_mat(A, n, LU, ipiv);
+  stats->linear_time += since_(start);
+  return ier;
+}
+
+int call_solve_factored_(const double * const LU, const int * const ipiv,
+                         int n, double * const x, SolverStats * stats)
+{
+  if (stats == nullptr) return solve_factored(LU, ipiv, n, x);
+  auto start = stats_clock::now();
+  int ier = solve_factored(LU, ipiv, n, x);
+  stats->linear_time += since_(start);
+  stats->linear_solves++;
+  return ier;
+}
+
+void finish_solve_(SolverStats * stats, int iters, int ier)
+{
+  if (stats == nullptr) return;
+  stats->solves++;
+  if (iters > 0) stats->iterations += iters;
+  if (ier != SUCCESS) stats->failures[ier]++;
+}
+
+} // namespace
+
+SolverStats::SolverStats() :
+    solves(0), iterations(0), rj_calls(0), r_calls(0), linear_solves(0),
+    substep_divisions(0), rj_time(0.0), linear_time(0.0)
+{
+
+}
+
+void SolverStats::merge(const SolverStats & other)
+{
+  solves += other.solves;
+  iterations += other.iterations;
+  rj_calls += other.rj_calls;
+  r_calls += other.r_calls;
+  linear_solves += other.linear_solves;
+  substep_divisions += other.substep_divisions;
+  for (auto & f : other.failures) failures[f.first] += f.second;
+  rj_time += other.rj_time;
+  linear_time += other.linear_time;
+}
+
+size_t SolverStats::total_failures() const
+{
+  size_t n = 0;
+  for (auto & f : failures) n += f.second;
+  return n;
+}
+
+StatsCollector::StatsCollector() :
+    enabled_(false)
+{
+
+}
+
+StatsCollector::StatsCollector(const StatsCollector & other) :
+    enabled_(other.enabled())
+{
+
+}
+
+StatsCollector & StatsCollector::operator=(const StatsCollector & other)
+{
+  enable(other.enabled());
+  return *this;
+}
+
+void StatsCollector::enable(bool on)
+{
+  enabled_ = on;
+}
+
+bool StatsCollector::enabled() const
+{
+  return enabled_;
+}
+
+SolverStats * StatsCollector::local()
+{
+  if (not enabled_.load(std::memory_order_relaxed)) return nullptr;
+  return &threads_.local();
+}
+
+SolverStats StatsCollector::merged() const
+{
+  SolverStats total;
+  threads_.all([&total](const SolverStats & t) {total.merge(t);});
+  return total;
+}
+
+void StatsCollector::reset()
+{
+  threads_.reset();
+}
+
+int Solvable::linear_solve(const double * const J, double * const R) const
+{
+  return solve_mat(J, nparams(), R);
+}
+
+int Solvable::R(const double * const x, TrialState * ts, double * const R) const
+{
+  std::vector<double> J(nparams() * nparams());
+  return RJ(x, ts, R, &J[0]);
+}
+
 // This function is configured by the build
-int solve(Solvable * system, double * x, TrialState * ts,
+int solve(const Solvable * system, double * x, TrialState * ts,
           double tol, int miter, bool verbose, bool relative,
-          double * R, double * J)
+          double * R, double * J, int * iters, SolverStats * stats)
 {
+  NEML_TRACE_SCOPE("solve");
 #ifdef SOLVER_NOX
-  return nox(system, x, ts, tol, miter, verbose, R, J);
+  // NOX does not report the iteration count
+  if (iters != nullptr) *iters = -1;
+  int ier = nox(system, x, ts, tol, miter, verbose, R, J);
+  finish_solve_(stats, 0, ier);
+  return ier;
 #elif SOLVER_NEWTON
   // Actually selected the newton solver
-  return newton(system, x, ts, tol, miter, verbose, relative, R, J);
+  return newton(system, x, ts, tol, miter, verbose, relative, R, J, iters,
+                stats);
 #else
   // Default solver: plain NR
-  return newton(system, x, ts, tol, miter, verbose, relative, R, J);
+  return newton(system, x, ts, tol, miter, verbose, relative, R, J, iters,
+                stats);
 #endif
 }
 
-int newton(Solvable * system, double * x, TrialState * ts,
+int newton(const Solvable * system, double * x, TrialState * ts,
           double tol, int miter, bool verbose, bool relative,
-          double * R, double * J)
+          double * R, double * J, int * iters, SolverStats * stats)
 {
   int n = system->nparams();
   system->init_x(x, ts);
@@ -46,8 +218,11 @@ int newton(Solvable * system, double * x, TrialState * ts,
 
   int ier = 0;
 
-  ier = system->RJ(x, ts, R, J);
-  if (ier != SUCCESS) return ier;
+  ier = call_RJ_(system, x, ts, R, J, stats);
+  if (ier != SUCCESS) {
+    finish_solve_(stats, 0, ier);
+    return ier;
+  }
 
   double nR = norm2_vec(R, n);
   double nR0 = nR;
@@ -69,11 +244,11 @@ int newton(Solvable * system, double * x, TrialState * ts,
     if (relative) {
       if ((nR / nR0) < tol) break;
     }
-    solve_mat(J, n, R);
+    call_linear_solve_(system, J, R, stats);
 
     for (int j=0; j<n; j++) x[j] -= R[j];
 
-    system->RJ(x, ts, R, J);
+    call_RJ_(system, x, ts, R, J, stats);
     nR = norm2_vec(R, n);
     i++;
 
@@ -88,6 +263,8 @@ int newton(Solvable * system, double * x, TrialState * ts,
     std::cout << std::endl;
   }
 
+  if (iters != nullptr) *iters = i;
+
   if (local_R) {
     delete [] R;
   }
@@ -96,35 +273,240 @@ int newton(Solvable * system, double * x, TrialState * ts,
     delete [] J;
   }
 
-  if (ier != SUCCESS) return ier;
+  if ((ier == SUCCESS) && (i == miter)) ier = MAX_ITERATIONS;
+  finish_solve_(stats, i, ier);
 
-  if (i == miter) return MAX_ITERATIONS;
+  return ier;
+}
 
-  return SUCCESS;
+BroydenWorkspace::BroydenWorkspace(int nmax, double theta) :
+    nmax_(nmax), theta_(theta), n_(0), valid_(false), factorizations_(0)
+{
+  if (nmax_ < 1) {
+    throw std::invalid_argument("Broyden update history must be at least 1");
+  }
+}
+
+void BroydenWorkspace::reset()
+{
+  valid_ = false;
+}
+
+bool BroydenWorkspace::valid() const
+{
+  return valid_;
+}
+
+size_t BroydenWorkspace::factorizations() const
+{
+  return factorizations_;
+}
+
+void BroydenWorkspace::resize_(size_t n)
+{
+  if (n == n_) return;
+  n_ = n;
+  valid_ = false;
+  LU_.resize(n * n);
+  ipiv_.resize(n);
+  steps_.resize((nmax_ + 1) * n);
+  norms_.resize(nmax_ + 1);
+}
+
+NonlinearSolver parse_nonlinear_solver(const std::string & name)
+{
+  if (name == "newton") return NONLINEAR_NEWTON;
+  if (name == "broyden") return NONLINEAR_BROYDEN;
+  throw std::invalid_argument("Unknown solver " + name);
+}
+
+int broyden(const Solvable * system, double * x, TrialState * ts,
+            double tol, int miter, bool verbose, bool relative,
+            double * R, double * J, int * iters, BroydenWorkspace * work,
+            SolverStats * stats)
+{
+  NEML_TRACE_SCOPE("broyden");
+  int n = system->nparams();
+  system->init_x(x, ts);
+
+  BroydenWorkspace local_work;
+  if (work == nullptr) work = &local_work;
+  work->resize_(n);
+
+  std::vector<double> local_R;
+  std::vector<double> local_J;
+  bool want_J = (J != nullptr);
+  if (R == nullptr) {
+    local_R.resize(n);
+    R = &local_R[0];
+  }
+  if (J == nullptr) {
+    local_J.resize(n*n);
+    J = &local_J[0];
+  }
+
+  // Only rebuild the jacobian here if there is nothing to reuse
+  int ier;
+  bool current_J = false;
+  if (work->valid_) {
+    ier = call_R_(system, x, ts, R, stats);
+  }
+  else {
+    ier = call_RJ_(system, x, ts, R, J, stats);
+    current_J = true;
+    if (ier == SUCCESS) {
+      ier = call_factor_(J, n, &work->LU_[0], &work->ipiv_[0], stats);
+      work->factorizations_++;
+    }
+  }
+  if (ier != SUCCESS) {
+    work->valid_ = false;
+    finish_solve_(stats, 0, ier);
+    return ier;
+  }
+  work->valid_ = true;
+
+  double nR = norm2_vec(R, n);
+  double nR0 = nR;
+  int i = 0;
+
+  if (verbose) {
+    std::cout << "Iter.\tnR\t\tfresh J" << std::endl;
+    std::cout << i << "\t" << nR << "\t" << current_J << std::endl;
+  }
+
+  // Steps taken since the last factorization, s_0 ... s_k
+  double * s = &work->steps_[0];
+  double * ss = &work->norms_[0];
+  int k = -1;
+  // Whether the factors come from the jacobian where s_0 starts
+  bool exact = current_J;
+
+  std::vector<double> zv(n);
+  double * z = &zv[0];
+  std::vector<double> xov(n);
+  double * xo = &xov[0];
+
+  while ((nR > tol) && (i < miter))
+  {
+    if (relative) {
+      if ((nR / nR0) < tol) break;
+    }
+
+    // Plain (modified) Newton step from the factored jacobian
+    if (k < 0) {
+      for (int j=0; j<n; j++) s[j] = -R[j];
+      ier = call_solve_factored_(&work->LU_[0], &work->ipiv_[0], n, s,
+                                 stats);
+      if (ier != SUCCESS) break;
+      ss[0] = dot_vec(s, s, n);
+      k = 0;
+    }
+
+    std::copy(x, x+n, xo);
+    for (int j=0; j<n; j++) x[j] += s[k*n+j];
+    ier = call_R_(system, x, ts, R, stats);
+    if (ier != SUCCESS) break;
+    current_J = false;
+    double nR_new = norm2_vec(R, n);
+    i++;
+
+    bool newton = exact && (k == 0);
+    if (newton && not std::isfinite(nR_new)) {
+      ier = MAX_ITERATIONS;
+      break;
+    }
+    
+    bool done = (nR_new <= tol) || (relative && ((nR_new / nR0) < tol));
+    if (done || (i == miter)) {
+      nR = nR_new;
+      break;
+    }
+
+    bool worse = not (nR_new < nR);
+    if ((worse && not newton) || (nR_new > work->theta_ * nR) || 
+        (k + 1 > work->nmax_)) {
+      // An approximate jacobian that made things worse is not trusted to
+      // have got anywhere useful, so go back and refresh it at the start
+      // of the step.  Otherwise poor contraction or a full history
+      // refreshes the jacobian at the new point.
+      if (worse && not newton) std::copy(xo, xo+n, x);
+      ier = call_RJ_(system, x, ts, R, J, stats);
+      if (ier != SUCCESS) break;
+      current_J = true;
+      ier = call_factor_(J, n, &work->LU_[0], &work->ipiv_[0], stats);
+      work->factorizations_++;
+      if (ier != SUCCESS) break;
+      k = -1;
+      exact = true;
+      nR = norm2_vec(R, n);
+    }
+    else {
+      // Broyden correction of the next step in product form
+      for (int j=0; j<n; j++) z[j] = -R[j];
+      ier = call_solve_factored_(&work->LU_[0], &work->ipiv_[0], n, z,
+                                 stats);
+      if (ier != SUCCESS) break;
+      for (int l=0; l<k; l++) {
+        double f = dot_vec(&s[l*n], z, n) / ss[l];
+        for (int j=0; j<n; j++) z[j] += f * s[(l+1)*n+j];
+      }
+      double denom = 1.0 - dot_vec(&s[k*n], z, n) / ss[k];
+      for (int j=0; j<n; j++) s[(k+1)*n+j] = z[j] / denom;
+      ss[k+1] = dot_vec(&s[(k+1)*n], &s[(k+1)*n], n);
+      k++;
+      nR = nR_new;
+    }
+
+    if (verbose) {
+      std::cout << i << "\t" << nR << "\t" << current_J << std::endl;
+    }
+  }
+
+  if (verbose) {
+    std::cout << std::endl;
+  }
+
+  if (iters != nullptr) *iters = i;
+
+  if ((ier == SUCCESS) && (i == miter)) ier = MAX_ITERATIONS;
+
+  // Keep the factors for the next solve only after a success
+  if (ier != SUCCESS) {
+    work->valid_ = false;
+    finish_solve_(stats, i, ier);
+    return ier;
+  }
+
+  // The caller wants the true jacobian at the solution, e.g. for tangents
+  if (want_J && not current_J) {
+    ier = call_RJ_(system, x, ts, R, J, stats);
+  }
+  finish_solve_(stats, i, ier);
+
+  return ier;
 }
 
 /// Helper to get numerical jacobian
-int diff_jac(Solvable * system, const double * const x, TrialState * ts,
+int diff_jac(const Solvable * system, const double * const x, TrialState * ts,
              double * const nJ, double eps)
 {
   std::vector<double> R0v(system->nparams());
   std::vector<double> nRv(system->nparams());
   std::vector<double> nXv(system->nparams());
-  std::vector<double> dJv(system->nparams() * system->nparams());
 
   double * R0 = &R0v[0];
   double * nR = &nRv[0];
   double * nX = &nXv[0];
-  double * dJ = &dJv[0];
 
-  system->RJ(x, ts, R0, dJ);
+  system->R(x, ts, R0);
   
   for (size_t i=0; i<system->nparams(); i++) {
     std::copy(x, x+system->nparams(), nX);
     double dx = eps * fabs(nX[i]);
     if (dx < eps) dx = eps;
     nX[i] += dx;
-    system->RJ(nX, ts, nR, dJ);
+    system->R(nX, ts, nR);
     for (size_t j=0; j<system->nparams(); j++) {
       nJ[CINDEX(j,i,system->nparams())] = (nR[j] - R0[j]) / dx;
     }
@@ -134,7 +516,7 @@ int diff_jac(Solvable * system, const double * const x, TrialState * ts,
 }
 
 /// Helper to get checksum
-double diff_jac_check(Solvable * system, const double * const x,
+double diff_jac_check(const Solvable * system, const double * const x,
                       TrialState * ts, const double * const J)
 {
   std::vector<double> nJv(system->nparams() * system->nparams());
@@ -153,7 +535,7 @@ double diff_jac_check(Solvable * system, const double * const x,
 
 // START NOX STUFF
 #ifdef SOLVER_NOX
-NOXSolver::NOXSolver(Solvable * system, TrialState * ts) :
+NOXSolver::NOXSolver(const Solvable * system, TrialState * ts) :
     nox_guess_(system->nparams()), system_(system), ts_(ts)
 {
   std::vector<double> xn(system_->nparams());
@@ -171,19 +553,16 @@ const NOX::LAPACK::Vector& NOXSolver::getInitialGuess()
 
 bool NOXSolver::computeF(NOX::LAPACK::Vector& f, const NOX::LAPACK::Vector& x)
 {
-  // This is highly inefficient
   std::vector<double> Riv(system_->nparams());
-  std::vector<double> Jiv(system_->nparams()*system_->nparams());
   std::vector<double> xiv(system_->nparams());
   
   double * Ri = &Riv[0];
-  double * Ji = &Jiv[0];
   double * xi = &xiv[0];
 
   for (size_t i=0; i<system_->nparams(); i++) {
     xi[i] = x(i);
   }
-  system_->RJ(xi, ts_, Ri, Ji);
+  system_->R(xi, ts_, Ri);
   
   for (size_t i=0; i<system_->nparams(); i++) {
     f(i) = Ri[i];
@@ -219,7 +598,7 @@ bool NOXSolver::computeJacobian(NOX::LAPACK::Matrix<double>& J,
 }
 
 
-int nox(Solvable * system, double * x, TrialState * ts,
+int nox(const Solvable * system, double * x, TrialState * ts,
         double tol, int miter, bool verbose, double * R,
         double * J)
 {
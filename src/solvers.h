@@ -1,9 +1,14 @@
 #ifndef SOLVERS_H
 #define SOLVERS_H
 
+#include <atomic>
 #include <cstddef>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "perthread.h"
 #include "windows.h"
 
 #ifdef SOLVER_NOX
@@ -28,29 +33,158 @@ class NEML_EXPORT Solvable {
   /// Number of parameters in the nonlinear equation
   virtual size_t nparams() const = 0;
   /// Initialize a guess to start the solution iterations
-  virtual int init_x(double * const x, TrialState * ts) = 0;
+  virtual int init_x(double * const x, TrialState * ts) const = 0;
   /// Nonlinear residual equations and corresponding jacobian
   virtual int RJ(const double * const x, TrialState * ts, double * const R,
-                 double * const J) = 0;
+                 double * const J) const = 0;
+  /// Nonlinear residual equations alone
+  //  Defaults to calling RJ and discarding the jacobian, implementations
+  //  can override this to skip assembling the jacobian
+  virtual int R(const double * const x, TrialState * ts,
+                double * const R) const;
+
+  /// Solve the Newton system J dx = R, overwriting R with dx
+  //  Defaults to a dense LU solve, implementations can override this
+  //  to take advantage of structure in the Jacobian
+  virtual int linear_solve(const double * const J, double * const R) const;
+};
+
+/// Counts and timings of the nonlinear solves behind a model's updates
+struct NEML_EXPORT SolverStats {
+  SolverStats();
+
+  /// Add another set of statistics into this one
+  void merge(const SolverStats & other);
+  /// Total number of failed solves
+  size_t total_failures() const;
+
+  /// Number of nonlinear solves
+  size_t solves;
+  /// Total number of solver iterations
+  size_t iterations;
+  /// Calls to the residual and jacobian
+  size_t rj_calls;
+  /// Calls to the residual alone
+  size_t r_calls;
+  /// Solves of the linearized system
+  size_t linear_solves;
+  /// Number of times a model cut its step after a failed solve
+  size_t substep_divisions;
+  /// Failed solves, by error code
+  std::map<int, size_t> failures;
+  /// Wall time spent in RJ and R (seconds)
+  double rj_time;
+  /// Wall time spent in the linear solves, including factoring (seconds)
+  double linear_time;
+};
+
+/// Opt-in collector for the solver statistics of one object
+//  Each thread records into its own SolverStats, so collecting takes no
+//  lock in the update itself, and merged() sums the threads on demand.
+//  merged() and reset() should be called between updates, not during
+//  them.  A copy starts out empty but keeps the on/off setting.
+class NEML_EXPORT StatsCollector {
+ public:
+  StatsCollector();
+  StatsCollector(const StatsCollector & other);
+  StatsCollector & operator=(const StatsCollector & other);
+
+  /// Turn collection on or off
+  void enable(bool on = true);
+  /// Whether statistics are being collected
+  bool enabled() const;
+
+  /// Statistics for the calling thread, nullptr if not collecting
+  SolverStats * local();
+  /// Statistics summed over all the threads
+  SolverStats merged() const;
+  /// Zero the statistics
+  void reset();
+
+ private:
+  std::atomic<bool> enabled_;
+  PerThread<SolverStats> threads_;
 };
 
 /// Call the built-in solver
-int NEML_EXPORT solve(Solvable * system, double * x, TrialState * ts,
+//  If provided, iters returns the number of iterations the solver took
+//  and stats accumulates the solver statistics
+int NEML_EXPORT solve(const Solvable * system, double * x, TrialState * ts,
           double tol = 1.0e-8, int miter = 50,
           bool verbose = false, bool relative = false,
-          double * R = nullptr, double * J = nullptr);
+          double * R = nullptr, double * J = nullptr,
+          int * iters = nullptr, SolverStats * stats = nullptr);
 
 /// Default solver: plain NR
-int NEML_EXPORT newton(Solvable * system, double * x, TrialState * ts,
+int NEML_EXPORT newton(const Solvable * system, double * x, TrialState * ts,
+          double tol, int miter, bool verbose, bool relative,
+          double * R, double * J, int * iters = nullptr,
+          SolverStats * stats = nullptr);
+
+/// Factored jacobian and step history kept by the Broyden solver
+//  Passing the same workspace to consecutive solves of similar systems,
+//  for example the substeps of one update, reuses the factors of the last
+//  jacobian for as long as the iterations keep contracting.
+class NEML_EXPORT BroydenWorkspace {
+ public:
+  /// Parameters: maximum number of rank one updates before refactoring
+  //  and the largest ratio of successive residual norms accepted before
+  //  refreshing the jacobian
+  BroydenWorkspace(int nmax = 10, double theta = 0.1);
+
+  /// Forget the factors, the next solve starts with a fresh jacobian
+  void reset();
+
+  /// Whether there are factors to reuse
+  bool valid() const;
+  /// Number of jacobians factored so far
+  size_t factorizations() const;
+
+ private:
+  friend int broyden(const Solvable * system, double * x, TrialState * ts,
+                     double tol, int miter, bool verbose, bool relative,
+                     double * R, double * J, int * iters,
+                     BroydenWorkspace * work, SolverStats * stats);
+
+  void resize_(size_t n);
+
+  int nmax_;
+  double theta_;
+  size_t n_;
+  bool valid_;
+  size_t factorizations_;
+  std::vector<double> LU_;
+  std::vector<int> ipiv_;
+  std::vector<double> steps_;
+  std::vector<double> norms_;
+};
+
+/// Modified Newton with Broyden updates
+//  Reuses the LU factors of an analytic jacobian, correcting the steps
+//  with rank one ("good") Broyden updates applied in product form, and
+//  only rebuilds and refactors the jacobian when the residual stops
+//  contracting quickly or the update history is full.  If J is provided
+//  it returns the analytic jacobian at the solution, as in newton.
+int NEML_EXPORT broyden(const Solvable * system, double * x, TrialState * ts,
           double tol, int miter, bool verbose, bool relative,
-          double * R, double * J);
+          double * R, double * J, int * iters = nullptr,
+          BroydenWorkspace * work = nullptr, SolverStats * stats = nullptr);
+
+/// Nonlinear solver used by a model
+enum NonlinearSolver {
+  NONLINEAR_NEWTON  = 0,  // newton, with the Solvable linear_solve
+  NONLINEAR_BROYDEN = 1   // broyden, with its own LU factors
+};
+
+/// Convert a solver name ("newton" or "broyden") to the enum
+NEML_EXPORT NonlinearSolver parse_nonlinear_solver(const std::string & name);
 
 #ifdef SOLVER_NOX
 /// NOX object-oriented interface
 class NEML_EXPORT NOXSolver: public NOX::LAPACK::Interface {
  public:
   /// Setup with the solvable object and the trial state
-  NOXSolver(Solvable * system, TrialState * ts);
+  NOXSolver(const Solvable * system, TrialState * ts);
 
   /// Get a NOX initial guess
   const NOX::LAPACK::Vector& getInitialGuess();
@@ -63,21 +197,21 @@ class NEML_EXPORT NOXSolver: public NOX::LAPACK::Interface {
 
  private:
   NOX::LAPACK::Vector nox_guess_;
-  Solvable * system_;
+  const Solvable * system_;
   TrialState * ts_;
 };
 
 /// Interface to nox
-int NEML_EXPORT nox(Solvable * system, double * x, TrialState * ts,
+int NEML_EXPORT nox(const Solvable * system, double * x, TrialState * ts,
         double tol, int miter, bool verbose, double * R, double * J);
 
 #endif
 
 /// Helper to get numerical jacobian
-int NEML_EXPORT diff_jac(Solvable * system, const double * const x, TrialState * ts,
+int NEML_EXPORT diff_jac(const Solvable * system, const double * const x, TrialState * ts,
              double * const nJ, double eps = 1.0e-9);
 /// Helper to get checksum
-double NEML_EXPORT diff_jac_check(Solvable * system, const double * const x, TrialState * ts,
+double NEML_EXPORT diff_jac_check(const Solvable * system, const double * const x, TrialState * ts,
                       const double * const J);
 
 } // namespace neml
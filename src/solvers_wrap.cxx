@@ -17,6 +17,21 @@ PYBIND11_MODULE(solvers, m) {
       .def(py::init<>())
       ;
 
+  py::class_<SolverStats>(m, "SolverStats")
+      .def(py::init<>())
+      .def("merge", &SolverStats::merge, "Add in another set of statistics.")
+      .def_property_readonly("total_failures", &SolverStats::total_failures, "Total number of failed solves.")
+      .def_readonly("solves", &SolverStats::solves, "Number of nonlinear solves.")
+      .def_readonly("iterations", &SolverStats::iterations, "Total number of solver iterations.")
+      .def_readonly("rj_calls", &SolverStats::rj_calls, "Calls to the residual and jacobian.")
+      .def_readonly("r_calls", &SolverStats::r_calls, "Calls to the residual alone.")
+      .def_readonly("linear_solves", &SolverStats::linear_solves, "Solves of the linearized system.")
+      .def_readonly("substep_divisions", &SolverStats::substep_divisions, "Step cuts after failed solves.")
+      .def_readonly("failures", &SolverStats::failures, "Failed solves, by error code.")
+      .def_readonly("rj_time", &SolverStats::rj_time, "Wall time in RJ and R (s).")
+      .def_readonly("linear_time", &SolverStats::linear_time, "Wall time in the linear solves (s).")
+      ;
+
   py::class_<Solvable, std::shared_ptr<Solvable>>(m, "Solvable")
       .def_property_readonly("nparams", &Solvable::nparams, "Number of variables in nonlinear equations.")
       .def("init_x",
@@ -38,21 +53,80 @@ PYBIND11_MODULE(solvers, m) {
 
             return std::make_tuple(R, J);
            }, "Residual and jacobian.")
+      .def("R",
+           [](Solvable & m, py::array_t<double, py::array::c_style> x, TrialState & ts) -> py::array_t<double>
+           {
+            auto R = alloc_vec<double>(m.nparams());
+            
+            int ier = m.R(arr2ptr<double>(x), &ts, arr2ptr<double>(R));
+            py_error(ier);
+
+            return R;
+           }, "Residual alone.")
+      .def("linear_solve",
+           [](Solvable & m, py::array_t<double, py::array::c_style> J, py::array_t<double, py::array::c_style> R) -> py::array_t<double>
+           {
+            auto x = alloc_vec<double>(m.nparams());
+            std::copy(arr2ptr<double>(R), arr2ptr<double>(R) + m.nparams(), arr2ptr<double>(x));
+
+            int ier = m.linear_solve(arr2ptr<double>(J), arr2ptr<double>(x));
+            py_error(ier);
+
+            return x;
+           }, "Solve the Newton linear system.")
       ;
 
   m.def("solve",
-        [](std::shared_ptr<Solvable> system, TrialState & ts, double tol, int miter, bool verbose) -> py::array_t<double>
+        [](std::shared_ptr<Solvable> system, TrialState & ts, double tol, int miter, bool verbose, bool return_iterations) -> py::object
         {
           auto x = alloc_vec<double>(system->nparams());
+          int iters;
           
-          int ier = solve(system.get(), arr2ptr<double>(x), &ts, tol, miter, verbose);
+          int ier = solve(system.get(), arr2ptr<double>(x), &ts, tol, miter,
+                          verbose, false, nullptr, nullptr, &iters);
           py_error(ier);
 
+          if (return_iterations) {
+            return py::make_tuple(x, iters);
+          }
           return x;
         }, "Solve a nonlinear system", 
         py::arg("solvable"), py::arg("trial_state"), py::arg("tol") = 1.0e-8,
         py::arg("miter") = 50,
-        py::arg("verbose") = false);
+        py::arg("verbose") = false,
+        py::arg("return_iterations") = false);
+
+  py::class_<BroydenWorkspace>(m, "BroydenWorkspace")
+      .def(py::init<int, double>(), py::arg("nmax") = 10,
+           py::arg("theta") = 0.1)
+      .def("reset", &BroydenWorkspace::reset, "Forget the jacobian factors.")
+      .def_property_readonly("valid", &BroydenWorkspace::valid,
+                             "Whether there are factors to reuse.")
+      .def_property_readonly("factorizations",
+                             &BroydenWorkspace::factorizations,
+                             "Number of jacobians factored so far.")
+      ;
+
+  m.def("broyden",
+        [](std::shared_ptr<Solvable> system, TrialState & ts, double tol, int miter, bool verbose, bool return_iterations, BroydenWorkspace * work) -> py::object
+        {
+          auto x = alloc_vec<double>(system->nparams());
+          int iters;
+          
+          int ier = broyden(system.get(), arr2ptr<double>(x), &ts, tol, miter,
+                            verbose, false, nullptr, nullptr, &iters, work);
+          py_error(ier);
+
+          if (return_iterations) {
+            return py::make_tuple(x, iters);
+          }
+          return x;
+        }, "Solve a nonlinear system with Broyden updates of a reused jacobian", 
+        py::arg("solvable"), py::arg("trial_state"), py::arg("tol") = 1.0e-8,
+        py::arg("miter") = 50,
+        py::arg("verbose") = false,
+        py::arg("return_iterations") = false,
+        py::arg("work") = nullptr);
 }
 
 } // namespace neml
@@ -5,6 +5,7 @@
 #include <stdarg.h>
 #include <memory>
 #include <algorithm>
+#include <stdexcept>
 #include <string>
 
 #include "windows.h"
@@ -55,6 +56,9 @@ class NEML_EXPORT YieldSurface: public NEMLObject {
 };
 
 /// Helper to reduce a isotropic + kinematic function to isotropic only
+//  The base surface takes the isotropic variable followed by the
+//  6 backstress components.  The expanded history and the base
+//  derivatives are fixed size, so they live on the stack.
 template<class BT, typename... Args>
 class NEML_EXPORT IsoFunction: public YieldSurface {
  public:
@@ -62,7 +66,10 @@ class NEML_EXPORT IsoFunction: public YieldSurface {
   IsoFunction(Args... args) :
       base_(new BT(args...))
   {
-
+    if (base_->nhist() != nbase) {
+      throw std::logic_error("IsoFunction needs an isotropic + kinematic"
+                             " base surface");
+    }
   }
 
   /// Also interfaces with a single isotropic hardening variable
@@ -75,32 +82,29 @@ class NEML_EXPORT IsoFunction: public YieldSurface {
   virtual int f(const double* const s, const double* const q, double T,
                 double & fv) const
   {
-    double * qn = expand_hist_(q);
-    int ier = base_->f(s, qn, T, fv);
-    delete [] qn;
-    return ier;
+    double qn[nbase];
+    expand_hist_(q, qn);
+    return base_->f(s, qn, T, fv);
   }
 
   /// Call with zero kinematic hardening
   virtual int df_ds(const double* const s, const double* const q, double T,
                 double * const df) const
   {
-    double * qn = expand_hist_(q);
-    int ier = base_->df_ds(s, qn, T, df);
-    delete [] qn;
-    return ier;
+    double qn[nbase];
+    expand_hist_(q, qn);
+    return base_->df_ds(s, qn, T, df);
   }
 
   /// Call with zero kinematic hardening
   virtual int df_dq(const double* const s, const double* const q, double T,
                 double * const df) const
   {
-    double * qn = expand_hist_(q);
-    double * dfn = new double[base_->nhist()];
+    double qn[nbase];
+    expand_hist_(q, qn);
+    double dfn[nbase];
     int ier = base_->df_dq(s, qn, T, dfn);
     df[0] = dfn[0];
-    delete [] qn;
-    delete [] dfn;
     return ier;
   }
 
@@ -108,22 +112,20 @@ class NEML_EXPORT IsoFunction: public YieldSurface {
   virtual int df_dsds(const double* const s, const double* const q, double T,
                 double * const ddf) const
   {
-    double * qn = expand_hist_(q);
-    int ier = base_->df_dsds(s, qn, T, ddf);
-    delete [] qn;
-    return ier;
+    double qn[nbase];
+    expand_hist_(q, qn);
+    return base_->df_dsds(s, qn, T, ddf);
   }
 
   /// Call with zero kinematic hardening
   virtual int df_dqdq(const double* const s, const double* const q, double T,
                 double * const ddf) const
   {
-    double * qn = expand_hist_(q);
-    double * ddfn = new double[(base_->nhist())*(base_->nhist())];
+    double qn[nbase];
+    expand_hist_(q, qn);
+    double ddfn[nbase*nbase];
     int ier = base_->df_dqdq(s, qn, T, ddfn);
     ddf[0] = ddfn[0];
-    delete [] qn;
-    delete [] ddfn;
     return ier;
   }
 
@@ -132,14 +134,13 @@ class NEML_EXPORT IsoFunction: public YieldSurface {
                 double * const ddf) const
   {
     // This one is annoying
-    double * qn = expand_hist_(q);
-    double * ddfn = new double[6*(base_->nhist())];
+    double qn[nbase];
+    expand_hist_(q, qn);
+    double ddfn[6*nbase];
     int ier = base_->df_dsdq(s, qn, T, ddfn);
     for (int i=0; i<6; i++) {
-      ddf[i] = ddfn[CINDEX(i,0,base_->nhist())];
+      ddf[i] = ddfn[CINDEX(i,0,nbase)];
     }
-    delete [] qn;
-    delete [] ddfn;
     return ier;
   }
 
@@ -147,25 +148,25 @@ class NEML_EXPORT IsoFunction: public YieldSurface {
   virtual int df_dqds(const double* const s, const double* const q, double T,
                 double * const ddf) const
   {
-    double * qn = expand_hist_(q);
-    double * ddfn = new double[(base_->nhist())*6];
+    double qn[nbase];
+    expand_hist_(q, qn);
+    double ddfn[nbase*6];
     int ier = base_->df_dqds(s, qn, T, ddfn);
     std::copy(ddfn,ddfn+6,ddf);
-    delete [] qn;
-    delete [] ddfn;
     return ier;
   }
 
  private:
-  double * expand_hist_(const double* const q) const
+  void expand_hist_(const double* const q, double * const qn) const
   {
-    double * qn = new double[7];
     qn[0] = q[0];
-    std::fill(qn+1,qn+7,0.0);
-    return qn;
+    std::fill(qn+1,qn+nbase,0.0);
   }
 
  private:
+  /// Number of history variables in the base surface
+  static const size_t nbase = 7;
+
   std::unique_ptr<BT> base_;
 
 };
@@ -0,0 +1,185 @@
+#include "trace.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace neml {
+
+namespace detail {
+std::atomic<bool> trace_running(false);
+}
+
+namespace {
+
+typedef std::chrono::steady_clock trace_clock;
+
+/// One complete ("X") event
+struct TraceEvent {
+  const char * name;
+  trace_clock::time_point start;
+  trace_clock::time_point end;
+};
+
+/// The timeline of a single thread
+struct ThreadTrace {
+  size_t tid;
+  std::vector<TraceEvent> events;
+};
+
+/// Owns every thread's timeline, so events outlive pool threads
+struct TraceRegistry {
+  std::mutex lock;
+  std::vector<std::unique_ptr<ThreadTrace>> threads;
+  trace_clock::time_point origin = trace_clock::now();
+};
+
+TraceRegistry & registry()
+{
+  // Never destroyed, so threads can still record during shutdown
+  static TraceRegistry * reg = new TraceRegistry();
+  return *reg;
+}
+
+ThreadTrace & thread_trace()
+{
+  thread_local ThreadTrace * mine = nullptr;
+  if (mine == nullptr) {
+    TraceRegistry & reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    reg.threads.emplace_back(new ThreadTrace());
+    mine = reg.threads.back().get();
+    mine->tid = reg.threads.size() - 1;
+  }
+  return *mine;
+}
+
+double since_origin_us(trace_clock::time_point t)
+{
+  return std::chrono::duration<double, std::micro>(
+      t - registry().origin).count();
+}
+
+/// Escape a marker name for JSON
+std::string escape(const char * name)
+{
+  std::string res;
+  for (const char * c = name; *c != '\0'; c++) {
+    if ((*c == '"') || (*c == '\\')) res += '\\';
+    res += *c;
+  }
+  return res;
+}
+
+#ifdef NEML_TRACING
+/// Setting NEML_TRACE=file traces the whole run into that file
+struct EnvironmentTrace {
+  EnvironmentTrace()
+  {
+    const char * fname = std::getenv("NEML_TRACE");
+    if ((fname == nullptr) || (*fname == '\0')) return;
+    registry();
+    start_tracing();
+    std::atexit(&EnvironmentTrace::finish);
+  }
+
+  static void finish()
+  {
+    stop_tracing();
+    try {
+      write_trace(std::getenv("NEML_TRACE"));
+    }
+    catch (...) {
+    }
+  }
+};
+
+EnvironmentTrace environment_trace;
+#endif
+
+} // namespace
+
+void detail::record_trace_event(const char * name,
+                                trace_clock::time_point start,
+                                trace_clock::time_point end)
+{
+  thread_trace().events.push_back({name, start, end});
+}
+
+bool tracing_compiled()
+{
+#ifdef NEML_TRACING
+  return true;
+#else
+  return false;
+#endif
+}
+
+void start_tracing()
+{
+  registry();
+  detail::trace_running = true;
+}
+
+void stop_tracing()
+{
+  detail::trace_running = false;
+}
+
+bool tracing()
+{
+  return detail::trace_running;
+}
+
+void clear_trace()
+{
+  TraceRegistry & reg = registry();
+  std::lock_guard<std::mutex> guard(reg.lock);
+  for (auto & t : reg.threads) t->events.clear();
+}
+
+size_t trace_events()
+{
+  TraceRegistry & reg = registry();
+  std::lock_guard<std::mutex> guard(reg.lock);
+  size_t n = 0;
+  for (auto & t : reg.threads) n += t->events.size();
+  return n;
+}
+
+void write_trace(const std::string & fname)
+{
+  std::ofstream out(fname);
+  if (not out) {
+    throw std::runtime_error("Could not open trace file " + fname);
+  }
+
+  TraceRegistry & reg = registry();
+  std::lock_guard<std::mutex> guard(reg.lock);
+
+  // Timestamps are in microseconds
+  out << std::fixed << std::setprecision(3);
+  out << "{\"traceEvents\":[";
+  bool first = true;
+  for (auto & t : reg.threads) {
+    if (t->events.empty()) continue;
+    if (not first) out << ",";
+    first = false;
+    out << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":"
+        << t->tid << ",\"args\":{\"name\":\"thread " << t->tid << "\"}}";
+    for (auto & e : t->events) {
+      out << ",\n{\"name\":\"" << escape(e.name)
+          << "\",\"cat\":\"neml\",\"ph\":\"X\",\"pid\":0,\"tid\":" << t->tid
+          << ",\"ts\":" << since_origin_us(e.start)
+          << ",\"dur\":" << since_origin_us(e.end) - since_origin_us(e.start)
+          << "}";
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+} // namespace neml
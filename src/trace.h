@@ -0,0 +1,85 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "windows.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+/// Scoped timeline markers, compiled in only with -DNEML_TRACING
+//  NEML_TRACE_SCOPE("name") records the time from the marker to the end of
+//  the enclosing scope on the calling thread's timeline, while tracing is
+//  running.  Without NEML_TRACING the marker expands to nothing.  The name
+//  must be a string literal.
+#ifdef NEML_TRACING
+#define NEML_TRACE_CONCAT_(a, b) a##b
+#define NEML_TRACE_NAME_(line) NEML_TRACE_CONCAT_(neml_trace_scope_, line)
+#define NEML_TRACE_SCOPE(name) \
+  neml::TraceScope NEML_TRACE_NAME_(__LINE__)(name)
+#else
+#define NEML_TRACE_SCOPE(name)
+#endif
+
+namespace neml {
+
+/// Whether the library was built with the trace markers
+NEML_EXPORT bool tracing_compiled();
+
+/// Start recording the markers, keeping anything already recorded
+NEML_EXPORT void start_tracing();
+/// Stop recording the markers
+NEML_EXPORT void stop_tracing();
+/// Whether the markers are being recorded
+NEML_EXPORT bool tracing();
+/// Discard the recorded events
+//  Should not be called while traced code is running on other threads
+NEML_EXPORT void clear_trace();
+/// Total number of recorded events, over all threads
+NEML_EXPORT size_t trace_events();
+
+/// Write the recorded events as Chrome trace JSON
+//  Each thread that recorded events gets its own timeline.  The file loads
+//  in chrome://tracing and in the Perfetto UI.  Like clear_trace, it should
+//  not be called while traced code is running.
+NEML_EXPORT void write_trace(const std::string & fname);
+
+namespace detail {
+/// Set while recording, so an idle marker costs one relaxed load
+NEML_EXPORT extern std::atomic<bool> trace_running;
+/// Add a complete event to the calling thread's timeline
+NEML_EXPORT void record_trace_event(const char * name,
+                                    std::chrono::steady_clock::time_point start,
+                                    std::chrono::steady_clock::time_point end);
+}
+
+/// Records one event covering its own lifetime
+class TraceScope {
+ public:
+  explicit TraceScope(const char * name) :
+      name_(name),
+      active_(detail::trace_running.load(std::memory_order_relaxed))
+  {
+    if (active_) start_ = std::chrono::steady_clock::now();
+  }
+
+  ~TraceScope()
+  {
+    if (active_) {
+      detail::record_trace_event(name_, start_,
+                                 std::chrono::steady_clock::now());
+    }
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope & operator=(const TraceScope &) = delete;
+
+ private:
+  const char * name_;
+  bool active_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace neml
+
+#endif // TRACE_H
@@ -2,6 +2,7 @@
 
 #include "math/nemlmath.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -107,6 +108,115 @@ int ViscoPlasticFlowRule::dh_da_temp(const double * const s,
   return 0;
 }
 
+size_t ViscoPlasticFlowRule::nwork() const
+{
+  size_t nh = nhist();
+  return 2 * nh + std::max(6 * nh, nh * nh);
+}
+
+// Default fused evaluation, from the individual methods
+int ViscoPlasticFlowRule::evaluate(const double * const s,
+                                   const double * const alpha,
+                                   double T, double Tdot,
+                                   double * const erate,
+                                   double * const d_erate_ds,
+                                   double * const d_erate_da,
+                                   double * const adot,
+                                   double * const d_adot_ds,
+                                   double * const d_adot_da,
+                                   double * const work) const
+{
+  size_t nh = nhist();
+  double * hv = work;
+  double * dyda = &work[nh];
+  double * t = &work[2*nh];
+
+  double yv;
+  int ier = y(s, alpha, T, yv);
+  if (ier != SUCCESS) return ier;
+  double gv[6];
+  ier = g(s, alpha, T, gv);
+  if (ier != SUCCESS) return ier;
+  double dyds[6];
+  ier = dy_ds(s, alpha, T, dyds);
+  if (ier != SUCCESS) return ier;
+  ier = h(s, alpha, T, hv);
+  if (ier != SUCCESS) return ier;
+  ier = dy_da(s, alpha, T, dyda);
+  if (ier != SUCCESS) return ier;
+
+  // Inelastic strain rate
+  double temp[36];
+  for (int i=0; i<6; i++) erate[i] = yv * gv[i];
+  ier = g_temp(s, alpha, T, temp);
+  if (ier != SUCCESS) return ier;
+  for (int i=0; i<6; i++) erate[i] += Tdot * temp[i];
+  ier = g_time(s, alpha, T, temp);
+  if (ier != SUCCESS) return ier;
+  for (int i=0; i<6; i++) erate[i] += temp[i];
+
+  // Inelastic strain rate wrt stress
+  ier = dg_ds(s, alpha, T, d_erate_ds);
+  if (ier != SUCCESS) return ier;
+  for (int i=0; i<36; i++) d_erate_ds[i] *= yv;
+  outer_update(gv, 6, dyds, 6, d_erate_ds);
+  ier = dg_ds_temp(s, alpha, T, temp);
+  if (ier != SUCCESS) return ier;
+  for (int i=0; i<36; i++) d_erate_ds[i] += Tdot * temp[i];
+  ier = dg_ds_time(s, alpha, T, temp);
+  if (ier != SUCCESS) return ier;
+  for (int i=0; i<36; i++) d_erate_ds[i] += temp[i];
+
+  // Inelastic strain rate wrt history
+  size_t sz = 6 * nh;
+  ier = dg_da(s, alpha, T, d_erate_da);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<sz; i++) d_erate_da[i] *= yv;
+  outer_update(gv, 6, dyda, nh, d_erate_da);
+  ier = dg_da_temp(s, alpha, T, t);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<sz; i++) d_erate_da[i] += Tdot * t[i];
+  ier = dg_da_time(s, alpha, T, t);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<sz; i++) d_erate_da[i] += t[i];
+
+  // History rate
+  for (size_t i=0; i<nh; i++) adot[i] = yv * hv[i];
+  ier = h_temp(s, alpha, T, t);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<nh; i++) adot[i] += Tdot * t[i];
+  ier = h_time(s, alpha, T, t);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<nh; i++) adot[i] += t[i];
+
+  // History rate wrt stress
+  ier = dh_ds(s, alpha, T, d_adot_ds);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<sz; i++) d_adot_ds[i] *= yv;
+  outer_update(hv, nh, dyds, 6, d_adot_ds);
+  ier = dh_ds_temp(s, alpha, T, t);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<sz; i++) d_adot_ds[i] += Tdot * t[i];
+  ier = dh_ds_time(s, alpha, T, t);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<sz; i++) d_adot_ds[i] += t[i];
+
+  // History rate wrt history
+  sz = nh * nh;
+  ier = dh_da(s, alpha, T, d_adot_da);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<sz; i++) d_adot_da[i] *= yv;
+  outer_update(hv, nh, dyda, nh, d_adot_da);
+  ier = dh_da_temp(s, alpha, T, t);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<sz; i++) d_adot_da[i] += Tdot * t[i];
+  ier = dh_da_time(s, alpha, T, t);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<sz; i++) d_adot_da[i] += t[i];
+
+  return 0;
+}
+
 // Various g(s) implementations
 GPowerLaw::GPowerLaw(std::shared_ptr<Interpolate> n, 
                      std::shared_ptr<Interpolate> eta) :
@@ -381,6 +491,97 @@ int PerzynaFlowRule::dh_da(const double * const s, const double * const alpha, d
   return mat_mat(nhist(), nhist(), nhist(), dd, jac, dhv);
 }
 
+size_t PerzynaFlowRule::nwork() const
+{
+  size_t nh = nhist();
+  return 3 * nh + nh * nh + std::max(6 * nh, nh * nh);
+}
+
+// All the rates from one evaluation of the hardening and the surface
+int PerzynaFlowRule::evaluate(const double * const s,
+                              const double * const alpha,
+                              double T, double Tdot,
+                              double * const erate,
+                              double * const d_erate_ds,
+                              double * const d_erate_da,
+                              double * const adot,
+                              double * const d_adot_ds,
+                              double * const d_adot_da,
+                              double * const work) const
+{
+  size_t nh = nhist();
+  double * q = work;
+  double * jac = &work[nh];
+  double * hv = &work[nh + nh*nh];
+  double * dyda = &work[2*nh + nh*nh];
+  double * dd = &work[3*nh + nh*nh];
+
+  int ier = hardening_->q(alpha, T, q);
+  if (ier != SUCCESS) return ier;
+
+  double fv;
+  ier = surface_->f(s, q, T, fv);
+  if (ier != SUCCESS) return ier;
+
+  // Inside the surface there is no flow and the model has no time or
+  // temperature rate terms
+  if (fv <= 0.0) {
+    std::fill(erate, erate+6, 0.0);
+    std::fill(d_erate_ds, d_erate_ds+36, 0.0);
+    std::fill(d_erate_da, d_erate_da+6*nh, 0.0);
+    std::fill(adot, adot+nh, 0.0);
+    std::fill(d_adot_ds, d_adot_ds+nh*6, 0.0);
+    std::fill(d_adot_da, d_adot_da+nh*nh, 0.0);
+    return 0;
+  }
+
+  double yv = g_->g(fabs(fv), T);
+  double dgv = g_->dg(fabs(fv), T);
+
+  double gv[6];
+  ier = surface_->df_ds(s, q, T, gv);
+  if (ier != SUCCESS) return ier;
+  ier = surface_->df_dq(s, q, T, hv);
+  if (ier != SUCCESS) return ier;
+  ier = hardening_->dq_da(alpha, T, jac);
+  if (ier != SUCCESS) return ier;
+
+  // Scalar rate partials
+  double dyds[6];
+  for (int i=0; i<6; i++) dyds[i] = dgv * gv[i];
+  ier = mat_vec_trans(jac, nh, hv, nh, dyda);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<nh; i++) dyda[i] *= dgv;
+
+  // Inelastic strain rate and partials
+  for (int i=0; i<6; i++) erate[i] = yv * gv[i];
+  ier = surface_->df_dsds(s, q, T, d_erate_ds);
+  if (ier != SUCCESS) return ier;
+  for (int i=0; i<36; i++) d_erate_ds[i] *= yv;
+  outer_update(gv, 6, dyds, 6, d_erate_ds);
+  ier = surface_->df_dsdq(s, q, T, dd);
+  if (ier != SUCCESS) return ier;
+  ier = mat_mat(6, nh, nh, dd, jac, d_erate_da);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<6*nh; i++) d_erate_da[i] *= yv;
+  outer_update(gv, 6, dyda, nh, d_erate_da);
+
+  // History rate and partials
+  for (size_t i=0; i<nh; i++) adot[i] = yv * hv[i];
+  ier = surface_->df_dqds(s, q, T, d_adot_ds);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<nh*6; i++) d_adot_ds[i] *= yv;
+  outer_update(hv, nh, dyds, 6, d_adot_ds);
+  ier = surface_->df_dqdq(s, q, T, dd);
+  if (ier != SUCCESS) return ier;
+  ier = mat_mat(nh, nh, nh, dd, jac, d_adot_da);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<nh*nh; i++) d_adot_da[i] *= yv;
+  outer_update(hv, nh, dyda, nh, d_adot_da);
+
+  return 0;
+}
+
 // Begin Chaboche
 ConstantFluidity::ConstantFluidity(std::shared_ptr<Interpolate> eta) :
     eta_(eta)
@@ -712,6 +913,129 @@ int ChabocheFlowRule::dh_da_temp(const double * const s, const double * const al
   return hardening_->dh_da_temp(s, alpha, T, dhv);
 }
 
+size_t ChabocheFlowRule::nwork() const
+{
+  size_t nh = nhist();
+  size_t ni = hardening_->ninter();
+  return 2 * ni + ni * nh + 2 * nh
+      + std::max(6 * ni, std::max(6 * nh, nh * nh));
+}
+
+// All the rates from one evaluation of the surface, with the hardening
+// model's own rates
+int ChabocheFlowRule::evaluate(const double * const s,
+                               const double * const alpha,
+                               double T, double Tdot,
+                               double * const erate,
+                               double * const d_erate_ds,
+                               double * const d_erate_da,
+                               double * const adot,
+                               double * const d_adot_ds,
+                               double * const d_adot_da,
+                               double * const work) const
+{
+  size_t nh = nhist();
+  size_t ni = hardening_->ninter();
+  double * q = work;
+  double * dq = &work[ni];
+  double * jac = &work[2*ni];
+  double * hv = &work[2*ni + ni*nh];
+  double * dyda = &work[2*ni + ni*nh + nh];
+  double * dd = &work[2*ni + ni*nh + 2*nh];
+
+  int ier = hardening_->q(alpha, T, q);
+  if (ier != SUCCESS) return ier;
+
+  double fv;
+  ier = surface_->f(s, q, T, fv);
+  if (ier != SUCCESS) return ier;
+
+  if (fv > 0.0) {
+    double eta = sqrt(2.0/3.0) * fluidity_->eta(alpha[0], T);
+    double nv = n_->value(T);
+    double yv = sqrt(3.0/2.0) * pow(fv/eta, nv);
+    double mv = sqrt(3.0/2.0) * pow(fv/eta, nv - 1.0) * nv / eta;
+
+    double gv[6];
+    ier = surface_->df_ds(s, q, T, gv);
+    if (ier != SUCCESS) return ier;
+    ier = surface_->df_dq(s, q, T, dq);
+    if (ier != SUCCESS) return ier;
+    ier = hardening_->dq_da(alpha, T, jac);
+    if (ier != SUCCESS) return ier;
+
+    // Scalar rate partials
+    double dyds[6];
+    for (int i=0; i<6; i++) dyds[i] = mv * gv[i];
+    ier = mat_vec_trans(jac, nh, dq, ni, dyda);
+    if (ier != SUCCESS) return ier;
+    for (size_t i=0; i<nh; i++) dyda[i] *= mv;
+    double mv2 = -sqrt(3.0/2.0) * fv * pow(fv/eta, nv - 1.0) * nv / (eta * eta);
+    double deta = sqrt(2.0/3.0) * fluidity_->deta(alpha[0], T);
+    dyda[0] += deta * mv2;
+
+    // Inelastic strain rate and partials
+    for (int i=0; i<6; i++) erate[i] = yv * gv[i];
+    ier = surface_->df_dsds(s, q, T, d_erate_ds);
+    if (ier != SUCCESS) return ier;
+    for (int i=0; i<36; i++) d_erate_ds[i] *= yv;
+    outer_update(gv, 6, dyds, 6, d_erate_ds);
+    ier = surface_->df_dsdq(s, q, T, dd);
+    if (ier != SUCCESS) return ier;
+    ier = mat_mat(6, nh, ni, dd, jac, d_erate_da);
+    if (ier != SUCCESS) return ier;
+    for (size_t i=0; i<6*nh; i++) d_erate_da[i] *= yv;
+    outer_update(gv, 6, dyda, nh, d_erate_da);
+
+    // History rate and partials proportional to the flow
+    ier = hardening_->h(s, alpha, T, hv);
+    if (ier != SUCCESS) return ier;
+    for (size_t i=0; i<nh; i++) adot[i] = yv * hv[i];
+    ier = hardening_->dh_ds(s, alpha, T, d_adot_ds);
+    if (ier != SUCCESS) return ier;
+    for (size_t i=0; i<nh*6; i++) d_adot_ds[i] *= yv;
+    outer_update(hv, nh, dyds, 6, d_adot_ds);
+    ier = hardening_->dh_da(s, alpha, T, d_adot_da);
+    if (ier != SUCCESS) return ier;
+    for (size_t i=0; i<nh*nh; i++) d_adot_da[i] *= yv;
+    outer_update(hv, nh, dyda, nh, d_adot_da);
+  }
+  else {
+    std::fill(erate, erate+6, 0.0);
+    std::fill(d_erate_ds, d_erate_ds+36, 0.0);
+    std::fill(d_erate_da, d_erate_da+6*nh, 0.0);
+    std::fill(adot, adot+nh, 0.0);
+    std::fill(d_adot_ds, d_adot_ds+nh*6, 0.0);
+    std::fill(d_adot_da, d_adot_da+nh*nh, 0.0);
+  }
+
+  // Temperature rate terms, which drop out of isothermal steps
+  if (Tdot != 0.0) {
+    ier = hardening_->h_temp(s, alpha, T, dd);
+    if (ier != SUCCESS) return ier;
+    for (size_t i=0; i<nh; i++) adot[i] += Tdot * dd[i];
+    ier = hardening_->dh_ds_temp(s, alpha, T, dd);
+    if (ier != SUCCESS) return ier;
+    for (size_t i=0; i<nh*6; i++) d_adot_ds[i] += Tdot * dd[i];
+    ier = hardening_->dh_da_temp(s, alpha, T, dd);
+    if (ier != SUCCESS) return ier;
+    for (size_t i=0; i<nh*nh; i++) d_adot_da[i] += Tdot * dd[i];
+  }
+
+  // Static recovery acts even without flow
+  ier = hardening_->h_time(s, alpha, T, dd);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<nh; i++) adot[i] += dd[i];
+  ier = hardening_->dh_ds_time(s, alpha, T, dd);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<nh*6; i++) d_adot_ds[i] += dd[i];
+  ier = hardening_->dh_da_time(s, alpha, T, dd);
+  if (ier != SUCCESS) return ier;
+  for (size_t i=0; i<nh*nh; i++) d_adot_da[i] += dd[i];
+
+  return 0;
+}
+
 YaguchiGr91FlowRule::YaguchiGr91FlowRule()
 {
 
@@ -91,6 +91,22 @@ class NEML_EXPORT ViscoPlasticFlowRule: public NEMLObject {
   /// Derivative of h_temp wrt history
   virtual int dh_da_temp(const double * const s, const double * const alpha, double T,
                 double * const dhv) const;
+
+  /// Size of the scratch evaluate needs
+  virtual size_t nwork() const;
+
+  /// Inelastic strain rate, history rate and their partials in one call
+  //  The rates sum the parts proportional to the scalar inelastic strain
+  //  rate, the temperature rate and time.  The default calls the
+  //  individual methods; implementations can override it to share the
+  //  work common to all the terms.  work has room for nwork() doubles.
+  virtual int evaluate(const double * const s, const double * const alpha,
+                       double T, double Tdot,
+                       double * const erate, double * const d_erate_ds,
+                       double * const d_erate_da,
+                       double * const adot, double * const d_adot_ds,
+                       double * const d_adot_da,
+                       double * const work) const;
 };
 
 /// The "g" function in the Perzyna model -- often a power law
@@ -184,6 +200,17 @@ class NEML_EXPORT PerzynaFlowRule : public ViscoPlasticFlowRule {
   virtual int dh_da(const double * const s, const double * const alpha, double T,
                 double * const dhv) const;
 
+  /// Size of the scratch evaluate needs
+  virtual size_t nwork() const;
+  /// All the rates and partials from one hardening and surface evaluation
+  virtual int evaluate(const double * const s, const double * const alpha,
+                       double T, double Tdot,
+                       double * const erate, double * const d_erate_ds,
+                       double * const d_erate_da,
+                       double * const adot, double * const d_adot_ds,
+                       double * const d_adot_da,
+                       double * const work) const;
+
  private:
   std::shared_ptr<YieldSurface> surface_;
   std::shared_ptr<HardeningRule> hardening_;
@@ -331,6 +358,17 @@ class NEML_EXPORT ChabocheFlowRule: public ViscoPlasticFlowRule {
   virtual int dh_da_temp(const double * const s, const double * const alpha, double T,
                 double * const dhv) const;
 
+  /// Size of the scratch evaluate needs
+  virtual size_t nwork() const;
+  /// All the rates and partials from one hardening and surface evaluation
+  virtual int evaluate(const double * const s, const double * const alpha,
+                       double T, double Tdot,
+                       double * const erate, double * const d_erate_ds,
+                       double * const d_erate_da,
+                       double * const adot, double * const d_adot_ds,
+                       double * const d_adot_da,
+                       double * const work) const;
+
  private:
   std::shared_ptr<YieldSurface> surface_;
   std::shared_ptr<NonAssociativeHardening> hardening_;
@@ -199,6 +199,26 @@ PYBIND11_MODULE(visco_flow, m) {
             py_error(ier);
             return f;
            }, "Hardening rule (temperature) derivative with respect to history.")
+      .def("evaluate",
+           [](ViscoPlasticFlowRule & m, py::array_t<double, py::array::c_style> s, py::array_t<double, py::array::c_style> alpha, double T, double Tdot) -> py::tuple
+           {
+            auto erate = alloc_vec<double>(6);
+            auto d_erate_ds = alloc_mat<double>(6,6);
+            auto d_erate_da = alloc_mat<double>(6,m.nhist());
+            auto adot = alloc_vec<double>(m.nhist());
+            auto d_adot_ds = alloc_mat<double>(m.nhist(),6);
+            auto d_adot_da = alloc_mat<double>(m.nhist(),m.nhist());
+            std::vector<double> work(m.nwork());
+            int ier = m.evaluate(arr2ptr<double>(s), arr2ptr<double>(alpha),
+                          T, Tdot, arr2ptr<double>(erate),
+                          arr2ptr<double>(d_erate_ds),
+                          arr2ptr<double>(d_erate_da), arr2ptr<double>(adot),
+                          arr2ptr<double>(d_adot_ds),
+                          arr2ptr<double>(d_adot_da), work.data());
+            py_error(ier);
+            return py::make_tuple(erate, d_erate_ds, d_erate_da, adot,
+                                  d_adot_ds, d_adot_da);
+           }, "Inelastic strain rate, history rate, and their partials with respect to stress and history.")
 
       ;
 
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+
+from neml import models, elasticity, surfaces, hardening, visco_flow, general_flow
+
+import unittest
+import numpy as np
+
+class TestModelBatch(unittest.TestCase):
+  def setUp(self):
+    self.N = 50
+
+    E = 92000.0
+    nu = 0.3
+    self.elastic = elasticity.IsotropicLinearElasticModel(E, "youngs", 
+        nu, "poissons")
+
+    surface = surfaces.IsoKinJ2()
+    iso = hardening.VoceIsotropicHardeningRule(89.0, 165.0, 12.0)
+    gmodels = [hardening.ConstantGamma(g) for g in [0.9e3, 1.5e3, 1.0]]
+    hmodel = hardening.Chaboche(iso, [80.0e3, 14.02e3, 3.333e3], gmodels,
+        [0.0, 0.0, 0.0], [1.0, 1.0, 1.0])
+    fluidity = visco_flow.ConstantFluidity(108.0)
+    vmodel = visco_flow.ChabocheFlowRule(surface, hmodel, fluidity, 20.0)
+    flow = general_flow.TVPFlowRule(self.elastic, vmodel)
+
+    self.model = models.GeneralIntegrator(self.elastic, flow)
+
+    rng = np.random.default_rng(42)
+    self.e_np1 = rng.uniform(-0.002, 0.002, size = (self.N, 6))
+    self.e_n = np.zeros((self.N,6))
+    self.w_np1 = rng.uniform(-0.01, 0.01, size = (self.N, 3))
+    self.w_n = np.zeros((self.N,3))
+    self.T_np1 = np.full((self.N,), 300.0)
+    self.T_n = np.full((self.N,), 300.0)
+    self.t_np1 = 1.0
+    self.t_n = 0.0
+    self.s_n = np.zeros((self.N,6))
+    self.h_n = self.model.init_store_batch(self.N)
+    self.u_n = np.zeros((self.N,))
+    self.p_n = np.zeros((self.N,))
+
+  def test_init(self):
+    H = np.array([self.model.init_store() for i in range(self.N)])
+    self.assertTrue(np.allclose(self.model.init_store_batch(self.N), H))
+
+  def sd_reference(self):
+    return [self.model.update_sd(self.e_np1[i], self.e_n[i], self.T_np1[i],
+      self.T_n[i], self.t_np1, self.t_n, self.s_n[i], self.h_n[i], 
+      self.u_n[i], self.p_n[i]) for i in range(self.N)]
+
+  def check_sd(self, res, ref):
+    for i, rr in enumerate(ref):
+      for j in range(5):
+        self.assertTrue(np.allclose(res[j][i], rr[j]))
+
+  def test_sd(self):
+    res = self.model.update_sd_batch(self.e_np1, self.e_n, self.T_np1,
+        self.T_n, self.t_np1, self.t_n, self.s_n, self.h_n, self.u_n,
+        self.p_n)
+    self.check_sd(res, self.sd_reference())
+
+  def test_sd_threads(self):
+    res = self.model.update_sd_batch(self.e_np1, self.e_n, self.T_np1,
+        self.T_n, self.t_np1, self.t_n, self.s_n, self.h_n, self.u_n,
+        self.p_n, nthreads = 4)
+    self.check_sd(res, self.sd_reference())
+
+  def test_sd_out(self):
+    out = (np.zeros((self.N,6)), np.zeros((self.N,self.model.nstore)),
+        np.zeros((self.N,6,6)), np.zeros((self.N,)), np.zeros((self.N,)))
+    res = self.model.update_sd_batch(self.e_np1, self.e_n, self.T_np1,
+        self.T_n, self.t_np1, self.t_n, self.s_n, self.h_n, self.u_n,
+        self.p_n, nthreads = 2, out = out)
+    for a, b in zip(res, out):
+      self.assertIs(a, b)
+    self.check_sd(out, self.sd_reference())
+
+  def test_bad_out(self):
+    out = (np.zeros((self.N,6), dtype = np.float32), 
+        np.zeros((self.N,self.model.nstore)), np.zeros((self.N,6,6)), 
+        np.zeros((self.N,)), np.zeros((self.N,)))
+    with self.assertRaises(RuntimeError):
+      self.model.update_sd_batch(self.e_np1, self.e_n, self.T_np1,
+          self.T_n, self.t_np1, self.t_n, self.s_n, self.h_n, self.u_n,
+          self.p_n, out = out)
+
+    out = (np.zeros((self.N,6)), np.zeros((self.N,self.model.nstore)),
+        np.zeros((self.N,6,6)), np.zeros((self.N-1,)), np.zeros((self.N,)))
+    with self.assertRaises(RuntimeError):
+      self.model.update_sd_batch(self.e_np1, self.e_n, self.T_np1,
+          self.T_n, self.t_np1, self.t_n, self.s_n, self.h_n, self.u_n,
+          self.p_n, out = out)
+
+  def test_bad_input(self):
+    with self.assertRaises(RuntimeError):
+      self.model.update_sd_batch(self.e_np1[:,:3], self.e_n, self.T_np1,
+          self.T_n, self.t_np1, self.t_n, self.s_n, self.h_n, self.u_n,
+          self.p_n)
+
+  def test_ld_inc(self):
+    out = (np.zeros((self.N,6)), np.zeros((self.N,self.model.nstore)),
+        np.zeros((self.N,6,6)), np.zeros((self.N,6,3)), np.zeros((self.N,)),
+        np.zeros((self.N,)))
+    self.model.update_ld_inc_batch(self.e_np1, self.e_n, self.w_np1, 
+        self.w_n, self.T_np1, self.T_n, self.t_np1, self.t_n, self.s_n, 
+        self.h_n, self.u_n, self.p_n, nthreads = 2, out = out)
+
+    for i in range(self.N):
+      ref = self.model.update_ld_inc(self.e_np1[i], self.e_n[i], 
+          self.w_np1[i], self.w_n[i], self.T_np1[i], self.T_n[i], 
+          self.t_np1, self.t_n, self.s_n[i], self.h_n[i], self.u_n[i],
+          self.p_n[i])
+      for j in range(6):
+        self.assertTrue(np.allclose(out[j][i], ref[j]))
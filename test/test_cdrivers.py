@@ -0,0 +1,312 @@
+#!/usr/bin/env python3
+
+from neml import (models, elasticity, surfaces, hardening, visco_flow,
+    general_flow, ri_flow, drivers, cdrivers, parse)
+
+import unittest
+import os.path
+import numpy as np
+
+class CommonNativeDrivers(object):
+  """
+    Compare the native drivers to the python versions in neml.drivers
+  """
+  def compare(self, ref, res):
+    self.assertEqual(set(ref.keys()), set(res.keys()))
+    for k in ref.keys():
+      if np.isscalar(ref[k]) and not np.isfinite(ref[k]):
+        self.assertEqual(ref[k], res[k])
+        continue
+      a = np.asarray(ref[k])
+      b = np.asarray(res[k])
+      self.assertEqual(a.shape, b.shape, msg = k)
+      self.assertTrue(np.allclose(a, b, rtol = 1.0e-5, atol = 1.0e-8,
+          equal_nan = True),
+          msg = k)
+
+  def test_uniaxial(self):
+    self.compare(
+        drivers.uniaxial_test(self.model, 1.0e-2, emax = 0.02, nsteps = 50),
+        cdrivers.uniaxial_test(self.model, 1.0e-2, emax = 0.02, nsteps = 50))
+
+  def test_uniaxial_shear(self):
+    sdir = np.array([0,0,0,1.0,0,0])
+    self.compare(
+        drivers.uniaxial_test(self.model, 1.0e-2, emax = 0.02, nsteps = 50,
+          sdir = sdir),
+        cdrivers.uniaxial_test(self.model, 1.0e-2, emax = 0.02, nsteps = 50,
+          sdir = sdir))
+
+  def test_strain_cyclic(self):
+    self.compare(
+        drivers.strain_cyclic(self.model, 0.01, -0.5, 1.0e-3, 3,
+          nsteps = 20),
+        cdrivers.strain_cyclic(self.model, 0.01, -0.5, 1.0e-3, 3,
+          nsteps = 20))
+
+  def test_strain_cyclic_hold(self):
+    self.compare(
+        drivers.strain_cyclic(self.model, 0.01, -1.0, 1.0e-3, 2,
+          nsteps = 20, hold_time = [10.0, 5.0], n_hold = 5),
+        cdrivers.strain_cyclic(self.model, 0.01, -1.0, 1.0e-3, 2,
+          nsteps = 20, hold_time = [10.0, 5.0], n_hold = 5))
+
+  def test_stress_cyclic(self):
+    self.compare(
+        drivers.stress_cyclic(self.model, self.smax, -0.5, 10.0, 3,
+          nsteps = 20, hold_time = 5.0, n_hold = 5),
+        cdrivers.stress_cyclic(self.model, self.smax, -0.5, 10.0, 3,
+          nsteps = 20, hold_time = 5.0, n_hold = 5))
+
+  def test_stress_relaxation(self):
+    self.compare(
+        drivers.stress_relaxation(self.model, 0.01, 1.0e-4, 100.0,
+          nsteps = 20, nsteps_up = 20, logspace = True),
+        cdrivers.stress_relaxation(self.model, 0.01, 1.0e-4, 100.0,
+          nsteps = 20, nsteps_up = 20, logspace = True))
+
+  def test_creep(self):
+    self.compare(
+        drivers.creep(self.model, self.smax, 10.0, 100.0, nsteps = 20,
+          nsteps_up = 20),
+        cdrivers.creep(self.model, self.smax, 10.0, 100.0, nsteps = 20,
+          nsteps_up = 20))
+
+  def test_strain_cyclic_followup(self):
+    self.compare(
+        drivers.strain_cyclic_followup(self.model, 0.01, -1.0, 1.0e-3, 2,
+          q = 2.0, nsteps = 20, hold_time = [10.0, 5.0], n_hold = 5),
+        cdrivers.strain_cyclic_followup(self.model, 0.01, -1.0, 1.0e-3, 2,
+          q = 2.0, nsteps = 20, hold_time = [10.0, 5.0], n_hold = 5))
+
+  def test_rate_jump(self):
+    self.compare(
+        drivers.rate_jump_test(self.model, [1.0e-3, 1.0e-1, 1.0e-2],
+          e_per = 0.005, nsteps_per = 20),
+        cdrivers.rate_jump_test(self.model, [1.0e-3, 1.0e-1, 1.0e-2],
+          e_per = 0.005, nsteps_per = 20))
+
+  def test_rate_jump_strains(self):
+    self.compare(
+        drivers.rate_jump_test(self.model, [1.0e-3, 1.0e-1], nsteps_per = 20,
+          strains = [0.005, 0.015]),
+        cdrivers.rate_jump_test(self.model, [1.0e-3, 1.0e-1],
+          nsteps_per = 20, strains = [0.005, 0.015]))
+
+  def test_thermomechanical(self):
+    time = np.linspace(0, 100.0, 21)
+    temperature = np.linspace(300.0, 500.0, 21)
+    strain = 0.01 * np.sin(time / 20.0)
+    ref = drivers.thermomechanical_strain_raw(self.model, time, temperature,
+        strain, substep = 2)
+    res = cdrivers.thermomechanical_strain_raw(self.model, time,
+        temperature, strain, substep = 2)
+    # The python version drops the last point
+    n = len(ref['time'])
+    self.assertEqual(len(res['time']), n + 1)
+    for k in ("time", "temperature", "strain", "stress"):
+      self.assertTrue(np.allclose(ref[k], res[k][:n]), msg = k)
+    # No thermal expansion, so all the strain is mechanical
+    self.assertTrue(np.allclose(res['mechanical strain'], res['strain']))
+
+  def test_isochronous(self):
+    self.compare(
+        drivers.isochronous_curve(self.model, 100.0, emax = 0.01,
+          ds = 25.0, nsteps = 20),
+        cdrivers.isochronous_curve(self.model, 100.0, emax = 0.01,
+          ds = 25.0, nsteps = 20))
+
+  def test_driver(self):
+    ref = drivers.Driver_sd(self.model, T_init = 300.0)
+    res = cdrivers.Driver_sd(self.model, T_init = 300.0)
+
+    sdir = np.array([1.0,0.5,0,0,0,0])
+    for d in (ref, res):
+      d.erate_einc_step(sdir, 1.0e-3, 0.002, 300.0)
+      d.stress_step(d.stress[-1] * 1.1, d.t[-1] + 1.0, 300.0)
+      d.strain_step(d.strain[-1] * 1.05, d.t[-1] + 1.0, 300.0)
+      d.strain_hold_step(0, d.t[-1] + 10.0, 300.0)
+    for name in ("strain", "stress", "stored", "t", "u", "p"):
+      self.assertTrue(np.allclose(getattr(ref, name), getattr(res, name)))
+
+class TestNativeDriversViscoplastic(unittest.TestCase, CommonNativeDrivers):
+  def setUp(self):
+    E = 92000.0
+    nu = 0.3
+    elastic = elasticity.IsotropicLinearElasticModel(E, "youngs",
+        nu, "poissons")
+
+    surface = surfaces.IsoKinJ2()
+    iso = hardening.VoceIsotropicHardeningRule(89.0, 165.0, 12.0)
+    gmodels = [hardening.ConstantGamma(g) for g in [0.9e3, 1.5e3, 1.0]]
+    hmodel = hardening.Chaboche(iso, [80.0e3, 14.02e3, 3.333e3], gmodels,
+        [0.0, 0.0, 0.0], [1.0, 1.0, 1.0])
+    fluidity = visco_flow.ConstantFluidity(108.0)
+    vmodel = visco_flow.ChabocheFlowRule(surface, hmodel, fluidity, 20.0)
+    flow = general_flow.TVPFlowRule(elastic, vmodel)
+
+    self.model = models.GeneralIntegrator(elastic, flow)
+    self.smax = 150.0
+
+class TestNativeDriversRateIndependent(unittest.TestCase,
+    CommonNativeDrivers):
+  def setUp(self):
+    E = 150000.0
+    nu = 0.3
+    elastic = elasticity.IsotropicLinearElasticModel(E, "youngs",
+        nu, "poissons")
+
+    surface = surfaces.IsoJ2()
+    iso = hardening.LinearIsotropicHardeningRule(100.0, 2500.0)
+    flow = ri_flow.RateIndependentAssociativeFlow(surface, iso)
+
+    self.model = models.SmallStrainRateIndependentPlasticity(elastic, flow)
+    self.smax = 120.0
+
+  def test_creep(self):
+    # Rate independent, so the creep strain should vanish
+    res = cdrivers.creep(self.model, self.smax, 10.0, 100.0, nsteps = 20,
+        nsteps_up = 20)
+    self.assertFalse(res['failed'])
+    self.assertTrue(np.allclose(res['rrate'][1:], 0.0))
+    super().test_creep()
+
+class TestEnsemble(unittest.TestCase):
+  def setUp(self):
+    self.xml = os.path.join(os.path.dirname(__file__), "regression",
+        "reference.xml")
+    self.names = ["rule/flow/fluidity/eta", "rule/flow/n"]
+    self.ensemble = cdrivers.ModelEnsemble(self.xml, "chaboche", self.names)
+
+    self.values = np.array([[701.0, 10.5], [600.0, 10.5], [701.0, 8.0],
+      [800.0, 12.0]])
+
+  def test_base(self):
+    self.assertEqual(self.ensemble.nparams, 2)
+    self.assertEqual(self.ensemble.names, self.names)
+    self.assertTrue(np.allclose(self.ensemble.base_values, [701.0, 10.5]))
+
+  def test_bad_path(self):
+    with self.assertRaises(ValueError):
+      cdrivers.ModelEnsemble(self.xml, "chaboche", ["rule/flow/nope"])
+    with self.assertRaises(ValueError):
+      cdrivers.ModelEnsemble(self.xml, "chaboche", ["rule/flow/fluidity"])
+
+  def test_base_model(self):
+    model = parse.parse_xml(self.xml, "chaboche")
+    ref = cdrivers.uniaxial_test(model, 1.0e-3, emax = 0.01, nsteps = 20)
+    res = cdrivers.uniaxial_test(
+        self.ensemble.make_model(self.ensemble.base_values), 1.0e-3,
+        emax = 0.01, nsteps = 20)
+    self.assertTrue(np.allclose(ref['stress'], res['stress']))
+
+  def test_uniaxial(self):
+    test = cdrivers.UniaxialEnsembleTest(1.0e-3, emax = 0.01, nsteps = 20)
+    res = cdrivers.run_ensemble(self.ensemble, test, self.values)
+    self.assertTrue(np.all(res['errors'] == 0))
+    self.assertEqual(res['stress'].shape, (len(self.values), 21))
+    for i, v in enumerate(self.values):
+      ref = cdrivers.uniaxial_test(self.ensemble.make_model(v), 1.0e-3,
+          emax = 0.01, nsteps = 20)
+      self.assertTrue(np.allclose(res['stress'][i], ref['stress']))
+      self.assertTrue(np.isclose(res['youngs'][i], ref['youngs']))
+      self.assertTrue(np.isclose(res['yield'][i], ref['yield']))
+
+  def test_creep(self):
+    test = cdrivers.CreepEnsembleTest(200.0, 10.0, 1000.0, nsteps = 20,
+        nsteps_up = 10)
+    res = cdrivers.run_ensemble(self.ensemble, test, self.values)
+    for i, v in enumerate(self.values):
+      ref = cdrivers.creep(self.ensemble.make_model(v), 200.0, 10.0, 1000.0,
+          nsteps = 20, nsteps_up = 10)
+      n = len(ref['strain'])
+      self.assertEqual(res['failed'][i], ref['failed'])
+      self.assertTrue(np.allclose(res['strain'][i,:n], ref['strain']))
+      self.assertTrue(np.all(np.isnan(res['strain'][i,n:])))
+      self.assertTrue(np.isclose(res['final_strain'][i], ref['strain'][-1]))
+      self.assertTrue(np.isclose(res['min_rate'][i],
+        np.nanmin(ref['rrate'])))
+
+  def test_cyclic(self):
+    test = cdrivers.StrainCyclicEnsembleTest(0.005, -1.0, 1.0e-3, 3,
+        nsteps = 10)
+    res = cdrivers.run_ensemble(self.ensemble, test, self.values)
+    for i, v in enumerate(self.values):
+      ref = cdrivers.strain_cyclic(self.ensemble.make_model(v), 0.005, -1.0,
+          1.0e-3, 3, nsteps = 10)
+      self.assertEqual(res['cycles'][i], len(ref['cycles']))
+      self.assertTrue(np.allclose(res['max'][i], ref['max']))
+      self.assertTrue(np.allclose(res['min'][i], ref['min']))
+
+  def test_threads_and_out(self):
+    test = cdrivers.UniaxialEnsembleTest(1.0e-3, emax = 0.01, nsteps = 20)
+    ref = cdrivers.run_ensemble(self.ensemble, test, self.values)
+
+    out = np.zeros((len(self.values), test.nout))
+    res = cdrivers.run_ensemble(self.ensemble, test, self.values,
+        nthreads = 2, out = out)
+    self.assertTrue(np.shares_memory(res['stress'], out))
+    self.assertTrue(np.allclose(out[:,3:], ref['stress']))
+
+    with self.assertRaises(RuntimeError):
+      cdrivers.run_ensemble(self.ensemble, test, self.values,
+          out = np.zeros((2, test.nout)))
+
+class TestCycleExtrapolation(unittest.TestCase):
+  def setUp(self):
+    E = 92000.0
+    nu = 0.3
+    elastic = elasticity.IsotropicLinearElasticModel(E, "youngs",
+        nu, "poissons")
+
+    surface = surfaces.IsoKinJ2()
+    iso = hardening.VoceIsotropicHardeningRule(89.0, 165.0, 12.0)
+    gmodels = [hardening.ConstantGamma(g) for g in [0.9e3, 1.5e3, 1.0]]
+    hmodel = hardening.Chaboche(iso, [80.0e3, 14.02e3, 3.333e3], gmodels,
+        [0.0, 0.0, 0.0], [1.0, 1.0, 1.0])
+    fluidity = visco_flow.ConstantFluidity(108.0)
+    vmodel = visco_flow.ChabocheFlowRule(surface, hmodel, fluidity, 20.0)
+    flow = general_flow.TVPFlowRule(elastic, vmodel)
+
+    self.model = models.GeneralIntegrator(elastic, flow)
+    self.args = (self.model, 0.005, -1.0, 1.0e-3, 100)
+
+  def test_no_jump(self):
+    ref = cdrivers.strain_cyclic(*self.args, nsteps = 20)
+    res = cdrivers.strain_cyclic_extrapolated(*self.args, nsteps = 20,
+        max_jump = 0)
+    self.assertFalse(np.any(res['extrapolated']))
+    for k in ref.keys():
+      self.assertTrue(np.allclose(ref[k], res[k]), msg = k)
+
+  def test_jump(self):
+    ref = cdrivers.strain_cyclic(*self.args, nsteps = 20)
+    res = cdrivers.strain_cyclic_extrapolated(*self.args, nsteps = 20)
+
+    self.assertTrue(np.sum(res['extrapolated']) > 0)
+    self.assertTrue(len(res['cycles']) < len(ref['cycles']))
+    self.assertEqual(res['cycles'][-1], ref['cycles'][-1])
+    self.assertTrue(np.all(np.diff(res['cycles']) > 0))
+    self.assertEqual(len(res['max']), len(res['cycles']))
+
+    # Cycles before the first jump are integrated as usual
+    first = np.argmax(res['extrapolated'])
+    self.assertTrue(first >= 3)
+    self.assertTrue(np.allclose(res['max'][:first], ref['max'][:first]))
+
+    srange = np.max(ref['max'] - ref['min'])
+    c = res['cycles']
+    self.assertTrue(np.allclose(res['max'], ref['max'][c],
+      atol = 1.0e-3 * srange))
+    self.assertTrue(np.allclose(res['min'], ref['min'][c],
+      atol = 1.0e-3 * srange))
+
+  def test_jump_stress(self):
+    small = cdrivers.strain_cyclic_extrapolated(*self.args, nsteps = 20,
+        jump_stress = 0.1)
+    big = cdrivers.strain_cyclic_extrapolated(*self.args, nsteps = 20)
+    self.assertTrue(len(small['cycles']) > len(big['cycles']))
+
+  def test_bad_min_cycle(self):
+    with self.assertRaises(ValueError):
+      cdrivers.strain_cyclic_extrapolated(*self.args, min_cycle = 1)
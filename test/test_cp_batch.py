@@ -64,6 +64,15 @@ class TestBatch(unittest.TestCase):
     for q1,q2 in zip(self.orientations,nq):
       self.assertTrue(np.allclose(q1.quat,q2.quat))
 
+  def test_batch_init_instanced(self):
+    qs = rotations.OrientationArray(self.orientations)
+    H1 = batch.init_history_batch(self.model, qs, nthreads = 2)
+    H2 = batch.init_history_batch(self.model, self.N)
+    batch.set_orientation_passive_batch(self.model, H2,
+        [q.inverse() for q in self.orientations])
+
+    self.assertTrue(np.allclose(H1, H2))
+
   def test_batch_no_threads(self):
     self.batch_run(1)
 
@@ -284,6 +284,63 @@ class ShearTests(object):
                 self.lattice.slip_planes[i][j].data), self.QM.T)), S)
         num = tensors.Symmetric(differentiate(rs, self.S)[0])
 
+  def test_shears(self):
+    tau = self.lattice.shears(self.Q, self.ST)
+    self.assertEqual(len(tau), self.lattice.ntotal)
+    for i in range(self.lattice.ngroup):
+      for j in range(self.lattice.nslip(i)):
+        k = self.lattice.flat(i,j)
+        self.assertTrue(np.isclose(tau[k],
+          self.lattice.M(i,j,self.Q).contract(self.ST)))
+        self.assertTrue(np.isclose(tau[k],
+          self.lattice.shear(i,j,self.Q,self.ST)))
+
+  def test_d_shears(self):
+    dtau = self.lattice.d_shears(self.Q, self.ST)
+    for i in range(self.lattice.ngroup):
+      for j in range(self.lattice.nslip(i)):
+        self.assertTrue(np.allclose(dtau[self.lattice.flat(i,j)],
+          self.lattice.d_shear(i,j,self.Q,self.ST).data))
+
+class TestDisorientation(unittest.TestCase):
+  def setUp(self):
+    self.A = rotations.random_orientations(20, 1)
+    self.B = rotations.random_orientations(15, 2)
+    self.Aa = np.array([q.quat for q in self.A])
+    self.Ba = np.array([q.quat for q in self.B])
+    self.I = rotations.Orientation(np.array([1.0,0,0,0]))
+
+  def angle(self, grp, a, b):
+    return 2.0 * grp.misorientation(a, b).distance(self.I)
+
+  def test_all_pairs(self):
+    for cls in groups:
+      grp = crystallography.SymmetryGroup(cls)
+      angles = grp.disorientation_angles(self.Aa, self.Ba, nthreads = 2)
+      self.assertEqual(angles.shape, (20,15))
+      for i, a in enumerate(self.A):
+        for j, b in enumerate(self.B):
+          self.assertAlmostEqual(angles[i,j], self.angle(grp, a, b))
+
+  def test_paired(self):
+    for cls in groups:
+      grp = crystallography.SymmetryGroup(cls)
+      angles = grp.disorientation_angles_paired(self.Aa[:15], self.Ba)
+      for i, (a, b) in enumerate(zip(self.A, self.B)):
+        self.assertAlmostEqual(angles[i], self.angle(grp, a, b))
+
+  def test_equivalent(self):
+    grp = crystallography.SymmetryGroup("432")
+    equiv = np.array([(op * q).quat for op, q in zip(grp.ops, self.A)])
+    angles = grp.disorientation_angles_paired(equiv, self.Aa[:len(equiv)])
+    self.assertTrue(np.allclose(angles, 0.0, atol = 1.0e-6))
+
+  def test_fundamental_zone(self):
+    # No cubic disorientation exceeds the corner of the fundamental zone
+    grp = crystallography.SymmetryGroup("432")
+    angles = grp.disorientation_angles(self.Aa, self.Ba)
+    self.assertTrue(np.all(angles <= np.radians(62.8)))
+
 class TestCubicFCC(unittest.TestCase, LTests, ShearTests):
   def setUp(self):
     self.a = 1.3
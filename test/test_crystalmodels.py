@@ -68,6 +68,10 @@ class CommonSolver(object):
     
     self.assertTrue(np.allclose(J, Jn, rtol = 1.0e-4))
 
+  def test_residual_only(self):
+    R, J = self.model.RJ(self.x, self.ts)
+    self.assertTrue(np.allclose(self.model.R(self.x, self.ts), R))
+
 class TestSingleCrystal(unittest.TestCase, CommonTangents, CommonSolver):
   def setUp(self):
     self.tau0 = 10.0
@@ -212,6 +216,45 @@ class TestSingleCrystal(unittest.TestCase, CommonTangents, CommonSolver):
     self.assertTrue(np.allclose(q.quat, 
       self.model.get_active_orientation(h).inverse().quat))
 
+  def test_block_solve(self):
+    # Off unless asked for
+    self.assertFalse(self.model.block_solve)
+
+    self.assertTrue(self.strengthmodel.diagonal_history_jacobian)
+    blocked = singlecrystal.SingleCrystalModel(self.kmodel, self.L,
+        initial_rotation = self.Q, block_solve = True)
+    self.assertTrue(blocked.block_solve)
+
+    R, J = blocked.RJ(self.x, self.ts)
+    self.assertTrue(np.allclose(blocked.linear_solve(J, R),
+      la.solve(J, R)))
+
+    with self.assertRaises(ValueError):
+      singlecrystal.SingleCrystalModel(self.kmodel, self.L,
+          initial_rotation = self.Q, block_solve = True,
+          mixed_precision = True)
+
+  def test_block_solve_same(self):
+    blocked = singlecrystal.SingleCrystalModel(self.kmodel, self.L,
+        initial_rotation = self.Q, block_solve = True)
+    self.assertTrue(blocked.block_solve)
+
+    d_n = np.zeros((6,))
+    w_n = np.zeros((3,))
+    s_n = np.zeros((6,))
+    h_n = self.model.init_store()
+
+    d_np1 = self.Ddir * self.dt
+    w_np1 = self.Wdir * self.dt
+
+    r1 = self.model.update_ld_inc(d_np1, d_n, w_np1, w_n, self.T, self.T,
+        self.dt, 0.0, s_n, h_n, 0.0, 0.0)
+    r2 = blocked.update_ld_inc(d_np1, d_n, w_np1, w_n, self.T, self.T,
+        self.dt, 0.0, s_n, h_n, 0.0, 0.0)
+
+    for a, b in zip(r1, r2):
+      self.assertTrue(np.allclose(a, b))
+
 class TestComplicatedCrystal(unittest.TestCase, CommonTangents, CommonSolver):
   def setUp(self):
     self.tau0_0 = 10.0
@@ -306,6 +349,135 @@ class TestComplicatedCrystal(unittest.TestCase, CommonTangents, CommonSolver):
   def test_nhist(self):
     self.assertEqual(self.model.nstore, 10)
 
+  def test_block_solve(self):
+    # The summed strength couples the history variables
+    self.assertFalse(self.strengthmodel.diagonal_history_jacobian)
+    blocked = singlecrystal.SingleCrystalModel(self.kmodel, self.L,
+        initial_rotation = self.Q, block_solve = True)
+    self.assertFalse(blocked.block_solve)
+
+  def test_mixed_precision(self):
+    mixed = singlecrystal.SingleCrystalModel(self.kmodel, self.L,
+        initial_rotation = self.Q, mixed_precision = True)
+
+    d_n = np.zeros((6,))
+    w_n = np.zeros((3,))
+    s_n = np.zeros((6,))
+    h_n = self.model.init_store()
+
+    d_np1 = self.Ddir * self.dt
+    w_np1 = self.Wdir * self.dt
+
+    r1 = self.model.update_ld_inc(d_np1, d_n, w_np1, w_n, self.T, self.T,
+        self.dt, 0.0, s_n, h_n, 0.0, 0.0)
+    r2 = mixed.update_ld_inc(d_np1, d_n, w_np1, w_n, self.T, self.T,
+        self.dt, 0.0, s_n, h_n, 0.0, 0.0)
+
+    for a, b in zip(r1, r2):
+      self.assertTrue(np.allclose(a, b))
+
+  def test_broyden(self):
+    broyden = singlecrystal.SingleCrystalModel(self.kmodel, self.L,
+        initial_rotation = self.Q, solver = "broyden")
+
+    d_n = np.zeros((6,))
+    w_n = np.zeros((3,))
+    s_n = np.zeros((6,))
+    h_n = self.model.init_store()
+
+    d_np1 = self.Ddir * self.dt
+    w_np1 = self.Wdir * self.dt
+
+    r1 = self.model.update_ld_inc(d_np1, d_n, w_np1, w_n, self.T, self.T,
+        self.dt, 0.0, s_n, h_n, 0.0, 0.0)
+    r2 = broyden.update_ld_inc(d_np1, d_n, w_np1, w_n, self.T, self.T,
+        self.dt, 0.0, s_n, h_n, 0.0, 0.0)
+
+    for a, b in zip(r1, r2):
+      self.assertTrue(np.allclose(a, b, rtol = 1.0e-5))
+
+  def test_solver_stats(self):
+    broyden = singlecrystal.SingleCrystalModel(self.kmodel, self.L,
+        initial_rotation = self.Q, solver = "broyden")
+    broyden.collect_solver_stats()
+
+    d_np1 = self.Ddir * self.dt
+    w_np1 = self.Wdir * self.dt
+    broyden.update_ld_inc(d_np1, np.zeros((6,)), w_np1, np.zeros((3,)),
+        self.T, self.T, self.dt, 0.0, np.zeros((6,)), broyden.init_store(),
+        0.0, 0.0)
+
+    stats = broyden.solver_stats
+    self.assertEqual(stats.solves, 1)
+    self.assertTrue(stats.r_calls > 0)
+    self.assertEqual(stats.r_calls, stats.iterations)
+    self.assertTrue(stats.linear_solves >= stats.iterations)
+
+  def test_bad_solver(self):
+    with self.assertRaises(ValueError):
+      singlecrystal.SingleCrystalModel(self.kmodel, self.L,
+          initial_rotation = self.Q, solver = "wrong")
+
+  def test_broyden_linear_solve(self):
+    for opt in ("block_solve", "mixed_precision"):
+      with self.assertRaisesRegex(ValueError, "newton solver"):
+        singlecrystal.SingleCrystalModel(self.kmodel, self.L,
+            initial_rotation = self.Q, solver = "broyden", **{opt: True})
+
+  def test_adaptive_substep(self):
+    # Compare with the rotation fixed, as that is not substepped
+    controlled = singlecrystal.SingleCrystalModel(self.kmodel, self.L,
+        initial_rotation = self.Q, update_rotation = False,
+        adaptive_substep = True, substep_tol = 1.0e-3)
+
+    def run(model, nsteps):
+      d_n = np.zeros((6,))
+      w_n = np.zeros((3,))
+      s_n = np.zeros((6,))
+      h_n = model.init_store()
+      t_n = 0.0
+      for i in range(nsteps):
+        d_np1 = d_n + self.Ddir * self.dt / nsteps
+        w_np1 = w_n + self.Wdir * self.dt / nsteps
+        t_np1 = t_n + self.dt / nsteps
+        s_n, h_n, A, B, u, p = model.update_ld_inc(d_np1, d_n, w_np1, w_n,
+            self.T, self.T, t_np1, t_n, s_n, h_n, 0.0, 0.0)
+        d_n = d_np1
+        w_n = w_np1
+        t_n = t_np1
+      return s_n
+
+    exact = run(self.model_no_rot, 200)
+    default = run(self.model_no_rot, 1)
+    res = run(controlled, 1)
+
+    self.assertTrue(la.norm(res - exact) < 0.1 * la.norm(default - exact))
+
+  def test_extrapolate_predictor(self):
+    with self.assertRaisesRegex(ValueError, "does not support"):
+      singlecrystal.SingleCrystalModel(self.kmodel, self.L,
+          initial_rotation = self.Q, predictor = "extrapolate")
+
+  def test_euler_predictor(self):
+    euler = singlecrystal.SingleCrystalModel(self.kmodel, self.L,
+        initial_rotation = self.Q, predictor = "euler")
+
+    d_n = np.zeros((6,))
+    w_n = np.zeros((3,))
+    s_n = np.zeros((6,))
+    h_n = self.model.init_store()
+
+    d_np1 = self.Ddir * self.dt
+    w_np1 = self.Wdir * self.dt
+
+    r1 = self.model.update_ld_inc(d_np1, d_n, w_np1, w_n, self.T, self.T,
+        self.dt, 0.0, s_n, h_n, 0.0, 0.0)
+    r2 = euler.update_ld_inc(d_np1, d_n, w_np1, w_n, self.T, self.T,
+        self.dt, 0.0, s_n, h_n, 0.0, 0.0)
+
+    for a, b in zip(r1, r2):
+      self.assertTrue(np.allclose(a, b, rtol = 1.0e-4))
+
 class TestNyeStuffCrystal(unittest.TestCase):
   def setUp(self):
     self.tau0 = 10.0
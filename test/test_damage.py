@@ -114,6 +114,7 @@ class CommonScalarDamageModel(object):
     R_calc[6] = w_trial - d_np1
 
     self.assertTrue(np.allclose(R_calc, R))
+    self.assertTrue(np.allclose(self.model.R(self.x_trial, trial_state), R))
 
   def test_jacobian(self):
     trial_state = self.model.make_trial_state(
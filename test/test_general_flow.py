@@ -100,6 +100,25 @@ class CommonGeneralFlow(object):
     self.assertTrue(np.allclose(num, should, rtol = 1.0e-3))
 
 
+  def test_evaluate(self):
+    t_np1 = self.gen_t()
+    e_np1 = self.gen_e()
+    e_dot = self.gen_edot(e_np1, t_np1)
+    T_np1 = self.gen_T()
+    T_dot = self.gen_Tdot(T_np1, t_np1)
+    s_np1 = self.gen_stress()
+    h_np1 = self.gen_hist()
+
+    args = (s_np1, h_np1, e_dot, T_np1, T_dot)
+    should = (self.model.s(*args), self.model.ds_ds(*args),
+        self.model.ds_da(*args), self.model.a(*args),
+        self.model.da_ds(*args), self.model.da_da(*args))
+    actual = self.model.evaluate(*args)
+
+    self.assertEqual(len(actual), len(should))
+    for a, b in zip(actual, should):
+      self.assertTrue(np.allclose(a, b))
+
 class CommonTVPFlow(object):
   def test_history(self):
     self.assertEqual(len(self.h_n), self.model.nhist)
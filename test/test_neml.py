@@ -133,6 +133,20 @@ class CommonJacobian(object):
    
     self.assertTrue(np.allclose(J, nJ, rtol = 1.0e-3, atol = 1e-1))
 
+  def test_residual(self):
+    e_np1 = self.gen_strain()
+    T_np1 = self.gen_T()
+    h_n = self.gen_hist()
+    t_np1 = self.gen_time()
+
+    ts = self.model.make_trial_state(e_np1, self.gen_start_strain(), T_np1, T_np1,
+        t_np1, self.gen_start_time(), self.gen_start_stress(), h_n)
+
+    x = self.gen_x()
+
+    R, J = self.model.RJ(x, ts)
+    self.assertTrue(np.allclose(self.model.R(x, ts), R))
+
 class TestPerfectPlasticity(unittest.TestCase, CommonMatModel, CommonJacobian):
   """
     Test J2 perfect plasticity
@@ -251,6 +265,72 @@ class TestRIAPlasticityJ2Linear(unittest.TestCase, CommonMatModel, CommonJacobia
     return np.array(range(1,9)) / 9.0
 
 
+class TestSolverStats(unittest.TestCase):
+  """
+    Test the opt-in solver statistics
+  """
+  def setUp(self):
+    elastic = elasticity.IsotropicLinearElasticModel(92000.0, "youngs",
+        0.3, "poissons")
+    surface = surfaces.IsoJ2()
+    hrule = hardening.LinearIsotropicHardeningRule(180.0, 920.0)
+    flow = ri_flow.RateIndependentAssociativeFlow(surface, hrule)
+
+    self.model = models.SmallStrainRateIndependentPlasticity(elastic, flow)
+    self.e_np1 = np.array([0.01,-0.005,0.0,0.002,0.0,0.0])
+    self.T = 300.0
+
+  def update(self, model):
+    return model.update_sd(self.e_np1, np.zeros((6,)), self.T, self.T, 1.0,
+        0.0, np.zeros((6,)), model.init_store(), 0.0, 0.0)
+
+  def test_off(self):
+    self.update(self.model)
+    self.assertEqual(self.model.solver_stats.solves, 0)
+
+  def test_newton_counts(self):
+    self.model.collect_solver_stats()
+    self.update(self.model)
+    self.update(self.model)
+    stats = self.model.solver_stats
+
+    self.assertEqual(stats.solves, 2)
+    self.assertTrue(stats.iterations > 0)
+    self.assertEqual(stats.rj_calls, stats.solves + stats.iterations)
+    self.assertEqual(stats.linear_solves, stats.iterations)
+    self.assertEqual(stats.total_failures, 0)
+    self.assertTrue(stats.rj_time >= 0.0)
+
+  def test_reset(self):
+    self.model.collect_solver_stats()
+    self.update(self.model)
+    self.model.reset_solver_stats()
+    self.assertEqual(self.model.solver_stats.solves, 0)
+    self.update(self.model)
+    self.assertEqual(self.model.solver_stats.solves, 1)
+
+    self.model.collect_solver_stats(False)
+    self.update(self.model)
+    self.assertEqual(self.model.solver_stats.solves, 1)
+
+  def test_failures(self):
+    elastic = elasticity.IsotropicLinearElasticModel(92000.0, "youngs",
+        0.3, "poissons")
+    surface = surfaces.IsoJ2()
+    hrule = hardening.VoceIsotropicHardeningRule(180.0, 100.0, 1000.0)
+    flow = ri_flow.RateIndependentAssociativeFlow(surface, hrule)
+    model = models.SmallStrainRateIndependentPlasticity(elastic, flow,
+        miter = 1, max_divide = 2)
+    model.collect_solver_stats()
+
+    with self.assertRaises(Exception):
+      self.update(model)
+
+    stats = model.solver_stats
+    self.assertEqual(stats.substep_divisions, 1)
+    self.assertEqual(stats.failures, {-3: 2})
+    self.assertEqual(stats.total_failures, 2)
+
 class TestRIAPlasticityJ2Voce(unittest.TestCase, CommonMatModel, CommonJacobian):
   """
     Test the rate-independent plasticity algorithm with a Voce
@@ -435,6 +515,19 @@ class TestCreepPlasticityPerfect(unittest.TestCase, CommonMatModel):
   def gen_start_strain(self):
     return np.zeros((6,)) + 0.01
 
+  def test_residual(self):
+    e_n = np.zeros((6,)) + 0.01
+    e_np1 = e_n + self.efinal / self.nsteps
+    s_n = np.zeros((6,)) + 100.0
+    h_n = self.model.init_store()
+
+    ts = self.model.make_trial_state(e_np1, e_n, self.T, self.T,
+        self.tfinal / self.nsteps, 0.0, s_n, h_n)
+    x = self.model.init_x(ts) + 1.0e-3
+
+    R, J = self.model.RJ(x, ts)
+    self.assertTrue(np.allclose(self.model.R(x, ts), R))
+
 class TestDirectIntegrateChaboche(unittest.TestCase, CommonMatModel, CommonJacobian):
   """
     Test Chaboche's VP model with our new direct integrator
@@ -482,9 +575,9 @@ class TestDirectIntegrateChaboche(unittest.TestCase, CommonMatModel, CommonJacob
     self.elastic = elasticity.IsotropicLinearElasticModel(mu,
         "shear", K, "bulk")
 
-    flow = general_flow.TVPFlowRule(self.elastic, vmodel)
+    self.flow = general_flow.TVPFlowRule(self.elastic, vmodel)
 
-    self.model = models.GeneralIntegrator(self.elastic, flow)
+    self.model = models.GeneralIntegrator(self.elastic, self.flow)
 
     self.efinal = np.array([0.05,0,0,0.02,0,-0.01])
     self.tfinal = 10.0
@@ -502,6 +595,320 @@ class TestDirectIntegrateChaboche(unittest.TestCase, CommonMatModel, CommonJacob
     x = [100.0,150.0,-300.0,-10.0,50.0,100.0] + list(self.gen_hist()*1.1)
     return np.array(x)
 
+class TestDirectIntegrateChabocheMixed(TestDirectIntegrateChaboche):
+  """
+    Same model, but with a mixed precision Newton linear solve
+  """
+  def setUp(self):
+    super().setUp()
+    self.double_model = self.model
+    self.model = models.GeneralIntegrator(self.elastic, self.flow,
+        mixed_precision = True)
+
+  def test_same(self):
+    t_n = 0.0
+    strain_n = np.zeros((6,))
+    stress_n = np.zeros((6,))
+    hist_n = self.model.init_store()
+
+    for m in np.linspace(0,1,self.nsteps)[1:]:
+      t_np1 = self.tfinal * m
+      strain_np1 = self.efinal * m
+      
+      res_mixed = self.model.update_sd(strain_np1, strain_n, self.T, self.T,
+          t_np1, t_n, stress_n, hist_n, 0.0, 0.0)
+      res_double = self.double_model.update_sd(strain_np1, strain_n, self.T, 
+          self.T, t_np1, t_n, stress_n, hist_n, 0.0, 0.0)
+
+      self.assertTrue(np.allclose(res_mixed[0], res_double[0]))
+      self.assertTrue(np.allclose(res_mixed[1], res_double[1]))
+      
+      strain_n = strain_np1
+      stress_n = res_double[0]
+      hist_n = res_double[1]
+      t_n = t_np1
+
+class TestDirectIntegrateChabocheEuler(TestDirectIntegrateChaboche):
+  """
+    Same model, but with a forward Euler predictor
+  """
+  def setUp(self):
+    super().setUp()
+    self.model = models.GeneralIntegrator(self.elastic, self.flow,
+        predictor = "euler")
+
+class TestDirectIntegrateChabocheAdaptive(TestDirectIntegrateChaboche):
+  """
+    Same model, but trying the explicit integrator first
+  """
+  def setUp(self):
+    super().setUp()
+    self.implicit_model = self.model
+    self.model = models.GeneralIntegrator(self.elastic, self.flow,
+        adaptive_explicit = True)
+
+  def test_tangent_proportional_strain(self):
+    """
+      The adaptive step size control makes finite differences useless, 
+      so compare to the implicit tangent instead
+    """
+    t_n = 0.0
+    strain_n = np.zeros((6,))
+    stress_n = np.zeros((6,))
+    hist_n = self.model.init_store()
+
+    for m in np.linspace(0,1,self.nsteps)[1:]:
+      t_np1 = self.tfinal * m
+      strain_np1 = self.efinal * m
+
+      s1, h1, A1, u1, p1 = self.model.update_sd(strain_np1, strain_n, 
+          self.T, self.T, t_np1, t_n, stress_n, hist_n, 0.0, 0.0)
+      s2, h2, A2, u2, p2 = self.implicit_model.update_sd(strain_np1, 
+          strain_n, self.T, self.T, t_np1, t_n, stress_n, hist_n, 0.0, 0.0)
+
+      self.assertTrue(np.max(np.abs(A1 - A2)) < 0.05 * np.max(np.abs(A2)))
+
+      strain_n = strain_np1
+      stress_n = s1
+      hist_n = h1
+      t_n = t_np1
+
+  def run_hold(self, model, srate, thold, nsteps):
+    """
+      Load to some strain and then hold
+    """
+    e_n = np.zeros((6,))
+    s_n = np.zeros((6,))
+    h_n = model.init_store()
+    t_n = 0.0
+
+    e_np1 = np.array([srate,0,0,0,0,0])
+    t_np1 = 1.0
+    s_n, h_n, A, u, p = model.update_sd(e_np1, e_n, self.T, self.T,
+        t_np1, t_n, s_n, h_n, 0.0, 0.0)
+
+    e_n = e_np1
+    t_n = t_np1
+    for t_np1 in np.linspace(t_n, t_n + thold, nsteps+1)[1:]:
+      s_n, h_n, A, u, p = model.update_sd(e_n, e_n, self.T, self.T,
+          t_np1, t_n, s_n, h_n, 0.0, 0.0)
+      t_n = t_np1
+
+    return s_n, h_n
+
+  def test_low_stress_hold(self):
+    self.model.reset_stats()
+    s1, h1 = self.run_hold(self.model, 0.0012, 1000.0, 20)
+    s2, h2 = self.run_hold(self.implicit_model, 0.0012, 1000.0, 20)
+    
+    self.assertTrue(np.allclose(s1, s2, rtol = 1.0e-3))
+    self.assertEqual(self.model.stats.implicit_steps, 0)
+    self.assertTrue(self.model.stats.explicit_steps > 0)
+    self.assertTrue(self.model.stats.last_explicit)
+
+  def test_stiff_fallback(self):
+    self.model.reset_stats()
+    s1, h1 = self.run_hold(self.model, 0.02, 1000.0, 5)
+    s2, h2 = self.run_hold(self.implicit_model, 0.02, 1000.0, 5)
+    
+    self.assertTrue(np.allclose(s1, s2, rtol = 1.0e-3))
+    self.assertTrue(self.model.stats.fallbacks > 0)
+    self.assertEqual(self.model.stats.fallbacks, 
+        self.model.stats.implicit_steps)
+
+class TestDirectIntegrateChabocheControlled(TestDirectIntegrateChaboche):
+  """
+    Same model, but with error controlled substepping
+  """
+  def setUp(self):
+    super().setUp()
+    self.default_model = self.model
+    self.model = models.GeneralIntegrator(self.elastic, self.flow,
+        adaptive_substep = True, substep_tol = 1.0e-3, max_divide = 8)
+
+  def test_tangent_proportional_strain(self):
+    """
+      The tangent ignores the sensitivity of the substep sizes to the
+      strain, so it only approximately matches finite differences
+    """
+    t_n = 0.0
+    strain_n = np.zeros((6,))
+    stress_n = np.zeros((6,))
+    hist_n = self.model.init_store()
+
+    for m in np.linspace(0,1,self.nsteps)[1:]:
+      t_np1 = self.tfinal * m
+      strain_np1 = self.efinal * m
+
+      stress_np1, hist_np1, A_np1, u_np1, p_np1 = self.model.update_sd(
+          strain_np1, strain_n, self.T, self.T, t_np1, t_n, stress_n, hist_n,
+          0.0, 0.0)
+      dfn = lambda e: self.model.update_sd(e,
+          strain_n, self.T, self.T, t_np1, t_n, stress_n, hist_n, 0.0, 0.0)[0]
+      num_A = differentiate(dfn, strain_np1, eps = 1.0e-9)
+
+      self.assertTrue(np.max(np.abs(num_A - A_np1)) < 
+          1.0e-2 * np.max(np.abs(num_A)))
+
+      strain_n = strain_np1
+      stress_n = stress_np1
+      hist_n = hist_np1
+      t_n = t_np1
+
+  def one_step(self, model, nsteps):
+    e_n = np.zeros((6,))
+    s_n = np.zeros((6,))
+    h_n = model.init_store()
+    t_n = 0.0
+    for m in np.linspace(0, 1, nsteps+1)[1:]:
+      e_np1 = self.efinal * m / 5.0
+      t_np1 = self.tfinal * m
+      s_n, h_n, A, u, p = model.update_sd(e_np1, e_n, self.T, self.T,
+          t_np1, t_n, s_n, h_n, 0.0, 0.0)
+      e_n = e_np1
+      t_n = t_np1
+    return s_n
+
+  def test_large_step(self):
+    exact = self.one_step(self.default_model, 500)
+    default = self.one_step(self.default_model, 1)
+    controlled = self.one_step(self.model, 1)
+
+    err_default = la.norm(default - exact) / la.norm(exact)
+    err_controlled = la.norm(controlled - exact) / la.norm(exact)
+
+    self.assertTrue(err_controlled < 0.1 * err_default)
+
+class TestDirectIntegratePredictor(unittest.TestCase):
+  """
+    Compare the Newton initial guesses on a strain controlled ramp
+  """
+  def setUp(self):
+    n = 20.0
+    eta = 108.0
+    sY = 89.0
+    Q = 165.0
+    b = 12.0
+
+    surface = surfaces.IsoKinJ2()
+    iso = hardening.VoceIsotropicHardeningRule(sY, Q, b)
+    gmodels = [hardening.ConstantGamma(g) for g in [0.9e3, 1.5e3, 1.0]]
+    hmodel = hardening.Chaboche(iso, [80.0e3, 14.02e3, 3.333e3], gmodels,
+        [0.0, 0.0, 0.0], [1.0, 1.0, 1.0])
+    fluidity = visco_flow.ConstantFluidity(eta)
+    vmodel = visco_flow.ChabocheFlowRule(surface, hmodel, fluidity, n)
+
+    self.elastic = elasticity.IsotropicLinearElasticModel(92000.0, 
+        "youngs", 0.3, "poissons")
+    self.flow = general_flow.TVPFlowRule(self.elastic, vmodel)
+
+    self.models = {p: models.GeneralIntegrator(self.elastic, self.flow,
+      predictor = p) for p in ["none", "euler", "extrapolate"]}
+
+    self.efinal = np.array([0.05,0,0,0.02,0,-0.01])
+    self.tfinal = 10.0
+    self.T = 300.0
+    self.nsteps = 50
+
+  def run_model(self, model):
+    t_n = 0.0
+    e_n = np.zeros((6,))
+    s_n = np.zeros((6,))
+    h_n = model.init_store()
+
+    stresses = []
+    iters = 0
+    for m in np.linspace(0,1,self.nsteps)[1:]:
+      t_np1 = self.tfinal * m
+      e_np1 = self.efinal * m
+
+      ts = model.make_trial_state(e_np1, e_n, self.T, self.T, t_np1, t_n,
+          s_n, h_n[:model.nhist])
+      x, n = solvers.solve(model, ts, return_iterations = True)
+      iters += n
+      
+      s_np1, h_np1, A_np1, u_np1, p_np1 = model.update_sd(e_np1, e_n, 
+          self.T, self.T, t_np1, t_n, s_n, h_n, 0.0, 0.0)
+      self.assertTrue(np.allclose(x[:6], s_np1))
+      stresses.append(s_np1)
+
+      e_n = e_np1
+      s_n = s_np1
+      h_n = h_np1
+      t_n = t_np1
+
+    return np.array(stresses), iters
+
+  def test_history(self):
+    nh = self.flow.nhist
+    self.assertEqual(self.models["none"].nhist, nh)
+    self.assertEqual(self.models["euler"].nhist, nh)
+    self.assertEqual(self.models["extrapolate"].nhist, 6 + 2 * nh)
+
+  def test_bad_predictor(self):
+    with self.assertRaises(ValueError):
+      models.GeneralIntegrator(self.elastic, self.flow, predictor = "wrong")
+
+  def test_elastic_step_rates(self):
+    # An instantaneous, elastic step leaves no stale rates to extrapolate
+    model = self.models["extrapolate"]
+    nh = self.flow.nhist
+    e_np1 = self.efinal / self.nsteps
+    s_np1, h_np1, A_np1, u_np1, p_np1 = model.update_sd(e_np1, np.zeros((6,)),
+        self.T, self.T, self.tfinal / self.nsteps, 0.0, np.zeros((6,)),
+        model.init_store(), 0.0, 0.0)
+    self.assertTrue(np.linalg.norm(h_np1[nh:model.nhist]) > 0)
+
+    s, h, A, u, p = model.update_sd(2 * e_np1, e_np1, self.T, self.T,
+        self.tfinal / self.nsteps, self.tfinal / self.nsteps, s_np1, h_np1,
+        u_np1, p_np1)
+    self.assertTrue(np.allclose(h[:nh], h_np1[:nh]))
+    self.assertTrue(np.allclose(h[nh:model.nhist], 0.0))
+
+  def test_predictors(self):
+    base, base_iters = self.run_model(self.models["none"])
+    for p in ["euler", "extrapolate"]:
+      res, iters = self.run_model(self.models[p])
+      self.assertTrue(np.allclose(res, base, rtol = 1.0e-4))
+    
+    # The extrapolation should be much closer to the solution
+    res, iters = self.run_model(self.models["extrapolate"])
+    self.assertTrue(iters < base_iters)
+
+  def test_broyden(self):
+    model = self.models["none"]
+    work = solvers.BroydenWorkspace()
+
+    t_n = 0.0
+    e_n = np.zeros((6,))
+    s_n = np.zeros((6,))
+    h_n = model.init_store()
+
+    iters = 0
+    for m in np.linspace(0,1,self.nsteps)[1:]:
+      t_np1 = self.tfinal * m
+      e_np1 = self.efinal * m
+
+      ts = model.make_trial_state(e_np1, e_n, self.T, self.T, t_np1, t_n,
+          s_n, h_n[:model.nhist])
+      x, n = solvers.broyden(model, ts, return_iterations = True, 
+          work = work)
+      iters += n
+      self.assertTrue(work.valid)
+      self.assertTrue(la.norm(model.R(x, ts)) < 1.0e-8)
+
+      s_np1, h_np1, A_np1, u_np1, p_np1 = model.update_sd(e_np1, e_n, 
+          self.T, self.T, t_np1, t_n, s_n, h_n, 0.0, 0.0)
+      self.assertTrue(np.allclose(x[:6], s_np1))
+
+      e_n = e_np1
+      s_n = s_np1
+      h_n = h_np1
+      t_n = t_np1
+
+    # The factors carry over between steps
+    self.assertTrue(work.factorizations < iters)
+
 class TestPerzynaJ2Voce(unittest.TestCase, CommonMatModel, CommonJacobian):
   """
     Perzyna associated viscoplasticity w/ voce kinematic hardening
@@ -300,6 +300,14 @@ class TestSolve(unittest.TestCase):
     print(self.b)
     self.assertTrue(np.allclose(x, self.b))
 
+  def test_solve_mixed(self):
+    x = la.solve(self.A, self.b)
+    # Unrefined solution is only good to about single precision
+    y = solve_mat_mixed(self.A, np.copy(self.b), nrefine = 0)
+    self.assertTrue(np.allclose(x, y, rtol = 1.0e-2))
+    y = solve_mat_mixed(self.A, np.copy(self.b), nrefine = 3)
+    self.assertTrue(np.allclose(x, y))
+
 class TestDiagSolve(unittest.TestCase):
   def setUp(self):
     self.n = 10
@@ -416,6 +424,47 @@ class TestEigenstuff(unittest.TestCase):
     for nv, mv in zip(tvecs,vecs):
       self.assertTrue(np.allclose(nv,mv) or np.allclose(nv,-mv))
 
+  def test_random_against_lapack(self):
+    for i in range(100):
+      S = (ra.random((6,)) - 0.5) * 10.0**ra.randint(-3, 4)
+      vals = np.array(eigenvalues_sym(S))
+      self.assertTrue(np.allclose(vals, la.eigvalsh(usym(S)),
+        rtol = 1.0e-12, atol = 1.0e-12 * la.norm(S)))
+
+      vecs = eigenvectors_sym(S)
+      self.assertTrue(np.allclose(np.dot(vecs, vecs.T), np.eye(3)))
+      self.assertTrue(np.allclose(np.dot(vecs, np.dot(usym(S), vecs.T)),
+        np.diag(vals), atol = 1.0e-12 * la.norm(S)))
+
+  def test_repeated(self):
+    Q = la.qr(ra.random((3,3)))[0]
+    for d in ([1.0, 1.0, 2.0], [-3.0, 5.0, 5.0], [4.0, 4.0, 4.0],
+        [0.0, 0.0, 0.0], [1.0, 1.0 + 1.0e-12, 2.0]):
+      S = sym(np.dot(Q, np.dot(np.diag(d), Q.T)))
+      vals = np.array(eigenvalues_sym(S))
+      self.assertTrue(np.allclose(vals, sorted(d), atol = 1.0e-12))
+
+      vecs = eigenvectors_sym(S)
+      self.assertTrue(np.allclose(np.dot(vecs, vecs.T), np.eye(3)))
+      self.assertTrue(np.allclose(np.dot(vecs, np.dot(usym(S), vecs.T)),
+        np.diag(vals), atol = 1.0e-12))
+
+  def test_derivatives(self):
+    vals, dvals = eigenvalue_derivatives_sym(self.S)
+    self.assertTrue(np.allclose(vals, eigenvalues_sym(self.S)))
+    for i in range(3):
+      nd = differentiate(lambda s: eigenvalues_sym(s)[i], self.S)
+      self.assertTrue(np.allclose(nd, dvals[i]))
+
+  def test_derivatives_repeated(self):
+    # The derivative of the mean of a repeated pair is unique
+    S = np.array([100.0, 100.0, -50.0, 0, 0, 0])
+    vals, dvals = eigenvalue_derivatives_sym(S)
+    nd = differentiate(lambda s: np.mean(eigenvalues_sym(s)[1:]), S)[0]
+    self.assertTrue(np.allclose(dvals[1], nd, atol = 1.0e-6))
+    self.assertTrue(np.allclose(dvals[2], nd, atol = 1.0e-6))
+    self.assertTrue(np.allclose(np.sum(dvals, axis = 0), [1,1,1,0,0,0]))
+
 class TestInvariants(unittest.TestCase):
   def setUp(self):
     self.S = np.array([50.0,-25.0,100.0,30.0,-180.0,90.0])
@@ -1,8 +1,40 @@
-from neml import solvers, interpolate, models, elasticity, ri_flow, hardening, surfaces, parse, visco_flow, general_flow, creep, damage
+from neml import solvers, interpolate, models, elasticity, ri_flow, hardening, surfaces, parse, visco_flow, general_flow, creep, damage, objects
 
 import unittest
 import numpy as np
 
+class TestInterning(unittest.TestCase):
+  def tearDown(self):
+    objects.set_interning(True)
+
+  def test_shared(self):
+    model1 = parse.parse_xml("test/examples.xml", "test_j2iso")
+    model2 = parse.parse_xml("test/examples.xml", "test_j2iso")
+    self.assertIsNot(model1, model2)
+    self.assertIs(model1.elastic, model2.elastic)
+    self.assertTrue(objects.interned_objects() > 0)
+
+  def test_off(self):
+    objects.set_interning(False)
+    self.assertFalse(objects.interning())
+    model1 = parse.parse_xml("test/examples.xml", "test_j2iso")
+    model2 = parse.parse_xml("test/examples.xml", "test_j2iso")
+    self.assertIsNot(model1.elastic, model2.elastic)
+
+  def test_python_not_shared(self):
+    a = interpolate.ConstantInterpolate(1.0)
+    b = interpolate.ConstantInterpolate(1.0)
+    self.assertIsNot(a, b)
+
+  def test_lattice_frozen(self):
+    model1 = parse.parse_xml("test/regression/reference.xml", "cp")
+    model2 = parse.parse_xml("test/regression/reference.xml", "cp")
+    self.assertIs(model1.lattice, model2.lattice)
+    self.assertTrue(model1.lattice.frozen)
+    with self.assertRaises(RuntimeError):
+      model1.lattice.add_slip_system([1,1,1],[1,1,0])
+    self.assertEqual(model2.lattice.ntotal, 12)
+
 class TestErrors(unittest.TestCase):
   def test_badobject(self):
     with self.assertRaises(RuntimeError):
@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+
+from neml import elasticity, drivers
+from neml.math import rotations
+from neml.cp import (crystallography, slipharden, sliprules, inelasticity,
+    kinematics, singlecrystal, polycrystal)
+
+import unittest
+import numpy as np
+
+class TestTaylorThreads(unittest.TestCase):
+  def setUp(self):
+    strength = slipharden.VoceSlipHardening(50.0, 2.5, 10.0)
+    slip = sliprules.PowerLawSlipRule(strength, 1.0, 3.0)
+    imodel = inelasticity.AsaroInelasticity(slip)
+    emodel = elasticity.IsotropicLinearElasticModel(100000.0, "youngs",
+        0.3, "poissons")
+    kmodel = kinematics.StandardKinematicModel(emodel, imodel)
+    lattice = crystallography.CubicLattice(1.0)
+    lattice.add_slip_system([1,1,0],[1,1,1])
+    self.model = singlecrystal.SingleCrystalModel(kmodel, lattice)
+    self.qs = rotations.random_orientations(7, 3)
+
+  def test_threads(self):
+    # The grain blocks do not divide evenly between the threads
+    res = []
+    for nthreads in [1, 3, 10]:
+      pmodel = polycrystal.TaylorModel(self.model, self.qs,
+          nthreads = nthreads)
+      res.append(drivers.uniaxial_test(pmodel, 1.0e-4, emax = 0.01,
+        nsteps = 10)['stress'])
+
+    for r in res[1:]:
+      self.assertTrue(np.allclose(res[0], r))
+
+  def test_orientations(self):
+    pmodel = polycrystal.TaylorModel(self.model, self.qs, nthreads = 3)
+    h = pmodel.init_store()
+    for q1, q2 in zip(pmodel.orientations(h), self.qs):
+      self.assertTrue(np.isclose(abs(np.dot(q1.quat, q2.inverse().quat)),
+        1.0))
+
+  def test_instanced(self):
+    qs = rotations.OrientationArray(self.qs)
+    pmodel = polycrystal.TaylorModel(self.model, qs, nthreads = 3)
+    self.assertEqual(pmodel.n, len(self.qs))
+    self.assertTrue(np.allclose(pmodel.initial_orientations.quats,
+      qs.quats))
+
+    other = polycrystal.TaylorModel(self.model, self.qs, nthreads = 3)
+    self.assertTrue(np.allclose(pmodel.init_store(), other.init_store()))
+    r1 = drivers.uniaxial_test(pmodel, 1.0e-4, emax = 0.01, nsteps = 10)
+    r2 = drivers.uniaxial_test(other, 1.0e-4, emax = 0.01, nsteps = 10)
+    self.assertTrue(np.allclose(r1['stress'], r2['stress']))
+
+class TestInteractionModels(unittest.TestCase):
+  def setUp(self):
+    strength = slipharden.VoceSlipHardening(50.0, 2.5, 10.0)
+    slip = sliprules.PowerLawSlipRule(strength, 1.0, 3.0)
+    imodel = inelasticity.AsaroInelasticity(slip)
+    emodel = elasticity.CubicLinearElasticModel(120000.0, 0.3, 29000.0,
+        "moduli")
+    kmodel = kinematics.StandardKinematicModel(emodel, imodel)
+    lattice = crystallography.CubicLattice(1.0)
+    lattice.add_slip_system([1,1,0],[1,1,1])
+    self.model = singlecrystal.SingleCrystalModel(kmodel, lattice)
+    self.qs = rotations.random_orientations(5, 11)
+
+    self.erate = 1.0e-4
+    self.emax = 0.01
+    self.nsteps = 10
+
+  def run_model(self, pmodel):
+    return drivers.uniaxial_test(pmodel, self.erate, emax = self.emax,
+        nsteps = self.nsteps)['stress']
+
+  def test_bounds(self):
+    taylor = self.run_model(polycrystal.TaylorModel(self.model, self.qs))
+    sc = self.run_model(polycrystal.SelfConsistentModel(self.model, self.qs))
+    sachs = self.run_model(polycrystal.SachsModel(self.model, self.qs))
+
+    self.assertTrue(np.all(sachs[1:] < sc[1:]))
+    self.assertTrue(np.all(sc[1:] < taylor[1:]))
+
+  def test_single_orientation(self):
+    qs = [self.qs[0]] * 3
+    taylor = self.run_model(polycrystal.TaylorModel(self.model, qs))
+    for M in [polycrystal.SachsModel, polycrystal.SelfConsistentModel]:
+      self.assertTrue(np.allclose(self.run_model(M(self.model, qs)), taylor))
+
+  def test_sc_unconverged(self):
+    pmodel = polycrystal.SelfConsistentModel(self.model, self.qs,
+        sc_miter = 1)
+    with self.assertRaises(RuntimeError):
+      self.run_model(pmodel)
+
+  def test_tangent(self):
+    pmodel = polycrystal.SachsModel(self.model, self.qs, rtol = 1.0e-12,
+        atol = 1.0e-12)
+    h_n = pmodel.init_store()
+    d_n = np.zeros(6)
+    w_n = np.zeros(3)
+    d_np1 = np.array([1.0e-4, -0.4e-4, -0.5e-4, 0.2e-4, 0.0, -0.1e-4])
+    w_np1 = np.array([0.0, 1.0e-5, 0.0])
+    s_n = np.zeros(6)
+
+    def update(d):
+      return pmodel.update_ld_inc(d, d_n, w_np1, w_n, 300.0, 300.0, 1.0, 0.0,
+          s_n, h_n, 0.0, 0.0)
+
+    s_np1, h_np1, A, B, u, p = update(d_np1)
+    Anum = np.zeros((6,6))
+    dx = 1.0e-8
+    for j in range(6):
+      dd = np.zeros(6)
+      dd[j] = dx
+      Anum[:,j] = (update(d_np1 + dd)[0] - update(d_np1 - dd)[0]) / (2 * dx)
+
+    self.assertTrue(np.allclose(A, Anum, rtol = 1.0e-4, atol = 1.0))
+
+  def test_polarization(self):
+    # Eshelby tensor of a sphere in an isotropic medium
+    K = 100000.0
+    mu = 40000.0
+    J = np.zeros((6,6))
+    J[:3,:3] = 1.0 / 3
+    D = np.eye(6) - J
+    L = 3 * K * J + 2 * mu * D
+
+    S = np.dot(polycrystal.sphere_polarization(L), L)
+    alpha = 3 * K / (3 * K + 4 * mu)
+    beta = 6 * (K + 2 * mu) / (5 * (3 * K + 4 * mu))
+    self.assertTrue(np.allclose(S, alpha * J + beta * D))
@@ -0,0 +1,112 @@
+import sys
+sys.path.append('..')
+
+from neml import models, elasticity, surfaces, hardening, ri_flow
+
+import unittest
+import os
+import tempfile
+import numpy as np
+
+class TestReplay(unittest.TestCase):
+  def setUp(self):
+    elastic = elasticity.IsotropicLinearElasticModel(92000.0, "youngs",
+        0.3, "poissons")
+    surface = surfaces.IsoJ2()
+    hrule = hardening.LinearIsotropicHardeningRule(180.0, 920.0)
+    flow = ri_flow.RateIndependentAssociativeFlow(surface, hrule)
+    self.model = models.SmallStrainRateIndependentPlasticity(elastic, flow)
+
+    fd, self.fname = tempfile.mkstemp(suffix = ".log")
+    os.close(fd)
+    os.remove(self.fname)
+
+  def tearDown(self):
+    self.model.recorder = None
+    if os.path.exists(self.fname):
+      os.remove(self.fname)
+
+  def run_steps(self, n = 10):
+    e_n = np.zeros((6,))
+    s_n = np.zeros((6,))
+    h_n = self.model.init_store()
+    u_n = 0.0
+    p_n = 0.0
+    stresses = []
+    for i in range(1, n+1):
+      e_np1 = np.array([0.0004 * i, -0.0002 * i, 0, 0.0001 * i, 0, 0])
+      s_n, h_n, A, u_n, p_n = self.model.update_sd(e_np1, e_n, 300.0, 300.0,
+          float(i), float(i-1), s_n, h_n, u_n, p_n)
+      e_n = e_np1
+      stresses.append(s_n)
+    return stresses
+
+  def test_all(self):
+    rec = models.UpdateRecorder(self.fname)
+    self.model.recorder = rec
+    stresses = self.run_steps()
+    self.assertEqual(rec.calls, 10)
+    self.assertEqual(rec.recorded, 10)
+
+    updates = models.read_update_log(self.fname)
+    self.assertEqual(len(updates), 10)
+    for u, s in zip(updates, stresses):
+      self.assertFalse(u.large)
+      self.assertTrue(np.allclose(u.s_np1, s))
+      self.assertTrue(np.allclose(models.replay_update(self.model, u), s))
+
+  def test_large(self):
+    self.model.recorder = models.UpdateRecorder(self.fname)
+    d_np1 = np.array([0.004, -0.002, 0, 0.001, 0, 0])
+    w_np1 = np.array([0.001, 0, 0])
+    s_np1, h_np1, A, B, u, p = self.model.update_ld_inc(d_np1, np.zeros((6,)),
+        w_np1, np.zeros((3,)), 300.0, 300.0, 1.0, 0.0, np.zeros((6,)),
+        self.model.init_store(), 0.0, 0.0)
+
+    update = models.read_update_log(self.fname)[0]
+    self.assertTrue(update.large)
+    self.assertTrue(np.allclose(update.w_np1, w_np1))
+    self.assertTrue(np.allclose(models.replay_update(self.model, update),
+      s_np1))
+
+  def test_sample(self):
+    rec = models.UpdateRecorder(self.fname, sample_every = 4,
+        time_threshold = 1.0e6)
+    self.model.recorder = rec
+    self.run_steps()
+    self.assertEqual(rec.recorded, 3)
+    self.assertEqual(len(models.read_update_log(self.fname)), 3)
+
+  def test_iterations(self):
+    rec = models.UpdateRecorder(self.fname, iteration_threshold = 1)
+    self.model.recorder = rec
+    self.run_steps()
+
+    # Only the plastic steps take any iterations
+    updates = models.read_update_log(self.fname)
+    self.assertTrue(0 < len(updates) < 10)
+    for u in updates:
+      self.assertTrue(u.iterations >= 1)
+
+  def test_stop(self):
+    self.model.recorder = models.UpdateRecorder(self.fname)
+    self.run_steps(2)
+    self.model.recorder = None
+    self.run_steps(2)
+    self.assertEqual(len(models.read_update_log(self.fname)), 2)
+
+  def test_wrong_model(self):
+    self.model.recorder = models.UpdateRecorder(self.fname)
+    self.run_steps(1)
+    elastic = models.SmallStrainElasticity(
+        elasticity.IsotropicLinearElasticModel(92000.0, "youngs", 0.3,
+          "poissons"))
+    update = models.read_update_log(self.fname)[0]
+    with self.assertRaises(ValueError):
+      models.replay_update(elastic, update)
+
+  def test_not_a_log(self):
+    with open(self.fname, "w") as f:
+      f.write("not a log")
+    with self.assertRaises(RuntimeError):
+      models.read_update_log(self.fname)
@@ -335,3 +335,30 @@ class TestOrientVectors(unittest.TestCase):
       v3 = q.apply(self.v1)
       self.assertEqual(self.v2,v3)
 
+
+class TestOrientationArray(unittest.TestCase):
+  def setUp(self):
+    self.qs = rotations.random_orientations(5, 11)
+
+  def test_from_list(self):
+    a = rotations.OrientationArray(self.qs)
+    self.assertEqual(len(a), 5)
+    for i, q in enumerate(self.qs):
+      self.assertTrue(np.allclose(a[i].quat, q.quat))
+
+  def test_from_quaternions(self):
+    quats = np.array([q.quat for q in self.qs])
+    a = rotations.OrientationArray(quats)
+    self.assertTrue(np.allclose(a.quats, quats))
+
+  def test_identity(self):
+    a = rotations.OrientationArray(3)
+    self.assertTrue(np.allclose(a.quats, [[1.0,0,0,0]]*3))
+
+  def test_set(self):
+    a = rotations.OrientationArray(2)
+    a[1] = self.qs[0]
+    self.assertTrue(np.allclose(a[1].quat, self.qs[0].quat))
+    self.assertTrue(np.allclose(a[0].quat, [1.0,0,0,0]))
+    with self.assertRaises(IndexError):
+      a[2]
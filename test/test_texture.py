@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+
+from neml import elasticity, drivers
+from neml.math import rotations, tensors
+from neml.cp import (crystallography, slipharden, sliprules, inelasticity,
+    kinematics, singlecrystal, polycrystal, texture)
+
+import unittest
+import numpy as np
+
+def angle(a, b):
+  return 2.0 * a.distance(b)
+
+class TestSampling(unittest.TestCase):
+  def setUp(self):
+    self.center = rotations.Orientation(35.0, 17.0, 14.0,
+        angle_type = "degrees")
+    self.width = 0.05
+    self.N = 200
+
+  def test_reproducible(self):
+    d = texture.UniformDistribution()
+    A = d.sample(self.N, 12)
+    B = d.sample(self.N, 12)
+    C = d.sample(self.N, 13)
+
+    self.assertTrue(all(np.allclose(a.quat, b.quat) for a, b in zip(A, B)))
+    self.assertFalse(all(np.allclose(a.quat, c.quat) for a, c in zip(A, C)))
+
+  def test_seeded_random_orientations(self):
+    A = rotations.random_orientations(self.N, 5)
+    B = rotations.random_orientations(self.N, 5)
+    self.assertTrue(all(np.allclose(a.quat, b.quat) for a, b in zip(A, B)))
+
+  def test_uniform_mean(self):
+    # The mean rotation matrix of a uniform distribution vanishes
+    qs = texture.UniformDistribution().sample(4000, 1)
+    R = np.mean([q.to_matrix() for q in qs], axis = 0)
+    self.assertTrue(np.all(np.abs(R) < 0.05))
+
+  def test_unimodal_spread(self):
+    d = texture.UnimodalDistribution(self.center, self.width)
+    qs = d.sample(self.N, 3)
+    self.assertTrue(all(np.isclose(np.linalg.norm(q.quat), 1.0) for q in qs))
+    angles = np.array([angle(q, self.center) for q in qs])
+    # Chi distribution with 3 degrees of freedom
+    self.assertAlmostEqual(np.mean(angles) / self.width,
+        2.0 * np.sqrt(2.0 / np.pi), delta = 0.1)
+
+  def test_fiber_alignment(self):
+    h = [1.0, 1.0, 1.0]
+    y = [0.0, 0.0, 1.0]
+    d = texture.FiberDistribution(h, y, 0.0)
+    hn = np.array(h) / np.linalg.norm(h)
+    for q in d.sample(20, 7):
+      self.assertTrue(np.allclose(q.apply(tensors.Vector(hn)).data, y))
+
+  def test_fiber_antiparallel(self):
+    d = texture.FiberDistribution([0, 0, 1.0], [0, 0, -1.0], 0.0)
+    for q in d.sample(5, 7):
+      self.assertTrue(np.allclose(
+        q.apply(tensors.Vector([0, 0, 1.0])).data, [0, 0, -1.0]))
+
+  def test_mixture(self):
+    other = rotations.Orientation(80.0, 40.0, 10.0, angle_type = "degrees")
+    d = texture.MixtureDistribution([
+      texture.UnimodalDistribution(self.center, 0.01),
+      texture.UnimodalDistribution(other, 0.01)], [3.0, 1.0])
+    qs = d.sample(1000, 9)
+    n1 = sum(angle(q, self.center) < angle(q, other) for q in qs)
+    self.assertAlmostEqual(n1 / 1000.0, 0.75, delta = 0.05)
+
+  def test_bad_weights(self):
+    with self.assertRaises(ValueError):
+      texture.MixtureDistribution([texture.UniformDistribution()], [1.0, 1.0])
+
+class TestReduction(unittest.TestCase):
+  def setUp(self):
+    self.sgroup = crystallography.SymmetryGroup("432")
+    self.centers = [
+        rotations.Orientation(10.0, 5.0, 3.0, angle_type = "degrees"),
+        rotations.Orientation(40.0, 30.0, 20.0, angle_type = "degrees"),
+        rotations.Orientation(70.0, 20.0, 60.0, angle_type = "degrees")]
+    self.width = 0.02
+    self.N = 60
+    self.qs = texture.MixtureDistribution(
+        [texture.UnimodalDistribution(c, self.width) for c in self.centers],
+        [1.0, 1.0, 2.0]).sample(self.N, 4)
+
+  def disorientation(self, a, b):
+    return 2.0 * self.sgroup.misorientation(a.inverse(), b.inverse()
+        ).distance(rotations.Orientation(np.array([1.0, 0, 0, 0])))
+
+  def test_weights(self):
+    w = np.linspace(1.0, 2.0, self.N)
+    res = texture.reduce_texture(self.qs, w, self.sgroup, 5, 2)
+    self.assertEqual(len(res.orientations), 5)
+    self.assertAlmostEqual(np.sum(res.weights), 1.0)
+    self.assertTrue(all(0 <= a < 5 for a in res.assignment))
+    for k in range(5):
+      wk = np.sum(w[np.array(res.assignment) == k]) / np.sum(w)
+      self.assertAlmostEqual(res.weights[k], wk)
+
+  def test_disorientation(self):
+    res = texture.reduce_texture(self.qs, [], self.sgroup, 3, 2)
+    dmax = max(self.disorientation(q, res.orientations[k])
+        for q, k in zip(self.qs, res.assignment))
+    self.assertAlmostEqual(res.max_disorientation, dmax)
+
+  def test_recover_centers(self):
+    # Symmetric equivalents of the samples should not split the clusters
+    ops = self.sgroup.ops
+    shuffled = [(ops[i % len(ops)] * q.inverse()).inverse()
+        for i, q in enumerate(self.qs)]
+    res = texture.reduce_texture(shuffled, [], self.sgroup, 3, 1)
+    self.assertTrue(res.max_disorientation < 5 * self.width)
+    for c in self.centers:
+      self.assertTrue(min(self.disorientation(c, r)
+        for r in res.orientations) < self.width)
+
+  def test_all_grains(self):
+    res = texture.reduce_texture(self.qs, [], self.sgroup, self.N, 0)
+    self.assertAlmostEqual(res.max_disorientation, 0.0)
+
+  def test_unconverged(self):
+    # Stopping early still assigns each grain to its closest representative
+    res = texture.reduce_texture(self.qs, [], self.sgroup, 5, 2, miter = 1)
+    for q, k in zip(self.qs, res.assignment):
+      d = [self.disorientation(q, r) for r in res.orientations]
+      self.assertAlmostEqual(d[k], min(d))
+    self.assertAlmostEqual(res.max_disorientation, max(
+      self.disorientation(q, res.orientations[k])
+      for q, k in zip(self.qs, res.assignment)))
+
+  def test_no_iterations(self):
+    with self.assertRaises(ValueError):
+      texture.reduce_texture(self.qs, [], self.sgroup, 3, miter = 0)
+
+  def test_zero_weights(self):
+    with self.assertRaises(ValueError):
+      texture.reduce_texture(self.qs, np.zeros(self.N), self.sgroup, 3)
+
+class TestWeightedTaylor(unittest.TestCase):
+  def setUp(self):
+    strength = slipharden.VoceSlipHardening(50.0, 2.5, 10.0)
+    slip = sliprules.PowerLawSlipRule(strength, 1.0, 3.0)
+    imodel = inelasticity.AsaroInelasticity(slip)
+    emodel = elasticity.IsotropicLinearElasticModel(100000.0, "youngs",
+        0.3, "poissons")
+    kmodel = kinematics.StandardKinematicModel(emodel, imodel)
+    lattice = crystallography.CubicLattice(1.0)
+    lattice.add_slip_system([1,1,0],[1,1,1])
+    self.model = singlecrystal.SingleCrystalModel(kmodel, lattice)
+    self.qs = rotations.random_orientations(4, 1)
+
+  def test_duplicates(self):
+    full = polycrystal.TaylorModel(self.model,
+        [self.qs[0], self.qs[0], self.qs[0], self.qs[1], self.qs[2]])
+    weighted = polycrystal.TaylorModel(self.model, self.qs[:3],
+        weights = [3.0, 1.0, 1.0])
+    self.assertAlmostEqual(weighted.weight(0), 0.6)
+
+    r1 = drivers.uniaxial_test(full, 1.0e-4, emax = 0.01, nsteps = 20)
+    r2 = drivers.uniaxial_test(weighted, 1.0e-4, emax = 0.01, nsteps = 20)
+    self.assertTrue(np.allclose(r1['stress'], r2['stress']))
+
+  def test_bad_weights(self):
+    with self.assertRaises(ValueError):
+      polycrystal.TaylorModel(self.model, self.qs, weights = [1.0])
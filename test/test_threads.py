@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+
+from neml import parse, models, damage, elasticity, surfaces, hardening, visco_flow, general_flow
+from neml.cp import singlecrystal, polycrystal
+
+import unittest
+import xml.etree.ElementTree as ET
+import numpy as np
+
+# One or more models of each registered model type
+model_file = "util/stress/models.xml"
+
+class TestSharedModelThreads(unittest.TestCase):
+  """
+    Every model, shared by many threads, gives bitwise the same results
+    as the same model run serially
+  """
+  def setUp(self):
+    self.names = [c.tag for c in ET.parse(model_file).getroot()]
+    self.N = 16
+    self.nthreads = 8
+
+    rng = np.random.default_rng(7)
+    self.e_np1 = rng.uniform(-0.004, 0.004, size = (self.N, 6))
+    self.e_n = np.zeros((self.N,6))
+    self.w_np1 = rng.uniform(-0.001, 0.001, size = (self.N, 3))
+    self.w_n = np.zeros((self.N,3))
+    self.T_np1 = np.full((self.N,), 510.0)
+    self.T_n = np.full((self.N,), 500.0)
+    self.t_np1 = 1.0
+    self.t_n = 0.0
+    self.s_n = np.zeros((self.N,6))
+    self.u_n = np.zeros((self.N,))
+    self.p_n = np.zeros((self.N,))
+
+  def sd(self, model, nthreads):
+    return model.update_sd_batch(self.e_np1, self.e_n, self.T_np1, self.T_n,
+        self.t_np1, self.t_n, self.s_n, model.init_store_batch(self.N),
+        self.u_n, self.p_n, nthreads = nthreads)
+
+  def ld_inc(self, model, nthreads):
+    return model.update_ld_inc_batch(self.e_np1, self.e_n, self.w_np1,
+        self.w_n, self.T_np1, self.T_n, self.t_np1, self.t_n, self.s_n,
+        model.init_store_batch(self.N), self.u_n, self.p_n,
+        nthreads = nthreads)
+
+  def test_sd(self):
+    for name in self.names:
+      model = parse.parse_xml(model_file, name)
+      serial = self.sd(model, 1)
+      threaded = self.sd(model, self.nthreads)
+      for a, b in zip(serial, threaded):
+        self.assertTrue(np.array_equal(a, b), msg = name)
+
+  def test_ld_inc(self):
+    for name in self.names:
+      model = parse.parse_xml(model_file, name)
+      serial = self.ld_inc(model, 1)
+      threaded = self.ld_inc(model, self.nthreads)
+      for a, b in zip(serial, threaded):
+        self.assertTrue(np.array_equal(a, b), msg = name)
+
+class TestGeneralIntegratorThreadStats(unittest.TestCase):
+  """
+    The path statistics of a shared GeneralIntegrator add up over the
+    threads
+  """
+  def setUp(self):
+    self.N = 40
+
+    E = 92000.0
+    nu = 0.3
+    elastic = elasticity.IsotropicLinearElasticModel(E, "youngs",
+        nu, "poissons")
+
+    surface = surfaces.IsoJ2()
+    iso = hardening.LinearIsotropicHardeningRule(100.0, 1000.0)
+    vmodel = visco_flow.PerzynaFlowRule(surface, iso,
+        visco_flow.GPowerLaw(5.0, 500.0))
+    flow = general_flow.TVPFlowRule(elastic, vmodel)
+
+    self.model = models.GeneralIntegrator(elastic, flow,
+        adaptive_explicit = True)
+
+  def test_counts(self):
+    rng = np.random.default_rng(3)
+    e_np1 = rng.uniform(-1.0e-4, 1.0e-4, size = (self.N, 6))
+    self.model.update_sd_batch(e_np1, np.zeros((self.N,6)),
+        np.full((self.N,), 300.0), np.full((self.N,), 300.0), 1.0, 0.0,
+        np.zeros((self.N,6)), self.model.init_store_batch(self.N),
+        np.zeros((self.N,)), np.zeros((self.N,)), nthreads = 4)
+    stats = self.model.stats
+    self.assertEqual(stats.explicit_steps + stats.implicit_steps, self.N)
+
+    self.model.reset_stats()
+    self.assertEqual(self.model.stats.explicit_steps, 0)
+    self.assertEqual(self.model.stats.implicit_steps, 0)
@@ -0,0 +1,63 @@
+import sys
+sys.path.append('..')
+
+from neml import objects, models, elasticity, surfaces, hardening, ri_flow
+
+import unittest
+import json
+import os
+import tempfile
+import numpy as np
+
+class TestTrace(unittest.TestCase):
+  def setUp(self):
+    elastic = elasticity.IsotropicLinearElasticModel(92000.0, "youngs",
+        0.3, "poissons")
+    surface = surfaces.IsoJ2()
+    hrule = hardening.LinearIsotropicHardeningRule(180.0, 920.0)
+    flow = ri_flow.RateIndependentAssociativeFlow(surface, hrule)
+    self.model = models.SmallStrainRateIndependentPlasticity(elastic, flow)
+
+    objects.clear_trace()
+
+  def tearDown(self):
+    objects.stop_tracing()
+    objects.clear_trace()
+
+  def update(self):
+    self.model.update_sd(np.array([0.01,0,0,0,0,0]), np.zeros((6,)), 300.0,
+        300.0, 1.0, 0.0, np.zeros((6,)), self.model.init_store(), 0.0, 0.0)
+
+  def test_start_stop(self):
+    self.assertFalse(objects.tracing())
+    objects.start_tracing()
+    self.assertTrue(objects.tracing())
+    objects.stop_tracing()
+    self.assertFalse(objects.tracing())
+
+  def test_not_running(self):
+    self.update()
+    self.assertEqual(objects.trace_events(), 0)
+
+  def test_write(self):
+    objects.start_tracing()
+    self.update()
+    objects.stop_tracing()
+
+    fd, fname = tempfile.mkstemp(suffix = ".json")
+    os.close(fd)
+    try:
+      objects.write_trace(fname)
+      with open(fname) as f:
+        events = json.load(f)["traceEvents"]
+    finally:
+      os.remove(fname)
+
+    names = [e["name"] for e in events if e["ph"] == "X"]
+    self.assertEqual(len(names), objects.trace_events())
+    if objects.tracing_compiled():
+      self.assertTrue("update_sd" in names)
+      self.assertTrue("solve" in names)
+      self.assertTrue("RJ" in names)
+    else:
+      self.assertEqual(len(names), 0)
@@ -198,6 +198,36 @@ class CommonFlowRule(object):
 
     self.assertTrue(np.allclose(num, exact, rtol = 1.0e-3))
 
+  def test_evaluate(self):
+    hist = self.gen_hist()
+    Tdot = 10.0
+
+    # Both flowing and inside the flow surface
+    for stress in [self.gen_stress(), 0.01 * self.gen_stress()]:
+      args = (stress, hist, self.T)
+      y = self.model.y(*args)
+      g = self.model.g(*args)
+      h = self.model.h(*args)
+      dy_ds = self.model.dy_ds(*args)
+      dy_da = self.model.dy_da(*args)
+
+      should = (
+          y * g + Tdot * self.model.g_temp(*args) + self.model.g_time(*args),
+          y * self.model.dg_ds(*args) + np.outer(g, dy_ds)
+          + Tdot * self.model.dg_ds_temp(*args) + self.model.dg_ds_time(*args),
+          y * self.model.dg_da(*args) + np.outer(g, dy_da)
+          + Tdot * self.model.dg_da_temp(*args) + self.model.dg_da_time(*args),
+          y * h + Tdot * self.model.h_temp(*args) + self.model.h_time(*args),
+          y * self.model.dh_ds(*args) + np.outer(h, dy_ds)
+          + Tdot * self.model.dh_ds_temp(*args) + self.model.dh_ds_time(*args),
+          y * self.model.dh_da(*args) + np.outer(h, dy_da)
+          + Tdot * self.model.dh_da_temp(*args) + self.model.dh_da_time(*args))
+      actual = self.model.evaluate(stress, hist, self.T, Tdot)
+
+      self.assertEqual(len(actual), len(should))
+      for a, b in zip(actual, should):
+        self.assertTrue(np.allclose(a, b))
+
 
 class TestPerzynaIsoJ2Voce(unittest.TestCase, CommonFlowRule):
   def setUp(self):
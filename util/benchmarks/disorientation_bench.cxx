@@ -0,0 +1,72 @@
+// Time the batched disorientation kernels against SymmetryGroup::misorientation
+
+#include "cp/crystallography.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace neml;
+
+/// Seconds since start
+double since(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 3) {
+    printf("Expected at most 2 arguments:\n");
+    printf("\tnumber of orientations\n");
+    printf("\tnumber of threads.\n");
+    return -1;
+  }
+  size_t n = (argc >= 2) ? std::atoi(argv[1]) : 1000;
+  int nthreads = (argc == 3) ? std::atoi(argv[2]) : 1;
+
+  SymmetryGroup group("432");
+  auto qs = random_orientations(2*n, 42);
+  std::vector<double> A(4*n), B(4*n);
+  for (size_t i = 0; i < n; i++) {
+    std::copy(qs[i].quat(), qs[i].quat() + 4, &A[4*i]);
+    std::copy(qs[n+i].quat(), qs[n+i].quat() + 4, &B[4*i]);
+  }
+
+  // Pairs through the Orientation interface
+  auto start = std::chrono::steady_clock::now();
+  double check = 0.0;
+  for (size_t i = 0; i < n; i++) {
+    check += group.misorientation(qs[i], qs[n+i]).distance(Orientation(
+            std::vector<double>({1,0,0,0})));
+  }
+  double t_old = since(start);
+
+  std::vector<double> paired(n);
+  start = std::chrono::steady_clock::now();
+  group.disorientation_angles_paired(&A[0], &B[0], n, &paired[0], nthreads);
+  double t_paired = since(start);
+
+  double err = 0.0;
+  for (size_t i = 0; i < n; i++) {
+    double angle = 2.0 * group.misorientation(qs[i], qs[n+i]).distance(
+        Orientation(std::vector<double>({1,0,0,0})));
+    err = std::max(err, fabs(angle - paired[i]));
+  }
+  printf("max difference from misorientation: %g (check %g)\n", err, check);
+
+  std::vector<double> all(n*n);
+  start = std::chrono::steady_clock::now();
+  group.disorientation_angles(&A[0], n, &B[0], n, &all[0], nthreads);
+  double t_all = since(start);
+
+  printf("misorientation:               %8.1f ns/pair\n", 1e9 * t_old / n);
+  printf("disorientation_angles_paired: %8.1f ns/pair\n", 1e9 * t_paired / n);
+  printf("disorientation_angles:        %8.1f ns/pair\n",
+         1e9 * t_all / (n * n));
+
+  return 0;
+}
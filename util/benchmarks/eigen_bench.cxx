@@ -0,0 +1,94 @@
+// Time the 3x3 symmetric eigensolver against LAPACK dsyev
+
+#include "math/nemlmath.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+using namespace neml;
+
+/// Time n calls of fn over a set of matrices, report ns per call
+double time_call(int n, const std::vector<double> & mats,
+                 std::function<int(const double * const)> fn)
+{
+  size_t nm = mats.size() / 6;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++) {
+    if (fn(&mats[6*(i % nm)]) != 0) {
+      throw std::runtime_error("Eigensolve failed");
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / n;
+}
+
+int lapack_values(const double * const s, double * const values)
+{
+  double F[9];
+  usym(s, F);
+  double work[15];
+  int info = 0;
+  dsyev_("N", "U", 3, F, 3, values, work, 15, info);
+  return info;
+}
+
+int lapack_vectors(const double * const s, double * const vectors)
+{
+  double values[3];
+  usym(s, vectors);
+  double work[15];
+  int info = 0;
+  dsyev_("V", "U", 3, vectors, 3, values, work, 15, info);
+  return info;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 2) {
+    printf("Expected at most 1 argument:\n");
+    printf("\tnumber of calls to time.\n");
+    return -1;
+  }
+  int n = (argc == 2) ? std::atoi(argv[1]) : 1000000;
+
+  // A fixed set of stress states, one in ten with repeated eigenvalues
+  std::vector<double> mats(6*100);
+  srand(42);
+  for (auto & s : mats) s = 200.0 * ((double) rand() / RAND_MAX - 0.5);
+  for (size_t i = 0; i < 100; i += 10) {
+    mats[6*i+1] = mats[6*i];
+    std::fill(&mats[6*i+3], &mats[6*i+6], 0.0);
+  }
+
+  // Accuracy against LAPACK
+  double err = 0.0;
+  for (size_t i = 0; i < 100; i++) {
+    double v1[3], v2[3];
+    eigenvalues_sym(&mats[6*i], v1);
+    lapack_values(&mats[6*i], v2);
+    for (int j = 0; j < 3; j++) {
+      err = std::max(err, fabs(v1[j] - v2[j]) / norm2_vec(&mats[6*i], 6));
+    }
+  }
+  printf("max relative eigenvalue difference from LAPACK: %g\n", err);
+
+  double values[3], vectors[9], dvalues[18];
+  printf("eigenvalues_sym:            %8.1f ns\n", time_call(n, mats,
+          [&](const double * const s) {return eigenvalues_sym(s, values);}));
+  printf("dsyev values:               %8.1f ns\n", time_call(n, mats,
+          [&](const double * const s) {return lapack_values(s, values);}));
+  printf("eigenvectors_sym:           %8.1f ns\n", time_call(n, mats,
+          [&](const double * const s) {return eigenvectors_sym(s, vectors);}));
+  printf("dsyev vectors:              %8.1f ns\n", time_call(n, mats,
+          [&](const double * const s) {return lapack_vectors(s, vectors);}));
+  printf("eigenvalue_derivatives_sym: %8.1f ns\n", time_call(n, mats,
+          [&](const double * const s) {
+            return eigenvalue_derivatives_sym(s, values, dvalues);}));
+
+  return 0;
+}
@@ -0,0 +1,127 @@
+// Time the fused GeneralFlowRule::evaluate against the separate rate and
+// partial calls it replaces in GeneralIntegrator::RJ
+
+#include "parse.h"
+#include "general_flow.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace neml;
+
+static const char * rule = R"(
+<rule type="TVPFlowRule">
+  <elastic type="IsotropicLinearElasticModel">
+    <m1>60384.61</m1>
+    <m1_type>shear</m1_type>
+    <m2>130833.3</m2>
+    <m2_type>bulk</m2_type>
+  </elastic>
+  <flow type="ChabocheFlowRule">
+    <surface type="IsoKinJ2"/>
+    <hardening type="Chaboche">
+      <iso type="VoceIsotropicHardeningRule">
+        <s0>0.0</s0>
+        <R>-80.0</R>
+        <d>3.0</d>
+      </iso>
+      <C>
+        <C1>135.0e3</C1>
+        <C2>61.0e3</C2>
+        <C3>11.0e3</C3>
+      </C>
+      <gmodels>
+        <g1 type="ConstantGamma">
+          <g>5.0e4</g>
+        </g1>
+        <g2 type="ConstantGamma">
+          <g>1100.0</g>
+        </g2>
+        <g3 type="ConstantGamma">
+          <g>1.0</g>
+        </g3>
+      </gmodels>
+      <A>
+        <A1>0.0</A1>
+        <A2>0.0</A2>
+        <A3>0.0</A3>
+      </A>
+      <a>
+        <a1>1.0</a1>
+        <a2>1.0</a2>
+        <a3>1.0</a3>
+      </a>
+    </hardening>
+    <fluidity type="ConstantFluidity">
+      <eta>701.0</eta>
+    </fluidity>
+    <n>10.5</n>
+  </flow>
+</rule>
+)";
+
+int main(int argc, char** argv)
+{
+  if (argc > 2) {
+    printf("Expected at most 1 argument:\n");
+    printf("\tnumber of evaluations.\n");
+    return -1;
+  }
+  int n = (argc == 2) ? std::atoi(argv[1]) : 100000;
+
+  std::vector<char> buffer(rule, rule + strlen(rule) + 1);
+  rapidxml::xml_document<> doc;
+  doc.parse<0>(&buffer[0]);
+  auto model = std::dynamic_pointer_cast<GeneralFlowRule>(
+      get_object(doc.first_node()));
+
+  size_t nh = model->nhist();
+  std::vector<double> h(nh);
+  model->init_hist(&h[0]);
+  for (size_t i = 1; i < nh; i++) h[i] = 10.0 * std::sin(double(i));
+  double s[6] = {200.0, -50.0, 25.0, 10.0, -5.0, 30.0};
+  double edot[6] = {1.0e-3, -5.0e-4, -5.0e-4, 0.0, 0.0, 0.0};
+  double T = 300.0;
+  double Tdot = 0.0;
+
+  std::vector<double> sep(6 + 36 + 6*nh + nh + nh*6 + nh*nh);
+  std::vector<double> fused(sep.size());
+  std::vector<double> work(model->nwork());
+
+  auto call_sep = [&](double * out) {
+    model->s(s, &h[0], edot, T, Tdot, out);
+    model->ds_ds(s, &h[0], edot, T, Tdot, out+6);
+    model->ds_da(s, &h[0], edot, T, Tdot, out+42);
+    model->a(s, &h[0], edot, T, Tdot, out+42+6*nh);
+    model->da_ds(s, &h[0], edot, T, Tdot, out+42+7*nh);
+    model->da_da(s, &h[0], edot, T, Tdot, out+42+13*nh);
+  };
+  auto call_fused = [&](double * out) {
+    model->evaluate(s, &h[0], edot, T, Tdot, out, out+6, out+42,
+                    out+42+6*nh, out+42+7*nh, out+42+13*nh, &work[0]);
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++) call_sep(&sep[0]);
+  double t1 = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++) call_fused(&fused[0]);
+  double t2 = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  double err = 0.0;
+  for (size_t i = 0; i < sep.size(); i++) {
+    err = std::max(err, fabs(sep[i] - fused[i]) / (1.0 + fabs(sep[i])));
+  }
+  printf("max relative difference: %g\n", err);
+  printf("separate calls: %8.3f us per evaluation\n", t1 / n * 1.0e6);
+  printf("evaluate:       %8.3f us per evaluation\n", t2 / n * 1.0e6);
+
+  return 0;
+}
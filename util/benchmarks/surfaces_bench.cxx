@@ -0,0 +1,79 @@
+// Time the yield surface calls used in the rate independent return maps
+
+#include "surfaces.h"
+#include "interpolate.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace neml;
+
+/// Time n calls of fn over a set of stress states, report ns per call
+double time_call(int n, const std::vector<double> & stresses,
+                 std::function<int(const double * const)> fn)
+{
+  size_t ns = stresses.size() / 6;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++) {
+    if (fn(&stresses[6*(i % ns)]) != 0) {
+      throw std::runtime_error("Surface evaluation failed");
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / n;
+}
+
+void bench(const std::string & name, YieldSurface & surface, int n,
+           const std::vector<double> & stresses)
+{
+  double q[1] = {50.0};
+  double T = 300.0;
+  double fv;
+  double d[36];
+
+  printf("%s\n", name.c_str());
+  printf("\tf:       %8.1f ns\n", time_call(n, stresses,
+          [&](const double * const s) {return surface.f(s, q, T, fv);}));
+  printf("\tdf_ds:   %8.1f ns\n", time_call(n, stresses,
+          [&](const double * const s) {return surface.df_ds(s, q, T, d);}));
+  printf("\tdf_dq:   %8.1f ns\n", time_call(n, stresses,
+          [&](const double * const s) {return surface.df_dq(s, q, T, d);}));
+  printf("\tdf_dsds: %8.1f ns\n", time_call(n, stresses,
+          [&](const double * const s) {return surface.df_dsds(s, q, T, d);}));
+  printf("\tdf_dqdq: %8.1f ns\n", time_call(n, stresses,
+          [&](const double * const s) {return surface.df_dqdq(s, q, T, d);}));
+  printf("\tdf_dsdq: %8.1f ns\n", time_call(n, stresses,
+          [&](const double * const s) {return surface.df_dsdq(s, q, T, d);}));
+  printf("\tdf_dqds: %8.1f ns\n", time_call(n, stresses,
+          [&](const double * const s) {return surface.df_dqds(s, q, T, d);}));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 2) {
+    printf("Expected at most 1 argument:\n");
+    printf("\tnumber of calls to time.\n");
+    return -1;
+  }
+  int n = (argc == 2) ? std::atoi(argv[1]) : 1000000;
+
+  // A fixed set of stress states so the timing is repeatable
+  std::vector<double> stresses(6*100);
+  srand(42);
+  for (auto & s : stresses) s = 200.0 * ((double) rand() / RAND_MAX - 0.5);
+
+  IsoJ2 j2;
+  bench("IsoJ2", j2, n, stresses);
+
+  IsoJ2I1 j2i1(std::make_shared<ConstantInterpolate>(10.0),
+               std::make_shared<ConstantInterpolate>(1.5));
+  bench("IsoJ2I1", j2i1, n, stresses);
+
+  return 0;
+}
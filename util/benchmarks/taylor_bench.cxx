@@ -0,0 +1,126 @@
+// Time TaylorModel updates called from inside and outside of an element loop
+
+#include "parse.h"
+#include "cp/polycrystal.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+using namespace neml;
+
+static const char * crystal = R"(
+<crystal type="SingleCrystalModel">
+  <kinematics type="StandardKinematicModel">
+    <emodel type="IsotropicLinearElasticModel">
+      <m1_type>youngs</m1_type>
+      <m1>100000.0</m1>
+      <m2_type>poissons</m2_type>
+      <m2>0.25</m2>
+    </emodel>
+    <imodel type="AsaroInelasticity">
+      <rule type="PowerLawSlipRule">
+        <resistance type="VoceSlipHardening">
+          <tau_sat>50.0</tau_sat>
+          <b>10.0</b>
+          <tau_0>50.0</tau_0>
+        </resistance>
+        <gamma0>1.0</gamma0>
+        <n>12.0</n>
+      </rule>
+    </imodel>
+  </kinematics>
+  <lattice type="CubicLattice">
+    <a>1.0</a>
+    <slip_systems>
+      1 1 0 ; 1 1 1
+    </slip_systems>
+  </lattice>
+</crystal>
+)";
+
+/// Update every element for nsteps, optionally threading over the elements
+double run(TaylorModel & model, size_t nelem, int nsteps, bool outer,
+           int nthreads, std::vector<double> & stress)
+{
+  size_t nh = model.nstore();
+  std::vector<double> h_n(nh * nelem), h_np1(nh * nelem);
+  std::vector<double> s_n(6 * nelem, 0.0), s_np1(6 * nelem, 0.0);
+  double d[6] = {0.01, -0.005, -0.005, 0.0, 0.0, 0.0};
+  double w[3] = {0.0, 0.0, 0.0};
+  double dt = 1.0;
+
+  auto start = std::chrono::steady_clock::now();
+
+#ifdef USE_OMP
+#pragma omp parallel for schedule(static) if(outer) num_threads(nthreads)
+#endif
+  for (size_t e = 0; e < nelem; e++) {
+    model.init_store(&h_n[e*nh]);
+  }
+
+  for (int i = 0; i < nsteps; i++) {
+#ifdef USE_OMP
+#pragma omp parallel for schedule(static) if(outer) num_threads(nthreads)
+#endif
+    for (size_t e = 0; e < nelem; e++) {
+      double A[36], B[18], u, p;
+      model.update_ld_inc(d, d, w, w, 300.0, 300.0, (i+1)*dt, i*dt,
+                          &s_np1[6*e], &s_n[6*e], &h_np1[e*nh], &h_n[e*nh],
+                          A, B, u, 0.0, p, 0.0);
+    }
+    std::swap(h_n, h_np1);
+    std::swap(s_n, s_np1);
+  }
+
+  stress = s_n;
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 4) {
+    printf("Expected at most 3 arguments:\n");
+    printf("\tnumber of elements\n");
+    printf("\tnumber of grains per element\n");
+    printf("\tnumber of threads.\n");
+    return -1;
+  }
+  size_t nelem = (argc >= 2) ? std::atoi(argv[1]) : 16;
+  int ngrain = (argc >= 3) ? std::atoi(argv[2]) : 64;
+  int nthreads = (argc == 4) ? std::atoi(argv[3]) : 4;
+  int nsteps = 5;
+
+  auto smodel = std::dynamic_pointer_cast<SingleCrystalModel>(
+      parse_string(crystal));
+  std::vector<std::shared_ptr<Orientation>> qs;
+  for (auto & q : random_orientations(ngrain, 42)) {
+    qs.push_back(std::make_shared<Orientation>(q));
+  }
+
+  TaylorModel inner(smodel, qs, nthreads);
+  TaylorModel serial(smodel, qs, 1);
+
+  std::vector<double> s1, s2, s3;
+  double t1 = run(inner, nelem, nsteps, false, nthreads, s1);
+  double t2 = run(inner, nelem, nsteps, true, nthreads, s2);
+  double t3 = run(serial, nelem, nsteps, true, nthreads, s3);
+
+  double err = 0.0;
+  for (size_t i = 0; i < s1.size(); i++) {
+    err = std::max(err, std::max(fabs(s1[i] - s2[i]), fabs(s1[i] - s3[i])));
+  }
+  printf("max stress difference between modes: %g\n", err);
+  printf("threads over grains:                  %8.3f s\n", t1);
+  printf("threads over elements, grain tasks:   %8.3f s\n", t2);
+  printf("threads over elements, serial grains: %8.3f s\n", t3);
+
+  return 0;
+}
@@ -75,4 +75,24 @@
                   integer, intent(out) :: ier
 
             end subroutine
+
+            subroutine record_nemlmodel(model, fname, sample_every,
+     &                  time_threshold, iteration_threshold, ier)
+     &                  bind(C)
+                  use iso_c_binding
+                  implicit none
+                  type(c_ptr), value :: model
+                  character(kind=c_char) :: fname(*)
+                  integer, intent(in), value :: sample_every,
+     &                  iteration_threshold
+                  double precision, intent(in), value :: time_threshold
+                  integer, intent(out) :: ier
+            end subroutine
+
+            subroutine stop_recording_nemlmodel(model, ier) bind(C)
+                  use iso_c_binding
+                  implicit none
+                  type(c_ptr), value :: model
+                  integer, intent(out) :: ier
+            end subroutine
       end interface
@@ -0,0 +1,63 @@
+// Rerun the updates captured by an UpdateRecorder, one at a time, so a
+// slow point from a large run can be profiled on its own
+
+#include "parse.h"
+#include "replay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace neml;
+
+int main(int argc, char** argv)
+{
+  if ((argc < 4) || (argc > 6)) {
+    printf("Expected 3 to 5 arguments:\n");
+    printf("\tXML file, model name, update log, "
+           "[repeats (1)], [only this record]\n");
+    return -1;
+  }
+
+  std::unique_ptr<NEMLModel> model = parse_xml_unique(argv[1], argv[2]);
+  std::vector<RecordedUpdate> updates = read_update_log(argv[3]);
+  int repeats = (argc > 4) ? std::atoi(argv[4]) : 1;
+  long only = (argc > 5) ? std::atol(argv[5]) : -1;
+
+  model->collect_solver_stats();
+
+  printf("%6s %4s %12s %12s %8s %8s %5s %12s\n", "record", "type",
+         "recorded(s)", "replay(s)", "rec.its", "its", "ier", "max ds");
+  for (size_t i = 0; i < updates.size(); i++) {
+    if ((only >= 0) && (i != (size_t) only)) continue;
+    const RecordedUpdate & rec = updates[i];
+
+    // Report the fastest of the repeats
+    double best = 0.0;
+    int ier = 0;
+    std::vector<double> s_np1;
+    model->reset_solver_stats();
+    for (int j = 0; j < repeats; j++) {
+      auto start = std::chrono::steady_clock::now();
+      ier = replay_update(*model, rec, s_np1);
+      double time = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - start).count();
+      if ((j == 0) || (time < best)) best = time;
+    }
+    size_t its = model->solver_stats().iterations / std::max(repeats, 1);
+
+    double ds = 0.0;
+    for (size_t k = 0; k < 6; k++) {
+      ds = std::max(ds, std::fabs(s_np1[k] - rec.s_np1[k]));
+    }
+
+    printf("%6zu %4s %12.4e %12.4e %8zu %8zu %5d %12.4e\n", i,
+           rec.large ? "ld" : "sd", rec.time, best, rec.iterations, its, ier,
+           ds);
+  }
+
+  return 0;
+}
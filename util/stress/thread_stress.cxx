@@ -0,0 +1,179 @@
+// Run every model in an XML file from many threads at once, all sharing one
+// const model object, and check the results are bitwise identical to a
+// serial run
+
+#include "parse.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace neml;
+
+static const size_t npoints = 64;
+static const int nsteps = 10;
+
+/// Everything the updates of one point return, step after step
+typedef std::vector<double> PointResults;
+
+static void append(PointResults & res, const double * const v, size_t n)
+{
+  res.insert(res.end(), v, v + n);
+}
+
+/// A fixed, point dependent direction for the strain or deformation rate
+static void direction(size_t point, double * const e)
+{
+  // Small linear congruential sequence, so the loading is reproducible
+  unsigned long x = 12345 + 7919 * point;
+  for (size_t i = 0; i < 6; i++) {
+    x = (1103515245 * x + 12345) % 2147483648UL;
+    e[i] = (double) x / 2147483648.0 - 0.5;
+  }
+  e[0] += 1.0;
+}
+
+/// Drive one point through nsteps small strain or large deformation updates
+static PointResults run_point(const NEMLModel & model, size_t point,
+                              bool large)
+{
+  size_t nh = model.nstore();
+  std::vector<double> h_n(nh), h_np1(nh);
+  double s_n[6] = {0.0}, s_np1[6], A[36], B[18];
+  double e_n[6] = {0.0}, e_np1[6], dir[6], w[3];
+  double u_n = 0.0, p_n = 0.0, u_np1, p_np1;
+  double rate = 2.0e-3;
+
+  direction(point, dir);
+  for (size_t i = 0; i < 3; i++) w[i] = 0.1 * rate * dir[i+3];
+
+  PointResults res;
+  model.init_store(&h_n[0]);
+  for (int i = 0; i < nsteps; i++) {
+    double t_n = i, t_np1 = i + 1;
+    double T_n = 500.0 + 10.0 * i, T_np1 = T_n + 10.0;
+    int ier;
+    if (large) {
+      for (size_t j = 0; j < 6; j++) e_np1[j] = rate * dir[j];
+      ier = model.update_ld_inc(e_np1, e_np1, w, w, T_np1, T_n, t_np1, t_n,
+                                s_np1, s_n, &h_np1[0], &h_n[0], A, B,
+                                u_np1, u_n, p_np1, p_n);
+    }
+    else {
+      for (size_t j = 0; j < 6; j++) e_np1[j] = e_n[j] + rate * dir[j];
+      ier = model.update_sd(e_np1, e_n, T_np1, T_n, t_np1, t_n, s_np1, s_n,
+                            &h_np1[0], &h_n[0], A, u_np1, u_n, p_np1, p_n);
+    }
+
+    res.push_back(ier);
+    if (ier != 0) break;
+    append(res, s_np1, 6);
+    append(res, &h_np1[0], nh);
+    append(res, A, 36);
+    if (large) append(res, B, 18);
+    res.push_back(u_np1);
+    res.push_back(p_np1);
+
+    std::copy(e_np1, e_np1 + 6, e_n);
+    std::copy(s_np1, s_np1 + 6, s_n);
+    std::swap(h_n, h_np1);
+    u_n = u_np1;
+    p_n = p_np1;
+  }
+
+  return res;
+}
+
+/// Run all the points serially and then from nthreads threads, returning
+/// the number of points whose results differ
+static size_t check(const NEMLModel & model, bool large, int nthreads)
+{
+  std::vector<PointResults> serial(npoints), parallel(npoints);
+  for (size_t p = 0; p < npoints; p++) {
+    serial[p] = run_point(model, p, large);
+  }
+
+  // Each thread takes every nthreads-th point, so the threads interleave
+  // points with different histories through the shared model
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nthreads; t++) {
+    threads.emplace_back([&model, &parallel, large, nthreads, t]() {
+      for (size_t p = t; p < npoints; p += nthreads) {
+        parallel[p] = run_point(model, p, large);
+      }
+    });
+  }
+  for (auto & t : threads) t.join();
+
+  size_t differ = 0;
+  for (size_t p = 0; p < npoints; p++) {
+    if ((serial[p].size() != parallel[p].size()) ||
+        (std::memcmp(serial[p].data(), parallel[p].data(),
+                     serial[p].size() * sizeof(double)) != 0)) {
+      differ++;
+    }
+  }
+
+  return differ;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2) {
+    printf("Expected at least 1 argument:\n");
+    printf("\tXML file, [threads (8)], [model names (all in the file)]\n");
+    return -1;
+  }
+
+  std::string fname = argv[1];
+  int nthreads = (argc > 2) ? std::atoi(argv[2]) : 8;
+
+  std::vector<std::string> names;
+  for (int i = 3; i < argc; i++) names.push_back(argv[i]);
+  if (names.empty()) {
+    rapidxml::file<> xml_file(fname.c_str());
+    rapidxml::xml_document<> doc;
+    doc.parse<0>(xml_file.data());
+    for (auto node = doc.first_node()->first_node(); node;
+         node = node->next_sibling()) {
+      names.push_back(node->name());
+    }
+  }
+
+  int bad = 0;
+  printf("%-24s %8s %8s\n", "model", "sd", "ld_inc");
+  for (auto & name : names) {
+    std::shared_ptr<NEMLModel> model;
+    try {
+      model = parse_xml(fname, name);
+    }
+    catch (std::exception & e) {
+      printf("%-24s could not be created: %s\n", name.c_str(), e.what());
+      bad++;
+      continue;
+    }
+
+    printf("%-24s", name.c_str());
+    for (bool large : {false, true}) {
+      size_t differ = check(*model, large, nthreads);
+      if (differ == 0) {
+        printf(" %8s", "same");
+      }
+      else {
+        printf(" %5zu/%zu", differ, npoints);
+        bad++;
+      }
+    }
+    printf("\n");
+  }
+
+  if (bad != 0) {
+    printf("%d model(s) gave different results in parallel\n", bad);
+    return 1;
+  }
+  return 0;
+}